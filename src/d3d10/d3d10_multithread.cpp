@@ -3,16 +3,22 @@
 namespace dxvk {
 
   void D3D10DeviceMutex::lock() {
-    while (!try_lock())
-      dxvk::this_thread::yield();
+    if (likely(try_lock()))
+      return;
+    
+    lockContended();
   }
 
 
   void D3D10DeviceMutex::unlock() {
-    if (likely(m_counter == 0))
-      m_owner.store(0, std::memory_order_release);
-    else
+    if (likely(m_counter == 0)) {
+      m_owner.store(0, std::memory_order_seq_cst);
+
+      if (unlikely(m_waiters.load(std::memory_order_seq_cst) != 0))
+        sync::ParkingLot::wake(&m_owner);
+    } else {
       m_counter -= 1;
+    }
   }
 
 
@@ -34,6 +40,34 @@ namespace dxvk {
   }
 
 
+  void D3D10DeviceMutex::lockContended() {
+    m_contended.fetch_add(1, std::memory_order_relaxed);
+
+    uint32_t spinCount = sync::ParkingLot::spinCount();
+
+    for (uint32_t i = 0; i < spinCount; i++) {
+      _mm_pause();
+
+      if (m_owner.load(std::memory_order_relaxed) == 0 && try_lock())
+        return;
+    }
+
+    // Register as a waiter before checking the owner
+    // again, so that unlock cannot miss the wakeup
+    m_parked.fetch_add(1, std::memory_order_relaxed);
+    m_waiters.fetch_add(1, std::memory_order_seq_cst);
+
+    while (!try_lock()) {
+      uint32_t owner = m_owner.load(std::memory_order_seq_cst);
+
+      if (owner != 0)
+        sync::ParkingLot::park(&m_owner, owner);
+    }
+
+    m_waiters.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+
   D3D10Multithread::D3D10Multithread(
           IUnknown*             pParent,
           BOOL                  Protected)
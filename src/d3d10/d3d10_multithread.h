@@ -8,7 +8,9 @@ namespace dxvk {
    * \brief Device mutex
    * 
    * Effectively implements a recursive spinlock
-   * which is used to lock the D3D10 device.
+   * which is used to lock the D3D10 device. If
+   * the lock is contested for longer than a short
+   * spin period, waiting threads will be parked.
    */
   class D3D10DeviceMutex {
 
@@ -20,10 +22,27 @@ namespace dxvk {
 
     bool try_lock();
 
+    /**
+     * \brief Queries contention statistics
+     * \returns Lock statistics
+     */
+    sync::LockStats getStats() const {
+      sync::LockStats result;
+      result.contended = m_contended.load(std::memory_order_relaxed);
+      result.parked    = m_parked.load(std::memory_order_relaxed);
+      return result;
+    }
+
   private:
 
-    std::atomic<uint32_t> m_owner   = { 0u };
-    uint32_t              m_counter = { 0u };
+    std::atomic<uint32_t> m_owner     = { 0u };
+    uint32_t              m_counter   = { 0u };
+
+    std::atomic<uint32_t> m_waiters   = { 0u };
+    std::atomic<uint32_t> m_contended = { 0u };
+    std::atomic<uint32_t> m_parked    = { 0u };
+
+    void lockContended();
     
   };
 
@@ -1,8 +1,9 @@
 #include "d3d11_annotation.h"
+#include "d3d11_context.h"
 
 namespace dxvk {
 
-  D3D11UserDefinedAnnotation::D3D11UserDefinedAnnotation(ID3D11DeviceContext* ctx)
+  D3D11UserDefinedAnnotation::D3D11UserDefinedAnnotation(D3D11DeviceContext* ctx)
   : m_container(ctx) { }
 
 
@@ -30,26 +31,60 @@ namespace dxvk {
 
   INT STDMETHODCALLTYPE D3D11UserDefinedAnnotation::BeginEvent(
           LPCWSTR                 Name) {
-    // Currently not implemented
-    return -1;
+    D3D10DeviceLock lock = m_container->LockContext();
+
+    if (!IsEnabled())
+      return -1;
+
+    m_container->EmitCs([
+      cName = Name ? str::fromws(Name) : std::string()
+    ] (DxvkContext* ctx) {
+      ctx->beginDebugRegion(cName);
+    });
+
+    return m_eventDepth++;
   }
 
 
   INT STDMETHODCALLTYPE D3D11UserDefinedAnnotation::EndEvent() {
-    // Currently not implemented
-    return -1;
+    D3D10DeviceLock lock = m_container->LockContext();
+
+    if (!IsEnabled() || !m_eventDepth)
+      return -1;
+
+    m_container->EmitCs([] (DxvkContext* ctx) {
+      ctx->endDebugRegion();
+    });
+
+    return --m_eventDepth;
   }
 
 
   void STDMETHODCALLTYPE D3D11UserDefinedAnnotation::SetMarker(
           LPCWSTR                 Name) {
-    // Currently not implemented
+    D3D10DeviceLock lock = m_container->LockContext();
+
+    if (!m_container->m_device->gpuProfiler()->hasDebugLabels())
+      return;
+
+    m_container->EmitCs([
+      cName = Name ? str::fromws(Name) : std::string()
+    ] (DxvkContext* ctx) {
+      ctx->insertDebugMarker(cName);
+    });
   }
 
 
   BOOL STDMETHODCALLTYPE D3D11UserDefinedAnnotation::GetStatus() {
-    // Currently not implemented
-    return FALSE;
+    return IsEnabled();
+  }
+
+
+  bool D3D11UserDefinedAnnotation::IsEnabled() const {
+    // Only record regions if anything consumes them, since
+    // applications may emit hundreds of events per frame
+    Rc<DxvkGpuProfiler> profiler = m_container->m_device->gpuProfiler();
+    return profiler->hasDebugLabels() || profiler->isTimingEnabled();
   }
 
-}
\ No newline at end of file
+}
@@ -4,11 +4,13 @@
 
 namespace dxvk {
 
+  class D3D11DeviceContext;
+
   class D3D11UserDefinedAnnotation : ID3DUserDefinedAnnotation {
 
   public:
 
-    D3D11UserDefinedAnnotation(ID3D11DeviceContext* ctx);
+    D3D11UserDefinedAnnotation(D3D11DeviceContext* ctx);
     ~D3D11UserDefinedAnnotation();
 
     ULONG STDMETHODCALLTYPE AddRef();
@@ -31,7 +33,10 @@ namespace dxvk {
 
   private:
 
-    ID3D11DeviceContext*  m_container;
+    D3D11DeviceContext*   m_container;
+    INT                   m_eventDepth = 0;
+
+    bool IsEnabled() const;
 
   };
 
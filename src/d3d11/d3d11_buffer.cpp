@@ -90,6 +90,14 @@ namespace dxvk {
                   | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
     }
     
+    // Constant buffers passed as push constants are read
+    // by the CPU at draw time, so they must be mappable
+    if ((pDesc->Usage == D3D11_USAGE_IMMUTABLE) && (pDesc->BindFlags & D3D11_BIND_CONSTANT_BUFFER)
+     && (m_device->GetOptions()->pushConstantBuffers)) {
+      memoryFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+                  | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    }
+    
     // AMD cards have a device-local, host-visible memory type where
     // we can put dynamic resources that need fast access by the GPU
     if (pDesc->Usage == D3D11_USAGE_DYNAMIC && pDesc->BindFlags)
@@ -0,0 +1,311 @@
+#include <atomic>
+#include <cstring>
+
+#include "d3d11_buffer.h"
+#include "d3d11_capture.h"
+#include "d3d11_texture.h"
+
+namespace dxvk {
+
+  D3D11ApiCapture::D3D11ApiCapture(const std::string& Directory) {
+    static std::atomic<uint32_t> s_captureId = { 0u };
+
+    std::string path = Directory;
+
+    if (!path.empty() && *path.rbegin() != '/')
+      path += '/';
+
+    std::string exeName = env::getExeName();
+    auto extp = exeName.find_last_of('.');
+
+    if (extp != std::string::npos && exeName.substr(extp + 1) == "exe")
+      exeName.erase(extp);
+
+    // Applications may create multiple devices, so
+    // we need to write each one to a different file
+    path += str::format(exeName, "_", s_captureId++, ".dxvk-trace");
+
+    m_stream = std::ofstream(path, std::ios_base::binary | std::ios_base::trunc);
+
+    if (!m_stream) {
+      Logger::err(str::format("D3D11: Failed to create capture file ", path));
+      return;
+    }
+
+    Logger::info(str::format("D3D11: Capturing API calls to ", path));
+
+    D3D11CaptureHeader header;
+    m_stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  }
+
+
+  D3D11ApiCapture::~D3D11ApiCapture() {
+    m_stream.flush();
+  }
+
+
+  void D3D11ApiCapture::RecordMap(
+          ID3D11Resource*             pResource,
+          UINT                        Subresource,
+          D3D11_MAP                   MapType,
+          UINT                        MapFlags,
+    const D3D11_MAPPED_SUBRESOURCE*   pMappedResource) {
+    RecordCall(D3D11CaptureOp::Map, pResource, Subresource, MapType, MapFlags);
+
+    if (MapType == D3D11_MAP_READ)
+      return;
+
+    D3D11_RESOURCE_DIMENSION resourceDim = D3D11_RESOURCE_DIMENSION_UNKNOWN;
+    pResource->GetType(&resourceDim);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    MappedRegion region;
+    region.mapType    = MapType;
+    region.mapPtr     = pMappedResource->pData;
+    region.rowPitch   = pMappedResource->RowPitch;
+    region.depthPitch = pMappedResource->DepthPitch;
+    region.bufferId   = 0;
+
+    if (resourceDim == D3D11_RESOURCE_DIMENSION_BUFFER) {
+      region.size     = static_cast<D3D11Buffer*>(pResource)->Desc()->ByteWidth;
+      region.bufferId = LookupObject(pResource);
+
+      // We need to know the current buffer contents in order to
+      // determine which range the application has written. Mapped
+      // memory is slow to read, so only do this if the buffer has
+      // not been mapped yet during the current frame.
+      if (MapType == D3D11_MAP_WRITE_NO_OVERWRITE && region.bufferId) {
+        auto& shadow = m_bufferShadows[region.bufferId];
+
+        if (shadow.size() != region.size) {
+          auto data = reinterpret_cast<const char*>(region.mapPtr);
+          shadow.assign(data, data + region.size);
+        }
+      }
+    } else {
+      const D3D11CommonTexture* texture = GetCommonTexture(pResource);
+
+      VkImageSubresource subresource = texture->GetSubresourceFromIndex(
+        VK_IMAGE_ASPECT_COLOR_BIT, Subresource);
+
+      region.size = size_t(region.depthPitch)
+        * texture->GetImage()->mipLevelExtent(subresource.mipLevel).depth;
+    }
+
+    m_mappedRegions[GetMapKey(pResource, Subresource)] = std::move(region);
+  }
+
+
+  void D3D11ApiCapture::RecordUnmap(
+          ID3D11Resource*             pResource,
+          UINT                        Subresource) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto entry = m_mappedRegions.find(GetMapKey(pResource, Subresource));
+
+    size_t offset = 0;
+    size_t size   = 0;
+
+    UINT rowPitch   = 0;
+    UINT depthPitch = 0;
+
+    const char* data = nullptr;
+
+    std::vector<char>* shadow = nullptr;
+
+    if (entry != m_mappedRegions.end()) {
+      const MappedRegion& region = entry->second;
+
+      data       = reinterpret_cast<const char*>(region.mapPtr);
+      size       = region.size;
+      rowPitch   = region.rowPitch;
+      depthPitch = region.depthPitch;
+
+      // Dynamic buffers can only be written through maps, so
+      // the shadow copy stays valid as long as we update it
+      if (region.bufferId && (region.mapType == D3D11_MAP_WRITE_DISCARD
+                           || region.mapType == D3D11_MAP_WRITE_NO_OVERWRITE))
+        shadow = &m_bufferShadows[region.bufferId];
+
+      // The shadow copy may have been dropped by a
+      // present while the buffer was still mapped
+      if (shadow && shadow->size() == region.size
+       && region.mapType == D3D11_MAP_WRITE_NO_OVERWRITE) {
+        size_t lo = 0;
+        size_t hi = region.size;
+
+        while (lo < hi && data[lo] == (*shadow)[lo])
+          lo += 1;
+
+        while (hi > lo && data[hi - 1] == (*shadow)[hi - 1])
+          hi -= 1;
+
+        offset = lo;
+        size   = hi - lo;
+      } else if (shadow) {
+        shadow->resize(region.size);
+      }
+    }
+
+    BeginRecord(D3D11CaptureOp::Unmap);
+    Write(LookupObject(pResource));
+    Write(Subresource);
+    Write(rowPitch);
+    Write(depthPitch);
+    Write(uint64_t(offset));
+    Write(D3D11CaptureBlob { data + offset, size });
+    EndRecord();
+
+    // Copy the recorded data rather than reading mapped memory again
+    if (shadow != nullptr && data != nullptr)
+      std::memcpy(shadow->data() + offset, m_record.data() + m_record.size() - size, size);
+
+    if (entry != m_mappedRegions.end())
+      m_mappedRegions.erase(entry);
+  }
+
+
+  std::string D3D11ApiCapture::GetCaptureDirectory() {
+    return env::getEnvVar("DXVK_CAPTURE_PATH");
+  }
+
+
+  uint32_t D3D11ApiCapture::RegisterObject(const void* pObject) {
+    // Objects may get recreated at the address of a previously
+    // destroyed object, so we always assign a new ID here
+    uint32_t id = m_nextObjectId++;
+    m_objects[pObject] = id;
+    return id;
+  }
+
+
+  uint32_t D3D11ApiCapture::LookupObject(const void* pObject) {
+    if (pObject == nullptr)
+      return 0;
+
+    auto entry = m_objects.find(pObject);
+
+    if (entry == m_objects.end()) {
+      static bool s_errorShown = false;
+
+      if (!std::exchange(s_errorShown, true))
+        Logger::warn("D3D11: Capture: Object not created by the captured device");
+
+      return 0;
+    }
+
+    return entry->second;
+  }
+
+
+  void D3D11ApiCapture::BeginRecord(D3D11CaptureOp Op) {
+    m_record.clear();
+    m_recordOp = Op;
+  }
+
+
+  void D3D11ApiCapture::EndRecord() {
+    D3D11CaptureRecordHeader header;
+    header.op   = m_recordOp;
+    header.size = uint32_t(m_record.size());
+
+    m_stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    m_stream.write(m_record.data(), m_record.size());
+
+    // Make sure the trace is usable if the application
+    // terminates without destroying the device. Buffer
+    // shadow copies are re-read once per frame, which
+    // also drops the ones of destroyed buffers.
+    if (m_recordOp == D3D11CaptureOp::Present) {
+      m_stream.flush();
+      m_bufferShadows.clear();
+    }
+  }
+
+
+  void D3D11ApiCapture::WriteRaw(const void* pData, size_t Size) {
+    auto data = reinterpret_cast<const char*>(pData);
+    m_record.insert(m_record.end(), data, data + Size);
+  }
+
+
+  void D3D11ApiCapture::WriteString(const char* pString) {
+    size_t length = pString ? std::strlen(pString) : 0;
+
+    Write(uint32_t(length));
+    WriteRaw(pString, length);
+  }
+
+
+  void D3D11ApiCapture::Write(const D3D11CaptureBlob& Blob) {
+    Write(uint64_t(Blob.data ? Blob.size : 0));
+
+    if (Blob.data != nullptr)
+      WriteRaw(Blob.data, Blob.size);
+  }
+
+
+  void D3D11ApiCapture::Write(const D3D11CaptureInitialData& InitialData) {
+    if (InitialData.data == nullptr || InitialData.data->pSysMem == nullptr) {
+      Write(uint32_t(0));
+      return;
+    }
+
+    const Rc<DxvkImage> image = InitialData.texture->GetImage();
+    const DxvkFormatInfo* formatInfo = imageFormatInfo(image->info().format);
+
+    uint32_t subresourceCount = image->info().mipLevels * image->info().numLayers;
+    Write(subresourceCount);
+
+    // Subresources are ordered the same way as in pInitialData
+    std::vector<char> packedData;
+
+    for (uint32_t layer = 0; layer < image->info().numLayers; layer++) {
+      for (uint32_t level = 0; level < image->info().mipLevels; level++) {
+        const D3D11_SUBRESOURCE_DATA& srcData = InitialData.data[
+          D3D11CalcSubresource(level, layer, image->info().mipLevels)];
+
+        VkExtent3D blockCount = util::computeBlockCount(
+          image->mipLevelExtent(level), formatInfo->blockSize);
+
+        VkDeviceSize bytesPerRow   = blockCount.width  * formatInfo->elementSize;
+        VkDeviceSize bytesPerLayer = blockCount.height * bytesPerRow;
+        VkDeviceSize bytesTotal    = blockCount.depth  * bytesPerLayer;
+
+        packedData.resize(bytesTotal);
+
+        util::packImageData(packedData.data(),
+          reinterpret_cast<const char*>(srcData.pSysMem),
+          blockCount, formatInfo->elementSize,
+          srcData.SysMemPitch, srcData.SysMemSlicePitch);
+
+        Write(uint32_t(bytesPerRow));
+        Write(uint32_t(bytesPerLayer));
+        Write(D3D11CaptureBlob { packedData.data(), packedData.size() });
+      }
+    }
+  }
+
+
+  void D3D11ApiCapture::Write(const D3D11_INPUT_ELEMENT_DESC& Element) {
+    WriteString(Element.SemanticName);
+    Write(Element.SemanticIndex);
+    Write(Element.Format);
+    Write(Element.InputSlot);
+    Write(Element.AlignedByteOffset);
+    Write(Element.InputSlotClass);
+    Write(Element.InstanceDataStepRate);
+  }
+
+
+  void D3D11ApiCapture::Write(const D3D11_SO_DECLARATION_ENTRY& Entry) {
+    Write(Entry.Stream);
+    WriteString(Entry.SemanticName);
+    Write(Entry.SemanticIndex);
+    Write(Entry.StartComponent);
+    Write(Entry.ComponentCount);
+    Write(Entry.OutputSlot);
+  }
+
+}
@@ -0,0 +1,346 @@
+#pragma once
+
+#include <fstream>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "d3d11_include.h"
+
+namespace dxvk {
+
+  class D3D11CommonTexture;
+
+  /**
+   * \brief API capture opcodes
+   *
+   * Each record in a capture file starts with one of
+   * these opcodes, followed by the size of the payload.
+   * Functions that exist in multiple versions are
+   * recorded using the most complete variant.
+   */
+  enum class D3D11CaptureOp : uint32_t {
+    CreateBuffer                                = 1,
+    CreateTexture1D                             = 2,
+    CreateTexture2D                             = 3,
+    CreateTexture3D                             = 4,
+    CreateShaderResourceView                    = 5,
+    CreateUnorderedAccessView                   = 6,
+    CreateRenderTargetView                      = 7,
+    CreateDepthStencilView                      = 8,
+    CreateInputLayout                           = 9,
+    CreateVertexShader                          = 10,
+    CreateHullShader                            = 11,
+    CreateDomainShader                          = 12,
+    CreateGeometryShader                        = 13,
+    CreateGeometryShaderWithStreamOutput        = 14,
+    CreatePixelShader                           = 15,
+    CreateComputeShader                         = 16,
+    CreateBlendState1                           = 17,
+    CreateDepthStencilState                     = 18,
+    CreateRasterizerState1                      = 19,
+    CreateSamplerState                          = 20,
+    CreateQuery                                 = 21,
+    CreatePredicate                             = 22,
+
+    ClearState                                  = 64,
+    Begin                                       = 65,
+    End                                         = 66,
+    SetPredication                              = 67,
+    CopySubresourceRegion1                      = 68,
+    CopyResource                                = 69,
+    CopyStructureCount                          = 70,
+    ClearRenderTargetView                       = 71,
+    ClearUnorderedAccessViewUint                = 72,
+    ClearUnorderedAccessViewFloat               = 73,
+    ClearDepthStencilView                       = 74,
+    ClearView                                   = 75,
+    GenerateMips                                = 76,
+    UpdateSubresource1                          = 77,
+    ResolveSubresource                          = 78,
+    DrawAuto                                    = 79,
+    Draw                                        = 80,
+    DrawIndexed                                 = 81,
+    DrawInstanced                               = 82,
+    DrawIndexedInstanced                        = 83,
+    DrawIndexedInstancedIndirect                = 84,
+    DrawInstancedIndirect                       = 85,
+    Dispatch                                    = 86,
+    DispatchIndirect                            = 87,
+    IASetInputLayout                            = 88,
+    IASetPrimitiveTopology                      = 89,
+    IASetVertexBuffers                          = 90,
+    IASetIndexBuffer                            = 91,
+    SetShader                                   = 92,
+    SetConstantBuffers                          = 93,
+    SetShaderResources                          = 94,
+    SetSamplers                                 = 95,
+    CSSetUnorderedAccessViews                   = 96,
+    OMSetRenderTargets                          = 97,
+    OMSetRenderTargetsAndUnorderedAccessViews   = 98,
+    OMSetBlendState                             = 99,
+    OMSetDepthStencilState                      = 100,
+    RSSetState                                  = 101,
+    RSSetViewports                              = 102,
+    RSSetScissorRects                           = 103,
+    SOSetTargets                                = 104,
+    DiscardResource                             = 105,
+    DiscardView                                 = 106,
+    Map                                         = 107,
+    Unmap                                       = 108,
+    Flush                                       = 109,
+    ExecuteCommandList                          = 110,
+    Present                                     = 111,
+  };
+
+
+  /**
+   * \brief Capture file header
+   */
+  struct D3D11CaptureHeader {
+    char     magic[4] = { 'D', 'X', 'V', 'T' };
+    uint32_t version  = 1;
+  };
+
+
+  /**
+   * \brief Capture record header
+   *
+   * Precedes the payload of each record.
+   */
+  struct D3D11CaptureRecordHeader {
+    D3D11CaptureOp op;
+    uint32_t       size;
+  };
+
+
+  /**
+   * \brief Array argument
+   *
+   * Arrays are stored with their element count. Null
+   * arrays are stored as empty arrays. Object pointers
+   * are stored as object IDs, with zero denoting null.
+   */
+  template<typename T>
+  struct D3D11CaptureArray {
+    D3D11CaptureArray(const T* pData, UINT Count)
+    : data(pData), count(pData ? Count : 0) { }
+
+    const T* data;
+    UINT     count;
+  };
+
+
+  /**
+   * \brief Optional argument
+   *
+   * Stores a flag that indicates whether the
+   * pointer is valid, followed by the object.
+   */
+  template<typename T>
+  struct D3D11CaptureOptional {
+    D3D11CaptureOptional(const T* pData)
+    : data(pData) { }
+
+    const T* data;
+  };
+
+
+  /**
+   * \brief Raw data argument
+   */
+  struct D3D11CaptureBlob {
+    const void* data;
+    size_t      size;
+  };
+
+
+  /**
+   * \brief Texture initial data argument
+   *
+   * Stores the data of each subresource in a tightly
+   * packed layout, followed by the row and layer pitch.
+   */
+  struct D3D11CaptureInitialData {
+    const D3D11CommonTexture*     texture;
+    const D3D11_SUBRESOURCE_DATA* data;
+  };
+
+
+  /**
+   * \brief D3D11 API capture
+   *
+   * Serializes resource creation and immediate context
+   * calls into a binary file, so that a frame sequence
+   * can be replayed deterministically for benchmarking.
+   * Objects are identified by IDs which are assigned
+   * in creation order. Capture is enabled by setting
+   * \c DXVK_CAPTURE_PATH to an existing directory.
+   */
+  class D3D11ApiCapture {
+
+  public:
+
+    D3D11ApiCapture(const std::string& Directory);
+
+    ~D3D11ApiCapture();
+
+    /**
+     * \brief Records a context call
+     *
+     * \param [in] Op The operation
+     * \param [in] Args Call arguments
+     */
+    template<typename... Args>
+    void RecordCall(D3D11CaptureOp Op, const Args&... Arguments) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+
+      BeginRecord(Op);
+      (Write(Arguments), ...);
+      EndRecord();
+    }
+
+    /**
+     * \brief Records object creation
+     *
+     * Assigns a new ID to the given object and
+     * writes it before the creation arguments.
+     * \param [in] Op The operation
+     * \param [in] pObject The created object
+     * \param [in] Args Creation arguments
+     */
+    template<typename T, typename... Args>
+    void RecordCreate(D3D11CaptureOp Op, T* pObject, const Args&... Arguments) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+
+      BeginRecord(Op);
+      Write(RegisterObject(pObject));
+      (Write(Arguments), ...);
+      EndRecord();
+    }
+
+    /**
+     * \brief Records a successful map operation
+     *
+     * Remembers the mapped memory region so that
+     * the data written by the application can be
+     * recorded when the resource gets unmapped.
+     * \param [in] pResource The mapped resource
+     * \param [in] Subresource Subresource index
+     * \param [in] MapType Map type
+     * \param [in] MapFlags Map flags
+     * \param [in] pMappedResource Mapped memory
+     */
+    void RecordMap(
+            ID3D11Resource*             pResource,
+            UINT                        Subresource,
+            D3D11_MAP                   MapType,
+            UINT                        MapFlags,
+      const D3D11_MAPPED_SUBRESOURCE*   pMappedResource);
+
+    /**
+     * \brief Records an unmap operation
+     *
+     * Writes the data that the application wrote to
+     * the mapped memory region. For buffers mapped with
+     * \c D3D11_MAP_WRITE_NO_OVERWRITE, only the range
+     * that differs from a shadow copy of the buffer is
+     * recorded. The shadow copy is updated on unmap, so
+     * that the buffer only needs to be copied out of
+     * mapped memory once per frame.
+     * \param [in] pResource The mapped resource
+     * \param [in] Subresource Subresource index
+     */
+    void RecordUnmap(
+            ID3D11Resource*             pResource,
+            UINT                        Subresource);
+
+    /**
+     * \brief Queries capture directory
+     * \returns Capture directory, or an empty
+     *    string if capture is disabled
+     */
+    static std::string GetCaptureDirectory();
+
+  private:
+
+    struct MappedRegion {
+      D3D11_MAP             mapType;
+      void*                 mapPtr;
+      UINT                  rowPitch;
+      UINT                  depthPitch;
+      size_t                size;
+      uint32_t              bufferId;
+    };
+
+    std::mutex        m_mutex;
+    std::ofstream     m_stream;
+
+    std::vector<char> m_record;
+    D3D11CaptureOp    m_recordOp;
+
+    uint32_t          m_nextObjectId = 1;
+
+    std::unordered_map<const void*, uint32_t> m_objects;
+    std::unordered_map<uint64_t, MappedRegion> m_mappedRegions;
+    std::unordered_map<uint32_t, std::vector<char>> m_bufferShadows;
+
+    uint32_t RegisterObject(const void* pObject);
+
+    uint32_t LookupObject(const void* pObject);
+
+    void BeginRecord(D3D11CaptureOp Op);
+
+    void EndRecord();
+
+    void WriteRaw(const void* pData, size_t Size);
+
+    void WriteString(const char* pString);
+
+    void Write(const D3D11CaptureBlob& Blob);
+
+    void Write(const D3D11CaptureInitialData& InitialData);
+
+    void Write(const D3D11_INPUT_ELEMENT_DESC& Element);
+
+    void Write(const D3D11_SO_DECLARATION_ENTRY& Entry);
+
+    template<typename T>
+    void Write(const D3D11CaptureArray<T>& Array) {
+      Write(Array.count);
+
+      for (uint32_t i = 0; i < Array.count; i++)
+        Write(Array.data[i]);
+    }
+
+    template<typename T>
+    void Write(const D3D11CaptureOptional<T>& Optional) {
+      Write(uint32_t(Optional.data != nullptr));
+
+      if (Optional.data != nullptr)
+        Write(*Optional.data);
+    }
+
+    template<typename T>
+    void Write(const T& Value) {
+      if constexpr (std::is_pointer<T>::value) {
+        static_assert(std::is_base_of<IUnknown, std::remove_pointer_t<T>>::value,
+          "D3D11ApiCapture: Non-object pointers must be wrapped");
+        Write(LookupObject(Value));
+      } else {
+        static_assert(std::is_trivially_copyable<T>::value,
+          "D3D11ApiCapture: Cannot serialize type");
+        WriteRaw(&Value, sizeof(Value));
+      }
+    }
+
+    static uint64_t GetMapKey(
+            ID3D11Resource*             pResource,
+            UINT                        Subresource) {
+      return uint64_t(reinterpret_cast<uintptr_t>(pResource)) ^ (uint64_t(Subresource) << 48);
+    }
+
+  };
+
+}
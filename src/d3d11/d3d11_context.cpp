@@ -77,10 +77,12 @@ namespace dxvk {
   void STDMETHODCALLTYPE D3D11DeviceContext::DiscardResource(ID3D11Resource* pResource) {
     D3D10DeviceLock lock = LockContext();
 
+    if (unlikely(m_capture != nullptr))
+      m_capture->RecordCall(D3D11CaptureOp::DiscardResource, pResource);
+
     if (!pResource)
       return;
     
-    // We don't support the Discard API for images
     D3D11_RESOURCE_DIMENSION resType = D3D11_RESOURCE_DIMENSION_UNKNOWN;
     pResource->GetType(&resType);
 
@@ -94,25 +96,10 @@ namespace dxvk {
   void STDMETHODCALLTYPE D3D11DeviceContext::DiscardView(ID3D11View* pResourceView) {
     D3D10DeviceLock lock = LockContext();
 
-    // ID3D11View has no methods to query the exact type of
-    // the view, so we'll have to check each possible class
-    auto dsv = dynamic_cast<D3D11DepthStencilView*>(pResourceView);
-    auto rtv = dynamic_cast<D3D11RenderTargetView*>(pResourceView);
-    auto uav = dynamic_cast<D3D11UnorderedAccessView*>(pResourceView);
-
-    Rc<DxvkImageView> view;
-    if (dsv) view = dsv->GetImageView();
-    if (rtv) view = rtv->GetImageView();
-    if (uav) view = uav->GetImageView();
+    if (unlikely(m_capture != nullptr))
+      m_capture->RecordCall(D3D11CaptureOp::DiscardView, pResourceView);
 
-    if (view != nullptr) {
-      EmitCs([cView = std::move(view)]
-      (DxvkContext* ctx) {
-        ctx->discardImage(
-          cView->image(),
-          cView->subresources());
-      });
-    }
+    DiscardImageView(pResourceView, nullptr, 0);
   }
 
 
@@ -120,10 +107,9 @@ namespace dxvk {
           ID3D11View*              pResourceView, 
     const D3D11_RECT*              pRects, 
           UINT                     NumRects) {
-    static bool s_errorShown = false;
-    
-    if (!std::exchange(s_errorShown, true))
-      Logger::err("D3D11DeviceContext::DiscardView1: Not implemented");
+    D3D10DeviceLock lock = LockContext();
+
+    DiscardImageView(pResourceView, pRects, NumRects);
   }
 
 
@@ -142,6 +128,9 @@ namespace dxvk {
   void STDMETHODCALLTYPE D3D11DeviceContext::ClearState() {
     D3D10DeviceLock lock = LockContext();
 
+    if (unlikely(m_capture != nullptr))
+      m_capture->RecordCall(D3D11CaptureOp::ClearState);
+
     // Default shaders
     m_state.vs.shader = nullptr;
     m_state.hs.shader = nullptr;
@@ -245,6 +234,9 @@ namespace dxvk {
   void STDMETHODCALLTYPE D3D11DeviceContext::Begin(ID3D11Asynchronous *pAsync) {
     D3D10DeviceLock lock = LockContext();
 
+    if (unlikely(m_capture != nullptr))
+      m_capture->RecordCall(D3D11CaptureOp::Begin, pAsync);
+
     if (!pAsync)
       return;
     
@@ -259,6 +251,9 @@ namespace dxvk {
   void STDMETHODCALLTYPE D3D11DeviceContext::End(ID3D11Asynchronous *pAsync) {
     D3D10DeviceLock lock = LockContext();
 
+    if (unlikely(m_capture != nullptr))
+      m_capture->RecordCall(D3D11CaptureOp::End, pAsync);
+
     if (!pAsync)
       return;
     
@@ -279,6 +274,9 @@ namespace dxvk {
       Logger::err("D3D11DeviceContext::SetPredication: Stub");
     
     D3D10DeviceLock lock = LockContext();
+
+    if (unlikely(m_capture != nullptr))
+      m_capture->RecordCall(D3D11CaptureOp::SetPredication, pPredicate, PredicateValue);
     
     m_state.pr.predicateObject = static_cast<D3D11Query*>(pPredicate);
     m_state.pr.predicateValue  = PredicateValue;
@@ -323,8 +321,17 @@ namespace dxvk {
           UINT                              SrcSubresource,
     const D3D11_BOX*                        pSrcBox,
           UINT                              CopyFlags) {
+    DXVK_TRACE_ZONE("D3D11DeviceContext::CopySubresourceRegion1");
+
     D3D10DeviceLock lock = LockContext();
 
+    if (unlikely(m_capture != nullptr)) {
+      m_capture->RecordCall(D3D11CaptureOp::CopySubresourceRegion1,
+        pDstResource, DstSubresource, DstX, DstY, DstZ,
+        pSrcResource, SrcSubresource,
+        D3D11CaptureOptional<D3D11_BOX>(pSrcBox), CopyFlags);
+    }
+
     D3D11_RESOURCE_DIMENSION dstResourceDim = D3D11_RESOURCE_DIMENSION_UNKNOWN;
     D3D11_RESOURCE_DIMENSION srcResourceDim = D3D11_RESOURCE_DIMENSION_UNKNOWN;
     
@@ -544,8 +551,13 @@ namespace dxvk {
   void STDMETHODCALLTYPE D3D11DeviceContext::CopyResource(
           ID3D11Resource*                   pDstResource,
           ID3D11Resource*                   pSrcResource) {
+    DXVK_TRACE_ZONE("D3D11DeviceContext::CopyResource");
+
     D3D10DeviceLock lock = LockContext();
 
+    if (unlikely(m_capture != nullptr))
+      m_capture->RecordCall(D3D11CaptureOp::CopyResource, pDstResource, pSrcResource);
+
     if (!pDstResource || !pSrcResource || (pDstResource == pSrcResource))
       return;
     
@@ -646,6 +658,11 @@ namespace dxvk {
           ID3D11UnorderedAccessView*        pSrcView) {
     D3D10DeviceLock lock = LockContext();
 
+    if (unlikely(m_capture != nullptr)) {
+      m_capture->RecordCall(D3D11CaptureOp::CopyStructureCount,
+        pDstBuffer, DstAlignedByteOffset, pSrcView);
+    }
+
     auto buf = static_cast<D3D11Buffer*>(pDstBuffer);
     auto uav = static_cast<D3D11UnorderedAccessView*>(pSrcView);
 
@@ -669,8 +686,15 @@ namespace dxvk {
   void STDMETHODCALLTYPE D3D11DeviceContext::ClearRenderTargetView(
           ID3D11RenderTargetView*           pRenderTargetView,
     const FLOAT                             ColorRGBA[4]) {
+    DXVK_TRACE_ZONE("D3D11DeviceContext::ClearRenderTargetView");
+
     D3D10DeviceLock lock = LockContext();
 
+    if (unlikely(m_capture != nullptr)) {
+      m_capture->RecordCall(D3D11CaptureOp::ClearRenderTargetView,
+        pRenderTargetView, D3D11CaptureArray<FLOAT>(ColorRGBA, 4));
+    }
+
     auto rtv = static_cast<D3D11RenderTargetView*>(pRenderTargetView);
     
     if (!rtv)
@@ -701,6 +725,11 @@ namespace dxvk {
     const UINT                              Values[4]) {
     D3D10DeviceLock lock = LockContext();
 
+    if (unlikely(m_capture != nullptr)) {
+      m_capture->RecordCall(D3D11CaptureOp::ClearUnorderedAccessViewUint,
+        pUnorderedAccessView, D3D11CaptureArray<UINT>(Values, 4));
+    }
+
     auto uav = static_cast<D3D11UnorderedAccessView*>(pUnorderedAccessView);
     
     if (!uav)
@@ -802,6 +831,11 @@ namespace dxvk {
     const FLOAT                             Values[4]) {
     D3D10DeviceLock lock = LockContext();
 
+    if (unlikely(m_capture != nullptr)) {
+      m_capture->RecordCall(D3D11CaptureOp::ClearUnorderedAccessViewFloat,
+        pUnorderedAccessView, D3D11CaptureArray<FLOAT>(Values, 4));
+    }
+
     auto uav = static_cast<D3D11UnorderedAccessView*>(pUnorderedAccessView);
     
     if (!uav)
@@ -842,8 +876,15 @@ namespace dxvk {
           UINT                              ClearFlags,
           FLOAT                             Depth,
           UINT8                             Stencil) {
+    DXVK_TRACE_ZONE("D3D11DeviceContext::ClearDepthStencilView");
+
     D3D10DeviceLock lock = LockContext();
 
+    if (unlikely(m_capture != nullptr)) {
+      m_capture->RecordCall(D3D11CaptureOp::ClearDepthStencilView,
+        pDepthStencilView, ClearFlags, Depth, Stencil);
+    }
+
     auto dsv = static_cast<D3D11DepthStencilView*>(pDepthStencilView);
     
     if (!dsv)
@@ -887,6 +928,12 @@ namespace dxvk {
           UINT                              NumRects) {
     D3D10DeviceLock lock = LockContext();
 
+    if (unlikely(m_capture != nullptr)) {
+      m_capture->RecordCall(D3D11CaptureOp::ClearView, pView,
+        D3D11CaptureArray<FLOAT>(Color, 4),
+        D3D11CaptureArray<D3D11_RECT>(pRect, NumRects));
+    }
+
     // ID3D11View has no methods to query the exact type of
     // the view, so we'll have to check each possible class
     auto dsv = dynamic_cast<D3D11DepthStencilView*>(pView);
@@ -949,7 +996,10 @@ namespace dxvk {
       clearValue.depthStencil.stencil = 0;
     }
 
-    // Clear all the rectangles that are specified
+    // Clear all the rectangles that are specified. Image
+    // rects are batched so that they can be cleared at once.
+    std::vector<VkRect2D> imageRects;
+
     for (uint32_t i = 0; i < NumRects; i++) {
       if (pRect[i].left >= pRect[i].right
        || pRect[i].top >= pRect[i].bottom)
@@ -974,26 +1024,29 @@ namespace dxvk {
       }
 
       if (imgView != nullptr) {
-        VkOffset3D offset = { pRect[i].left, pRect[i].top, 0 };
-        VkExtent3D extent = { 
+        VkRect2D rect;
+        rect.offset = { pRect[i].left, pRect[i].top };
+        rect.extent = {
           uint32_t(pRect[i].right - pRect[i].left),
-          uint32_t(pRect[i].bottom - pRect[i].top), 1 };
-        
-        EmitCs([
-          cImageView    = imgView,
-          cAreaOffset   = offset,
-          cAreaExtent   = extent,
-          cClearValue   = clearValue
-        ] (DxvkContext* ctx) {
-          ctx->clearImageView(
-            cImageView,
-            cAreaOffset,
-            cAreaExtent,
-            cClearValue);
-        });
+          uint32_t(pRect[i].bottom - pRect[i].top) };
+        imageRects.push_back(rect);
       }
     }
 
+    if (!imageRects.empty()) {
+      EmitCs([
+        cImageView    = imgView,
+        cAreaRects    = std::move(imageRects),
+        cClearValue   = clearValue
+      ] (DxvkContext* ctx) {
+        ctx->clearImageViewRects(
+          cImageView,
+          cAreaRects.size(),
+          cAreaRects.data(),
+          cClearValue);
+      });
+    }
+
     // The rect array is optional, so if it is not
     // specified, we'll have to clear the entire view
     if (pRect == nullptr) {
@@ -1029,6 +1082,9 @@ namespace dxvk {
   void STDMETHODCALLTYPE D3D11DeviceContext::GenerateMips(ID3D11ShaderResourceView* pShaderResourceView) {
     D3D10DeviceLock lock = LockContext();
 
+    if (unlikely(m_capture != nullptr))
+      m_capture->RecordCall(D3D11CaptureOp::GenerateMips, pShaderResourceView);
+
     auto view = static_cast<D3D11ShaderResourceView*>(pShaderResourceView);
 
     if (!view || view->GetResourceType() == D3D11_RESOURCE_DIMENSION_BUFFER)
@@ -1062,6 +1118,8 @@ namespace dxvk {
           UINT                              SrcRowPitch, 
           UINT                              SrcDepthPitch, 
           UINT                              CopyFlags) {
+    DXVK_TRACE_ZONE("D3D11DeviceContext::UpdateSubresource1");
+
     D3D10DeviceLock lock = LockContext();
 
     if (!pDstResource)
@@ -1086,6 +1144,17 @@ namespace dxvk {
         size   = pDstBox->right - pDstBox->left;
       }
       
+      // Record the call once, no matter which path we take
+      // below, so that the replay does not depend on it
+      if (unlikely(m_capture != nullptr)) {
+        size_t blobSize = offset + size <= bufferSlice.length() ? size_t(size) : 0;
+        
+        m_capture->RecordCall(D3D11CaptureOp::UpdateSubresource1,
+          pDstResource, DstSubresource, D3D11CaptureOptional<D3D11_BOX>(pDstBox),
+          SrcRowPitch, SrcDepthPitch, CopyFlags,
+          D3D11CaptureBlob { pSrcData, blobSize });
+      }
+      
       if (offset + size > bufferSlice.length()) {
         Logger::err(str::format(
           "D3D11: UpdateSubresource: Buffer update range out of bounds",
@@ -1101,14 +1170,45 @@ namespace dxvk {
       
       if (((size == bufferSlice.length())
        && (bufferSlice.buffer()->memFlags() & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT))) {
+        // The update has already been recorded, so
+        // these calls must not show up in the capture
+        D3D11ApiCapture* capture = std::exchange(m_capture, nullptr);
+        
         D3D11_MAPPED_SUBRESOURCE mappedSr;
         Map(pDstResource, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedSr);
         std::memcpy(mappedSr.pData, pSrcData, size);
         Unmap(pDstResource, 0);
-      } else {
+        
+        m_capture = capture;
+      } else if (m_parent->GetOptions()->pushConstantBuffers
+              && (bufferResource->Desc()->BindFlags & D3D11_BIND_CONSTANT_BUFFER)
+              && (bufferSlice.buffer()->memFlags() & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)) {
         DxvkDataSlice dataSlice = AllocUpdateBufferSlice(size);
         std::memcpy(dataSlice.ptr(), pSrcData, size);
         
+        // Constant buffers may be read from mapped memory at draw
+        // time, so we cannot update them on the GPU. Rename the
+        // buffer instead and carry over the previous contents.
+        // This happens at execution time so that deferred contexts
+        // see the contents at the time the command list executes.
+        EmitCs([
+          cDataBuffer   = std::move(dataSlice),
+          cBufferSlice  = bufferSlice,
+          cOffset       = offset
+        ] (DxvkContext* ctx) {
+          DxvkBufferSliceHandle prevSlice = cBufferSlice.buffer()->getSliceHandle();
+          DxvkBufferSliceHandle physSlice = cBufferSlice.buffer()->allocSlice();
+          
+          auto dstData = reinterpret_cast<char*>(physSlice.mapPtr);
+          std::memcpy(dstData, prevSlice.mapPtr, cBufferSlice.length());
+          std::memcpy(dstData + cOffset, cDataBuffer.ptr(), cDataBuffer.length());
+          
+          ctx->invalidateBuffer(cBufferSlice.buffer(), physSlice);
+        });
+      } else {
+        DxvkDataSlice dataSlice = AllocUpdateBufferSlice(size);
+        std::memcpy(dataSlice.ptr(), pSrcData, size);
+
         EmitCs([
           cDataBuffer   = std::move(dataSlice),
           cBufferSlice  = bufferSlice.subSlice(offset, size)
@@ -1173,6 +1273,15 @@ namespace dxvk {
         regionExtent, formatInfo->elementSize,
         SrcRowPitch, SrcDepthPitch);
       
+      // Record the packed data so that the
+      // source pitches need not be preserved
+      if (unlikely(m_capture != nullptr)) {
+        m_capture->RecordCall(D3D11CaptureOp::UpdateSubresource1,
+          pDstResource, DstSubresource, D3D11CaptureOptional<D3D11_BOX>(pDstBox),
+          UINT(bytesPerRow), UINT(bytesPerLayer), CopyFlags,
+          D3D11CaptureBlob { imageDataBuffer.ptr(), size_t(bytesTotal) });
+      }
+
       EmitCs([
         cDstImage         = textureInfo->GetImage(),
         cDstLayers        = layers,
@@ -1211,6 +1320,12 @@ namespace dxvk {
           DXGI_FORMAT                       Format) {
     D3D10DeviceLock lock = LockContext();
 
+    if (unlikely(m_capture != nullptr)) {
+      m_capture->RecordCall(D3D11CaptureOp::ResolveSubresource,
+        pDstResource, DstSubresource,
+        pSrcResource, SrcSubresource, Format);
+    }
+
     bool isSameSubresource = pDstResource   == pSrcResource
                           && DstSubresource == SrcSubresource;
     
@@ -1309,8 +1424,13 @@ namespace dxvk {
   
   
   void STDMETHODCALLTYPE D3D11DeviceContext::DrawAuto() {
+    DXVK_TRACE_ZONE("D3D11DeviceContext::DrawAuto");
+
     D3D10DeviceLock lock = LockContext();
 
+    if (unlikely(m_capture != nullptr))
+      m_capture->RecordCall(D3D11CaptureOp::DrawAuto);
+
     D3D11Buffer* buffer = m_state.ia.vertexBuffers[0].buffer.ptr();
 
     if (buffer == nullptr)
@@ -1333,8 +1453,15 @@ namespace dxvk {
   void STDMETHODCALLTYPE D3D11DeviceContext::Draw(
           UINT            VertexCount,
           UINT            StartVertexLocation) {
+    DXVK_TRACE_ZONE("D3D11DeviceContext::Draw");
+
     D3D10DeviceLock lock = LockContext();
 
+    if (unlikely(m_capture != nullptr)) {
+      m_capture->RecordCall(D3D11CaptureOp::Draw,
+        VertexCount, StartVertexLocation);
+    }
+
     EmitCs([=] (DxvkContext* ctx) {
       ctx->draw(
         VertexCount, 1,
@@ -1347,7 +1474,14 @@ namespace dxvk {
           UINT            IndexCount,
           UINT            StartIndexLocation,
           INT             BaseVertexLocation) {
+    DXVK_TRACE_ZONE("D3D11DeviceContext::DrawIndexed");
+
     D3D10DeviceLock lock = LockContext();
+
+    if (unlikely(m_capture != nullptr)) {
+      m_capture->RecordCall(D3D11CaptureOp::DrawIndexed,
+        IndexCount, StartIndexLocation, BaseVertexLocation);
+    }
     
     EmitCs([=] (DxvkContext* ctx) {
       ctx->drawIndexed(
@@ -1363,7 +1497,15 @@ namespace dxvk {
           UINT            InstanceCount,
           UINT            StartVertexLocation,
           UINT            StartInstanceLocation) {
+    DXVK_TRACE_ZONE("D3D11DeviceContext::DrawInstanced");
+
     D3D10DeviceLock lock = LockContext();
+
+    if (unlikely(m_capture != nullptr)) {
+      m_capture->RecordCall(D3D11CaptureOp::DrawInstanced,
+        VertexCountPerInstance, InstanceCount,
+        StartVertexLocation, StartInstanceLocation);
+    }
     
     EmitCs([=] (DxvkContext* ctx) {
       ctx->draw(
@@ -1381,7 +1523,15 @@ namespace dxvk {
           UINT            StartIndexLocation,
           INT             BaseVertexLocation,
           UINT            StartInstanceLocation) {
+    DXVK_TRACE_ZONE("D3D11DeviceContext::DrawIndexedInstanced");
+
     D3D10DeviceLock lock = LockContext();
+
+    if (unlikely(m_capture != nullptr)) {
+      m_capture->RecordCall(D3D11CaptureOp::DrawIndexedInstanced,
+        IndexCountPerInstance, InstanceCount, StartIndexLocation,
+        BaseVertexLocation, StartInstanceLocation);
+    }
     
     EmitCs([=] (DxvkContext* ctx) {
       ctx->drawIndexed(
@@ -1397,7 +1547,14 @@ namespace dxvk {
   void STDMETHODCALLTYPE D3D11DeviceContext::DrawIndexedInstancedIndirect(
           ID3D11Buffer*   pBufferForArgs,
           UINT            AlignedByteOffsetForArgs) {
+    DXVK_TRACE_ZONE("D3D11DeviceContext::DrawIndexedInstancedIndirect");
+
     D3D10DeviceLock lock = LockContext();
+
+    if (unlikely(m_capture != nullptr)) {
+      m_capture->RecordCall(D3D11CaptureOp::DrawIndexedInstancedIndirect,
+        pBufferForArgs, AlignedByteOffsetForArgs);
+    }
     
     SetDrawBuffer(pBufferForArgs);
     
@@ -1429,7 +1586,14 @@ namespace dxvk {
   void STDMETHODCALLTYPE D3D11DeviceContext::DrawInstancedIndirect(
           ID3D11Buffer*   pBufferForArgs,
           UINT            AlignedByteOffsetForArgs) {
+    DXVK_TRACE_ZONE("D3D11DeviceContext::DrawInstancedIndirect");
+
     D3D10DeviceLock lock = LockContext();
+
+    if (unlikely(m_capture != nullptr)) {
+      m_capture->RecordCall(D3D11CaptureOp::DrawInstancedIndirect,
+        pBufferForArgs, AlignedByteOffsetForArgs);
+    }
     
     SetDrawBuffer(pBufferForArgs);
 
@@ -1462,7 +1626,14 @@ namespace dxvk {
           UINT            ThreadGroupCountX,
           UINT            ThreadGroupCountY,
           UINT            ThreadGroupCountZ) {
+    DXVK_TRACE_ZONE("D3D11DeviceContext::Dispatch");
+
     D3D10DeviceLock lock = LockContext();
+
+    if (unlikely(m_capture != nullptr)) {
+      m_capture->RecordCall(D3D11CaptureOp::Dispatch,
+        ThreadGroupCountX, ThreadGroupCountY, ThreadGroupCountZ);
+    }
     
     EmitCs([=] (DxvkContext* ctx) {
       ctx->dispatch(
@@ -1476,7 +1647,14 @@ namespace dxvk {
   void STDMETHODCALLTYPE D3D11DeviceContext::DispatchIndirect(
           ID3D11Buffer*   pBufferForArgs,
           UINT            AlignedByteOffsetForArgs) {
+    DXVK_TRACE_ZONE("D3D11DeviceContext::DispatchIndirect");
+
     D3D10DeviceLock lock = LockContext();
+
+    if (unlikely(m_capture != nullptr)) {
+      m_capture->RecordCall(D3D11CaptureOp::DispatchIndirect,
+        pBufferForArgs, AlignedByteOffsetForArgs);
+    }
     
     SetDrawBuffer(pBufferForArgs);
     
@@ -1489,6 +1667,9 @@ namespace dxvk {
   
   void STDMETHODCALLTYPE D3D11DeviceContext::IASetInputLayout(ID3D11InputLayout* pInputLayout) {
     D3D10DeviceLock lock = LockContext();
+
+    if (unlikely(m_capture != nullptr))
+      m_capture->RecordCall(D3D11CaptureOp::IASetInputLayout, pInputLayout);
     
     auto inputLayout = static_cast<D3D11InputLayout*>(pInputLayout);
     
@@ -1511,6 +1692,9 @@ namespace dxvk {
   
   void STDMETHODCALLTYPE D3D11DeviceContext::IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY Topology) {
     D3D10DeviceLock lock = LockContext();
+
+    if (unlikely(m_capture != nullptr))
+      m_capture->RecordCall(D3D11CaptureOp::IASetPrimitiveTopology, Topology);
     
     if (m_state.ia.primitiveTopology != Topology) {
       m_state.ia.primitiveTopology = Topology;
@@ -1526,6 +1710,13 @@ namespace dxvk {
     const UINT*                             pStrides,
     const UINT*                             pOffsets) {
     D3D10DeviceLock lock = LockContext();
+
+    if (unlikely(m_capture != nullptr)) {
+      m_capture->RecordCall(D3D11CaptureOp::IASetVertexBuffers, StartSlot, NumBuffers,
+        D3D11CaptureArray<ID3D11Buffer*>(ppVertexBuffers, NumBuffers),
+        D3D11CaptureArray<UINT>(pStrides, NumBuffers),
+        D3D11CaptureArray<UINT>(pOffsets, NumBuffers));
+    }
     
     for (uint32_t i = 0; i < NumBuffers; i++) {
       auto newBuffer = static_cast<D3D11Buffer*>(ppVertexBuffers[i]);
@@ -1544,6 +1735,11 @@ namespace dxvk {
           DXGI_FORMAT                       Format,
           UINT                              Offset) {
     D3D10DeviceLock lock = LockContext();
+
+    if (unlikely(m_capture != nullptr)) {
+      m_capture->RecordCall(D3D11CaptureOp::IASetIndexBuffer,
+        pIndexBuffer, Format, Offset);
+    }
     
     auto newBuffer = static_cast<D3D11Buffer*>(pIndexBuffer);
     
@@ -1612,6 +1808,11 @@ namespace dxvk {
           ID3D11ClassInstance* const*       ppClassInstances,
           UINT                              NumClassInstances) {
     D3D10DeviceLock lock = LockContext();
+
+    if (unlikely(m_capture != nullptr)) {
+      m_capture->RecordCall(D3D11CaptureOp::SetShader,
+        uint32_t(DxbcProgramType::VertexShader), pVertexShader);
+    }
     
     auto shader = static_cast<D3D11VertexShader*>(pVertexShader);
     
@@ -1761,6 +1962,11 @@ namespace dxvk {
           ID3D11ClassInstance* const*       ppClassInstances,
           UINT                              NumClassInstances) {
     D3D10DeviceLock lock = LockContext();
+
+    if (unlikely(m_capture != nullptr)) {
+      m_capture->RecordCall(D3D11CaptureOp::SetShader,
+        uint32_t(DxbcProgramType::HullShader), pHullShader);
+    }
     
     auto shader = static_cast<D3D11HullShader*>(pHullShader);
     
@@ -1910,6 +2116,11 @@ namespace dxvk {
           ID3D11ClassInstance* const*       ppClassInstances,
           UINT                              NumClassInstances) {
     D3D10DeviceLock lock = LockContext();
+
+    if (unlikely(m_capture != nullptr)) {
+      m_capture->RecordCall(D3D11CaptureOp::SetShader,
+        uint32_t(DxbcProgramType::DomainShader), pDomainShader);
+    }
     
     auto shader = static_cast<D3D11DomainShader*>(pDomainShader);
     
@@ -2059,6 +2270,11 @@ namespace dxvk {
           ID3D11ClassInstance* const*       ppClassInstances,
           UINT                              NumClassInstances) {
     D3D10DeviceLock lock = LockContext();
+
+    if (unlikely(m_capture != nullptr)) {
+      m_capture->RecordCall(D3D11CaptureOp::SetShader,
+        uint32_t(DxbcProgramType::GeometryShader), pShader);
+    }
     
     auto shader = static_cast<D3D11GeometryShader*>(pShader);
     
@@ -2208,6 +2424,11 @@ namespace dxvk {
           ID3D11ClassInstance* const*       ppClassInstances,
           UINT                              NumClassInstances) {
     D3D10DeviceLock lock = LockContext();
+
+    if (unlikely(m_capture != nullptr)) {
+      m_capture->RecordCall(D3D11CaptureOp::SetShader,
+        uint32_t(DxbcProgramType::PixelShader), pPixelShader);
+    }
     
     auto shader = static_cast<D3D11PixelShader*>(pPixelShader);
     
@@ -2357,6 +2578,11 @@ namespace dxvk {
           ID3D11ClassInstance* const*       ppClassInstances,
           UINT                              NumClassInstances) {
     D3D10DeviceLock lock = LockContext();
+
+    if (unlikely(m_capture != nullptr)) {
+      m_capture->RecordCall(D3D11CaptureOp::SetShader,
+        uint32_t(DxbcProgramType::ComputeShader), pComputeShader);
+    }
     
     auto shader = static_cast<D3D11ComputeShader*>(pComputeShader);
     
@@ -2440,6 +2666,12 @@ namespace dxvk {
           ID3D11UnorderedAccessView* const* ppUnorderedAccessViews,
     const UINT*                             pUAVInitialCounts) {
     D3D10DeviceLock lock = LockContext();
+
+    if (unlikely(m_capture != nullptr)) {
+      m_capture->RecordCall(D3D11CaptureOp::CSSetUnorderedAccessViews, StartSlot, NumUAVs,
+        D3D11CaptureArray<ID3D11UnorderedAccessView*>(ppUnorderedAccessViews, NumUAVs),
+        D3D11CaptureArray<UINT>(pUAVInitialCounts, NumUAVs));
+    }
     
     SetUnorderedAccessViews(
       DxbcProgramType::ComputeShader,
@@ -2533,6 +2765,12 @@ namespace dxvk {
           ID3D11RenderTargetView* const*    ppRenderTargetViews,
           ID3D11DepthStencilView*           pDepthStencilView) {
     D3D10DeviceLock lock = LockContext();
+
+    if (unlikely(m_capture != nullptr)) {
+      m_capture->RecordCall(D3D11CaptureOp::OMSetRenderTargets, NumViews,
+        D3D11CaptureArray<ID3D11RenderTargetView*>(ppRenderTargetViews, NumViews),
+        pDepthStencilView);
+    }
     
     SetRenderTargets(NumViews, ppRenderTargetViews, pDepthStencilView);
     BindFramebuffer(false);
@@ -2548,6 +2786,17 @@ namespace dxvk {
           ID3D11UnorderedAccessView* const* ppUnorderedAccessViews,
     const UINT*                             pUAVInitialCounts) {
     D3D10DeviceLock lock = LockContext();
+
+    if (unlikely(m_capture != nullptr)) {
+      UINT rtvCount = NumRTVs != D3D11_KEEP_RENDER_TARGETS_AND_DEPTH_STENCIL ? NumRTVs : 0;
+      UINT uavCount = NumUAVs != D3D11_KEEP_UNORDERED_ACCESS_VIEWS           ? NumUAVs : 0;
+
+      m_capture->RecordCall(D3D11CaptureOp::OMSetRenderTargetsAndUnorderedAccessViews, NumRTVs,
+        D3D11CaptureArray<ID3D11RenderTargetView*>(ppRenderTargetViews, rtvCount),
+        pDepthStencilView, UAVStartSlot, NumUAVs,
+        D3D11CaptureArray<ID3D11UnorderedAccessView*>(ppUnorderedAccessViews, uavCount),
+        D3D11CaptureArray<UINT>(pUAVInitialCounts, uavCount));
+    }
     
     bool isUavRendering = false;
     
@@ -2579,6 +2828,11 @@ namespace dxvk {
     const FLOAT                             BlendFactor[4],
           UINT                              SampleMask) {
     D3D10DeviceLock lock = LockContext();
+
+    if (unlikely(m_capture != nullptr)) {
+      m_capture->RecordCall(D3D11CaptureOp::OMSetBlendState, pBlendState,
+        D3D11CaptureArray<FLOAT>(BlendFactor, 4), SampleMask);
+    }
     
     auto blendState = static_cast<D3D11BlendState*>(pBlendState);
     
@@ -2603,6 +2857,11 @@ namespace dxvk {
           ID3D11DepthStencilState*          pDepthStencilState,
           UINT                              StencilRef) {
     D3D10DeviceLock lock = LockContext();
+
+    if (unlikely(m_capture != nullptr)) {
+      m_capture->RecordCall(D3D11CaptureOp::OMSetDepthStencilState,
+        pDepthStencilState, StencilRef);
+    }
     
     auto depthStencilState = static_cast<D3D11DepthStencilState*>(pDepthStencilState);
     
@@ -2684,6 +2943,9 @@ namespace dxvk {
   
   void STDMETHODCALLTYPE D3D11DeviceContext::RSSetState(ID3D11RasterizerState* pRasterizerState) {
     D3D10DeviceLock lock = LockContext();
+
+    if (unlikely(m_capture != nullptr))
+      m_capture->RecordCall(D3D11CaptureOp::RSSetState, pRasterizerState);
     
     auto rasterizerState = static_cast<D3D11RasterizerState*>(pRasterizerState);
     
@@ -2713,6 +2975,11 @@ namespace dxvk {
           UINT                              NumViewports,
     const D3D11_VIEWPORT*                   pViewports) {
     D3D10DeviceLock lock = LockContext();
+
+    if (unlikely(m_capture != nullptr)) {
+      m_capture->RecordCall(D3D11CaptureOp::RSSetViewports, NumViewports,
+        D3D11CaptureArray<D3D11_VIEWPORT>(pViewports, NumViewports));
+    }
     
     bool dirty = m_state.rs.numViewports != NumViewports;
     m_state.rs.numViewports = NumViewports;
@@ -2739,6 +3006,11 @@ namespace dxvk {
           UINT                              NumRects,
     const D3D11_RECT*                       pRects) {
     D3D10DeviceLock lock = LockContext();
+
+    if (unlikely(m_capture != nullptr)) {
+      m_capture->RecordCall(D3D11CaptureOp::RSSetScissorRects, NumRects,
+        D3D11CaptureArray<D3D11_RECT>(pRects, NumRects));
+    }
     
     bool dirty = m_state.rs.numScissors != NumRects;
     m_state.rs.numScissors = NumRects;
@@ -2826,6 +3098,12 @@ namespace dxvk {
           ID3D11Buffer* const*              ppSOTargets,
     const UINT*                             pOffsets) {
     D3D10DeviceLock lock = LockContext();
+
+    if (unlikely(m_capture != nullptr)) {
+      m_capture->RecordCall(D3D11CaptureOp::SOSetTargets, NumBuffers,
+        D3D11CaptureArray<ID3D11Buffer*>(ppSOTargets, NumBuffers),
+        D3D11CaptureArray<UINT>(pOffsets, NumBuffers));
+    }
     
     for (uint32_t i = 0; i < NumBuffers; i++) {
       D3D11Buffer* buffer = static_cast<D3D11Buffer*>(ppSOTargets[i]);
@@ -3326,6 +3604,59 @@ namespace dxvk {
   }
 
 
+  void D3D11DeviceContext::DiscardImageView(
+          ID3D11View*                       pResourceView,
+    const D3D11_RECT*                       pRects,
+          UINT                              NumRects) {
+    // ID3D11View has no methods to query the exact type of
+    // the view, so we'll have to check each possible class
+    auto dsv = dynamic_cast<D3D11DepthStencilView*>(pResourceView);
+    auto rtv = dynamic_cast<D3D11RenderTargetView*>(pResourceView);
+    auto uav = dynamic_cast<D3D11UnorderedAccessView*>(pResourceView);
+
+    Rc<DxvkImageView> view;
+    if (dsv) view = dsv->GetImageView();
+    if (rtv) view = rtv->GetImageView();
+    if (uav) view = uav->GetImageView();
+
+    if (view == nullptr)
+      return;
+    
+    // Discarding is only a hint, so we can ignore the call
+    // unless at least one rectangle covers the entire view
+    if (NumRects != 0 && pRects != nullptr) {
+      VkExtent3D extent = view->mipLevelExtent(0);
+      bool fullSize = false;
+
+      for (uint32_t i = 0; i < NumRects && !fullSize; i++) {
+        fullSize = pRects[i].left <= 0 && pRects[i].right  >= LONG(extent.width)
+                && pRects[i].top  <= 0 && pRects[i].bottom >= LONG(extent.height);
+      }
+
+      if (!fullSize)
+        return;
+    }
+
+    // Render targets can be discarded through render pass
+    // load ops, other views need a layout transition
+    bool isAttachment = dsv != nullptr || rtv != nullptr;
+
+    EmitCs([
+      cView         = std::move(view),
+      cIsAttachment = isAttachment
+    ] (DxvkContext* ctx) {
+      if (cIsAttachment) {
+        ctx->discardImageView(cView,
+          cView->info().aspect);
+      } else {
+        ctx->discardImage(
+          cView->image(),
+          cView->subresources());
+      }
+    });
+  }
+
+
   void D3D11DeviceContext::SetDrawBuffer(
           ID3D11Buffer*                     pBuffer) {
     auto buffer = static_cast<D3D11Buffer*>(pBuffer);
@@ -3345,6 +3676,14 @@ namespace dxvk {
           ID3D11Buffer* const*              ppConstantBuffers,
     const UINT*                             pFirstConstant,
     const UINT*                             pNumConstants) {
+    if (unlikely(m_capture != nullptr)) {
+      m_capture->RecordCall(D3D11CaptureOp::SetConstantBuffers,
+        uint32_t(ShaderStage), StartSlot, NumBuffers,
+        D3D11CaptureArray<ID3D11Buffer*>(ppConstantBuffers, NumBuffers),
+        D3D11CaptureArray<UINT>(pFirstConstant, NumBuffers),
+        D3D11CaptureArray<UINT>(pNumConstants, NumBuffers));
+    }
+    
     const uint32_t slotId = computeResourceSlotId(
       ShaderStage, DxbcBindingType::ConstantBuffer,
       StartSlot);
@@ -3381,6 +3720,12 @@ namespace dxvk {
           UINT                              StartSlot,
           UINT                              NumSamplers,
           ID3D11SamplerState* const*        ppSamplers) {
+    if (unlikely(m_capture != nullptr)) {
+      m_capture->RecordCall(D3D11CaptureOp::SetSamplers,
+        uint32_t(ShaderStage), StartSlot, NumSamplers,
+        D3D11CaptureArray<ID3D11SamplerState*>(ppSamplers, NumSamplers));
+    }
+    
     const uint32_t slotId = computeResourceSlotId(
       ShaderStage, DxbcBindingType::ImageSampler,
       StartSlot);
@@ -3402,6 +3747,12 @@ namespace dxvk {
           UINT                              StartSlot,
           UINT                              NumResources,
           ID3D11ShaderResourceView* const*  ppResources) {
+    if (unlikely(m_capture != nullptr)) {
+      m_capture->RecordCall(D3D11CaptureOp::SetShaderResources,
+        uint32_t(ShaderStage), StartSlot, NumResources,
+        D3D11CaptureArray<ID3D11ShaderResourceView*>(ppResources, NumResources));
+    }
+    
     const uint32_t slotId = computeResourceSlotId(
       ShaderStage, DxbcBindingType::ShaderResource,
       StartSlot);
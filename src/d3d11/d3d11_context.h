@@ -7,6 +7,7 @@
 #include "../d3d10/d3d10_multithread.h"
 
 #include "d3d11_annotation.h"
+#include "d3d11_capture.h"
 #include "d3d11_cmd.h"
 #include "d3d11_context_state.h"
 #include "d3d11_device_child.h"
@@ -17,7 +18,7 @@ namespace dxvk {
   class D3D11Device;
   
   class D3D11DeviceContext : public D3D11DeviceChild<ID3D11DeviceContext1> {
-    
+    friend class D3D11UserDefinedAnnotation;
   public:
     
     D3D11DeviceContext(
@@ -664,6 +665,8 @@ namespace dxvk {
     
     D3D11ContextState           m_state;
     D3D11CmdData*               m_cmdData;
+
+    D3D11ApiCapture*            m_capture = nullptr;
     
     void ApplyInputLayout();
     
@@ -728,6 +731,11 @@ namespace dxvk {
     void DiscardBuffer(
             D3D11Buffer*                      pBuffer);
     
+    void DiscardImageView(
+            ID3D11View*                       pResourceView,
+      const D3D11_RECT*                       pRects,
+            UINT                              NumRects);
+    
     void DiscardTexture(
             D3D11CommonTexture*               pTexture);
     
@@ -3,7 +3,8 @@
 #include "d3d11_device.h"
 #include "d3d11_texture.h"
 
-constexpr static uint32_t MinFlushIntervalUs = 1250;
+constexpr static uint32_t MinFlushIntervalUs = 250;
+constexpr static uint32_t MaxFlushCommands   = 8192;
 constexpr static uint32_t MaxPendingSubmits  = 3;
 
 namespace dxvk {
@@ -23,6 +24,8 @@ namespace dxvk {
         ctx->setBarrierControl(DxvkBarrierControl::IgnoreWriteAfterWrite);
     });
     
+    m_capture = pParent->GetApiCapture();
+
     ClearState();
   }
   
@@ -106,10 +109,15 @@ namespace dxvk {
   
   
   void STDMETHODCALLTYPE D3D11ImmediateContext::Flush() {
+    DXVK_TRACE_ZONE("D3D11ImmediateContext::Flush");
+
     m_parent->FlushInitContext();
     
     D3D10DeviceLock lock = LockContext();
     
+    if (unlikely(m_capture != nullptr))
+      m_capture->RecordCall(D3D11CaptureOp::Flush);
+
     if (m_csIsBusy || m_csChunk->commandCount() != 0) {
       // Add commands to flush the threaded
       // context, then flush the command list
@@ -122,6 +130,10 @@ namespace dxvk {
       // Reset flush timer used for implicit flushes
       m_lastFlush = std::chrono::high_resolution_clock::now();
       m_csIsBusy  = false;
+      m_csCommandCount = 0;
+      
+      m_device->mergeStatCounters(m_flushCounters);
+      m_flushCounters.reset();
     }
   }
   
@@ -131,6 +143,15 @@ namespace dxvk {
           BOOL                RestoreContextState) {
     D3D10DeviceLock lock = LockContext();
 
+    if (unlikely(m_capture != nullptr)) {
+      static bool s_errorShown = false;
+
+      if (!std::exchange(s_errorShown, true))
+        Logger::warn("D3D11: Capture: Deferred context commands are not captured");
+
+      m_capture->RecordCall(D3D11CaptureOp::ExecuteCommandList, RestoreContextState);
+    }
+
     auto commandList = static_cast<D3D11CommandList*>(pCommandList);
     
     // Flush any outstanding commands so that
@@ -172,6 +193,8 @@ namespace dxvk {
           D3D11_MAP                   MapType,
           UINT                        MapFlags,
           D3D11_MAPPED_SUBRESOURCE*   pMappedResource) {
+    DXVK_TRACE_ZONE("D3D11ImmediateContext::Map");
+
     D3D10DeviceLock lock = LockContext();
 
     if (!pResource || !pMappedResource)
@@ -197,6 +220,9 @@ namespace dxvk {
       pMappedResource->pData      = nullptr;
       pMappedResource->RowPitch   = 0;
       pMappedResource->DepthPitch = 0;
+    } else if (unlikely(m_capture != nullptr)) {
+      m_capture->RecordMap(pResource, Subresource,
+        MapType, MapFlags, pMappedResource);
     }
 
     return hr;
@@ -206,8 +232,15 @@ namespace dxvk {
   void STDMETHODCALLTYPE D3D11ImmediateContext::Unmap(
           ID3D11Resource*             pResource,
           UINT                        Subresource) {
+    DXVK_TRACE_ZONE("D3D11ImmediateContext::Unmap");
+
     D3D10DeviceLock lock = LockContext();
 
+    // Mapped image memory may get released when
+    // unmapping, so we need to record it first
+    if (unlikely(m_capture != nullptr))
+      m_capture->RecordUnmap(pResource, Subresource);
+
     D3D11_RESOURCE_DIMENSION resourceDim = D3D11_RESOURCE_DIMENSION_UNKNOWN;
     pResource->GetType(&resourceDim);
     
@@ -565,6 +598,15 @@ namespace dxvk {
   }
   
   
+  void D3D11ImmediateContext::DefragmentMemory() {
+    D3D10DeviceLock lock = LockContext();
+    
+    EmitCs([] (DxvkContext* ctx) {
+      ctx->defragmentMemory();
+    });
+  }
+  
+  
   void D3D11ImmediateContext::SynchronizeDevice() {
     m_device->waitForIdle();
   }
@@ -596,8 +638,11 @@ namespace dxvk {
         Flush();
         SynchronizeCsThread();
         
-        while (Resource->isInUse())
-          dxvk::this_thread::yield();
+        // Block until the last submission that uses the resource
+        // has completed. The queue releases all resources of a
+        // command list before it reports the list as completed,
+        // so the resource is no longer in use after this.
+        m_device->waitForSubmission(Resource->lastSubmissionId());
       }
     }
     
@@ -606,20 +651,43 @@ namespace dxvk {
   
   
   void D3D11ImmediateContext::EmitCsChunk(DxvkCsChunkRef&& chunk) {
+    m_csCommandCount += chunk->commandCount();
     m_csThread.dispatchChunk(std::move(chunk));
     m_csIsBusy = true;
   }
 
 
   void D3D11ImmediateContext::FlushImplicit(BOOL StrongHint) {
-    // Flush only if the GPU is about to go idle, in
-    // order to keep the number of submissions low.
-    if (StrongHint || m_device->pendingSubmissions() <= MaxPendingSubmits) {
-      auto now = std::chrono::high_resolution_clock::now();
+    // Never queue up more work than the GPU can process
+    // in a reasonable amount of time, unless requested
+    if (!StrongHint && m_device->pendingSubmissions() > MaxPendingSubmits) {
+      m_flushCounters.addCtr(DxvkStatCounter::QueueFlushDeferCount, 1);
+      return;
+    }
 
-      // Prevent flushing too often in short intervals.
-      if (now - m_lastFlush >= std::chrono::microseconds(MinFlushIntervalUs))
-        Flush();
+    auto now = std::chrono::high_resolution_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(now - m_lastFlush);
+
+    // Prevent flushing too often in short intervals.
+    if (uint64_t(elapsed.count()) < MinFlushIntervalUs)
+      return;
+
+    // Predict when the GPU is going to run out of work based on
+    // how long previous submissions took to complete, and flush
+    // slightly ahead of time so that the GPU does not go idle.
+    // Flush early if a large amount of work has been recorded.
+    uint64_t latency = m_device->submissionLatencyUs();
+    bool gpuIdle = m_device->pendingSubmissions() == 0
+      || 4 * uint64_t(elapsed.count()) >= 3 * latency;
+    
+    if (StrongHint || gpuIdle) {
+      m_flushCounters.addCtr(DxvkStatCounter::QueueFlushIdleCount, 1);
+      Flush();
+    } else if (m_csCommandCount + m_csChunk->commandCount() >= MaxFlushCommands) {
+      m_flushCounters.addCtr(DxvkStatCounter::QueueFlushWorkCount, 1);
+      Flush();
+    } else {
+      m_flushCounters.addCtr(DxvkStatCounter::QueueFlushDeferCount, 1);
     }
   }
   
@@ -123,14 +123,19 @@ namespace dxvk {
     
     void SynchronizeCsThread();
     
+    void DefragmentMemory();
+    
   private:
     
     DxvkCsThread m_csThread;
     bool         m_csIsBusy = false;
+    size_t       m_csCommandCount = 0;
 
     std::chrono::high_resolution_clock::time_point m_lastFlush
       = std::chrono::high_resolution_clock::now();
     
+    DxvkStatCounters m_flushCounters;
+    
     HRESULT MapBuffer(
             D3D11Buffer*                pResource,
             D3D11_MAP                   MapType,
@@ -39,6 +39,11 @@ namespace dxvk {
     m_d3d11Formats  (m_dxvkAdapter),
     m_d3d11Options  (m_dxvkAdapter->instance()->config()),
     m_dxbcOptions   (m_dxvkDevice, m_d3d11Options) {
+    std::string captureDir = D3D11ApiCapture::GetCaptureDirectory();
+
+    if (!captureDir.empty())
+      m_capture = new D3D11ApiCapture(captureDir);
+
     m_initializer = new D3D11Initializer(m_dxvkDevice);
     m_context     = new D3D11ImmediateContext(this, m_dxvkDevice);
     m_d3d10Device = new D3D10Device(this, m_context);
@@ -52,6 +57,7 @@ namespace dxvk {
     delete m_d3d10Device;
     delete m_context;
     delete m_initializer;
+    delete m_capture;
   }
   
   
@@ -88,6 +94,12 @@ namespace dxvk {
       
       m_initializer->InitBuffer(buffer.ptr(), pInitialData);
       *ppBuffer = buffer.ref();
+
+      if (unlikely(m_capture != nullptr)) {
+        m_capture->RecordCreate(D3D11CaptureOp::CreateBuffer, *ppBuffer, *pDesc,
+          D3D11CaptureBlob { pInitialData ? pInitialData->pSysMem : nullptr, pDesc->ByteWidth });
+      }
+
       return S_OK;
     } catch (const DxvkError& e) {
       Logger::err(e.message());
@@ -128,6 +140,12 @@ namespace dxvk {
       const Com<D3D11Texture1D> texture = new D3D11Texture1D(this, &desc);
       m_initializer->InitTexture(texture->GetCommonTexture(), pInitialData);
       *ppTexture1D = texture.ref();
+
+      if (unlikely(m_capture != nullptr)) {
+        m_capture->RecordCreate(D3D11CaptureOp::CreateTexture1D, *ppTexture1D, *pDesc,
+          D3D11CaptureInitialData { texture->GetCommonTexture(), pInitialData });
+      }
+
       return S_OK;
     } catch (const DxvkError& e) {
       Logger::err(e.message());
@@ -168,6 +186,12 @@ namespace dxvk {
       const Com<D3D11Texture2D> texture = new D3D11Texture2D(this, &desc);
       m_initializer->InitTexture(texture->GetCommonTexture(), pInitialData);
       *ppTexture2D = texture.ref();
+
+      if (unlikely(m_capture != nullptr)) {
+        m_capture->RecordCreate(D3D11CaptureOp::CreateTexture2D, *ppTexture2D, *pDesc,
+          D3D11CaptureInitialData { texture->GetCommonTexture(), pInitialData });
+      }
+
       return S_OK;
     } catch (const DxvkError& e) {
       Logger::err(e.message());
@@ -208,6 +232,12 @@ namespace dxvk {
       const Com<D3D11Texture3D> texture = new D3D11Texture3D(this, &desc);
       m_initializer->InitTexture(texture->GetCommonTexture(), pInitialData);
       *ppTexture3D = texture.ref();
+
+      if (unlikely(m_capture != nullptr)) {
+        m_capture->RecordCreate(D3D11CaptureOp::CreateTexture3D, *ppTexture3D, *pDesc,
+          D3D11CaptureInitialData { texture->GetCommonTexture(), pInitialData });
+      }
+
       return S_OK;
     } catch (const DxvkError& e) {
       Logger::err(e.message());
@@ -256,6 +286,10 @@ namespace dxvk {
     
     try {
       *ppSRView = ref(new D3D11ShaderResourceView(this, pResource, &desc));
+
+      if (unlikely(m_capture != nullptr))
+        m_capture->RecordCreate(D3D11CaptureOp::CreateShaderResourceView, *ppSRView, pResource, desc);
+
       return S_OK;
     } catch (const DxvkError& e) {
       Logger::err(e.message());
@@ -304,6 +338,10 @@ namespace dxvk {
     
     try {
       *ppUAView = ref(new D3D11UnorderedAccessView(this, pResource, &desc));
+
+      if (unlikely(m_capture != nullptr))
+        m_capture->RecordCreate(D3D11CaptureOp::CreateUnorderedAccessView, *ppUAView, pResource, desc);
+
       return S_OK;
     } catch (const DxvkError& e) {
       Logger::err(e.message());
@@ -358,6 +396,10 @@ namespace dxvk {
     
     try {
       *ppRTView = ref(new D3D11RenderTargetView(this, pResource, &desc));
+
+      if (unlikely(m_capture != nullptr))
+        m_capture->RecordCreate(D3D11CaptureOp::CreateRenderTargetView, *ppRTView, pResource, desc);
+
       return S_OK;
     } catch (const DxvkError& e) {
       Logger::err(e.message());
@@ -406,6 +448,10 @@ namespace dxvk {
     
     try {
       *ppDepthStencilView = ref(new D3D11DepthStencilView(this, pResource, &desc));
+
+      if (unlikely(m_capture != nullptr))
+        m_capture->RecordCreate(D3D11CaptureOp::CreateDepthStencilView, *ppDepthStencilView, pResource, desc);
+
       return S_OK;
     } catch (const DxvkError& e) {
       Logger::err(e.message());
@@ -543,6 +589,12 @@ namespace dxvk {
           new D3D11InputLayout(this,
             attrCount, attrList.data(),
             bindCount, bindList.data()));
+
+        if (unlikely(m_capture != nullptr)) {
+          m_capture->RecordCreate(D3D11CaptureOp::CreateInputLayout, *ppInputLayout,
+            D3D11CaptureArray<D3D11_INPUT_ELEMENT_DESC>(pInputElementDescs, NumElements),
+            D3D11CaptureBlob { pShaderBytecodeWithInputSignature, BytecodeLength });
+        }
       }
       
       return S_OK;
@@ -579,6 +631,12 @@ namespace dxvk {
       return S_FALSE;
     
     *ppVertexShader = ref(new D3D11VertexShader(this, module));
+
+    if (unlikely(m_capture != nullptr)) {
+      m_capture->RecordCreate(D3D11CaptureOp::CreateVertexShader, *ppVertexShader,
+        D3D11CaptureBlob { pShaderBytecode, BytecodeLength });
+    }
+
     return S_OK;
   }
   
@@ -609,6 +667,12 @@ namespace dxvk {
       return S_FALSE;
     
     *ppGeometryShader = ref(new D3D11GeometryShader(this, module));
+
+    if (unlikely(m_capture != nullptr)) {
+      m_capture->RecordCreate(D3D11CaptureOp::CreateGeometryShader, *ppGeometryShader,
+        D3D11CaptureBlob { pShaderBytecode, BytecodeLength });
+    }
+
     return S_OK;
   }
   
@@ -698,6 +762,15 @@ namespace dxvk {
       return S_FALSE;
     
     *ppGeometryShader = ref(new D3D11GeometryShader(this, module));
+
+    if (unlikely(m_capture != nullptr)) {
+      m_capture->RecordCreate(D3D11CaptureOp::CreateGeometryShaderWithStreamOutput, *ppGeometryShader,
+        D3D11CaptureBlob { pShaderBytecode, BytecodeLength },
+        D3D11CaptureArray<D3D11_SO_DECLARATION_ENTRY>(pSODeclaration, NumEntries),
+        D3D11CaptureArray<UINT>(pBufferStrides, NumStrides),
+        RasterizedStream);
+    }
+
     return S_OK;
   }
   
@@ -728,6 +801,12 @@ namespace dxvk {
       return S_FALSE;
     
     *ppPixelShader = ref(new D3D11PixelShader(this, module));
+
+    if (unlikely(m_capture != nullptr)) {
+      m_capture->RecordCreate(D3D11CaptureOp::CreatePixelShader, *ppPixelShader,
+        D3D11CaptureBlob { pShaderBytecode, BytecodeLength });
+    }
+
     return S_OK;
   }
   
@@ -763,6 +842,12 @@ namespace dxvk {
       return S_FALSE;
     
     *ppHullShader = ref(new D3D11HullShader(this, module));
+
+    if (unlikely(m_capture != nullptr)) {
+      m_capture->RecordCreate(D3D11CaptureOp::CreateHullShader, *ppHullShader,
+        D3D11CaptureBlob { pShaderBytecode, BytecodeLength });
+    }
+
     return S_OK;
   }
   
@@ -792,6 +877,12 @@ namespace dxvk {
       return S_FALSE;
     
     *ppDomainShader = ref(new D3D11DomainShader(this, module));
+
+    if (unlikely(m_capture != nullptr)) {
+      m_capture->RecordCreate(D3D11CaptureOp::CreateDomainShader, *ppDomainShader,
+        D3D11CaptureBlob { pShaderBytecode, BytecodeLength });
+    }
+
     return S_OK;
   }
   
@@ -822,6 +913,12 @@ namespace dxvk {
       return S_FALSE;
     
     *ppComputeShader = ref(new D3D11ComputeShader(this, module));
+
+    if (unlikely(m_capture != nullptr)) {
+      m_capture->RecordCreate(D3D11CaptureOp::CreateComputeShader, *ppComputeShader,
+        D3D11CaptureBlob { pShaderBytecode, BytecodeLength });
+    }
+
     return S_OK;
   }
   
@@ -846,6 +943,10 @@ namespace dxvk {
     
     if (ppBlendState != nullptr) {
       *ppBlendState = m_bsStateObjects.Create(this, desc);
+
+      if (unlikely(m_capture != nullptr))
+        m_capture->RecordCreate(D3D11CaptureOp::CreateBlendState1, *ppBlendState, desc);
+
       return S_OK;
     } return S_FALSE;
   }
@@ -865,6 +966,10 @@ namespace dxvk {
     
     if (ppBlendState != nullptr) {
       *ppBlendState = m_bsStateObjects.Create(this, desc);
+
+      if (unlikely(m_capture != nullptr))
+        m_capture->RecordCreate(D3D11CaptureOp::CreateBlendState1, *ppBlendState, desc);
+
       return S_OK;
     } return S_FALSE;
   }
@@ -884,6 +989,10 @@ namespace dxvk {
     
     if (ppDepthStencilState != nullptr) {
       *ppDepthStencilState = m_dsStateObjects.Create(this, desc);
+
+      if (unlikely(m_capture != nullptr))
+        m_capture->RecordCreate(D3D11CaptureOp::CreateDepthStencilState, *ppDepthStencilState, desc);
+
       return S_OK;
     } return S_FALSE;
   }
@@ -903,6 +1012,10 @@ namespace dxvk {
     
     if (ppRasterizerState != nullptr) {
       *ppRasterizerState = m_rsStateObjects.Create(this, desc);
+
+      if (unlikely(m_capture != nullptr))
+        m_capture->RecordCreate(D3D11CaptureOp::CreateRasterizerState1, *ppRasterizerState, desc);
+
       return S_OK;
     } return S_FALSE;
   }
@@ -922,6 +1035,10 @@ namespace dxvk {
     
     if (ppRasterizerState != nullptr) {
       *ppRasterizerState = m_rsStateObjects.Create(this, desc);
+
+      if (unlikely(m_capture != nullptr))
+        m_capture->RecordCreate(D3D11CaptureOp::CreateRasterizerState1, *ppRasterizerState, desc);
+
       return S_OK;
     } return S_FALSE;
   }
@@ -945,6 +1062,10 @@ namespace dxvk {
     
     try {
       *ppSamplerState = m_samplerObjects.Create(this, desc);
+
+      if (unlikely(m_capture != nullptr))
+        m_capture->RecordCreate(D3D11CaptureOp::CreateSamplerState, *ppSamplerState, desc);
+
       return S_OK;
     } catch (const DxvkError& e) {
       Logger::err(e.message());
@@ -966,6 +1087,10 @@ namespace dxvk {
     
     try {
       *ppQuery = ref(new D3D11Query(this, *pQueryDesc));
+
+      if (unlikely(m_capture != nullptr))
+        m_capture->RecordCreate(D3D11CaptureOp::CreateQuery, *ppQuery, *pQueryDesc);
+
       return S_OK;
     } catch (const DxvkError& e) {
       Logger::err(e.message());
@@ -987,6 +1112,10 @@ namespace dxvk {
     
     try {
       *ppPredicate = ref(new D3D11Query(this, *pPredicateDesc));
+
+      if (unlikely(m_capture != nullptr))
+        m_capture->RecordCreate(D3D11CaptureOp::CreatePredicate, *ppPredicate, *pPredicateDesc);
+
       return S_OK;
     } catch (const DxvkError& e) {
       Logger::err(e.message());
@@ -1364,6 +1493,8 @@ namespace dxvk {
     enabled.extVertexAttributeDivisor.vertexAttributeInstanceRateDivisor      = supported.extVertexAttributeDivisor.vertexAttributeInstanceRateDivisor;
     enabled.extVertexAttributeDivisor.vertexAttributeInstanceRateZeroDivisor  = supported.extVertexAttributeDivisor.vertexAttributeInstanceRateZeroDivisor;
     
+    enabled.khrShaderFloat16Int8.shaderFloat16                    = supported.khrShaderFloat16Int8.shaderFloat16;
+    
     if (featureLevel >= D3D_FEATURE_LEVEL_9_1) {
       enabled.core.features.depthClamp                            = VK_TRUE;
       enabled.core.features.depthBiasClamp                        = VK_TRUE;
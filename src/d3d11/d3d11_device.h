@@ -14,6 +14,7 @@
 
 #include "../util/com/com_private_data.h"
 
+#include "d3d11_capture.h"
 #include "d3d11_counter_buffer.h"
 #include "d3d11_initializer.h"
 #include "d3d11_interfaces.h"
@@ -319,6 +320,10 @@ namespace dxvk {
     D3D10Device* GetD3D10Interface() const {
       return m_d3d10Device;
     }
+
+    D3D11ApiCapture* GetApiCapture() const {
+      return m_capture;
+    }
     
     DxvkBufferSlice AllocUavCounterSlice() { return m_uavCounters->AllocSlice(); }
     DxvkBufferSlice AllocXfbCounterSlice() { return m_xfbCounters->AllocSlice(); }
@@ -353,6 +358,7 @@ namespace dxvk {
     D3D11Initializer*               m_initializer = nullptr;
     D3D11ImmediateContext*          m_context     = nullptr;
     D3D10Device*                    m_d3d10Device = nullptr;
+    D3D11ApiCapture*                m_capture     = nullptr;
 
     Rc<D3D11CounterBuffer>          m_uavCounters;
     Rc<D3D11CounterBuffer>          m_xfbCounters;
@@ -42,6 +42,22 @@ namespace dxvk {
     /// but might also cause rendering issues.
     bool relaxedBarriers;
 
+    /// Pass small constant buffers as push constants
+    ///
+    /// Avoids descriptor updates for constant buffers
+    /// that fit into the push constant range of the
+    /// shader stage. Copies into constant buffers on
+    /// the GPU will not be visible to shaders.
+    bool pushConstantBuffers;
+
+    /// Use 16-bit floating point arithmetic
+    ///
+    /// Performs arithmetic on operands declared with
+    /// minimum precision on 16-bit floats, if supported
+    /// by the device. May cause rendering issues in games
+    /// that rely on min16float being full precision.
+    bool float16Arithmetic;
+
     /// Maximum tessellation factor.
     ///
     /// Limits tessellation factors in tessellation
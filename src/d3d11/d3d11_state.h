@@ -1,6 +1,7 @@
 #pragma once
 
-#include <unordered_map>
+#include <array>
+#include <atomic>
 
 #include "d3d11_blend.h"
 #include "d3d11_depth_stencil.h"
@@ -38,12 +39,41 @@ namespace dxvk {
    * an object with the same description already exists
    * and returns it if that is the case. This class
    * implements that behaviour.
+   * 
+   * Objects are never removed from the set, so entries
+   * are stored in insert-only bucket lists which can be
+   * traversed without taking a lock. Only insertions
+   * lock, and only the shard that the hash maps to, so
+   * that threads creating different objects do not
+   * contend with each other.
    */
   template<typename T>
   class D3D11StateObjectSet {
     using DescType = typename T::DescType;
+    
+    constexpr static size_t ShardCount  = 16;
+    constexpr static size_t BucketCount = 128;
   public:
     
+    D3D11StateObjectSet() { }
+    
+    ~D3D11StateObjectSet() {
+      for (auto& shard : m_shards) {
+        for (auto& bucket : shard.buckets) {
+          Entry* entry = bucket.load(std::memory_order_relaxed);
+          
+          while (entry != nullptr) {
+            Entry* next = entry->next;
+            delete entry;
+            entry = next;
+          }
+        }
+      }
+    }
+    
+    D3D11StateObjectSet             (const D3D11StateObjectSet&) = delete;
+    D3D11StateObjectSet& operator = (const D3D11StateObjectSet&) = delete;
+    
     /**
      * \brief Retrieves a state object
      * 
@@ -54,23 +84,62 @@ namespace dxvk {
      * \returns Pointer to the state object
      */
     T* Create(D3D11Device* device, const DescType& desc) {
-      std::lock_guard<std::mutex> lock(m_mutex);
+      const size_t hash = D3D11StateDescHash()(desc);
+      
+      Shard& shard = m_shards[hash % ShardCount];
+      std::atomic<Entry*>& bucket = shard.buckets[(hash / ShardCount) % BucketCount];
+      
+      Entry* head = bucket.load(std::memory_order_acquire);
+      Entry* entry = Find(head, nullptr, hash, desc);
       
-      auto pair = m_objects.find(desc);
+      if (likely(entry != nullptr))
+        return entry->object.ref();
       
-      if (pair != m_objects.end())
-        return pair->second.ref();
+      std::lock_guard<sync::Spinlock> lock(shard.mutex);
       
-      Com<T> result = new T(device, desc);
-      m_objects.insert({ desc, result });
-      return result.ref();
+      // Another thread may have inserted the object
+      // since we looked it up, but only entries added
+      // in front of the old list head can be new.
+      Entry* newHead = bucket.load(std::memory_order_acquire);
+      entry = Find(newHead, head, hash, desc);
+      
+      if (entry != nullptr)
+        return entry->object.ref();
+      
+      entry = new Entry { desc, hash, new T(device, desc), newHead };
+      bucket.store(entry, std::memory_order_release);
+      return entry->object.ref();
     }
     
   private:
     
-    std::mutex                                 m_mutex;
-    std::unordered_map<DescType, Com<T>,
-      D3D11StateDescHash, D3D11StateDescEqual> m_objects;
+    struct Entry {
+      DescType  desc;
+      size_t    hash;
+      Com<T>    object;
+      Entry*    next;
+    };
+    
+    struct Shard {
+      alignas(CACHE_LINE_SIZE)
+      sync::Spinlock      mutex;
+      std::atomic<Entry*> buckets[BucketCount] = { };
+    };
+    
+    std::array<Shard, ShardCount> m_shards;
+    
+    static Entry* Find(
+            Entry*          first,
+            Entry*          last,
+            size_t          hash,
+      const DescType&       desc) {
+      for (Entry* entry = first; entry != last; entry = entry->next) {
+        if (entry->hash == hash && D3D11StateDescEqual()(entry->desc, desc))
+          return entry;
+      }
+      
+      return nullptr;
+    }
     
   };
   
@@ -14,6 +14,22 @@ namespace dxvk {
   }
 
 
+  static bool IsIdentityGammaRamp(
+          UINT                NumControlPoints,
+    const D3D11_VK_GAMMA_CP*  pControlPoints) {
+    for (uint32_t i = 0; i < NumControlPoints; i++) {
+      int32_t expected = int32_t((65535 * i) / std::max(NumControlPoints - 1, 1u));
+
+      if (std::abs(int32_t(pControlPoints[i].R) - expected) > 1
+       || std::abs(int32_t(pControlPoints[i].G) - expected) > 1
+       || std::abs(int32_t(pControlPoints[i].B) - expected) > 1)
+        return false;
+    }
+
+    return true;
+  }
+
+
   D3D11SwapChain::D3D11SwapChain(
           D3D11DXGIDevice*        pContainer,
           D3D11Device*            pDevice,
@@ -149,6 +165,7 @@ namespace dxvk {
       }
 
       CreateGammaTexture(NumControlPoints, cp.data());
+      m_gammaIdentity = IsIdentityGammaRamp(NumControlPoints, cp.data());
     } else {
       std::array<D3D11_VK_GAMMA_CP, 256> cp;
 
@@ -158,6 +175,7 @@ namespace dxvk {
       }
 
       CreateGammaTexture(cp.size(), cp.data());
+      m_gammaIdentity = true;
     }
 
     return S_OK;
@@ -168,6 +186,8 @@ namespace dxvk {
           UINT                      SyncInterval,
           UINT                      PresentFlags,
     const DXGI_PRESENT_PARAMETERS*  pPresentParameters) {
+    DXVK_TRACE_ZONE("D3D11SwapChain::Present");
+
     auto options = m_parent->GetOptions();
 
     if (options->syncInterval >= 0)
@@ -184,6 +204,11 @@ namespace dxvk {
     if (std::exchange(m_dirty, false))
       RecreateSwapChain(vsync);
     
+    D3D11ApiCapture* capture = m_parent->GetApiCapture();
+
+    if (unlikely(capture != nullptr))
+      capture->RecordCall(D3D11CaptureOp::Present, SyncInterval);
+
     FlushImmediateContext();
 
     try {
@@ -247,51 +272,29 @@ namespace dxvk {
       if (m_usePresentFence)
         m_presenter->waitForFence(sync.fence);
 
-      // Use an appropriate texture filter depending on whether
-      // the back buffer size matches the swap image size
-      bool fitSize = m_swapImage->info().extent.width  == info.imageExtent.width
-                  && m_swapImage->info().extent.height == info.imageExtent.height;
-
-      m_context->bindShader(VK_SHADER_STAGE_VERTEX_BIT,   m_vertShader);
-      m_context->bindShader(VK_SHADER_STAGE_FRAGMENT_BIT, m_fragShader);
-
-      DxvkRenderTargets renderTargets;
-      renderTargets.color[0].view   = m_imageViews.at(imageIndex);
-      renderTargets.color[0].layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-      m_context->bindRenderTargets(renderTargets, false);
-
-      VkViewport viewport;
-      viewport.x        = 0.0f;
-      viewport.y        = 0.0f;
-      viewport.width    = float(info.imageExtent.width);
-      viewport.height   = float(info.imageExtent.height);
-      viewport.minDepth = 0.0f;
-      viewport.maxDepth = 1.0f;
-      
-      VkRect2D scissor;
-      scissor.offset.x      = 0;
-      scissor.offset.y      = 0;
-      scissor.extent.width  = info.imageExtent.width;
-      scissor.extent.height = info.imageExtent.height;
-
-      m_context->setViewports(1, &viewport, &scissor);
-
-      m_context->setRasterizerState(m_rsState);
-      m_context->setMultisampleState(m_msState);
-      m_context->setDepthStencilState(m_dsState);
-      m_context->setLogicOpState(m_loState);
-      m_context->setBlendMode(0, m_blendMode);
-      
-      m_context->setInputAssemblyState(m_iaState);
-      m_context->setInputLayout(0, nullptr, 0, nullptr);
-
-      m_context->bindResourceSampler(BindingIds::Sampler, fitSize ? m_samplerFitting : m_samplerScaling);
-      m_context->bindResourceSampler(BindingIds::GammaSmp, m_gammaSampler);
-
-      m_context->bindResourceView(BindingIds::Texture, m_swapImageView, nullptr);
-      m_context->bindResourceView(BindingIds::GammaTex, m_gammaTextureView, nullptr);
-
-      m_context->draw(4, 1, 0, 0);
+      // Copy the back buffer directly into the swap chain image
+      // if no gamma correction, scaling or format conversion
+      // is needed, and render a full-screen quad otherwise.
+      if (CanCopyToSwapImage(info)) {
+        VkImageSubresourceLayers subresource;
+        subresource.aspectMask      = VK_IMAGE_ASPECT_COLOR_BIT;
+        subresource.mipLevel        = 0;
+        subresource.baseArrayLayer  = 0;
+        subresource.layerCount      = 1;
+
+        VkExtent3D extent = { info.imageExtent.width, info.imageExtent.height, 1 };
+
+        m_context->copyImage(
+          m_imageViews.at(imageIndex)->image(),
+          subresource, VkOffset3D { 0, 0, 0 },
+          m_swapImageResolve != nullptr
+            ? m_swapImageResolve
+            : m_swapImage,
+          subresource, VkOffset3D { 0, 0, 0 },
+          extent);
+      } else {
+        BlitSwapImage(info, imageIndex);
+      }
 
       if (m_hud != nullptr)
         m_hud->render(m_context, info.imageExtent);
@@ -316,6 +319,70 @@ namespace dxvk {
   }
 
   
+  void D3D11SwapChain::BlitSwapImage(
+    const vk::PresenterInfo&  PresenterInfo,
+          uint32_t            ImageIndex) {
+    // Use an appropriate texture filter depending on whether
+    // the back buffer size matches the swap image size
+    bool fitSize = m_swapImage->info().extent.width  == PresenterInfo.imageExtent.width
+                && m_swapImage->info().extent.height == PresenterInfo.imageExtent.height;
+
+    m_context->bindShader(VK_SHADER_STAGE_VERTEX_BIT,   m_vertShader);
+    m_context->bindShader(VK_SHADER_STAGE_FRAGMENT_BIT, m_fragShader);
+
+    DxvkRenderTargets renderTargets;
+    renderTargets.color[0].view   = m_imageViews.at(ImageIndex);
+    renderTargets.color[0].layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    m_context->bindRenderTargets(renderTargets, false);
+
+    VkViewport viewport;
+    viewport.x        = 0.0f;
+    viewport.y        = 0.0f;
+    viewport.width    = float(PresenterInfo.imageExtent.width);
+    viewport.height   = float(PresenterInfo.imageExtent.height);
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+    
+    VkRect2D scissor;
+    scissor.offset.x      = 0;
+    scissor.offset.y      = 0;
+    scissor.extent.width  = PresenterInfo.imageExtent.width;
+    scissor.extent.height = PresenterInfo.imageExtent.height;
+
+    m_context->setViewports(1, &viewport, &scissor);
+
+    m_context->setRasterizerState(m_rsState);
+    m_context->setMultisampleState(m_msState);
+    m_context->setDepthStencilState(m_dsState);
+    m_context->setLogicOpState(m_loState);
+    m_context->setBlendMode(0, m_blendMode);
+    
+    m_context->setInputAssemblyState(m_iaState);
+    m_context->setInputLayout(0, nullptr, 0, nullptr);
+
+    m_context->bindResourceSampler(BindingIds::Sampler, fitSize ? m_samplerFitting : m_samplerScaling);
+    m_context->bindResourceSampler(BindingIds::GammaSmp, m_gammaSampler);
+
+    m_context->bindResourceView(BindingIds::Texture, m_swapImageView, nullptr);
+    m_context->bindResourceView(BindingIds::GammaTex, m_gammaTextureView, nullptr);
+
+    m_context->draw(4, 1, 0, 0);
+  }
+
+
+  bool D3D11SwapChain::CanCopyToSwapImage(
+    const vk::PresenterInfo&  PresenterInfo) const {
+    // The HUD is rendered on top of the swap chain image,
+    // which requires the image to be bound for rendering
+    if (m_hud != nullptr || !m_gammaIdentity)
+      return false;
+    
+    return m_swapImage->info().format        == PresenterInfo.format.format
+        && m_swapImage->info().extent.width  == PresenterInfo.imageExtent.width
+        && m_swapImage->info().extent.height == PresenterInfo.imageExtent.height;
+  }
+
+  
   void D3D11SwapChain::RecreateSwapChain(BOOL Vsync) {
     vk::PresenterDesc presenterDesc;
     presenterDesc.imageExtent     = { m_desc.Width, m_desc.Height };
@@ -368,7 +435,8 @@ namespace dxvk {
     imageInfo.extent      = { info.imageExtent.width, info.imageExtent.height, 1 };
     imageInfo.numLayers   = 1;
     imageInfo.mipLevels   = 1;
-    imageInfo.usage       = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    imageInfo.usage       = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT
+                          | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
     imageInfo.stages      = 0;
     imageInfo.access      = 0;
     imageInfo.tiling      = VK_IMAGE_TILING_OPTIMAL;
@@ -403,6 +471,7 @@ namespace dxvk {
     // The presentation code is run from the main rendering thread
     // rather than the command stream thread, so we synchronize.
     auto immediateContext = static_cast<D3D11ImmediateContext*>(deviceContext.ptr());
+    immediateContext->DefragmentMemory();
     immediateContext->Flush();
     immediateContext->SynchronizeCsThread();
   }
@@ -440,6 +509,17 @@ namespace dxvk {
     m_backBuffer = new D3D11Texture2D(m_parent, &desc);
     m_backBuffer->AddRefPrivate();
 
+    D3D11ApiCapture* capture = m_parent->GetApiCapture();
+
+    if (unlikely(capture != nullptr)) {
+      D3D11_TEXTURE2D_DESC captureDesc;
+      m_backBuffer->GetDesc(&captureDesc);
+
+      capture->RecordCreate(D3D11CaptureOp::CreateTexture2D,
+        static_cast<ID3D11Texture2D*>(m_backBuffer), captureDesc,
+        D3D11CaptureInitialData { nullptr, nullptr });
+    }
+
     m_swapImage = GetCommonTexture(m_backBuffer)->GetImage();
 
     // If the image is multisampled, we need to create
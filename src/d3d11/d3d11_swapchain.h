@@ -121,9 +121,14 @@ namespace dxvk {
     bool                    m_vsync = true;
 
     bool                    m_usePresentFence = true;
+    bool                    m_gammaIdentity   = true;
 
     void PresentImage(UINT SyncInterval);
 
+    void BlitSwapImage(
+      const vk::PresenterInfo&  PresenterInfo,
+            uint32_t            ImageIndex);
+
     void FlushImmediateContext();
     
     void RecreateSwapChain(
@@ -141,6 +146,9 @@ namespace dxvk {
     
     void CreateHud();
 
+    bool CanCopyToSwapImage(
+      const vk::PresenterInfo&  PresenterInfo) const;
+
     void InitRenderState();
 
     void InitSamplers();
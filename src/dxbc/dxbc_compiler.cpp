@@ -233,6 +233,7 @@ namespace dxvk {
     m_module.setDebugName(m_entryPointId, "main");
 
     DxvkShaderOptions shaderOptions = { };
+    shaderOptions.pushConstants = m_pushConstants;
 
     if (m_moduleInfo.xfb != nullptr) {
       shaderOptions.rasterizedStream = m_moduleInfo.xfb->rasterizedStream;
@@ -742,6 +743,16 @@ namespace dxvk {
     const uint32_t bufferId     = ins.dst[0].idx[0].offset;
     const uint32_t elementCount = ins.dst[0].idx[1].offset;
     
+    // Small constant buffers that are only accessed with
+    // static offsets can be passed via push constants,
+    // which is cheaper than updating descriptors.
+    if (m_moduleInfo.options.usePushConstantBuffers
+     && ins.controls.accessType() == DxbcConstantBufferAccessType::StaticallyIndexed) {
+      if (this->emitDclPushConstantBufferVar(bufferId, elementCount,
+            str::format("cb", bufferId).c_str()))
+        return;
+    }
+    
     this->emitDclConstantBufferVar(bufferId, elementCount,
       str::format("cb", bufferId).c_str());
   }
@@ -807,6 +818,57 @@ namespace dxvk {
   }
 
 
+  bool DxbcCompiler::emitDclPushConstantBufferVar(
+          uint32_t                regIdx,
+          uint32_t                numConstants,
+    const char*                   name) {
+    // Only one buffer per stage can be promoted, and
+    // it has to fit into the stage's push constant range
+    const DxbcPushConstantRange range = computePushConstantRange(m_programInfo.type());
+    
+    if (m_pushConstants.size != 0 || numConstants == 0
+     || numConstants * 16 > range.size)
+      return false;
+    
+    const uint32_t arrayType = m_module.defArrayTypeUnique(
+      getVectorTypeId({ DxbcScalarType::Float32, 4 }),
+      m_module.constu32(numConstants));
+    m_module.decorateArrayStride(arrayType, 16);
+    
+    // The array is placed at the stage's offset within the
+    // push constant block, so that stages do not overlap.
+    const uint32_t structType = m_module.defStructTypeUnique(1, &arrayType);
+    
+    m_module.decorateBlock       (structType);
+    m_module.memberDecorateOffset(structType, 0, range.offset);
+    
+    m_module.setDebugName        (structType, str::format(name, "_t").c_str());
+    m_module.setDebugMemberName  (structType, 0, "m");
+    
+    const uint32_t varId = m_module.newVar(
+      m_module.defPointerType(structType, spv::StorageClassPushConstant),
+      spv::StorageClassPushConstant);
+    
+    m_module.setDebugName(varId, name);
+    
+    DxbcConstantBuffer buf;
+    buf.varId  = varId;
+    buf.size   = numConstants;
+    buf.sclass = spv::StorageClassPushConstant;
+    m_constantBuffers.at(regIdx) = buf;
+    
+    // The context will copy the contents of the buffer
+    // bound to the regular resource slot to the range.
+    m_pushConstants.slot   = computeResourceSlotId(
+      m_programInfo.type(), DxbcBindingType::ConstantBuffer,
+      regIdx);
+    m_pushConstants.stages = m_programInfo.shaderStage();
+    m_pushConstants.offset = range.offset;
+    m_pushConstants.size   = numConstants * 16;
+    return true;
+  }
+
+
   void DxbcCompiler::emitDclSampler(const DxbcShaderInstruction& ins) {
     // dclSampler takes one operand:
     //    (dst0) The sampler register to declare
@@ -1082,6 +1144,11 @@ namespace dxvk {
         : DxbcBindingType::ShaderResource,
       registerId);
     
+    // Vector view of the same descriptor, used for
+    // structure members with a known alignment
+    uint32_t vecVarId = 0;
+    uint32_t vecSize  = 0;
+    
     if (m_moduleInfo.options.useRawSsbo) {
       uint32_t elemType   = getScalarTypeId(DxbcScalarType::Uint32);
       uint32_t arrayType  = m_module.defRuntimeArrayTypeUnique(elemType);
@@ -1101,6 +1168,49 @@ namespace dxvk {
 
       if (!isUav)
         m_module.decorate(varId, spv::DecorationNonWritable);
+      
+      // Structures that are made up of 16-byte or 8-byte
+      // blocks can be accessed through a uvec4 or uvec2
+      // array, which avoids splitting vector loads and
+      // stores into individual scalar operations.
+      if (isStructured) {
+        vecSize = (resStride % 16 == 0) ? 4
+                : (resStride %  8 == 0) ? 2 : 0;
+      }
+      
+      if (vecSize) {
+        uint32_t vecElemType   = getVectorTypeId({ DxbcScalarType::Uint32, vecSize });
+        uint32_t vecArrayType  = m_module.defRuntimeArrayTypeUnique(vecElemType);
+        uint32_t vecStructType = m_module.defStructTypeUnique(1, &vecArrayType);
+        uint32_t vecPtrType    = m_module.defPointerType(vecStructType, spv::StorageClassUniform);
+        
+        vecVarId = m_module.newVar(vecPtrType, spv::StorageClassUniform);
+        
+        m_module.decorateArrayStride(vecArrayType, vecSize * sizeof(uint32_t));
+        m_module.decorate(vecStructType, spv::DecorationBufferBlock);
+        m_module.memberDecorateOffset(vecStructType, 0, 0);
+        
+        m_module.setDebugName(vecStructType,
+          str::format(isUav ? "u" : "t", registerId, "_v", vecSize, "_t").c_str());
+        m_module.setDebugMemberName(vecStructType, 0, "m");
+        m_module.setDebugName(vecVarId,
+          str::format(isUav ? "u" : "t", registerId, "_v", vecSize).c_str());
+        
+        m_module.decorateDescriptorSet(vecVarId, 0);
+        m_module.decorateBinding(vecVarId, bindingId);
+        
+        // Writes through one view must be visible
+        // to reads through the other one
+        if (isUav) {
+          m_module.decorate(varId,    spv::DecorationAliased);
+          m_module.decorate(vecVarId, spv::DecorationAliased);
+          
+          if (ins.controls.uavFlags().test(DxbcUavFlag::GloballyCoherent))
+            m_module.decorate(vecVarId, spv::DecorationCoherent);
+        } else {
+          m_module.decorate(vecVarId, spv::DecorationNonWritable);
+        }
+      }
     } else {
       // Structured and raw buffers are represented as
       // texel buffers consisting of 32-bit integers.
@@ -1144,6 +1254,8 @@ namespace dxvk {
       uav.sampledTypeId = sampledTypeId;
       uav.imageTypeId   = resTypeId;
       uav.structStride  = resStride;
+      uav.vecVarId      = vecVarId;
+      uav.vecSize       = vecSize;
       m_uavs.at(registerId) = uav;
     } else {
       DxbcShaderResource res;
@@ -1157,6 +1269,8 @@ namespace dxvk {
       res.colorTypeId   = resTypeId;
       res.depthTypeId   = 0;
       res.structStride  = resStride;
+      res.vecVarId      = vecVarId;
+      res.vecSize       = vecSize;
       m_textures.at(registerId) = res;
     }
     
@@ -1289,7 +1403,14 @@ namespace dxvk {
     // count embedded within the opcode token.
     m_hs.vertexCountOut = ins.controls.controlPointCount();
     
-    m_hs.outputPerPatch  = emitTessInterfacePerPatch(spv::StorageClassPrivate);
+    // If there are multiple control point invocations, fork and
+    // join phase instances will be distributed across them, so
+    // patch constants must be written to the shared output array.
+    m_hs.outputPerPatchClass = m_hs.vertexCountOut > 1
+      ? spv::StorageClassOutput
+      : spv::StorageClassPrivate;
+    
+    m_hs.outputPerPatch  = emitTessInterfacePerPatch(m_hs.outputPerPatchClass);
     m_hs.outputPerVertex = emitTessInterfacePerVertex(spv::StorageClassOutput, m_hs.vertexCountOut);
     
     m_module.setOutputVertices(m_entryPointId, m_hs.vertexCountOut);
@@ -1516,7 +1637,21 @@ namespace dxvk {
     if (isDoubleType(ins.dst[0].dataType))
       dst.type.ccount /= 2;
     
-    const uint32_t typeId = getVectorTypeId(dst.type);
+    // If all operands are min16float, perform the operation on
+    // 16-bit floats. Registers themselves remain 32-bit, so the
+    // result will be converted back before storing it.
+    const bool useFloat16 = isFloat16Instruction(ins);
+    
+    if (useFloat16) {
+      m_module.enableCapability(spv::CapabilityFloat16);
+      
+      for (uint32_t i = 0; i < ins.srcCount; i++)
+        src.at(i).id = m_module.opFConvert(getFloat16TypeId(dst.type.ccount), src.at(i).id);
+    }
+    
+    const uint32_t typeId = useFloat16
+      ? getFloat16TypeId(dst.type.ccount)
+      : getVectorTypeId(dst.type);
     
     switch (ins.op) {
       /////////////////////
@@ -1745,6 +1880,15 @@ namespace dxvk {
     if (ins.controls.precise())
       m_module.decorate(dst.id, spv::DecorationNoContraction);
     
+    if (useFloat16) {
+      dst.id = m_module.opFConvert(
+        getVectorTypeId(dst.type), dst.id);
+    } else if (ins.dst[0].precision != DxbcMinPrecision::None
+            && ins.op != DxbcOpcode::Mov
+            && ins.op != DxbcOpcode::DMov) {
+      m_module.decorate(dst.id, spv::DecorationRelaxedPrecision);
+    }
+    
     // Store computed value
     dst = emitDstOperandModifiers(dst, ins.modifiers);
     emitRegisterStore(ins.dst[0], dst);
@@ -1993,6 +2137,9 @@ namespace dxvk {
     if (ins.controls.precise())
       m_module.decorate(dst.id, spv::DecorationNoContraction);
     
+    if (ins.dst[0].precision != DxbcMinPrecision::None)
+      m_module.decorate(dst.id, spv::DecorationRelaxedPrecision);
+    
     dst = emitDstOperandModifiers(dst, ins.modifiers);
     emitRegisterStore(ins.dst[0], dst);
   }
@@ -2419,24 +2566,81 @@ namespace dxvk {
     
     const uint32_t typeId = getVectorTypeId(value.type);
     
-    switch (ins.op) {
-      case DxbcOpcode::ImmAtomicAlloc:
-        value.id = m_module.opAtomicIAdd(typeId, ptrId,
-          scopeId, semanticsId, m_module.constu32(1));
-        break;
-        
-      case DxbcOpcode::ImmAtomicConsume:
-        value.id = m_module.opAtomicISub(typeId, ptrId,
-          scopeId, semanticsId, m_module.constu32(1));
-        value.id = m_module.opISub(typeId, value.id,
-          m_module.constu32(1));
-        break;
+    if (ins.op != DxbcOpcode::ImmAtomicAlloc
+     && ins.op != DxbcOpcode::ImmAtomicConsume) {
+      Logger::warn(str::format(
+        "DxbcCompiler: Unhandled instruction: ",
+        ins.op));
+      return;
+    }
+    
+    // Helper invocations in pixel shaders do not perform
+    // atomics, so only aggregate in compute shaders
+    bool useSubgroupOps = m_moduleInfo.options.useSubgroupOpsForAtomicCounters
+                       && m_programInfo.type() == DxbcProgramType::ComputeShader;
+    
+    if (useSubgroupOps) {
+      m_module.enableCapability(spv::CapabilityGroupNonUniform);
+      m_module.enableCapability(spv::CapabilityGroupNonUniformBallot);
       
-      default:
-        Logger::warn(str::format(
-          "DxbcCompiler: Unhandled instruction: ",
-          ins.op));
-        return;
+      // Count active invocations and compute the index
+      // of the current invocation among them
+      const uint32_t subgroupScopeId = m_module.constu32(spv::ScopeSubgroup);
+      
+      uint32_t ballot = m_module.opGroupNonUniformBallot(
+        getVectorTypeId({ DxbcScalarType::Uint32, 4 }),
+        subgroupScopeId, m_module.constBool(true));
+      
+      uint32_t count = m_module.opGroupNonUniformBallotBitCount(
+        typeId, subgroupScopeId, spv::GroupOperationReduce, ballot);
+      
+      uint32_t index = m_module.opGroupNonUniformBallotBitCount(
+        typeId, subgroupScopeId, spv::GroupOperationExclusiveScan, ballot);
+      
+      // Perform one atomic for the entire subgroup
+      uint32_t elected = m_module.opGroupNonUniformElect(
+        m_module.defBoolType(), subgroupScopeId);
+      
+      DxbcConditional elect;
+      elect.labelIf  = m_module.allocateId();
+      elect.labelEnd = m_module.allocateId();
+      
+      m_module.opSelectionMerge(elect.labelEnd, spv::SelectionControlMaskNone);
+      m_module.opBranchConditional(elected, elect.labelIf, elect.labelEnd);
+      
+      m_module.opLabel(elect.labelIf);
+      
+      uint32_t base = ins.op == DxbcOpcode::ImmAtomicAlloc
+        ? m_module.opAtomicIAdd(typeId, ptrId, scopeId, semanticsId, count)
+        : m_module.opAtomicISub(typeId, ptrId, scopeId, semanticsId, count);
+      
+      m_module.opBranch(elect.labelEnd);
+      m_module.opLabel (elect.labelEnd);
+      
+      // The elected invocation is the first active one,
+      // so broadcasting from it yields the atomic result
+      std::array<SpirvPhiLabel, 2> phiLabels = {{
+        { base,                   elect.labelIf },
+        { m_module.constu32(0),   cond.labelIf  },
+      }};
+      
+      base = m_module.opGroupNonUniformBroadcastFirst(typeId, subgroupScopeId,
+        m_module.opPhi(typeId, phiLabels.size(), phiLabels.data()));
+      
+      // Consume returns the decremented counter value,
+      // so the first invocation gets the highest index
+      value.id = ins.op == DxbcOpcode::ImmAtomicAlloc
+        ? m_module.opIAdd(typeId, base, index)
+        : m_module.opISub(typeId, base,
+            m_module.opIAdd(typeId, index, m_module.constu32(1)));
+    } else if (ins.op == DxbcOpcode::ImmAtomicAlloc) {
+      value.id = m_module.opAtomicIAdd(typeId, ptrId,
+        scopeId, semanticsId, m_module.constu32(1));
+    } else {
+      value.id = m_module.opAtomicISub(typeId, ptrId,
+        scopeId, semanticsId, m_module.constu32(1));
+      value.id = m_module.opISub(typeId, value.id,
+        m_module.constu32(1));
     }
     
     // Store the result
@@ -2692,8 +2896,12 @@ namespace dxvk {
       : emitCalcBufferIndexRaw(
           emitRegisterLoad(ins.src[0], DxbcRegMask(true, false, false, false)));
     
+    const uint32_t alignment = isStructured
+      ? getBufferAlignment(ins.src[1], bufferInfo.stride)
+      : 0;
+    
     emitRegisterStore(dstReg,
-      emitRawBufferLoad(srcReg, elementIndex, dstReg.mask));
+      emitRawBufferLoad(srcReg, elementIndex, dstReg.mask, alignment));
   }
   
   
@@ -2727,8 +2935,12 @@ namespace dxvk {
       : emitCalcBufferIndexRaw(
           emitRegisterLoad(ins.src[0], DxbcRegMask(true, false, false, false)));
     
+    const uint32_t alignment = isStructured
+      ? getBufferAlignment(ins.src[1], bufferInfo.stride)
+      : 0;
+    
     emitRawBufferStore(dstReg, elementIndex,
-      emitRegisterLoad(srcReg, dstReg.mask));
+      emitRegisterLoad(srcReg, dstReg.mask), alignment);
   }
   
   
@@ -4520,7 +4732,7 @@ namespace dxvk {
                   : InputArray { m_ds.inputPerVertex,  spv::StorageClassInput   };
         case DxbcOperandType::InputPatchConstant:
           return m_programInfo.type() == DxbcProgramType::HullShader
-                  ? InputArray { m_hs.outputPerPatch, spv::StorageClassPrivate }
+                  ? InputArray { m_hs.outputPerPatch, m_hs.outputPerPatchClass }
                   : InputArray { m_ds.inputPerPatch,  spv::StorageClassInput   };
         case DxbcOperandType::OutputControlPoint:
           return InputArray { m_hs.outputPerVertex, spv::StorageClassOutput };
@@ -4571,7 +4783,7 @@ namespace dxvk {
       } else {
         uint32_t ptrTypeId  = m_module.defPointerType(
           getVectorTypeId(result.type),
-          spv::StorageClassPrivate);
+          m_hs.outputPerPatchClass);
         
         result.id = m_module.opAccessChain(
           ptrTypeId, m_hs.outputPerPatch,
@@ -4592,13 +4804,14 @@ namespace dxvk {
     // Constant buffers take a two-dimensional index:
     //    (0) register index (immediate)
     //    (1) constant offset (relative)
+    const uint32_t regId = operand.idx[0].offset;
+    
     DxbcRegisterInfo info;
     info.type.ctype   = DxbcScalarType::Float32;
     info.type.ccount  = 4;
     info.type.alength = 0;
-    info.sclass = spv::StorageClassUniform;
+    info.sclass = m_constantBuffers.at(regId).sclass;
     
-    const uint32_t regId = operand.idx[0].offset;
     const DxbcRegisterValue constId = emitIndexLoad(operand.idx[1]);
     
     const uint32_t ptrTypeId = getPointerTypeId(info);
@@ -4845,7 +5058,8 @@ namespace dxvk {
   DxbcRegisterValue DxbcCompiler::emitRawBufferLoad(
     const DxbcRegister&           operand,
           DxbcRegisterValue       elementIndex,
-          DxbcRegMask             writeMask) {
+          DxbcRegMask             writeMask,
+          uint32_t                alignment) {
     const DxbcBufferInfo bufferInfo = getBufferInfo(operand);
     
     // Shared memory is the only type of buffer that
@@ -4853,6 +5067,28 @@ namespace dxvk {
     bool isTgsm = operand.type == DxbcOperandType::ThreadGroupSharedMemory;
     bool isSsbo = m_moduleInfo.options.useRawSsbo && !isTgsm;
     
+    // If the access is aligned to the vector view and all
+    // components we read are part of the same vector, use
+    // a single vector load and swizzle the result.
+    if (isSsbo && bufferInfo.vecVarId && alignment
+     && alignment % (bufferInfo.vecSize * sizeof(uint32_t)) == 0) {
+      uint32_t componentCount = 0;
+      
+      for (uint32_t i = 0; i < 4; i++) {
+        if (writeMask[i])
+          componentCount = std::max(componentCount, operand.swizzle[i] + 1);
+      }
+      
+      if (componentCount <= bufferInfo.vecSize) {
+        DxbcRegisterValue result;
+        result.type.ctype  = DxbcScalarType::Uint32;
+        result.type.ccount = bufferInfo.vecSize;
+        result.id = m_module.opLoad(getVectorTypeId(result.type),
+          emitGetRawBufferVectorPtr(bufferInfo, elementIndex));
+        return emitRegisterSwizzle(result, operand.swizzle, writeMask);
+      }
+    }
+    
     // Common types and IDs used while loading the data
     uint32_t bufferId = isTgsm || isSsbo ? 0 : m_module.opLoad(bufferInfo.typeId, bufferInfo.varId);
     
@@ -4929,7 +5165,8 @@ namespace dxvk {
   void DxbcCompiler::emitRawBufferStore(
     const DxbcRegister&           operand,
           DxbcRegisterValue       elementIndex,
-          DxbcRegisterValue       value) {
+          DxbcRegisterValue       value,
+          uint32_t                alignment) {
     const DxbcBufferInfo bufferInfo = getBufferInfo(operand);
     
     // Cast source value to the expected data type
@@ -4955,55 +5192,67 @@ namespace dxvk {
       m_module.opLabel(cond.labelIf);
     }
     
-    // Perform the actual write operation
-    uint32_t bufferId = isTgsm || isSsbo ? 0 : m_module.opLoad(bufferInfo.typeId, bufferInfo.varId);
+    // Perform the actual write operation. If the store
+    // writes a full vector at an aligned offset, use the
+    // vector view and write all components at once.
+    bool isVector = isSsbo && bufferInfo.vecVarId && alignment
+      && alignment % (bufferInfo.vecSize * sizeof(uint32_t)) == 0
+      && operand.mask == DxbcRegMask::firstN(bufferInfo.vecSize);
     
-    uint32_t scalarTypeId = getVectorTypeId({ DxbcScalarType::Uint32, 1 });
-    uint32_t vectorTypeId = getVectorTypeId({ DxbcScalarType::Uint32, 4 });
-    
-    uint32_t srcComponentIndex = 0;
-    
-    for (uint32_t i = 0; i < 4; i++) {
-      if (operand.mask[i]) {
-        uint32_t srcComponentId = value.type.ccount > 1
-          ? m_module.opCompositeExtract(scalarTypeId,
-              value.id, 1, &srcComponentIndex)
-          : value.id;
-        
-        // Add the component offset to the element index
-        uint32_t elementIndexAdjusted = i != 0
-          ? m_module.opIAdd(getVectorTypeId(elementIndex.type),
-              elementIndex.id, m_module.consti32(i))
-          : elementIndex.id;
+    if (isVector) {
+      m_module.opStore(
+        emitGetRawBufferVectorPtr(bufferInfo, elementIndex),
+        value.id);
+    } else {
+      uint32_t bufferId = isTgsm || isSsbo ? 0 : m_module.opLoad(bufferInfo.typeId, bufferInfo.varId);
+    
+      uint32_t scalarTypeId = getVectorTypeId({ DxbcScalarType::Uint32, 1 });
+      uint32_t vectorTypeId = getVectorTypeId({ DxbcScalarType::Uint32, 4 });
+    
+      uint32_t srcComponentIndex = 0;
+    
+      for (uint32_t i = 0; i < 4; i++) {
+        if (operand.mask[i]) {
+          uint32_t srcComponentId = value.type.ccount > 1
+            ? m_module.opCompositeExtract(scalarTypeId,
+                value.id, 1, &srcComponentIndex)
+            : value.id;
+        
+          // Add the component offset to the element index
+          uint32_t elementIndexAdjusted = i != 0
+            ? m_module.opIAdd(getVectorTypeId(elementIndex.type),
+                elementIndex.id, m_module.consti32(i))
+            : elementIndex.id;
+        
+          if (isTgsm) {
+            m_module.opStore(
+              m_module.opAccessChain(bufferInfo.typeId,
+                bufferInfo.varId, 1, &elementIndexAdjusted),
+              srcComponentId);
+          } else if (isSsbo) {
+            uint32_t indices[2] = { m_module.constu32(0), elementIndexAdjusted };
+            m_module.opStore(
+              m_module.opAccessChain(bufferInfo.typeId,
+                bufferInfo.varId, 2, indices),
+              srcComponentId);
+          } else if (operand.type == DxbcOperandType::UnorderedAccessView) {
+            const std::array<uint32_t, 4> srcVectorIds = {
+              srcComponentId, srcComponentId,
+              srcComponentId, srcComponentId,
+            };
+      
+            m_module.opImageWrite(
+              bufferId, elementIndexAdjusted,
+              m_module.opCompositeConstruct(vectorTypeId,
+                4, srcVectorIds.data()),
+              SpirvImageOperands());
+          } else {
+            throw DxvkError("DxbcCompiler: Invalid operand type for strucured/raw store");
+          }
         
-        if (isTgsm) {
-          m_module.opStore(
-            m_module.opAccessChain(bufferInfo.typeId,
-              bufferInfo.varId, 1, &elementIndexAdjusted),
-            srcComponentId);
-        } else if (isSsbo) {
-          uint32_t indices[2] = { m_module.constu32(0), elementIndexAdjusted };
-          m_module.opStore(
-            m_module.opAccessChain(bufferInfo.typeId,
-              bufferInfo.varId, 2, indices),
-            srcComponentId);
-        } else if (operand.type == DxbcOperandType::UnorderedAccessView) {
-          const std::array<uint32_t, 4> srcVectorIds = {
-            srcComponentId, srcComponentId,
-            srcComponentId, srcComponentId,
-          };
-      
-          m_module.opImageWrite(
-            bufferId, elementIndexAdjusted,
-            m_module.opCompositeConstruct(vectorTypeId,
-              4, srcVectorIds.data()),
-            SpirvImageOperands());
-        } else {
-          throw DxvkError("DxbcCompiler: Invalid operand type for strucured/raw store");
+          // Write next component
+          srcComponentIndex += 1;
         }
-        
-        // Write next component
-        srcComponentIndex += 1;
       }
     }
     
@@ -5015,6 +5264,25 @@ namespace dxvk {
   }
 
 
+  uint32_t DxbcCompiler::emitGetRawBufferVectorPtr(
+    const DxbcBufferInfo&         bufferInfo,
+          DxbcRegisterValue       elementIndex) {
+    uint32_t typeId = getVectorTypeId(elementIndex.type);
+    
+    // The element index is given in dwords, and the
+    // caller ensures that it is a multiple of the size
+    uint32_t vecIndex = m_module.opShiftRightLogical(typeId, elementIndex.id,
+      m_module.consti32(bufferInfo.vecSize == 4 ? 2 : 1));
+    
+    uint32_t vecTypeId = getVectorTypeId({ DxbcScalarType::Uint32, bufferInfo.vecSize });
+    uint32_t indices[2] = { m_module.constu32(0), vecIndex };
+    
+    return m_module.opAccessChain(
+      m_module.defPointerType(vecTypeId, spv::StorageClassUniform),
+      bufferInfo.vecVarId, 2, indices);
+  }
+  
+  
   DxbcRegisterValue DxbcCompiler::emitQueryBufferSize(
     const DxbcRegister&           resource) {
     const DxbcBufferInfo bufferInfo = getBufferInfo(resource);
@@ -5353,10 +5621,52 @@ namespace dxvk {
   void DxbcCompiler::emitRegisterStore(
     const DxbcRegister&           reg,
           DxbcRegisterValue       value) {
+    if (m_programInfo.type() == DxbcProgramType::HullShader
+     && m_hs.currPhaseType != DxbcCompilerHsPhase::ControlPoint
+     && m_hs.outputPerPatchClass == spv::StorageClassOutput
+     && reg.type == DxbcOperandType::Output) {
+      emitHsPatchConstantStore(reg, value);
+      return;
+    }
+    
     emitValueStore(emitGetOperandPtr(reg), value, reg.mask);
   }
   
   
+  void DxbcCompiler::emitHsPatchConstantStore(
+    const DxbcRegister&           reg,
+          DxbcRegisterValue       value) {
+    // Multiple invocations may write to different components
+    // of the same patch constant register, so we cannot do a
+    // read-modify-write on the entire vector here.
+    DxbcRegisterPointer ptr = emitGetOperandPtr(reg);
+    
+    if (value.type.ctype != ptr.type.ctype)
+      value = emitRegisterBitcast(value, ptr.type.ctype);
+    
+    if (value.type.ccount == 1)
+      value = emitRegisterExtend(value, reg.mask.popCount());
+    
+    uint32_t ptrTypeId = m_module.defPointerType(
+      getScalarTypeId(ptr.type.ctype),
+      spv::StorageClassOutput);
+    
+    uint32_t srcIndex = 0;
+    
+    for (uint32_t i = 0; i < 4; i++) {
+      if (!reg.mask[i])
+        continue;
+      
+      uint32_t componentIndex = m_module.constu32(i);
+      uint32_t componentPtr   = m_module.opAccessChain(
+        ptrTypeId, ptr.id, 1, &componentIndex);
+      
+      m_module.opStore(componentPtr, emitRegisterExtract(
+        value, DxbcRegMask::select(srcIndex++)).id);
+    }
+  }
+  
+  
   DxbcRegisterValue DxbcCompiler::getSpecConstant(DxvkSpecConstantId specId) {
     const uint32_t specIdOffset = uint32_t(specId) - uint32_t(DxvkSpecConstantId::SpecConstantIdMin);
     
@@ -5511,7 +5821,7 @@ namespace dxvk {
         outputReg.id = m_module.opAccessChain(
           m_module.defPointerType(
             getVectorTypeId(outputReg.type),
-            spv::StorageClassPrivate),
+            m_hs.outputPerPatchClass),
           m_hs.outputPerPatch,
           1, &registerIndex);
       }
@@ -6544,18 +6854,40 @@ namespace dxvk {
     this->emitHsControlPointPhase(m_hs.cpPhase);
     this->emitHsPhaseBarrier();
     
-    // Fork-join phases and output setup
-    this->emitHsInvocationBlockBegin(1);
-    
-    for (const auto& phase : m_hs.forkPhases)
-      this->emitHsForkJoinPhase(phase);
-    
-    for (const auto& phase : m_hs.joinPhases)
-      this->emitHsForkJoinPhase(phase);
+    if (m_hs.outputPerPatchClass == spv::StorageClassOutput) {
+      // Fork-join phases, with the instances of all fork
+      // phases being distributed across control point
+      // invocations. Fork phases write disjoint patch
+      // constants and do not depend on each other, but
+      // join phases may read the fork phase outputs.
+      this->emitHsForkJoinPhasesDistributed(m_hs.forkPhases);
+      
+      if (!m_hs.joinPhases.empty()) {
+        this->emitHsPhaseBarrier();
+        this->emitHsForkJoinPhasesDistributed(m_hs.joinPhases);
+      }
+      
+      // Patch constants are already stored in the
+      // output array, only write the tess factors
+      this->emitHsPhaseBarrier();
+      this->emitHsInvocationBlockBegin(1);
+      this->emitOutputSetup();
+      this->emitHsInvocationBlockEnd();
+    } else {
+      // Fork-join phases and output setup
+      this->emitHsInvocationBlockBegin(1);
+      
+      for (const auto& phase : m_hs.forkPhases)
+        this->emitHsForkJoinPhase(phase);
+      
+      for (const auto& phase : m_hs.joinPhases)
+        this->emitHsForkJoinPhase(phase);
+      
+      this->emitOutputSetup();
+      this->emitHsOutputSetup();
+      this->emitHsInvocationBlockEnd();
+    }
     
-    this->emitOutputSetup();
-    this->emitHsOutputSetup();
-    this->emitHsInvocationBlockEnd();
     this->emitFunctionEnd();
   }
   
@@ -6738,6 +7070,71 @@ namespace dxvk {
   }
   
   
+  void DxbcCompiler::emitHsForkJoinPhasesDistributed(
+    const std::vector<DxbcCompilerHsForkJoinPhase>& phases) {
+    // Instances of all phases are numbered consecutively, and
+    // invocation i runs every instance k with k mod N == i,
+    // where N is the number of control point invocations.
+    const uint32_t invocationCount = m_hs.vertexCountOut;
+    
+    uint32_t uintTypeId = getScalarTypeId(DxbcScalarType::Uint32);
+    uint32_t baseIndex  = 0;
+    
+    uint32_t invocationId = m_module.opLoad(
+      uintTypeId, m_hs.builtinInvocationId);
+    
+    for (const auto& phase : phases) {
+      // First instance of the phase that runs on this invocation
+      uint32_t rotation = (invocationCount - baseIndex % invocationCount) % invocationCount;
+      uint32_t instanceId = invocationId;
+      
+      if (rotation) {
+        instanceId = m_module.opUMod(uintTypeId,
+          m_module.opIAdd(uintTypeId, invocationId, m_module.constu32(rotation)),
+          m_module.constu32(invocationCount));
+      }
+      
+      for (uint32_t i = 0; i < phase.instanceCount; i += invocationCount) {
+        uint32_t currInstanceId = i
+          ? m_module.opIAdd(uintTypeId, instanceId, m_module.constu32(i))
+          : instanceId;
+        
+        // Only the last batch of instances may not
+        // cover all invocations, so check the range
+        bool isPartial = i + invocationCount > phase.instanceCount;
+        
+        uint32_t labelBegin = 0;
+        uint32_t labelEnd   = 0;
+        
+        if (isPartial) {
+          labelBegin = m_module.allocateId();
+          labelEnd   = m_module.allocateId();
+          
+          uint32_t condition = m_module.opULessThan(
+            m_module.defBoolType(), currInstanceId,
+            m_module.constu32(phase.instanceCount));
+          
+          m_module.opSelectionMerge(labelEnd, spv::SelectionControlMaskNone);
+          m_module.opBranchConditional(condition, labelBegin, labelEnd);
+          m_module.opLabel(labelBegin);
+        }
+        
+        m_module.opFunctionCall(
+          m_module.defVoidType(),
+          phase.functionId, 1,
+          &currInstanceId);
+        
+        if (isPartial) {
+          m_module.opBranch(labelEnd);
+          m_module.opLabel (labelEnd);
+        }
+      }
+      
+      baseIndex += phase.instanceCount;
+    }
+  }
+  
+  
   void DxbcCompiler::emitDclInputArray(uint32_t vertexCount) {
     DxbcArrayType info;
     info.ctype   = DxbcScalarType::Float32;
@@ -7187,6 +7584,8 @@ namespace dxvk {
         result.varId  = m_textures.at(registerId).varId;
         result.specId = m_textures.at(registerId).specId;
         result.stride = m_textures.at(registerId).structStride;
+        result.vecVarId = m_textures.at(registerId).vecVarId;
+        result.vecSize  = m_textures.at(registerId).vecSize;
         return result;
       } break;
         
@@ -7199,6 +7598,8 @@ namespace dxvk {
         result.varId  = m_uavs.at(registerId).varId;
         result.specId = m_uavs.at(registerId).specId;
         result.stride = m_uavs.at(registerId).structStride;
+        result.vecVarId = m_uavs.at(registerId).vecVarId;
+        result.vecSize  = m_uavs.at(registerId).vecSize;
         return result;
       } break;
         
@@ -7213,6 +7614,8 @@ namespace dxvk {
         result.varId  = m_gRegs.at(registerId).varId;
         result.specId = 0;
         result.stride = m_gRegs.at(registerId).elementStride;
+        result.vecVarId = 0;
+        result.vecSize  = 0;
         return result;
       } break;
         
@@ -7222,6 +7625,23 @@ namespace dxvk {
   }
   
   
+  uint32_t DxbcCompiler::getBufferAlignment(
+    const DxbcRegister&           offset,
+          uint32_t                stride) const {
+    // We can only reason about constant offsets. The structure
+    // index may be dynamic since the stride is a constant.
+    if (offset.type != DxbcOperandType::Imm32)
+      return 0;
+    
+    uint32_t alignment = 16;
+    
+    while (alignment > 1 && ((offset.imm.u32_1 | stride) & (alignment - 1)))
+      alignment /= 2;
+    
+    return alignment;
+  }
+  
+  
   uint32_t DxbcCompiler::getTexSizeDim(const DxbcImageInfo& imageType) const {
     switch (imageType.dim) {
       case spv::DimBuffer:  return 1 + imageType.array;
@@ -7364,6 +7784,43 @@ namespace dxvk {
   }
 
 
+  bool DxbcCompiler::isFloat16Instruction(const DxbcShaderInstruction& ins) const {
+    if (!m_moduleInfo.options.useFloat16Arithmetic
+     || ins.dst[0].dataType  != DxbcScalarType::Float32
+     || ins.dst[0].precision != DxbcMinPrecision::Float16)
+      return false;
+    
+    // Only consider operations that do not lose much
+    // precision and don't require special constants
+    switch (ins.op) {
+      case DxbcOpcode::Add:
+      case DxbcOpcode::Frc:
+      case DxbcOpcode::Mad:
+      case DxbcOpcode::Max:
+      case DxbcOpcode::Min:
+      case DxbcOpcode::Mul:
+      case DxbcOpcode::RoundNe:
+      case DxbcOpcode::RoundNi:
+      case DxbcOpcode::RoundPi:
+      case DxbcOpcode::RoundZ:
+        break;
+      
+      default:
+        return false;
+    }
+    
+    // Immediates are converted, but all other
+    // source operands must be min16float too
+    for (uint32_t i = 0; i < ins.srcCount; i++) {
+      if (ins.src[i].type      != DxbcOperandType::Imm32
+       && ins.src[i].precision != DxbcMinPrecision::Float16)
+        return false;
+    }
+    
+    return true;
+  }
+  
+  
   uint32_t DxbcCompiler::getScalarTypeId(DxbcScalarType type) {
     if (type == DxbcScalarType::Float64)
       m_module.enableCapability(spv::CapabilityFloat64);
@@ -7395,6 +7852,16 @@ namespace dxvk {
   }
   
   
+  uint32_t DxbcCompiler::getFloat16TypeId(uint32_t count) {
+    uint32_t typeId = m_module.defFloatType(16);
+    
+    if (count > 1)
+      typeId = m_module.defVectorType(typeId, count);
+    
+    return typeId;
+  }
+  
+  
   uint32_t DxbcCompiler::getArrayTypeId(const DxbcArrayType& type) {
     DxbcVectorType vtype;
     vtype.ctype  = type.ctype;
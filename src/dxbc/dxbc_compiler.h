@@ -260,6 +260,8 @@ namespace dxvk {
     uint32_t outputPerPatch        = 0;
     uint32_t outputPerVertex       = 0;
     
+    spv::StorageClass outputPerPatchClass = spv::StorageClassPrivate;
+    
     uint32_t invocationBlockBegin  = 0;
     uint32_t invocationBlockEnd    = 0;
 
@@ -345,6 +347,8 @@ namespace dxvk {
     uint32_t varId;
     uint32_t specId;
     uint32_t stride;
+    uint32_t vecVarId;
+    uint32_t vecSize;
   };
   
 
@@ -459,6 +463,11 @@ namespace dxvk {
     std::array<DxbcShaderResource, 128> m_textures;
     std::array<DxbcUav,             64> m_uavs;
     
+    /////////////////////////////////////////////////////
+    // Constant buffer that is passed to the shader via
+    // push constants rather than a uniform buffer
+    DxvkPushConstantSlot m_pushConstants = { };
+    
     ///////////////////////////////////////////////
     // Control flow information. Stores labels for
     // currently active if-else blocks and loops.
@@ -572,6 +581,11 @@ namespace dxvk {
             uint32_t                numConstants,
       const char*                   name);
     
+    bool emitDclPushConstantBufferVar(
+            uint32_t                regIdx,
+            uint32_t                numConstants,
+      const char*                   name);
+    
     void emitDclSampler(
       const DxbcShaderInstruction&  ins);
     
@@ -913,12 +927,22 @@ namespace dxvk {
     DxbcRegisterValue emitRawBufferLoad(
       const DxbcRegister&           operand,
             DxbcRegisterValue       elementIndex,
-            DxbcRegMask             writeMask);
+            DxbcRegMask             writeMask,
+            uint32_t                alignment);
     
     void emitRawBufferStore(
       const DxbcRegister&           operand,
             DxbcRegisterValue       elementIndex,
-            DxbcRegisterValue       value);
+            DxbcRegisterValue       value,
+            uint32_t                alignment);
+    
+    uint32_t emitGetRawBufferVectorPtr(
+      const DxbcBufferInfo&         bufferInfo,
+            DxbcRegisterValue       elementIndex);
+    
+    uint32_t getBufferAlignment(
+      const DxbcRegister&           offset,
+            uint32_t                stride) const;
     
     //////////////////////////
     // Resource query methods
@@ -984,6 +1008,10 @@ namespace dxvk {
       const DxbcRegister&           reg,
             DxbcRegisterValue       value);
     
+    void emitHsPatchConstantStore(
+      const DxbcRegister&           reg,
+            DxbcRegisterValue       value);
+    
     ////////////////////////////////////////
     // Spec constant declaration and access
     DxbcRegisterValue getSpecConstant(
@@ -1109,6 +1137,9 @@ namespace dxvk {
     void emitHsForkJoinPhase(
       const DxbcCompilerHsForkJoinPhase&      phase);
     
+    void emitHsForkJoinPhasesDistributed(
+      const std::vector<DxbcCompilerHsForkJoinPhase>& phases);
+    
     void emitHsPhaseBarrier();
     
     void emitHsInvocationBlockBegin(
@@ -1203,6 +1234,9 @@ namespace dxvk {
     bool isDoubleType(
             DxbcScalarType type) const;
     
+    bool isFloat16Instruction(
+      const DxbcShaderInstruction& ins) const;
+    
     ///////////////////////////
     // Type definition methods
     uint32_t getScalarTypeId(
@@ -1211,6 +1245,9 @@ namespace dxvk {
     uint32_t getVectorTypeId(
       const DxbcVectorType& type);
     
+    uint32_t getFloat16TypeId(
+            uint32_t       count);
+    
     uint32_t getArrayTypeId(
       const DxbcArrayType& type);
     
@@ -232,6 +232,7 @@ namespace dxvk {
         // value of a source operand during the load operation
         case DxbcOperandExt::OperandModifier:
           reg.modifiers = bit::extract(token, 6, 13);
+          reg.precision = static_cast<DxbcMinPrecision>(bit::extract(token, 14, 16));
           break;
         
         default:
@@ -316,6 +317,7 @@ namespace dxvk {
     reg.type            = static_cast<DxbcOperandType>(bit::extract(token, 12, 19));
     reg.dataType        = type;
     reg.modifiers       = 0;
+    reg.precision       = DxbcMinPrecision::None;
     reg.idxDim          = 0;
     
     for (uint32_t i = 0; i < DxbcMaxRegIndexDim; i++) {
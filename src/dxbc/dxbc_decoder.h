@@ -35,9 +35,10 @@ namespace dxvk {
    * access a constant buffer.
    */
   struct DxbcConstantBuffer {
-    uint32_t varId  = 0;
-    uint32_t specId = 0;
-    uint32_t size   = 0;
+    uint32_t          varId  = 0;
+    uint32_t          specId = 0;
+    uint32_t          size   = 0;
+    spv::StorageClass sclass = spv::StorageClassUniform;
   };
   
   /**
@@ -81,6 +82,8 @@ namespace dxvk {
     uint32_t          colorTypeId   = 0;
     uint32_t          depthTypeId   = 0;
     uint32_t          structStride  = 0;
+    uint32_t          vecVarId      = 0;
+    uint32_t          vecSize       = 0;
   };
   
   
@@ -100,6 +103,8 @@ namespace dxvk {
     uint32_t          sampledTypeId = 0;
     uint32_t          imageTypeId   = 0;
     uint32_t          structStride  = 0;
+    uint32_t          vecVarId      = 0;
+    uint32_t          vecSize       = 0;
   };
   
   
@@ -225,6 +230,7 @@ namespace dxvk {
     DxbcRegMask           mask;
     DxbcRegSwizzle        swizzle;
     DxbcRegModifiers      modifiers;
+    DxbcMinPrecision      precision;
     
     union {
       uint32_t            u32_4[4];
@@ -313,6 +319,10 @@ namespace dxvk {
       return DxbcTessPartitioning(bit::extract(m_bits, 11, 13));
     }
     
+    DxbcConstantBufferAccessType accessType() const {
+      return DxbcConstantBufferAccessType(bit::extract(m_bits, 11, 11));
+    }
+    
     DxbcUavFlags uavFlags() const {
       return DxbcUavFlags(bit::extract(m_bits, 16, 16));
     }
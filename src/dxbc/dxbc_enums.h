@@ -341,6 +341,21 @@ namespace dxvk {
   };
   
   
+  /**
+   * \brief Minimum precision
+   * 
+   * Lowest precision that the operand
+   * may be evaluated with, if any.
+   */
+  enum class DxbcMinPrecision : uint32_t {
+    None              = 0,
+    Float16           = 1,
+    Float2_8          = 2,
+    Sint16            = 4,
+    Uint16            = 5,
+  };
+  
+  
   /**
    * \brief Resource dimension
    * The type of a resource.
@@ -585,6 +600,14 @@ namespace dxvk {
     FractEven     = 4,
   };
   
+  /**
+   * \brief Constant buffer access pattern
+   */
+  enum class DxbcConstantBufferAccessType : uint32_t {
+    StaticallyIndexed   = 0,
+    DynamicallyIndexed  = 1,
+  };
+  
   /**
    * \brief UAV definition flags
    */
@@ -23,6 +23,9 @@ namespace dxvk {
       = (devInfo.coreSubgroup.subgroupSize >= 4)
      && (devInfo.coreSubgroup.supportedStages     & VK_SHADER_STAGE_FRAGMENT_BIT)
      && (devInfo.coreSubgroup.supportedOperations & VK_SUBGROUP_FEATURE_BALLOT_BIT);
+    useSubgroupOpsForAtomicCounters
+      = (devInfo.coreSubgroup.supportedStages     & VK_SHADER_STAGE_COMPUTE_BIT)
+     && (devInfo.coreSubgroup.supportedOperations & VK_SUBGROUP_FEATURE_BALLOT_BIT);
     useRawSsbo
       = (devInfo.core.properties.limits.minStorageBufferOffsetAlignment <= sizeof(uint32_t));
     useSdivForBufferIndex
@@ -30,6 +33,9 @@ namespace dxvk {
     
     strictDivision          = options.strictDivision;
     zeroInitWorkgroupMemory = options.zeroInitWorkgroupMemory;
+    usePushConstantBuffers  = options.pushConstantBuffers;
+    useFloat16Arithmetic    = options.float16Arithmetic
+                           && devFeatures.khrShaderFloat16Int8.shaderFloat16;
     
     // Disable early discard on RADV due to GPU hangs
     // Disable early discard on Nvidia because it may hurt performance
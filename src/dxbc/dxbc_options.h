@@ -21,6 +21,10 @@ namespace dxvk {
     /// shader invocations if derivatives remain valid.
     bool useSubgroupOpsForEarlyDiscard = false;
 
+    /// Use subgroup operations to perform only one
+    /// atomic UAV counter operation per subgroup.
+    bool useSubgroupOpsForAtomicCounters = false;
+
     /// Use SSBOs instead of texel buffers
     /// for raw and structured buffers.
     bool useRawSsbo = false;
@@ -34,6 +38,14 @@ namespace dxvk {
 
     /// Clear thread-group shared memory to zero
     bool zeroInitWorkgroupMemory = false;
+
+    /// Pass small, statically indexed constant
+    /// buffers to the shader via push constants
+    bool usePushConstantBuffers = false;
+
+    /// Perform arithmetic on min16float
+    /// operands with 16-bit precision
+    bool useFloat16Arithmetic = false;
   };
   
 }
\ No newline at end of file
@@ -44,6 +44,19 @@ namespace dxvk {
     return 0;
   }
   
+  DxbcPushConstantRange computePushConstantRange(
+          DxbcProgramType shaderStage) {
+    // Only vertex and pixel shaders tend to have small
+    // per-draw constant buffers, so the space available
+    // for graphics pipelines is split between the two.
+    switch (shaderStage) {
+      case DxbcProgramType::VertexShader:  return { 0,                       MaxPushConstantSize / 2 };
+      case DxbcProgramType::PixelShader:   return { MaxPushConstantSize / 2, MaxPushConstantSize / 2 };
+      case DxbcProgramType::ComputeShader: return { 0,                       MaxPushConstantSize     };
+      default:                             return { 0, 0 };
+    }
+  }
+  
   uint32_t primitiveVertexCount(DxbcPrimitive primitive) {
     static const std::array<uint32_t, 8> s_vertexCounts = {
        0, // Undefined
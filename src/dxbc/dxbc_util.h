@@ -34,6 +34,26 @@ namespace dxvk {
           DxbcBindingType bindingType,
           uint32_t        bindingIndex);
   
+  /**
+   * \brief Push constant range
+   */
+  struct DxbcPushConstantRange {
+    uint32_t offset;
+    uint32_t size;
+  };
+  
+  /**
+   * \brief Computes push constant range for a stage
+   * 
+   * Each shader stage gets its own, non-overlapping part
+   * of the push constant space, so that all stages of a
+   * graphics pipeline can use push constants at once.
+   * \param [in] shaderStage The target shader stage
+   * \returns Push constant range, may be empty
+   */
+  DxbcPushConstantRange computePushConstantRange(
+          DxbcProgramType shaderStage);
+  
   /**
    * \brief Primitive vertex count
    * 
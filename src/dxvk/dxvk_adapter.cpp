@@ -17,6 +17,7 @@ namespace dxvk {
     this->queryDeviceInfo();
     this->queryDeviceFeatures();
     this->queryDeviceQueues();
+    this->queryFormatProperties();
 
     m_hasMemoryBudget = m_deviceExtensions.supports(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
   }
@@ -70,6 +71,9 @@ namespace dxvk {
   
   
   VkFormatProperties DxvkAdapter::formatProperties(VkFormat format) const {
+    if (likely(uint32_t(format) < m_formatProperties.size()))
+      return m_formatProperties[format];
+
     VkFormatProperties formatProperties;
     m_vki->vkGetPhysicalDeviceFormatProperties(m_handle, format, &formatProperties);
     return formatProperties;
@@ -83,8 +87,24 @@ namespace dxvk {
     VkImageUsageFlags         usage,
     VkImageCreateFlags        flags,
     VkImageFormatProperties&  properties) const {
-    return m_vki->vkGetPhysicalDeviceImageFormatProperties(
+    DxvkImageFormatQuery query = { format, type, tiling, usage, flags };
+
+    std::lock_guard<std::mutex> lock(m_imageFormatLock);
+    auto entry = m_imageFormatCache.find(query);
+
+    if (entry != m_imageFormatCache.end()) {
+      properties = entry->second.properties;
+      return entry->second.result;
+    }
+
+    VkResult result = m_vki->vkGetPhysicalDeviceImageFormatProperties(
       m_handle, format, type, tiling, usage, flags, &properties);
+
+    // Do not cache errors that may be transient
+    if (result == VK_SUCCESS || result == VK_ERROR_FORMAT_NOT_SUPPORTED)
+      m_imageFormatCache.insert({ query, { result, properties } });
+
+    return result;
   }
   
     
@@ -226,7 +246,9 @@ namespace dxvk {
         && (m_deviceFeatures.extVertexAttributeDivisor.vertexAttributeInstanceRateDivisor
                 || !required.extVertexAttributeDivisor.vertexAttributeInstanceRateDivisor)
         && (m_deviceFeatures.extVertexAttributeDivisor.vertexAttributeInstanceRateZeroDivisor
-                || !required.extVertexAttributeDivisor.vertexAttributeInstanceRateZeroDivisor);
+                || !required.extVertexAttributeDivisor.vertexAttributeInstanceRateZeroDivisor)
+        && (m_deviceFeatures.khrShaderFloat16Int8.shaderFloat16
+                || !required.khrShaderFloat16Int8.shaderFloat16);
   }
   
   
@@ -238,7 +260,7 @@ namespace dxvk {
   Rc<DxvkDevice> DxvkAdapter::createDevice(std::string clientApi, DxvkDeviceFeatures enabledFeatures) {
     DxvkDeviceExtensions devExtensions;
 
-    std::array<DxvkExt*, 17> devExtensionList = {{
+    std::array<DxvkExt*, 18> devExtensionList = {{
       &devExtensions.amdMemoryOverallocationBehaviour,
       &devExtensions.extDepthClipEnable,
       &devExtensions.extHostQueryReset,
@@ -255,6 +277,7 @@ namespace dxvk {
       &devExtensions.khrMaintenance2,
       &devExtensions.khrSamplerMirrorClampToEdge,
       &devExtensions.khrShaderDrawParameters,
+      &devExtensions.khrShaderFloat16Int8,
       &devExtensions.khrSwapchain,
     }};
 
@@ -307,6 +330,12 @@ namespace dxvk {
       enabledFeatures.core.pNext = &enabledFeatures.extVertexAttributeDivisor;
     }
 
+    if (devExtensions.khrShaderFloat16Int8) {
+      enabledFeatures.khrShaderFloat16Int8.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FLOAT16_INT8_FEATURES_KHR;
+      enabledFeatures.khrShaderFloat16Int8.pNext = enabledFeatures.core.pNext;
+      enabledFeatures.core.pNext = &enabledFeatures.khrShaderFloat16Int8;
+    }
+
     // Report the desired overallocation behaviour to the driver
     VkDeviceMemoryOverallocationCreateInfoAMD overallocInfo;
     overallocInfo.sType = VK_STRUCTURE_TYPE_DEVICE_MEMORY_OVERALLOCATION_CREATE_INFO_AMD;
@@ -512,6 +541,11 @@ namespace dxvk {
       m_deviceFeatures.extVertexAttributeDivisor.pNext = std::exchange(m_deviceFeatures.core.pNext, &m_deviceFeatures.extVertexAttributeDivisor);
     }
 
+    if (m_deviceExtensions.supports(VK_KHR_SHADER_FLOAT16_INT8_EXTENSION_NAME)) {
+      m_deviceFeatures.khrShaderFloat16Int8.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FLOAT16_INT8_FEATURES_KHR;
+      m_deviceFeatures.khrShaderFloat16Int8.pNext = std::exchange(m_deviceFeatures.core.pNext, &m_deviceFeatures.khrShaderFloat16Int8);
+    }
+
     m_vki->vkGetPhysicalDeviceFeatures2KHR(m_handle, &m_deviceFeatures.core);
   }
 
@@ -527,6 +561,14 @@ namespace dxvk {
   }
   
   
+  void DxvkAdapter::queryFormatProperties() {
+    for (uint32_t i = 0; i < m_formatProperties.size(); i++) {
+      m_vki->vkGetPhysicalDeviceFormatProperties(
+        m_handle, VkFormat(i), &m_formatProperties[i]);
+    }
+  }
+  
+  
   void DxvkAdapter::logNameList(const DxvkNameList& names) {
     for (uint32_t i = 0; i < names.count(); i++)
       Logger::info(str::format("  ", names.name(i)));
@@ -2,6 +2,7 @@
 
 #include "dxvk_device_info.h"
 #include "dxvk_extensions.h"
+#include "dxvk_hash.h"
 #include "dxvk_include.h"
 
 namespace dxvk {
@@ -42,6 +43,46 @@ namespace dxvk {
     DxvkAdapterMemoryHeapInfo heaps[VK_MAX_MEMORY_HEAPS];
   };
   
+  /**
+   * \brief Image format query
+   * 
+   * Parameters of an image format property
+   * query. Used to look up cached results.
+   */
+  struct DxvkImageFormatQuery {
+    VkFormat            format;
+    VkImageType         type;
+    VkImageTiling       tiling;
+    VkImageUsageFlags   usage;
+    VkImageCreateFlags  flags;
+    
+    bool eq(const DxvkImageFormatQuery& other) const {
+      return format == other.format
+          && type   == other.type
+          && tiling == other.tiling
+          && usage  == other.usage
+          && flags  == other.flags;
+    }
+    
+    size_t hash() const {
+      DxvkHashState hash;
+      hash.add(uint32_t(format));
+      hash.add(uint32_t(type));
+      hash.add(uint32_t(tiling));
+      hash.add(usage);
+      hash.add(flags);
+      return hash;
+    }
+  };
+  
+  /**
+   * \brief Image format query result
+   */
+  struct DxvkImageFormatResult {
+    VkResult                result;
+    VkImageFormatProperties properties;
+  };
+  
   /**
    * \brief DXVK adapter
    * 
@@ -136,6 +177,9 @@ namespace dxvk {
     /**
      * \brief Queries format support
      * 
+     * Properties of core formats are queried once
+     * when creating the adapter, so this does not
+     * call into the driver for those formats.
      * \param [in] format The format to query
      * \returns Format support info
      */
@@ -145,6 +189,9 @@ namespace dxvk {
     /**
      * \brief Queries image format support
      * 
+     * Results are cached, so that repeated queries
+     * with the same parameters, e.g. from format
+     * support checks, do not call into the driver.
      * \param [in] format Format to query
      * \param [in] type Image type
      * \param [in] tiling Image tiling
@@ -266,6 +313,14 @@ namespace dxvk {
     
     std::vector<VkQueueFamilyProperties> m_queueFamilies;
 
+    std::array<VkFormatProperties, VK_FORMAT_RANGE_SIZE> m_formatProperties;
+
+    mutable std::mutex  m_imageFormatLock;
+    mutable std::unordered_map<
+      DxvkImageFormatQuery,
+      DxvkImageFormatResult,
+      DxvkHash, DxvkEq> m_imageFormatCache;
+
     std::array<std::atomic<VkDeviceSize>, VK_MAX_MEMORY_HEAPS> m_heapAlloc;
 
     void initHeapAllocInfo();
@@ -273,6 +328,7 @@ namespace dxvk {
     void queryDeviceInfo();
     void queryDeviceFeatures();
     void queryDeviceQueues();
+    void queryFormatProperties();
     
     static void logNameList(const DxvkNameList& names);
     
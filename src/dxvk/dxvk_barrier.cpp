@@ -2,8 +2,14 @@
 
 namespace dxvk {
   
-  DxvkBarrierSet:: DxvkBarrierSet() { }
-  DxvkBarrierSet::~DxvkBarrierSet() { }
+  DxvkBarrierSet:: DxvkBarrierSet(DxvkCmdBuffer cmdBuffer)
+  : m_cmdBuffer(cmdBuffer) {
+
+  }
+
+  DxvkBarrierSet::~DxvkBarrierSet() {
+
+  }
   
   void DxvkBarrierSet::accessBuffer(
     const DxvkBufferSliceHandle&    bufSlice,
@@ -183,7 +189,7 @@ namespace dxvk {
       if (m_srcAccess | m_dstAccess)
         pMemBarrier = &memBarrier;
       
-      commandList->cmdPipelineBarrier(
+      commandList->cmdPipelineBarrier(m_cmdBuffer,
         srcFlags, dstFlags, 0,
         pMemBarrier ? 1 : 0, pMemBarrier,
         m_bufBarriers.size(), m_bufBarriers.data(),
@@ -17,7 +17,7 @@ namespace dxvk {
     
   public:
     
-    DxvkBarrierSet();
+    DxvkBarrierSet(DxvkCmdBuffer cmdBuffer);
     ~DxvkBarrierSet();
         
     void accessBuffer(
@@ -70,6 +70,8 @@ namespace dxvk {
     
   private:
 
+    DxvkCmdBuffer m_cmdBuffer;
+
     struct BufSlice {
       DxvkBufferSliceHandle   slice;
       DxvkAccessFlags         access;
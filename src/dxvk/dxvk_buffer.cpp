@@ -83,12 +83,16 @@ namespace dxvk {
     vkd->vkGetBufferMemoryRequirements2KHR(
        vkd->device(), &memReqInfo, &memReq);
 
-    // Use high memory priority for GPU-writable resources
+    // Use high memory priority for GPU-writable resources, and
+    // low priority for buffers that get written by the CPU since
+    // those can be demoted to system memory with little impact
     bool isGpuWritable = (m_info.usage & (
       VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
       VK_BUFFER_USAGE_STORAGE_TEXEL_BUFFER_BIT)) != 0;
     
-    float priority = isGpuWritable ? 1.0f : 0.5f;
+    bool isCpuWritable = (m_memFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0;
+    
+    float priority = isGpuWritable ? 1.0f : (isCpuWritable ? 0.0f : 0.5f);
     
     // Ask driver whether we should be using a dedicated allocation
     bool useDedicated = dedicatedRequirements.prefersDedicatedAllocation;
@@ -102,6 +106,31 @@ namespace dxvk {
     
     return handle;
   }
+  
+  
+  DxvkBufferHandle DxvkBuffer::relocate() {
+    DxvkBufferHandle handle = allocBuffer(1);
+    
+    m_physSlice.handle = handle.buffer;
+    m_physSlice.offset = 0;
+    m_physSlice.length = m_physSliceLength;
+    m_physSlice.mapPtr = handle.memory.mapPtr(0);
+    
+    return std::exchange(m_buffer, std::move(handle));
+  }
+
+
+  DxvkRetiredBuffer::DxvkRetiredBuffer(
+    const Rc<vk::DeviceFn>&     vkd,
+          DxvkBufferHandle&&    handle)
+  : m_vkd(vkd), m_handle(std::move(handle)) {
+    
+  }
+  
+  
+  DxvkRetiredBuffer::~DxvkRetiredBuffer() {
+    m_vkd->vkDestroyBuffer(m_vkd->device(), m_handle.buffer, nullptr);
+  }
 
 
   
@@ -206,6 +206,42 @@ namespace dxvk {
       return std::exchange(m_physSlice, slice);
     }
     
+    /**
+     * \brief Checks whether the buffer should be relocated
+     * 
+     * This is the case if the buffer has never been renamed
+     * and its memory lives in a chunk that is currently being
+     * evacuated. Texel buffers are not relocated since views
+     * cache the Vulkan buffer handle they were created for.
+     * \returns \c true if the buffer can and should be moved
+     */
+    bool needsRelocation() const {
+      constexpr VkBufferUsageFlags requiredUsage
+        = VK_BUFFER_USAGE_TRANSFER_SRC_BIT
+        | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+      
+      constexpr VkBufferUsageFlags texelUsage
+        = VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT
+        | VK_BUFFER_USAGE_STORAGE_TEXEL_BUFFER_BIT;
+      
+      return m_buffer.memory.needsRelocation()
+          && m_buffers.empty()
+          && m_physSlice.handle == m_buffer.buffer
+          && (m_info.usage & requiredUsage) == requiredUsage
+          && !(m_info.usage & texelUsage);
+    }
+    
+    /**
+     * \brief Allocates new backing storage
+     * 
+     * Replaces the buffer's backing resource with a newly
+     * allocated one. The caller is responsible for copying
+     * the buffer contents and for keeping the returned
+     * resource alive until the GPU no longer uses it.
+     * \returns Previous backing resource
+     */
+    DxvkBufferHandle relocate();
+    
     /**
      * \brief Transform feedback vertex stride
      * 
@@ -309,6 +345,39 @@ namespace dxvk {
   };
   
   
+  /**
+   * \brief Retired buffer
+   * 
+   * Owns the previous backing resource of a buffer
+   * that got relocated, so that it can be destroyed
+   * as soon as the GPU no longer accesses it.
+   */
+  class DxvkRetiredBuffer : public DxvkResource {
+    
+  public:
+    
+    DxvkRetiredBuffer(
+      const Rc<vk::DeviceFn>&     vkd,
+            DxvkBufferHandle&&    handle);
+    
+    ~DxvkRetiredBuffer();
+    
+    /**
+     * \brief Buffer handle
+     * \returns Buffer handle
+     */
+    VkBuffer handle() const {
+      return m_handle.buffer;
+    }
+    
+  private:
+    
+    Rc<vk::DeviceFn>  m_vkd;
+    DxvkBufferHandle  m_handle;
+    
+  };
+  
+  
   /**
    * \brief Buffer slice
    * 
@@ -55,9 +55,9 @@ namespace dxvk {
     std::array<VkCommandBuffer, 2> cmdBuffers;
     uint32_t cmdBufferCount = 0;
     
-    if (m_cmdBuffersUsed.test(DxvkCmdBufferFlag::InitBuffer))
+    if (m_cmdBuffersUsed.test(DxvkCmdBuffer::InitBuffer))
       cmdBuffers[cmdBufferCount++] = m_initBuffer;
-    if (m_cmdBuffersUsed.test(DxvkCmdBufferFlag::ExecBuffer))
+    if (m_cmdBuffersUsed.test(DxvkCmdBuffer::ExecBuffer))
       cmdBuffers[cmdBufferCount++] = m_execBuffer;
     
     const VkPipelineStageFlags waitStageMask
@@ -110,7 +110,7 @@ namespace dxvk {
     
     // Unconditionally mark the exec buffer as used. There
     // is virtually no use case where this isn't correct.
-    m_cmdBuffersUsed.set(DxvkCmdBufferFlag::ExecBuffer);
+    m_cmdBuffersUsed.set(DxvkCmdBuffer::ExecBuffer);
   }
   
   
@@ -139,6 +139,7 @@ namespace dxvk {
   
   
   void DxvkCommandList::stagedBufferCopy(
+          DxvkCmdBuffer           cmdBuffer,
           VkBuffer                dstBuffer,
           VkDeviceSize            dstOffset,
           VkDeviceSize            dataSize,
@@ -148,7 +149,7 @@ namespace dxvk {
     region.dstOffset = dstOffset;
     region.size      = dataSize;
     
-    m_vkd->vkCmdCopyBuffer(m_execBuffer,
+    m_vkd->vkCmdCopyBuffer(getCmdBuffer(cmdBuffer),
       dataSlice.buffer, dstBuffer, 1, &region);
   }
   
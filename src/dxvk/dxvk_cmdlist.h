@@ -17,17 +17,20 @@
 namespace dxvk {
   
   /**
-   * \brief Command buffer flags
+   * \brief Command buffer
    * 
-   * A set of flags used to specify which of
-   * the command buffers need to be submitted.
+   * Identifies one of the command buffers of a command
+   * list. Commands recorded into the init buffer are
+   * executed before any commands in the exec buffer.
+   * Also used as flags to specify which of the command
+   * buffers need to be submitted.
    */
-  enum class DxvkCmdBufferFlag : uint32_t {
+  enum class DxvkCmdBuffer : uint32_t {
     InitBuffer = 0,
     ExecBuffer = 1,
   };
   
-  using DxvkCmdBufferFlags = Flags<DxvkCmdBufferFlag>;
+  using DxvkCmdBufferFlags = Flags<DxvkCmdBuffer>;
   
   /**
    * \brief DXVK command list
@@ -69,6 +72,31 @@ namespace dxvk {
      */
     VkResult synchronize();
     
+    /**
+     * \brief Submission sequence number
+     * 
+     * Assigned by the device when the command
+     * list gets submitted. Sequence numbers are
+     * monotonically increasing across the device.
+     * \returns Submission sequence number
+     */
+    uint64_t submissionId() const {
+      return m_submissionId;
+    }
+    
+    /**
+     * \brief Sets submission sequence number
+     * 
+     * Stores the sequence number and updates all
+     * resources tracked by the command list so
+     * that their completion can be queried.
+     * \param [in] submissionId Submission sequence number
+     */
+    void notifySubmission(uint64_t submissionId) {
+      m_submissionId = submissionId;
+      m_resources.notify(submissionId);
+    }
+    
     /**
      * \brief Stat counters
      * 
@@ -213,6 +241,12 @@ namespace dxvk {
     }
     
     
+    void cmdBeginDebugUtilsLabel(
+      const VkDebugUtilsLabelEXT*   pLabelInfo) {
+      m_vkd->vkCmdBeginDebugUtilsLabelEXT(m_execBuffer, pLabelInfo);
+    }
+    
+    
     void cmdBeginQuery(
             VkQueryPool             queryPool,
             uint32_t                query,
@@ -351,11 +385,12 @@ namespace dxvk {
     
     
     void cmdCopyBuffer(
+            DxvkCmdBuffer           cmdBuffer,
             VkBuffer                srcBuffer,
             VkBuffer                dstBuffer,
             uint32_t                regionCount,
       const VkBufferCopy*           pRegions) {
-      m_vkd->vkCmdCopyBuffer(m_execBuffer,
+      m_vkd->vkCmdCopyBuffer(getCmdBuffer(cmdBuffer),
         srcBuffer, dstBuffer,
         regionCount, pRegions);
     }
@@ -472,6 +507,11 @@ namespace dxvk {
     }
     
     
+    void cmdEndDebugUtilsLabel() {
+      m_vkd->vkCmdEndDebugUtilsLabelEXT(m_execBuffer);
+    }
+    
+    
     void cmdEndQuery(
             VkQueryPool             queryPool,
             uint32_t                query) {
@@ -504,16 +544,24 @@ namespace dxvk {
 
 
     void cmdFillBuffer(
+            DxvkCmdBuffer           cmdBuffer,
             VkBuffer                dstBuffer,
             VkDeviceSize            dstOffset,
             VkDeviceSize            size,
             uint32_t                data) {
-      m_vkd->vkCmdFillBuffer(m_execBuffer,
+      m_vkd->vkCmdFillBuffer(getCmdBuffer(cmdBuffer),
         dstBuffer, dstOffset, size, data);
     }
     
     
+    void cmdInsertDebugUtilsLabel(
+      const VkDebugUtilsLabelEXT*   pLabelInfo) {
+      m_vkd->vkCmdInsertDebugUtilsLabelEXT(m_execBuffer, pLabelInfo);
+    }
+    
+    
     void cmdPipelineBarrier(
+            DxvkCmdBuffer           cmdBuffer,
             VkPipelineStageFlags    srcStageMask,
             VkPipelineStageFlags    dstStageMask,
             VkDependencyFlags       dependencyFlags,
@@ -523,7 +571,7 @@ namespace dxvk {
       const VkBufferMemoryBarrier*  pBufferMemoryBarriers,
             uint32_t                imageMemoryBarrierCount,
       const VkImageMemoryBarrier*   pImageMemoryBarriers) {
-      m_vkd->vkCmdPipelineBarrier(m_execBuffer,
+      m_vkd->vkCmdPipelineBarrier(getCmdBuffer(cmdBuffer),
         srcStageMask, dstStageMask, dependencyFlags,
         memoryBarrierCount,       pMemoryBarriers,
         bufferMemoryBarrierCount, pBufferMemoryBarriers,
@@ -550,7 +598,7 @@ namespace dxvk {
         m_vkd->vkResetQueryPoolEXT(
           m_vkd->device(), queryPool, queryId, 1);
       } else {
-        m_cmdBuffersUsed.set(DxvkCmdBufferFlag::InitBuffer);
+        m_cmdBuffersUsed.set(DxvkCmdBuffer::InitBuffer);
 
         m_vkd->vkResetEvent(
           m_vkd->device(), event);
@@ -568,7 +616,7 @@ namespace dxvk {
             VkQueryPool             queryPool,
             uint32_t                firstQuery,
             uint32_t                queryCount) {
-      m_cmdBuffersUsed.set(DxvkCmdBufferFlag::InitBuffer);
+      m_cmdBuffersUsed.set(DxvkCmdBuffer::InitBuffer);
       
       m_vkd->vkCmdResetQueryPool(m_initBuffer,
         queryPool, firstQuery, queryCount);
@@ -590,11 +638,12 @@ namespace dxvk {
     
     
     void cmdUpdateBuffer(
+            DxvkCmdBuffer           cmdBuffer,
             VkBuffer                dstBuffer,
             VkDeviceSize            dstOffset,
             VkDeviceSize            dataSize,
       const void*                   pData) {
-      m_vkd->vkCmdUpdateBuffer(m_execBuffer,
+      m_vkd->vkCmdUpdateBuffer(getCmdBuffer(cmdBuffer),
         dstBuffer, dstOffset, dataSize, pData);
     }
     
@@ -631,6 +680,14 @@ namespace dxvk {
     }
     
     
+    void cmdSetStencilCompareMask(
+            VkStencilFaceFlags      faceMask,
+            uint32_t                compareMask) {
+      m_vkd->vkCmdSetStencilCompareMask(m_execBuffer,
+        faceMask, compareMask);
+    }
+    
+    
     void cmdSetStencilReference(
             VkStencilFaceFlags      faceMask,
             uint32_t                reference) {
@@ -639,6 +696,14 @@ namespace dxvk {
     }
     
     
+    void cmdSetStencilWriteMask(
+            VkStencilFaceFlags      faceMask,
+            uint32_t                writeMask) {
+      m_vkd->vkCmdSetStencilWriteMask(m_execBuffer,
+        faceMask, writeMask);
+    }
+    
+    
     void cmdSetViewport(
             uint32_t                firstViewport,
             uint32_t                viewportCount,
@@ -662,6 +727,7 @@ namespace dxvk {
     
     
     void stagedBufferCopy(
+            DxvkCmdBuffer           cmdBuffer,
             VkBuffer                dstBuffer,
             VkDeviceSize            dstOffset,
             VkDeviceSize            dataSize,
@@ -679,6 +745,7 @@ namespace dxvk {
     Rc<vk::DeviceFn>    m_vkd;
     
     VkFence             m_fence;
+    uint64_t            m_submissionId = 0;
     
     VkCommandPool       m_pool;
     VkCommandBuffer     m_execBuffer;
@@ -694,6 +761,14 @@ namespace dxvk {
     DxvkBufferTracker   m_bufferTracker;
     DxvkStatCounters    m_statCounters;
     
+    VkCommandBuffer getCmdBuffer(DxvkCmdBuffer cmdBuffer) {
+      if (cmdBuffer == DxvkCmdBuffer::ExecBuffer)
+        return m_execBuffer;
+      
+      m_cmdBuffersUsed.set(cmdBuffer);
+      return m_initBuffer;
+    }
+    
   };
   
 }
\ No newline at end of file
@@ -34,10 +34,13 @@ namespace dxvk {
     m_layout = new DxvkPipelineLayout(m_vkd,
       slotMapping.bindingCount(),
       slotMapping.bindingInfos(),
+      slotMapping.pushConstSlotCount(),
+      slotMapping.pushConstSlotInfos(),
       VK_PIPELINE_BIND_POINT_COMPUTE);
     
     DxvkShaderModuleCreateInfo moduleInfo;
     moduleInfo.fsDualSrcBlend = false;
+    moduleInfo.unusedOutputs  = 0;
 
     m_cs = cs->createShaderModule(m_vkd, slotMapping, moduleInfo);
   }
@@ -51,6 +54,8 @@ namespace dxvk {
   
   VkPipeline DxvkComputePipeline::getPipelineHandle(
     const DxvkComputePipelineStateInfo& state) {
+    DXVK_TRACE_ZONE("DxvkComputePipeline::getPipelineHandle");
+
     VkPipeline newPipelineHandle = VK_NULL_HANDLE;
 
     { std::lock_guard<sync::Spinlock> lock(m_mutex);
@@ -94,6 +99,8 @@ namespace dxvk {
   VkPipeline DxvkComputePipeline::compilePipeline(
     const DxvkComputePipelineStateInfo& state,
           VkPipeline                    baseHandle) const {
+    DXVK_TRACE_ZONE("DxvkComputePipeline::compilePipeline");
+
     std::vector<VkDescriptorSetLayoutBinding> bindings;
 
     if (Logger::logLevel() <= LogLevel::Debug) {
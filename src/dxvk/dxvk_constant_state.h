@@ -53,6 +53,34 @@ namespace dxvk {
   };
   
   
+  /**
+   * \brief Stencil masks
+   * 
+   * Stores the stencil compare and
+   * write masks for both faces.
+   */
+  struct DxvkStencilMasks {
+    uint32_t            compareMaskFront;
+    uint32_t            writeMaskFront;
+    uint32_t            compareMaskBack;
+    uint32_t            writeMaskBack;
+
+    bool operator == (const DxvkStencilMasks& other) const {
+      return compareMaskFront == other.compareMaskFront
+          && writeMaskFront   == other.writeMaskFront
+          && compareMaskBack  == other.compareMaskBack
+          && writeMaskBack    == other.writeMaskBack;
+    }
+
+    bool operator != (const DxvkStencilMasks& other) const {
+      return compareMaskFront != other.compareMaskFront
+          || writeMaskFront   != other.writeMaskFront
+          || compareMaskBack  != other.compareMaskBack
+          || writeMaskBack    != other.writeMaskBack;
+    }
+  };
+  
+  
   /**
    * \brief Input assembly state
    * 
@@ -24,6 +24,9 @@ namespace dxvk {
     m_metaMipGen  (metaMipGenObjects),
     m_metaPack    (metaPackObjects),
     m_metaResolve (metaResolveObjects),
+    m_barriers    (DxvkCmdBuffer::ExecBuffer),
+    m_transitions (DxvkCmdBuffer::ExecBuffer),
+    m_initBarriers(DxvkCmdBuffer::InitBuffer),
     m_queryManager(gpuQueryPool) {
 
   }
@@ -38,6 +41,16 @@ namespace dxvk {
     m_cmd = cmdList;
     m_cmd->beginRecording();
     
+    // Debug labels cannot span multiple command buffers,
+    // so re-open the ones closed in the previous one
+    if (m_device->gpuProfiler()->hasDebugLabels()) {
+      for (const auto& region : m_debugRegions) {
+        VkDebugUtilsLabelEXT label = { VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT };
+        label.pLabelName = region.name.c_str();
+        m_cmd->cmdBeginDebugUtilsLabel(&label);
+      }
+    }
+    
     // The current state of the internal command buffer is
     // undefined, so we have to bind and set up everything
     // before any draw or dispatch command is recorded.
@@ -68,6 +81,12 @@ namespace dxvk {
     this->spillRenderPass();
     
     m_barriers.recordCommands(m_cmd);
+    m_initBarriers.recordCommands(m_cmd);
+
+    if (m_device->gpuProfiler()->hasDebugLabels()) {
+      for (size_t i = 0; i < m_debugRegions.size(); i++)
+        m_cmd->cmdEndDebugUtilsLabel();
+    }
 
     m_cmd->endRecording();
     return std::exchange(m_cmd, nullptr);
@@ -86,11 +105,13 @@ namespace dxvk {
   
   
   void DxvkContext::beginQuery(const Rc<DxvkGpuQuery>& query) {
+    this->flushClearBatch();
     m_queryManager.enableQuery(m_cmd, query);
   }
 
 
   void DxvkContext::endQuery(const Rc<DxvkGpuQuery>& query) {
+    this->flushClearBatch();
     m_queryManager.disableQuery(m_cmd, query);
   }
   
@@ -142,6 +163,8 @@ namespace dxvk {
       m_state.vi.indexBuffer = buffer;
       m_state.vi.indexType   = indexType;
       
+      this->trackBufferRelocation(buffer.buffer());
+      
       m_flags.set(DxvkContextFlag::GpDirtyIndexBuffer);
     }
   }
@@ -153,9 +176,13 @@ namespace dxvk {
     if (!m_rc[slot].bufferSlice.matches(buffer)) {
       m_rc[slot].bufferSlice = buffer;
       
+      this->trackBufferRelocation(buffer.buffer());
+      
       m_flags.set(
         DxvkContextFlag::CpDirtyResources,
-        DxvkContextFlag::GpDirtyResources);
+        DxvkContextFlag::GpDirtyResources,
+        DxvkContextFlag::CpDirtyPushConstants,
+        DxvkContextFlag::GpDirtyPushConstants);
     }
   }
   
@@ -231,6 +258,7 @@ namespace dxvk {
           uint32_t              stride) {
     if (!m_state.vi.vertexBuffers[binding].matches(buffer)) {
       m_state.vi.vertexBuffers[binding] = buffer;
+      this->trackBufferRelocation(buffer.buffer());
       m_flags.set(DxvkContextFlag::GpDirtyVertexBuffers);
     }
     
@@ -259,13 +287,17 @@ namespace dxvk {
           VkDeviceSize          offset,
           VkDeviceSize          length,
           uint32_t              value) {
-    this->spillRenderPass();
-    
     length = align(length, sizeof(uint32_t));
+
+    DxvkCmdBuffer cmdBuffer = this->prepareBufferWrite(buffer, offset, length);
+    DxvkBarrierSet& barriers = cmdBuffer == DxvkCmdBuffer::InitBuffer
+      ? m_initBarriers
+      : m_barriers;
+
     auto slice = buffer->getSliceHandle(offset, length);
 
-    if (m_barriers.isBufferDirty(slice, DxvkAccess::Write))
-      m_barriers.recordCommands(m_cmd);
+    if (barriers.isBufferDirty(slice, DxvkAccess::Write))
+      barriers.recordCommands(m_cmd);
     
     constexpr VkDeviceSize updateThreshold = 256;
 
@@ -275,20 +307,20 @@ namespace dxvk {
       for (uint32_t i = 0; i < length / sizeof(uint32_t); i++)
         data[i] = value;
       
-      m_cmd->cmdUpdateBuffer(
+      m_cmd->cmdUpdateBuffer(cmdBuffer,
         slice.handle,
         slice.offset,
         slice.length,
         data.data());
     } else {
-      m_cmd->cmdFillBuffer(
+      m_cmd->cmdFillBuffer(cmdBuffer,
         slice.handle,
         slice.offset,
         slice.length,
         value);
     }
     
-    m_barriers.accessBuffer(slice,
+    barriers.accessBuffer(slice,
       VK_PIPELINE_STAGE_TRANSFER_BIT,
       VK_ACCESS_TRANSFER_WRITE_BIT,
       buffer->info().stages,
@@ -515,6 +547,8 @@ namespace dxvk {
     const VkClearValue&         clearValue) {
     this->updateFramebuffer();
 
+    m_cmd->addStatCtr(DxvkStatCounter::CmdClearCountFb, 1);
+
     // Prepare attachment ops
     DxvkColorAttachmentOps colorOp;
     colorOp.loadOp        = VK_ATTACHMENT_LOAD_OP_LOAD;
@@ -648,12 +682,23 @@ namespace dxvk {
           VkOffset3D            offset,
           VkExtent3D            extent,
           VkClearValue          value) {
-    const VkImageUsageFlags viewUsage = imageView->info().usage;
-
-    if (viewUsage & (VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT))
-      this->clearImageViewFb(imageView, offset, extent, value);
-    else if (viewUsage & VK_IMAGE_USAGE_STORAGE_BIT)
-      this->clearImageViewCs(imageView, offset, extent, value);
+    VkRect2D rect;
+    rect.offset = { offset.x, offset.y };
+    rect.extent = { extent.width, extent.height };
+    
+    this->clearImageViewRegion(imageView,
+      offset.z, extent.depth, 1, &rect, value);
+  }
+  
+  
+  void DxvkContext::clearImageViewRects(
+    const Rc<DxvkImageView>&    imageView,
+          uint32_t              rectCount,
+    const VkRect2D*             rects,
+          VkClearValue          value) {
+    this->clearImageViewRegion(imageView,
+      0, imageView->mipLevelExtent(0).depth,
+      rectCount, rects, value);
   }
   
   
@@ -680,7 +725,7 @@ namespace dxvk {
     bufferRegion.dstOffset = dstSlice.offset;
     bufferRegion.size      = dstSlice.length;
 
-    m_cmd->cmdCopyBuffer(
+    m_cmd->cmdCopyBuffer(DxvkCmdBuffer::ExecBuffer,
       srcSlice.handle,
       dstSlice.handle,
       1, &bufferRegion);
@@ -1074,6 +1119,31 @@ namespace dxvk {
   }
   
   
+  void DxvkContext::defragmentMemory() {
+    const VkDeviceSize maxBytes = VkDeviceSize(std::max(
+      m_device->config().defragMemoryPerFrame, 0)) << 20;
+    
+    if (!maxBytes)
+      return;
+    
+    m_device->updateMemoryDefragmentation();
+    
+    // Buffers that have been moved in the meantime, e.g. because
+    // they were bound multiple times, are skipped automatically
+    VkDeviceSize bytesMoved = 0;
+    
+    while (!m_relocations.empty() && bytesMoved < maxBytes) {
+      Rc<DxvkBuffer> buffer = std::move(m_relocations.back());
+      m_relocations.pop_back();
+      
+      if (buffer->needsRelocation()) {
+        this->relocateBuffer(buffer);
+        bytesMoved += buffer->info().size;
+      }
+    }
+  }
+  
+  
   void DxvkContext::discardBuffer(
     const Rc<DxvkBuffer>&       buffer) {
     if (m_barriers.isBufferDirty(buffer->getSliceHandle(), DxvkAccess::Write))
@@ -1099,6 +1169,75 @@ namespace dxvk {
   }
 
 
+  void DxvkContext::discardImageView(
+    const Rc<DxvkImageView>&      imageView,
+          VkImageAspectFlags      discardAspects) {
+    this->updateFramebuffer();
+
+    int32_t attachmentIndex = -1;
+
+    if (m_state.om.framebuffer != nullptr
+     && m_state.om.framebuffer->isFullSize(imageView))
+      attachmentIndex = m_state.om.framebuffer->findAttachment(imageView);
+
+    if (attachmentIndex < 0) {
+      this->discardImage(
+        imageView->image(),
+        imageView->subresources());
+      return;
+    }
+
+    // If the render pass is already active, the attachment
+    // will be stored either way, and ending the render pass
+    // early would only add load and store operations.
+    if (m_flags.test(DxvkContextFlag::GpRenderPassBound))
+      return;
+
+    // Don't load the attachment when starting the next render
+    // pass. Any pending clear on the attachment is discarded.
+    bool discardLayout = discardAspects == imageView->info().aspect
+      && imageView->imageInfo().type != VK_IMAGE_TYPE_3D;
+
+    for (uint32_t i = 0; i < MaxNumRenderTargets; i++) {
+      if (m_state.om.renderTargets.color[i].view == imageView
+       && (discardAspects & VK_IMAGE_ASPECT_COLOR_BIT)) {
+        m_state.om.renderPassOps.colorOps[i].loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+
+        if (discardLayout)
+          m_state.om.renderPassOps.colorOps[i].loadLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+      }
+    }
+
+    if (m_state.om.renderTargets.depth.view == imageView) {
+      DxvkDepthAttachmentOps& depthOps = m_state.om.renderPassOps.depthOps;
+
+      if (discardAspects & VK_IMAGE_ASPECT_DEPTH_BIT)
+        depthOps.loadOpD = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+
+      if (discardAspects & VK_IMAGE_ASPECT_STENCIL_BIT)
+        depthOps.loadOpS = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+
+      // The layout can only be discarded if none of
+      // the view's aspects need to be preserved
+      VkImageAspectFlags viewAspects = imageView->info().aspect;
+
+      bool preserveD = (viewAspects & VK_IMAGE_ASPECT_DEPTH_BIT)
+        && depthOps.loadOpD == VK_ATTACHMENT_LOAD_OP_LOAD;
+      bool preserveS = (viewAspects & VK_IMAGE_ASPECT_STENCIL_BIT)
+        && depthOps.loadOpS == VK_ATTACHMENT_LOAD_OP_LOAD;
+
+      if (!preserveD && !preserveS
+       && imageView->imageInfo().type != VK_IMAGE_TYPE_3D)
+        depthOps.loadLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    }
+
+    // Track the discard like a pending clear, so that the render
+    // pass ops get applied and reset before any other command
+    // accesses the image outside of a render pass.
+    m_flags.set(DxvkContextFlag::GpClearRenderTargets);
+  }
+
+
   void DxvkContext::dispatch(
           uint32_t x,
           uint32_t y,
@@ -1388,6 +1527,14 @@ namespace dxvk {
     DxvkBufferSliceHandle prevSlice = buffer->rename(slice);
     m_cmd->freeBufferSlice(buffer, prevSlice);
     
+    this->invalidateBufferBindings(buffer, prevSlice, slice);
+  }
+  
+  
+  void DxvkContext::invalidateBufferBindings(
+    const Rc<DxvkBuffer>&           buffer,
+    const DxvkBufferSliceHandle&    prevSlice,
+    const DxvkBufferSliceHandle&    slice) {
     // We also need to update all bindings that the buffer
     // may be bound to either directly or through views.
     const VkBufferUsageFlags usage = buffer->info().usage;
@@ -1410,6 +1557,11 @@ namespace dxvk {
                   DxvkContextFlag::CpDirtyResources);
     }
 
+    if (usage & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT) {
+      m_flags.set(DxvkContextFlag::GpDirtyPushConstants,
+                  DxvkContextFlag::CpDirtyPushConstants);
+    }
+
     if (usage & (VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT
                | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT)) {
       if (prevSlice.handle != slice.handle) {
@@ -1477,8 +1629,11 @@ namespace dxvk {
           VkDeviceSize              offset,
           VkDeviceSize              size,
     const void*                     data) {
-    this->spillRenderPass();
-    
+    DxvkCmdBuffer cmdBuffer = this->prepareBufferWrite(buffer, offset, size);
+    DxvkBarrierSet& barriers = cmdBuffer == DxvkCmdBuffer::InitBuffer
+      ? m_initBarriers
+      : m_barriers;
+
     // Vulkan specifies that small amounts of data (up to 64kB) can
     // be copied to a buffer directly if the size is a multiple of
     // four. Anything else must be copied through a staging buffer.
@@ -1486,11 +1641,11 @@ namespace dxvk {
     // reasonably small, we do not know how much data apps may upload.
     auto bufferSlice = buffer->getSliceHandle(offset, size);
 
-    if (m_barriers.isBufferDirty(bufferSlice, DxvkAccess::Write))
-      m_barriers.recordCommands(m_cmd);
+    if (barriers.isBufferDirty(bufferSlice, DxvkAccess::Write))
+      barriers.recordCommands(m_cmd);
     
     if ((size <= 4096) && ((size & 0x3) == 0) && ((offset & 0x3) == 0)) {
-      m_cmd->cmdUpdateBuffer(
+      m_cmd->cmdUpdateBuffer(cmdBuffer,
         bufferSlice.handle,
         bufferSlice.offset,
         bufferSlice.length,
@@ -1499,14 +1654,14 @@ namespace dxvk {
       auto slice = m_cmd->stagedAlloc(size);
       std::memcpy(slice.mapPtr, data, size);
 
-      m_cmd->stagedBufferCopy(
+      m_cmd->stagedBufferCopy(cmdBuffer,
         bufferSlice.handle,
         bufferSlice.offset,
         bufferSlice.length,
         slice);
     }
 
-    m_barriers.accessBuffer(
+    barriers.accessBuffer(
       bufferSlice,
       VK_PIPELINE_STAGE_TRANSFER_BIT,
       VK_ACCESS_TRANSFER_WRITE_BIT,
@@ -1606,8 +1761,8 @@ namespace dxvk {
           uint32_t            viewportCount,
     const VkViewport*         viewports,
     const VkRect2D*           scissorRects) {
-    if (m_state.gp.state.rsViewportCount != viewportCount) {
-      m_state.gp.state.rsViewportCount = viewportCount;
+    if (m_state.gp.state.rs.viewportCount() != viewportCount) {
+      m_state.gp.state.rs.setViewportCount(viewportCount);
       m_flags.set(DxvkContextFlag::GpDirtyPipelineState);
     }
     
@@ -1655,9 +1810,10 @@ namespace dxvk {
   
   
   void DxvkContext::setInputAssemblyState(const DxvkInputAssemblyState& ia) {
-    m_state.gp.state.iaPrimitiveTopology = ia.primitiveTopology;
-    m_state.gp.state.iaPrimitiveRestart  = ia.primitiveRestart;
-    m_state.gp.state.iaPatchVertexCount  = ia.patchVertexCount;
+    m_state.gp.state.ia = DxvkIaInfo(
+      ia.primitiveTopology,
+      ia.primitiveRestart,
+      ia.patchVertexCount);
     
     m_flags.set(DxvkContextFlag::GpDirtyPipelineState);
   }
@@ -1673,65 +1829,90 @@ namespace dxvk {
       DxvkContextFlag::GpDirtyVertexBuffers);
     
     for (uint32_t i = 0; i < attributeCount; i++) {
-      m_state.gp.state.ilAttributes[i].location = attributes[i].location;
-      m_state.gp.state.ilAttributes[i].binding  = attributes[i].binding;
-      m_state.gp.state.ilAttributes[i].format   = attributes[i].format;
-      m_state.gp.state.ilAttributes[i].offset   = attributes[i].offset;
+      m_state.gp.state.ilAttributes[i] = DxvkIlAttribute(
+        attributes[i].location,
+        attributes[i].binding,
+        attributes[i].format,
+        attributes[i].offset);
     }
     
-    for (uint32_t i = attributeCount; i < m_state.gp.state.ilAttributeCount; i++)
-      m_state.gp.state.ilAttributes[i] = VkVertexInputAttributeDescription();
+    for (uint32_t i = attributeCount; i < m_state.gp.state.il.attributeCount(); i++)
+      m_state.gp.state.ilAttributes[i] = DxvkIlAttribute();
     
     for (uint32_t i = 0; i < bindingCount; i++) {
-      m_state.gp.state.ilBindings[i].binding    = bindings[i].binding;
-      m_state.gp.state.ilBindings[i].inputRate  = bindings[i].inputRate;
-      m_state.gp.state.ilDivisors[i]            = bindings[i].fetchRate;
+      m_state.gp.state.ilBindings[i] = DxvkIlBinding(
+        bindings[i].binding, 0,
+        bindings[i].inputRate,
+        bindings[i].fetchRate);
     }
     
-    for (uint32_t i = bindingCount; i < m_state.gp.state.ilBindingCount; i++)
-      m_state.gp.state.ilBindings[i] = VkVertexInputBindingDescription();
+    for (uint32_t i = bindingCount; i < m_state.gp.state.il.bindingCount(); i++)
+      m_state.gp.state.ilBindings[i] = DxvkIlBinding();
     
-    m_state.gp.state.ilAttributeCount = attributeCount;
-    m_state.gp.state.ilBindingCount   = bindingCount;
+    m_state.gp.state.il = DxvkIlInfo(attributeCount, bindingCount);
   }
   
   
   void DxvkContext::setRasterizerState(const DxvkRasterizerState& rs) {
-    m_state.gp.state.rsDepthClipEnable   = rs.depthClipEnable;
-    m_state.gp.state.rsDepthBiasEnable   = rs.depthBiasEnable;
-    m_state.gp.state.rsPolygonMode       = rs.polygonMode;
-    m_state.gp.state.rsCullMode          = rs.cullMode;
-    m_state.gp.state.rsFrontFace         = rs.frontFace;
-    m_state.gp.state.rsSampleCount       = rs.sampleCount;
+    m_state.gp.state.rs = DxvkRsInfo(
+      rs.depthClipEnable,
+      rs.depthBiasEnable,
+      rs.polygonMode,
+      rs.cullMode,
+      rs.frontFace,
+      m_state.gp.state.rs.viewportCount(),
+      rs.sampleCount);
 
     m_flags.set(DxvkContextFlag::GpDirtyPipelineState);
   }
   
   
   void DxvkContext::setMultisampleState(const DxvkMultisampleState& ms) {
-    m_state.gp.state.msSampleMask            = ms.sampleMask;
-    m_state.gp.state.msEnableAlphaToCoverage = ms.enableAlphaToCoverage;
-    m_state.gp.state.msEnableAlphaToOne      = ms.enableAlphaToOne;
+    m_state.gp.state.ms = DxvkMsInfo(
+      m_state.gp.state.ms.sampleCount(),
+      ms.sampleMask,
+      ms.enableAlphaToCoverage,
+      ms.enableAlphaToOne);
     
     m_flags.set(DxvkContextFlag::GpDirtyPipelineState);
   }
   
   
   void DxvkContext::setDepthStencilState(const DxvkDepthStencilState& ds) {
-    m_state.gp.state.dsEnableDepthTest   = ds.enableDepthTest;
-    m_state.gp.state.dsEnableDepthWrite  = ds.enableDepthWrite;
-    m_state.gp.state.dsEnableStencilTest = ds.enableStencilTest;
-    m_state.gp.state.dsDepthCompareOp    = ds.depthCompareOp;
-    m_state.gp.state.dsStencilOpFront    = ds.stencilOpFront;
-    m_state.gp.state.dsStencilOpBack     = ds.stencilOpBack;
+    m_state.gp.state.ds = DxvkDsInfo(
+      ds.enableDepthTest,
+      ds.enableDepthWrite,
+      ds.enableStencilTest,
+      ds.depthCompareOp);
+    
+    // Stencil ops only matter if the stencil test is enabled
+    m_state.gp.state.dsFront = ds.enableStencilTest
+      ? DxvkDsStencilOp(ds.stencilOpFront)
+      : DxvkDsStencilOp();
+    m_state.gp.state.dsBack  = ds.enableStencilTest
+      ? DxvkDsStencilOp(ds.stencilOpBack)
+      : DxvkDsStencilOp();
+    
+    // Stencil masks are dynamic state
+    DxvkStencilMasks stencilMasks;
+    stencilMasks.compareMaskFront = ds.stencilOpFront.compareMask;
+    stencilMasks.writeMaskFront   = ds.stencilOpFront.writeMask;
+    stencilMasks.compareMaskBack  = ds.stencilOpBack.compareMask;
+    stencilMasks.writeMaskBack    = ds.stencilOpBack.writeMask;
+    
+    if (m_state.dyn.stencilMasks != stencilMasks) {
+      m_state.dyn.stencilMasks = stencilMasks;
+      m_flags.set(DxvkContextFlag::GpDirtyStencilMask);
+    }
     
     m_flags.set(DxvkContextFlag::GpDirtyPipelineState);
   }
   
   
   void DxvkContext::setLogicOpState(const DxvkLogicOpState& lo) {
-    m_state.gp.state.omEnableLogicOp = lo.enableLogicOp;
-    m_state.gp.state.omLogicOp       = lo.logicOp;
+    m_state.gp.state.om = DxvkOmInfo(
+      lo.enableLogicOp,
+      lo.logicOp);
     
     m_flags.set(DxvkContextFlag::GpDirtyPipelineState);
   }
@@ -1740,14 +1921,15 @@ namespace dxvk {
   void DxvkContext::setBlendMode(
           uint32_t            attachment,
     const DxvkBlendMode&      blendMode) {
-    m_state.gp.state.omBlendAttachments[attachment].blendEnable         = blendMode.enableBlending;
-    m_state.gp.state.omBlendAttachments[attachment].srcColorBlendFactor = blendMode.colorSrcFactor;
-    m_state.gp.state.omBlendAttachments[attachment].dstColorBlendFactor = blendMode.colorDstFactor;
-    m_state.gp.state.omBlendAttachments[attachment].colorBlendOp        = blendMode.colorBlendOp;
-    m_state.gp.state.omBlendAttachments[attachment].srcAlphaBlendFactor = blendMode.alphaSrcFactor;
-    m_state.gp.state.omBlendAttachments[attachment].dstAlphaBlendFactor = blendMode.alphaDstFactor;
-    m_state.gp.state.omBlendAttachments[attachment].alphaBlendOp        = blendMode.alphaBlendOp;
-    m_state.gp.state.omBlendAttachments[attachment].colorWriteMask      = blendMode.writeMask;
+    m_state.gp.state.omBlend[attachment] = DxvkOmAttachmentBlend(
+      blendMode.enableBlending,
+      blendMode.colorSrcFactor,
+      blendMode.colorDstFactor,
+      blendMode.colorBlendOp,
+      blendMode.alphaSrcFactor,
+      blendMode.alphaDstFactor,
+      blendMode.alphaBlendOp,
+      blendMode.writeMask);
     
     m_flags.set(DxvkContextFlag::GpDirtyPipelineState);
   }
@@ -1777,14 +1959,153 @@ namespace dxvk {
   
   
   void DxvkContext::writeTimestamp(const Rc<DxvkGpuQuery>& query) {
+    this->flushClearBatch();
     m_queryManager.writeTimestamp(m_cmd, query);
   }
   
   
+  void DxvkContext::beginDebugRegion(const std::string& name) {
+    this->flushClearBatch();
+    
+    Rc<DxvkGpuProfiler> profiler = m_device->gpuProfiler();
+    
+    DxvkDebugRegion region;
+    region.name = name;
+    
+    if (profiler->isTimingEnabled()) {
+      region.query = m_device->createGpuQuery(VK_QUERY_TYPE_TIMESTAMP, 0, 0);
+      m_queryManager.writeTimestamp(m_cmd, region.query);
+    }
+    
+    if (profiler->hasDebugLabels()) {
+      VkDebugUtilsLabelEXT label = { VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT };
+      label.pLabelName = region.name.c_str();
+      m_cmd->cmdBeginDebugUtilsLabel(&label);
+    }
+    
+    m_debugRegions.push_back(std::move(region));
+  }
+  
+  
+  void DxvkContext::endDebugRegion() {
+    if (m_debugRegions.empty())
+      return;
+    
+    this->flushClearBatch();
+    
+    Rc<DxvkGpuProfiler> profiler = m_device->gpuProfiler();
+    
+    DxvkDebugRegion region = std::move(m_debugRegions.back());
+    m_debugRegions.pop_back();
+    
+    if (region.query != nullptr) {
+      Rc<DxvkGpuQuery> query = m_device->createGpuQuery(VK_QUERY_TYPE_TIMESTAMP, 0, 0);
+      m_queryManager.writeTimestamp(m_cmd, query);
+      
+      profiler->addRegion(region.name,
+        m_debugRegions.size(), region.query, query);
+    }
+    
+    if (profiler->hasDebugLabels())
+      m_cmd->cmdEndDebugUtilsLabel();
+  }
+  
+  
+  void DxvkContext::insertDebugMarker(const std::string& name) {
+    this->flushClearBatch();
+    
+    if (m_device->gpuProfiler()->hasDebugLabels()) {
+      VkDebugUtilsLabelEXT label = { VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT };
+      label.pLabelName = name.c_str();
+      m_cmd->cmdInsertDebugUtilsLabel(&label);
+    }
+  }
+  
+  
+  void DxvkContext::clearImageViewRegion(
+    const Rc<DxvkImageView>&    imageView,
+          int32_t               zOffset,
+          uint32_t              zExtent,
+          uint32_t              rectCount,
+    const VkRect2D*             rects,
+          VkClearValue          value) {
+    if (!rectCount)
+      return;
+    
+    const VkImageUsageFlags viewUsage = imageView->info().usage;
+    
+    if (viewUsage & VK_IMAGE_USAGE_STORAGE_BIT) {
+      this->clearImageViewCsBatched(imageView,
+        zOffset, zExtent, rectCount, rects, value);
+      return;
+    }
+    
+    if (!(viewUsage & (VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT)))
+      return;
+    
+    // Attachments of the current render pass can be cleared
+    // inline, and clearing the entire view through a render
+    // pass lets the driver use a fast clear. For any other
+    // clear, a compute dispatch is cheaper than setting up a
+    // temporary framebuffer, provided the image supports it.
+    this->updateFramebuffer();
+    
+    bool isBound = m_state.om.framebuffer != nullptr
+      && m_state.om.framebuffer->findAttachment(imageView) >= 0;
+    
+    VkExtent3D viewExtent = imageView->mipLevelExtent(0);
+    
+    bool isFullClear = rectCount == 1
+      && rects[0].offset.x == 0 && rects[0].extent.width  == viewExtent.width
+      && rects[0].offset.y == 0 && rects[0].extent.height == viewExtent.height;
+    
+    if (!isBound && !isFullClear) {
+      Rc<DxvkImageView> storageView = this->createClearStorageView(imageView);
+      
+      if (storageView != nullptr) {
+        this->clearImageViewCsBatched(storageView,
+          zOffset, zExtent, rectCount, rects, value);
+        return;
+      }
+    }
+    
+    this->clearImageViewFb(imageView, rectCount, rects, value);
+    m_cmd->addStatCtr(DxvkStatCounter::CmdClearCountFb, 1);
+  }
+  
+  
+  void DxvkContext::clearImageViewCsBatched(
+    const Rc<DxvkImageView>&    imageView,
+          int32_t               zOffset,
+          uint32_t              zExtent,
+          uint32_t              rectCount,
+    const VkRect2D*             rects,
+          VkClearValue          value) {
+    m_cmd->addStatCtr(DxvkStatCounter::CmdClearCountCs, 1);
+    
+    // Clears of 2D views are deferred so that clears of
+    // different images can share a single dispatch
+    if (imageView->type() == VK_IMAGE_VIEW_TYPE_2D) {
+      this->deferClearImageView(imageView, rectCount, rects, value);
+      return;
+    }
+    
+    // 3D images need the slice range, which is shared
+    // by all rectangles, so we clear them one by one
+    uint32_t batchSize = imageView->type() == VK_IMAGE_VIEW_TYPE_3D
+      ? 1u : uint32_t(MaxNumClearRects);
+    
+    for (uint32_t i = 0; i < rectCount; i += batchSize) {
+      this->clearImageViewCs(imageView, zOffset, zExtent,
+        std::min(rectCount - i, batchSize), rects + i, value);
+    }
+  }
+  
+  
   void DxvkContext::clearImageViewFb(
     const Rc<DxvkImageView>&    imageView,
-          VkOffset3D            offset,
-          VkExtent3D            extent,
+          uint32_t              rectCount,
+    const VkRect2D*             rects,
           VkClearValue          value) {
     this->updateFramebuffer();
 
@@ -1853,15 +2174,19 @@ namespace dxvk {
     if (attachmentIndex < 0)
       clearInfo.colorAttachment   = 0;
 
-    VkClearRect clearRect;
-    clearRect.rect.offset.x       = offset.x;
-    clearRect.rect.offset.y       = offset.y;
-    clearRect.rect.extent.width   = extent.width;
-    clearRect.rect.extent.height  = extent.height;
-    clearRect.baseArrayLayer      = 0;
-    clearRect.layerCount          = imageView->info().numLayers;
+    std::array<VkClearRect, MaxNumClearRects> clearRects;
+
+    for (uint32_t i = 0; i < rectCount; i += clearRects.size()) {
+      uint32_t count = std::min<uint32_t>(rectCount - i, clearRects.size());
+
+      for (uint32_t j = 0; j < count; j++) {
+        clearRects[j].rect            = rects[i + j];
+        clearRects[j].baseArrayLayer  = 0;
+        clearRects[j].layerCount      = imageView->info().numLayers;
+      }
 
-    m_cmd->cmdClearAttachments(1, &clearInfo, 1, &clearRect);
+      m_cmd->cmdClearAttachments(1, &clearInfo, count, clearRects.data());
+    }
 
     // Unbind temporary framebuffer
     if (attachmentIndex < 0)
@@ -1871,8 +2196,10 @@ namespace dxvk {
   
   void DxvkContext::clearImageViewCs(
     const Rc<DxvkImageView>&    imageView,
-          VkOffset3D            offset,
-          VkExtent3D            extent,
+          int32_t               zOffset,
+          uint32_t              zExtent,
+          uint32_t              rectCount,
+    const VkRect2D*             rects,
           VkClearValue          value) {
     this->spillRenderPass();
     this->unbindComputePipeline();
@@ -1908,19 +2235,51 @@ namespace dxvk {
     descriptorWrite.pTexelBufferView = nullptr;
     m_cmd->updateDescriptorSets(1, &descriptorWrite);
     
-    // Prepare shader arguments
-    DxvkMetaClearArgs pushArgs;
+    // Prepare shader arguments. All rectangles are processed
+    // by the same dispatch, which has to be large enough to
+    // cover the largest one.
+    DxvkMetaClearImageArgs pushArgs = { };
     pushArgs.clearValue = value.color;
-    pushArgs.offset = offset;
-    pushArgs.extent = extent;
+    pushArgs.zOffset    = zOffset;
+    pushArgs.zExtent    = zExtent;
+    pushArgs.rectCount  = rectCount;
+    
+    VkExtent3D maxExtent = { 0u, 0u, zExtent };
+    
+    for (uint32_t i = 0; i < rectCount; i++) {
+      pushArgs.rects[i] = rects[i];
+      
+      maxExtent.width  = std::max(maxExtent.width,  rects[i].extent.width);
+      maxExtent.height = std::max(maxExtent.height, rects[i].extent.height);
+    }
     
     VkExtent3D workgroups = util::computeBlockCount(
-      pushArgs.extent, pipeInfo.workgroupSize);
+      maxExtent, pipeInfo.workgroupSize);
+    
+    uint32_t layerCount = imageView->subresources().layerCount;
     
-    if (imageView->type() == VK_IMAGE_VIEW_TYPE_1D_ARRAY)
-      workgroups.height = imageView->subresources().layerCount;
-    else if (imageView->type() == VK_IMAGE_VIEW_TYPE_2D_ARRAY)
-      workgroups.depth = imageView->subresources().layerCount;
+    switch (imageView->type()) {
+      case VK_IMAGE_VIEW_TYPE_1D:
+        workgroups.height = rectCount;
+        workgroups.depth  = 1;
+        break;
+      
+      case VK_IMAGE_VIEW_TYPE_1D_ARRAY:
+        workgroups.height = layerCount;
+        workgroups.depth  = rectCount;
+        break;
+      
+      case VK_IMAGE_VIEW_TYPE_2D:
+        workgroups.depth  = rectCount;
+        break;
+      
+      case VK_IMAGE_VIEW_TYPE_2D_ARRAY:
+        workgroups.depth  = rectCount * layerCount;
+        break;
+      
+      default:
+        break;
+    }
     
     m_cmd->cmdBindPipeline(
       VK_PIPELINE_BIND_POINT_COMPUTE,
@@ -1953,6 +2312,225 @@ namespace dxvk {
   }
 
   
+  void DxvkContext::deferClearImageView(
+    const Rc<DxvkImageView>&    imageView,
+          uint32_t              rectCount,
+    const VkRect2D*             rects,
+          VkClearValue          value) {
+    if (m_flags.any(
+          DxvkContextFlag::GpRenderPassBound,
+          DxvkContextFlag::GpClearRenderTargets))
+      this->spillRenderPass();
+    
+    // Rectangles are packed into 16-bit fields, so they must
+    // not exceed the view, nor have negative offsets. The
+    // view is only added once a rectangle actually hits it.
+    VkExtent3D viewExtent = imageView->mipLevelExtent(0);
+    uint32_t   viewIndex  = MaxNumClearViews;
+    
+    for (uint32_t i = 0; i < rectCount; i++) {
+      int64_t x0 = std::max<int64_t>(rects[i].offset.x, 0);
+      int64_t y0 = std::max<int64_t>(rects[i].offset.y, 0);
+      int64_t x1 = std::min<int64_t>(int64_t(rects[i].offset.x) + rects[i].extent.width,  viewExtent.width);
+      int64_t y1 = std::min<int64_t>(int64_t(rects[i].offset.y) + rects[i].extent.height, viewExtent.height);
+      
+      if (x0 >= x1 || y0 >= y1)
+        continue;
+      
+      // Adding the view again flushes the full batch
+      if (viewIndex == MaxNumClearViews
+       || m_clearBatch.rectCount == MaxNumClearRects)
+        viewIndex = this->addClearBatchView(imageView, value);
+      
+      VkRect2D& rect = m_clearBatch.rects[m_clearBatch.rectCount];
+      rect.offset = { int32_t(x0), int32_t(y0) };
+      rect.extent = { uint32_t(x1 - x0), uint32_t(y1 - y0) };
+      
+      m_clearBatch.rectViews[m_clearBatch.rectCount] = viewIndex;
+      m_clearBatch.rectCount += 1;
+    }
+  }
+  
+  
+  uint32_t DxvkContext::addClearBatchView(
+    const Rc<DxvkImageView>&    imageView,
+          VkClearValue          value) {
+    DxvkClearBatchState& batch = m_clearBatch;
+    
+    bool isUint = imageFormatInfo(imageView->info().format)->flags.any(
+      DxvkFormatFlag::SampledUInt, DxvkFormatFlag::SampledSInt);
+    
+    // All views must use the same pipeline, and since there is
+    // no ordering between the rectangles of a dispatch, images
+    // must not be written more than once per batch.
+    bool flush = batch.viewCount == MaxNumClearViews
+              || batch.rectCount == MaxNumClearRects
+              || batch.isUint    != isUint;
+    
+    for (uint32_t i = 0; i < batch.viewCount && !flush; i++)
+      flush = batch.views[i]->image() == imageView->image();
+    
+    if (flush)
+      this->flushClearBatch();
+    
+    uint32_t viewIndex = batch.viewCount++;
+    
+    batch.isUint            = isUint;
+    batch.views [viewIndex] = imageView;
+    batch.values[viewIndex] = value.color;
+    return viewIndex;
+  }
+  
+  
+  void DxvkContext::flushClearBatch() {
+    DxvkClearBatchState& batch = m_clearBatch;
+    
+    if (!batch.viewCount)
+      return;
+    
+    this->unbindComputePipeline();
+    
+    bool flushBarriers = false;
+    
+    for (uint32_t i = 0; i < batch.viewCount; i++) {
+      flushBarriers |= m_barriers.isImageDirty(
+        batch.views[i]->image(),
+        batch.views[i]->subresources(),
+        DxvkAccess::Write);
+    }
+    
+    if (flushBarriers)
+      m_barriers.recordCommands(m_cmd);
+    
+    DxvkMetaClearPipeline pipeInfo = m_metaClear->getClearImageBatchPipeline(
+      imageFormatInfo(batch.views[0]->info().format)->flags);
+    
+    // Unused array elements still need a valid
+    // descriptor, so we point them to the first view
+    VkDescriptorSet descriptorSet = allocateDescriptorSet(pipeInfo.dsetLayout);
+    
+    std::array<VkDescriptorImageInfo, MaxNumClearViews> viewInfos;
+    
+    for (uint32_t i = 0; i < MaxNumClearViews; i++) {
+      const Rc<DxvkImageView>& view = batch.views[i < batch.viewCount ? i : 0];
+      
+      viewInfos[i].sampler      = VK_NULL_HANDLE;
+      viewInfos[i].imageView    = view->handle();
+      viewInfos[i].imageLayout  = view->imageInfo().layout;
+    }
+    
+    VkWriteDescriptorSet descriptorWrite;
+    descriptorWrite.sType            = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptorWrite.pNext            = nullptr;
+    descriptorWrite.dstSet           = descriptorSet;
+    descriptorWrite.dstBinding       = 0;
+    descriptorWrite.dstArrayElement  = 0;
+    descriptorWrite.descriptorCount  = viewInfos.size();
+    descriptorWrite.descriptorType   = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    descriptorWrite.pImageInfo       = viewInfos.data();
+    descriptorWrite.pBufferInfo      = nullptr;
+    descriptorWrite.pTexelBufferView = nullptr;
+    m_cmd->updateDescriptorSets(1, &descriptorWrite);
+    
+    // Prepare shader arguments. Each rectangle is processed
+    // by one layer of workgroups, which has to be large
+    // enough to cover the largest rectangle.
+    DxvkMetaClearImageBatchArgs pushArgs = { };
+    pushArgs.rectCount = batch.rectCount;
+    
+    for (uint32_t i = 0; i < batch.viewCount; i++)
+      pushArgs.clearValues[i] = batch.values[i];
+    
+    VkExtent3D maxExtent = { 0u, 0u, 1u };
+    
+    for (uint32_t i = 0; i < batch.rectCount; i++) {
+      const VkRect2D& rect = batch.rects[i];
+      
+      pushArgs.rectViews  |= batch.rectViews[i] << (2 * i);
+      pushArgs.rects[i][0] = (uint32_t(rect.offset.x) & 0xFFFF) | ((uint32_t(rect.offset.y) & 0xFFFF) << 16);
+      pushArgs.rects[i][1] = (rect.extent.width       & 0xFFFF) | ((rect.extent.height     & 0xFFFF) << 16);
+      
+      maxExtent.width  = std::max(maxExtent.width,  rect.extent.width);
+      maxExtent.height = std::max(maxExtent.height, rect.extent.height);
+    }
+    
+    VkExtent3D workgroups = util::computeBlockCount(
+      maxExtent, pipeInfo.workgroupSize);
+    workgroups.depth = batch.rectCount;
+    
+    m_cmd->cmdBindPipeline(
+      VK_PIPELINE_BIND_POINT_COMPUTE,
+      pipeInfo.pipeline);
+    m_cmd->cmdBindDescriptorSet(
+      VK_PIPELINE_BIND_POINT_COMPUTE,
+      pipeInfo.pipeLayout, descriptorSet,
+      0, nullptr);
+    m_cmd->cmdPushConstants(
+      pipeInfo.pipeLayout,
+      VK_SHADER_STAGE_COMPUTE_BIT,
+      0, sizeof(pushArgs), &pushArgs);
+    m_cmd->cmdDispatch(
+      workgroups.width,
+      workgroups.height,
+      workgroups.depth);
+    
+    for (uint32_t i = 0; i < batch.viewCount; i++) {
+      const Rc<DxvkImageView>& view = batch.views[i];
+      
+      m_barriers.accessImage(
+        view->image(),
+        view->subresources(),
+        view->imageInfo().layout,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_ACCESS_SHADER_WRITE_BIT,
+        view->imageInfo().layout,
+        view->imageInfo().stages,
+        view->imageInfo().access);
+      
+      m_cmd->trackResource(view);
+      m_cmd->trackResource(view->image());
+    }
+    
+    for (uint32_t i = 0; i < batch.viewCount; i++)
+      batch.views[i] = nullptr;
+    
+    batch.viewCount = 0;
+    batch.rectCount = 0;
+  }
+  
+  
+  Rc<DxvkImageView> DxvkContext::createClearStorageView(
+    const Rc<DxvkImageView>&    imageView) {
+    const Rc<DxvkImage>& image = imageView->image();
+    
+    // The image must be in a layout that is valid for storage
+    // image access, and the view format must support it.
+    if (!(image->info().usage & VK_IMAGE_USAGE_STORAGE_BIT)
+     || !(imageView->info().aspect & VK_IMAGE_ASPECT_COLOR_BIT)
+     || image->info().type == VK_IMAGE_TYPE_3D
+     || image->info().layout != VK_IMAGE_LAYOUT_GENERAL)
+      return nullptr;
+    
+    if (imageView->info().format != image->info().format
+     && !(image->info().flags & VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT))
+      return nullptr;
+    
+    VkFormatProperties formatProperties = m_device->adapter()
+      ->formatProperties(imageView->info().format);
+    
+    VkFormatFeatureFlags formatFeatures = image->info().tiling == VK_IMAGE_TILING_OPTIMAL
+      ? formatProperties.optimalTilingFeatures
+      : formatProperties.linearTilingFeatures;
+    
+    if (!(formatFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT))
+      return nullptr;
+    
+    DxvkImageViewCreateInfo viewInfo = imageView->info();
+    viewInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT;
+    return m_device->createImageView(image, viewInfo);
+  }
+  
+  
   void DxvkContext::copyImageHw(
     const Rc<DxvkImage>&        dstImage,
           VkImageSubresourceLayers dstSubresource,
@@ -2408,6 +2986,8 @@ namespace dxvk {
   void DxvkContext::startRenderPass() {
     if (!m_flags.test(DxvkContextFlag::GpRenderPassBound)
      && (m_state.om.framebuffer != nullptr)) {
+      this->flushClearBatch();
+      
       m_flags.set(DxvkContextFlag::GpRenderPassBound);
       m_flags.clr(DxvkContextFlag::GpClearRenderTargets);
 
@@ -2433,6 +3013,8 @@ namespace dxvk {
   
   
   void DxvkContext::spillRenderPass() {
+    this->flushClearBatch();
+    
     if (m_flags.test(DxvkContextFlag::GpClearRenderTargets))
       this->clearRenderPass();
     
@@ -2700,6 +3282,9 @@ namespace dxvk {
         m_cmd->cmdBindPipeline(
           VK_PIPELINE_BIND_POINT_COMPUTE,
           m_cpActivePipeline);
+        
+        // Meta operations may have overwritten push constants
+        m_flags.set(DxvkContextFlag::CpDirtyPushConstants);
       }
     }
   }
@@ -2715,6 +3300,7 @@ namespace dxvk {
       DxvkContextFlag::GpDirtyXfbBuffers,
       DxvkContextFlag::GpDirtyBlendConstants,
       DxvkContextFlag::GpDirtyStencilRef,
+      DxvkContextFlag::GpDirtyStencilMask,
       DxvkContextFlag::GpDirtyViewport,
       DxvkContextFlag::GpDirtyDepthBias);
     
@@ -2748,23 +3334,24 @@ namespace dxvk {
       this->pauseTransformFeedback();
 
       // Fix up vertex binding strides for unbound buffers
-      for (uint32_t i = 0; i < m_state.gp.state.ilBindingCount; i++) {
-        const uint32_t binding = m_state.gp.state.ilBindings[i].binding;
+      for (uint32_t i = 0; i < m_state.gp.state.il.bindingCount(); i++) {
+        const uint32_t binding = m_state.gp.state.ilBindings[i].binding();
         
-        m_state.gp.state.ilBindings[i].stride
-          = (m_state.vi.bindingMask & (1u << binding)) != 0
+        m_state.gp.state.ilBindings[i].setStride(
+          (m_state.vi.bindingMask & (1u << binding)) != 0
             ? m_state.vi.vertexStrides[binding]
-            : 0;
+            : 0);
       }
       
-      for (uint32_t i = m_state.gp.state.ilBindingCount; i < MaxNumVertexBindings; i++)
-        m_state.gp.state.ilBindings[i].stride = 0;
+      for (uint32_t i = m_state.gp.state.il.bindingCount(); i < MaxNumVertexBindings; i++)
+        m_state.gp.state.ilBindings[i].setStride(0);
       
       // Check which dynamic states need to be active. States that
       // are not dynamic will be invalidated in the command buffer.
       m_flags.clr(DxvkContextFlag::GpDynamicBlendConstants,
                   DxvkContextFlag::GpDynamicDepthBias,
-                  DxvkContextFlag::GpDynamicStencilRef);
+                  DxvkContextFlag::GpDynamicStencilRef,
+                  DxvkContextFlag::GpDynamicStencilMask);
       
       m_flags.set(m_state.gp.state.useDynamicBlendConstants()
         ? DxvkContextFlag::GpDynamicBlendConstants
@@ -2778,6 +3365,10 @@ namespace dxvk {
         ? DxvkContextFlag::GpDynamicStencilRef
         : DxvkContextFlag::GpDirtyStencilRef);
       
+      m_flags.set(m_state.gp.state.useDynamicStencilMask()
+        ? DxvkContextFlag::GpDynamicStencilMask
+        : DxvkContextFlag::GpDirtyStencilMask);
+      
       // Retrieve and bind actual Vulkan pipeline handle
       m_gpActivePipeline = m_state.gp.pipeline != nullptr && m_state.om.framebuffer != nullptr
         ? m_state.gp.pipeline->getPipelineHandle(m_state.gp.state,
@@ -2788,6 +3379,9 @@ namespace dxvk {
         m_cmd->cmdBindPipeline(
           VK_PIPELINE_BIND_POINT_GRAPHICS,
           m_gpActivePipeline);
+        
+        // Meta operations may have overwritten push constants
+        m_flags.set(DxvkContextFlag::GpDirtyPushConstants);
       }
     }
   }
@@ -2836,6 +3430,14 @@ namespace dxvk {
   }
   
   
+  void DxvkContext::updateComputePushConstants() {
+    if (m_state.cp.pipeline != nullptr)
+      this->updatePushConstants(m_state.cp.pipeline->layout());
+    
+    m_flags.clr(DxvkContextFlag::CpDirtyPushConstants);
+  }
+  
+  
   void DxvkContext::updateGraphicsShaderResources() {
     if (m_state.gp.pipeline == nullptr)
       return;
@@ -2879,10 +3481,48 @@ namespace dxvk {
   }
   
   
+  void DxvkContext::updateGraphicsPushConstants() {
+    if (m_state.gp.pipeline != nullptr)
+      this->updatePushConstants(m_state.gp.pipeline->layout());
+    
+    m_flags.clr(DxvkContextFlag::GpDirtyPushConstants);
+  }
+  
+  
+  void DxvkContext::updatePushConstants(
+    const DxvkPipelineLayout*     layout) {
+    for (uint32_t i = 0; i < layout->pushConstSlotCount(); i++) {
+      const DxvkPushConstantSlot& slot = layout->pushConstSlot(i);
+      const DxvkBufferSlice& buffer = m_rc[slot.slot].bufferSlice;
+      
+      // Unbound constant buffers read zero, same as with
+      // the descriptor-based path using a null buffer
+      std::array<char, MaxPushConstantSize> data = { };
+      
+      if (buffer.defined()) {
+        if (buffer.buffer()->memFlags() & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+          std::memcpy(data.data(), buffer.mapPtr(0),
+            std::min<VkDeviceSize>(buffer.length(), slot.size));
+        } else {
+          static bool s_errorShown = false;
+          
+          if (!std::exchange(s_errorShown, true))
+            Logger::warn("DxvkContext: Push constant source buffer not host-visible");
+        }
+      }
+      
+      m_cmd->cmdPushConstants(layout->pipelineLayout(),
+        slot.stages, slot.offset, slot.size, data.data());
+    }
+  }
+  
+  
   void DxvkContext::updateShaderResources(
           VkPipelineBindPoint     bindPoint,
           DxvkBindingMask&        bindMask,
     const DxvkPipelineLayout*     layout) {
+    DXVK_TRACE_ZONE("DxvkContext::updateShaderResources");
+
     bool updatePipelineState = false;
     
     // If the depth attachment is also bound as a shader
@@ -2890,6 +3530,11 @@ namespace dxvk {
     VkImage       depthImage  = VK_NULL_HANDLE;
     VkImageLayout depthLayout = VK_IMAGE_LAYOUT_UNDEFINED;
     
+    // If enabled, unbound read-only slots are treated as bound
+    // to their dummy resource so that they do not affect the
+    // binding mask, and thus the pipeline state vector
+    const bool bindDummyResources = m_device->config().bindDummyResources;
+    
     if (bindPoint == VK_PIPELINE_BIND_POINT_GRAPHICS && m_state.om.framebuffer != nullptr) {
       const auto& depthAttachment = m_state.om.framebuffer->getDepthTarget();
 
@@ -2903,6 +3548,9 @@ namespace dxvk {
       const auto& binding = layout->binding(i);
       const auto& res     = m_rc[binding.slot];
       
+      const bool useDummy = bindDummyResources
+        && layout->canBindDummyResource(i);
+      
       switch (binding.type) {
         case VK_DESCRIPTOR_TYPE_SAMPLER:
           if (res.sampler != nullptr) {
@@ -2914,7 +3562,9 @@ namespace dxvk {
             
             m_cmd->trackResource(res.sampler);
           } else {
-            updatePipelineState |= bindMask.setUnbound(i);
+            updatePipelineState |= useDummy
+              ? bindMask.setBound(i)
+              : bindMask.setUnbound(i);
             m_descInfos[i].image = m_device->dummySamplerDescriptor();
           } break;
         
@@ -2933,7 +3583,9 @@ namespace dxvk {
             m_cmd->trackResource(res.imageView);
             m_cmd->trackResource(res.imageView->image());
           } else {
-            updatePipelineState |= bindMask.setUnbound(i);
+            updatePipelineState |= useDummy
+              ? bindMask.setBound(i)
+              : bindMask.setUnbound(i);
             m_descInfos[i].image = m_device->dummyImageViewDescriptor(binding.view);
           } break;
         
@@ -2948,7 +3600,9 @@ namespace dxvk {
             m_cmd->trackResource(res.bufferView);
             m_cmd->trackResource(res.bufferView->buffer());
           } else {
-            updatePipelineState |= bindMask.setUnbound(i);
+            updatePipelineState |= useDummy
+              ? bindMask.setBound(i)
+              : bindMask.setUnbound(i);
             m_descInfos[i].texelBuffer = m_device->dummyBufferViewDescriptor();
           } break;
         
@@ -2960,7 +3614,9 @@ namespace dxvk {
             
             m_cmd->trackResource(res.bufferSlice.buffer());
           } else {
-            updatePipelineState |= bindMask.setUnbound(i);
+            updatePipelineState |= useDummy
+              ? bindMask.setBound(i)
+              : bindMask.setUnbound(i);
             m_descInfos[i].buffer = m_device->dummyBufferDescriptor();
           } break;
         
@@ -2973,7 +3629,9 @@ namespace dxvk {
             
             m_cmd->trackResource(res.bufferSlice.buffer());
           } else {
-            updatePipelineState |= bindMask.setUnbound(i);
+            updatePipelineState |= useDummy
+              ? bindMask.setBound(i)
+              : bindMask.setUnbound(i);
             m_descInfos[i].buffer = m_device->dummyBufferDescriptor();
           } break;
         
@@ -3038,15 +3696,15 @@ namespace dxvk {
       
       auto fb = m_device->createFramebuffer(m_state.om.renderTargets);
       
-      m_state.gp.state.msSampleCount = fb->getSampleCount();
+      m_state.gp.state.ms.setSampleCount(fb->getSampleCount());
       m_state.om.framebuffer = fb;
 
       for (uint32_t i = 0; i < MaxNumRenderTargets; i++) {
         Rc<DxvkImageView> attachment = fb->getColorTarget(i).view;
 
-        m_state.gp.state.omComponentMapping[i] = attachment != nullptr
+        m_state.gp.state.omSwizzle[i] = DxvkOmAttachmentSwizzle(attachment != nullptr
           ? util::invertComponentMapping(attachment->info().swizzle)
-          : VkComponentMapping();
+          : VkComponentMapping());
       }
 
       m_flags.set(DxvkContextFlag::GpDirtyPipelineState);
@@ -3054,6 +3712,33 @@ namespace dxvk {
   }
   
   
+  DxvkCmdBuffer DxvkContext::prepareBufferWrite(
+    const Rc<DxvkBuffer>&           buffer,
+          VkDeviceSize              offset,
+          VkDeviceSize              length) {
+    // If the entire buffer gets overwritten while a render pass
+    // is active, rename the buffer and write to the new backing
+    // storage from the init command buffer. None of the commands
+    // recorded so far can access the new slice, so the render pass
+    // does not need to be interrupted. Host-visible buffers are
+    // excluded since the client API may track mapped slices itself.
+    // Renamed buffers keep all their physical slices alive, so only
+    // do this for buffers no larger than a constant buffer.
+    if (m_flags.test(DxvkContextFlag::GpRenderPassBound)
+     && offset == 0 && length == buffer->info().size
+     && length <= MaxUniformBufferSize
+     && !(buffer->memFlags() & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)) {
+      this->invalidateBuffer(buffer, buffer->allocSlice());
+
+      m_cmd->addStatCtr(DxvkStatCounter::CmdTransfersHoisted, 1);
+      return DxvkCmdBuffer::InitBuffer;
+    }
+
+    this->spillRenderPass();
+    return DxvkCmdBuffer::ExecBuffer;
+  }
+
+
   void DxvkContext::updateIndexBufferBinding() {
     if (m_flags.test(DxvkContextFlag::GpDirtyIndexBuffer)) {
       m_flags.clr(DxvkContextFlag::GpDirtyIndexBuffer);
@@ -3087,8 +3772,8 @@ namespace dxvk {
       uint32_t bindingCount = 0;
       uint32_t bindingMask  = 0;
       
-      for (uint32_t i = 0; i < m_state.gp.state.ilBindingCount; i++) {
-        const uint32_t binding = m_state.gp.state.ilBindings[i].binding;
+      for (uint32_t i = 0; i < m_state.gp.state.il.bindingCount(); i++) {
+        const uint32_t binding = m_state.gp.state.ilBindings[i].binding();
         bindingCount = std::max(bindingCount, binding + 1);
         
         if (m_state.vi.vertexBuffers[binding].defined()) {
@@ -3185,7 +3870,7 @@ namespace dxvk {
     if (m_flags.test(DxvkContextFlag::GpDirtyViewport)) {
       m_flags.clr(DxvkContextFlag::GpDirtyViewport);
 
-      uint32_t viewportCount = m_state.gp.state.rsViewportCount;
+      uint32_t viewportCount = m_state.gp.state.rs.viewportCount();
       m_cmd->cmdSetViewport(0, viewportCount, m_state.vp.viewports.data());
       m_cmd->cmdSetScissor (0, viewportCount, m_state.vp.scissorRects.data());
     }
@@ -3205,6 +3890,18 @@ namespace dxvk {
         m_state.dyn.stencilReference);
     }
     
+    if (m_flags.all(DxvkContextFlag::GpDirtyStencilMask,
+                    DxvkContextFlag::GpDynamicStencilMask)) {
+      m_flags.clr(DxvkContextFlag::GpDirtyStencilMask);
+      
+      const DxvkStencilMasks& masks = m_state.dyn.stencilMasks;
+      
+      m_cmd->cmdSetStencilCompareMask(VK_STENCIL_FACE_FRONT_BIT, masks.compareMaskFront);
+      m_cmd->cmdSetStencilCompareMask(VK_STENCIL_FACE_BACK_BIT,  masks.compareMaskBack);
+      m_cmd->cmdSetStencilWriteMask  (VK_STENCIL_FACE_FRONT_BIT, masks.writeMaskFront);
+      m_cmd->cmdSetStencilWriteMask  (VK_STENCIL_FACE_BACK_BIT,  masks.writeMaskBack);
+    }
+    
     if (m_flags.all(DxvkContextFlag::GpDirtyDepthBias,
                     DxvkContextFlag::GpDynamicDepthBias)) {
       m_flags.clr(DxvkContextFlag::GpDirtyDepthBias);
@@ -3234,6 +3931,10 @@ namespace dxvk {
   
   
   void DxvkContext::commitComputeState() {
+    DXVK_TRACE_ZONE("DxvkContext::commitComputeState");
+
+    this->flushClearBatch();
+
     if (m_flags.test(DxvkContextFlag::GpRenderPassBound))
       this->spillRenderPass();
 
@@ -3255,10 +3956,15 @@ namespace dxvk {
           DxvkContextFlag::CpDirtyDescriptorSet,
           DxvkContextFlag::CpDirtyDescriptorOffsets))
       this->updateComputeShaderDescriptors();
+    
+    if (m_flags.test(DxvkContextFlag::CpDirtyPushConstants))
+      this->updateComputePushConstants();
   }
   
   
   void DxvkContext::commitGraphicsState(bool indexed) {
+    DXVK_TRACE_ZONE("DxvkContext::commitGraphicsState");
+
     if (m_flags.test(DxvkContextFlag::GpDirtyFramebuffer))
       this->updateFramebuffer();
 
@@ -3290,6 +3996,9 @@ namespace dxvk {
           DxvkContextFlag::GpDirtyDescriptorOffsets))
       this->updateGraphicsShaderDescriptors();
     
+    if (m_flags.test(DxvkContextFlag::GpDirtyPushConstants))
+      this->updateGraphicsPushConstants();
+    
     if (m_flags.any(
           DxvkContextFlag::GpDirtyViewport,
           DxvkContextFlag::GpDirtyBlendConstants,
@@ -3463,8 +4172,8 @@ namespace dxvk {
     barrier.srcAccessMask = srcAccess;
     barrier.dstAccessMask = dstAccess;
 
-    m_cmd->cmdPipelineBarrier(srcStages, dstStages,
-      0, 1, &barrier, 0, nullptr, 0, nullptr);
+    m_cmd->cmdPipelineBarrier(DxvkCmdBuffer::ExecBuffer,
+      srcStages, dstStages, 0, 1, &barrier, 0, nullptr, 0, nullptr);
   }
 
 
@@ -3495,4 +4204,62 @@ namespace dxvk {
     }
   }
   
+  
+  void DxvkContext::trackBufferRelocation(
+    const Rc<DxvkBuffer>&           buffer) {
+    // Limit the size of the queue in case the app binds a
+    // lot of buffers, we will pick the rest up eventually
+    constexpr size_t MaxPendingRelocations = 1024;
+    
+    if (unlikely(buffer != nullptr && buffer->needsRelocation())
+     && m_relocations.size() < MaxPendingRelocations)
+      m_relocations.push_back(buffer);
+  }
+  
+  
+  void DxvkContext::relocateBuffer(
+    const Rc<DxvkBuffer>&           buffer) {
+    this->spillRenderPass();
+    
+    // Keep the old backing resource alive until the GPU
+    // is done with it. Its memory, and the memory chunk
+    // once empty, will be freed when the resource dies.
+    DxvkBufferSliceHandle srcSlice = buffer->getSliceHandle();
+    
+    Rc<DxvkRetiredBuffer> retired = new DxvkRetiredBuffer(
+      m_device->vkd(), buffer->relocate());
+    
+    DxvkBufferSliceHandle dstSlice = buffer->getSliceHandle();
+    
+    if (m_barriers.isBufferDirty(srcSlice, DxvkAccess::Read))
+      m_barriers.recordCommands(m_cmd);
+    
+    VkBufferCopy bufferRegion;
+    bufferRegion.srcOffset = srcSlice.offset;
+    bufferRegion.dstOffset = dstSlice.offset;
+    bufferRegion.size      = dstSlice.length;
+    
+    m_cmd->cmdCopyBuffer(DxvkCmdBuffer::ExecBuffer,
+      srcSlice.handle,
+      dstSlice.handle,
+      1, &bufferRegion);
+    
+    m_barriers.accessBuffer(srcSlice,
+      VK_PIPELINE_STAGE_TRANSFER_BIT,
+      VK_ACCESS_TRANSFER_READ_BIT,
+      buffer->info().stages,
+      buffer->info().access);
+    
+    m_barriers.accessBuffer(dstSlice,
+      VK_PIPELINE_STAGE_TRANSFER_BIT,
+      VK_ACCESS_TRANSFER_WRITE_BIT,
+      buffer->info().stages,
+      buffer->info().access);
+    
+    m_cmd->trackResource(buffer);
+    m_cmd->trackResource(retired);
+    
+    this->invalidateBufferBindings(buffer, srcSlice, dstSlice);
+  }
+  
 }
\ No newline at end of file
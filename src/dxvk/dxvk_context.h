@@ -7,6 +7,7 @@
 #include "dxvk_data.h"
 #include "dxvk_event.h"
 #include "dxvk_gpu_event.h"
+#include "dxvk_gpu_profiler.h"
 #include "dxvk_gpu_query.h"
 #include "dxvk_meta_clear.h"
 #include "dxvk_meta_copy.h"
@@ -292,6 +293,23 @@ namespace dxvk {
             VkExtent3D            extent,
             VkClearValue          value);
     
+    /**
+     * \brief Clears multiple rectangles of an image view
+     * 
+     * Clears the given rectangles in all layers of
+     * the view. Compute clears will process multiple
+     * rectangles with a single dispatch.
+     * \param [in] imageView The image view
+     * \param [in] rectCount Number of rectangles
+     * \param [in] rects Rectangles to clear
+     * \param [in] value The clear value
+     */
+    void clearImageViewRects(
+      const Rc<DxvkImageView>&    imageView,
+            uint32_t              rectCount,
+      const VkRect2D*             rects,
+            VkClearValue          value);
+    
     /**
      * \brief Copies data from one buffer to another
      * 
@@ -426,6 +444,16 @@ namespace dxvk {
             VkExtent2D            srcExtent,
             VkFormat              format);
     
+    /**
+     * \brief Defragments device memory
+     * 
+     * Relocates buffers that live in sparsely used memory
+     * chunks so that those chunks can be freed. Should be
+     * called once per frame. The amount of data copied is
+     * limited in order to avoid stutter.
+     */
+    void defragmentMemory();
+    
     /**
      * \brief Discards a buffer
      * 
@@ -451,6 +479,20 @@ namespace dxvk {
       const Rc<DxvkImage>&          image,
             VkImageSubresourceRange subresources);
     
+    /**
+     * \brief Discards an image view
+     * 
+     * If the view is bound as a render target, the next
+     * render pass will not load its contents. Otherwise,
+     * this behaves like \ref discardImage for the view's
+     * subresources.
+     * \param [in] imageView The image view to discard
+     * \param [in] discardAspects Image aspects to discard
+     */
+    void discardImageView(
+      const Rc<DxvkImageView>&      imageView,
+            VkImageAspectFlags      discardAspects);
+    
     /**
      * \brief Starts compute jobs
      * 
@@ -786,6 +828,33 @@ namespace dxvk {
     void writeTimestamp(
       const Rc<DxvkGpuQuery>&   query);
     
+    /**
+     * \brief Begins a debug region
+     * 
+     * Reports the region to debugging tools if debug
+     * labels are supported, and writes a timestamp
+     * if GPU timing is enabled on the device.
+     * \param [in] name Region name
+     */
+    void beginDebugRegion(
+      const std::string&        name);
+    
+    /**
+     * \brief Ends the current debug region
+     * 
+     * Hands the region over to the GPU profiler
+     * if it was timed. Does nothing if no region
+     * is currently open.
+     */
+    void endDebugRegion();
+    
+    /**
+     * \brief Inserts a debug marker
+     * \param [in] name Marker name
+     */
+    void insertDebugMarker(
+      const std::string&        name);
+    
   private:
     
     const Rc<DxvkDevice>              m_device;
@@ -802,13 +871,17 @@ namespace dxvk {
 
     DxvkContextFlags        m_flags;
     DxvkContextState        m_state;
+    DxvkClearBatchState     m_clearBatch;
 
     DxvkBarrierSet          m_barriers;
     DxvkBarrierSet          m_transitions;
+    DxvkBarrierSet          m_initBarriers;
     DxvkBarrierControlFlags m_barrierControl;
     
     DxvkGpuQueryManager     m_queryManager;
     
+    std::vector<DxvkDebugRegion> m_debugRegions;
+    
     VkPipeline m_gpActivePipeline = VK_NULL_HANDLE;
     VkPipeline m_cpActivePipeline = VK_NULL_HANDLE;
 
@@ -819,18 +892,53 @@ namespace dxvk {
     std::array<DxvkDescriptorInfo,     MaxNumActiveBindings> m_descInfos;
     std::array<uint32_t,               MaxNumActiveBindings> m_descOffsets;
     
+    std::vector<Rc<DxvkBuffer>> m_relocations;
+    
+    void clearImageViewRegion(
+      const Rc<DxvkImageView>&    imageView,
+            int32_t               zOffset,
+            uint32_t              zExtent,
+            uint32_t              rectCount,
+      const VkRect2D*             rects,
+            VkClearValue          value);
+    
+    void clearImageViewCsBatched(
+      const Rc<DxvkImageView>&    imageView,
+            int32_t               zOffset,
+            uint32_t              zExtent,
+            uint32_t              rectCount,
+      const VkRect2D*             rects,
+            VkClearValue          value);
+    
     void clearImageViewFb(
       const Rc<DxvkImageView>&    imageView,
-            VkOffset3D            offset,
-            VkExtent3D            extent,
+            uint32_t              rectCount,
+      const VkRect2D*             rects,
             VkClearValue          value);
     
     void clearImageViewCs(
       const Rc<DxvkImageView>&    imageView,
-            VkOffset3D            offset,
-            VkExtent3D            extent,
+            int32_t               zOffset,
+            uint32_t              zExtent,
+            uint32_t              rectCount,
+      const VkRect2D*             rects,
+            VkClearValue          value);
+    
+    void deferClearImageView(
+      const Rc<DxvkImageView>&    imageView,
+            uint32_t              rectCount,
+      const VkRect2D*             rects,
+            VkClearValue          value);
+    
+    uint32_t addClearBatchView(
+      const Rc<DxvkImageView>&    imageView,
             VkClearValue          value);
     
+    void flushClearBatch();
+    
+    Rc<DxvkImageView> createClearStorageView(
+      const Rc<DxvkImageView>&    imageView);
+    
     void copyImageHw(
       const Rc<DxvkImage>&        dstImage,
             VkImageSubresourceLayers dstSubresource,
@@ -891,9 +999,14 @@ namespace dxvk {
     
     void updateComputeShaderResources();
     void updateComputeShaderDescriptors();
+    void updateComputePushConstants();
     
     void updateGraphicsShaderResources();
     void updateGraphicsShaderDescriptors();
+    void updateGraphicsPushConstants();
+    
+    void updatePushConstants(
+      const DxvkPipelineLayout*     layout);
     
     void updateShaderResources(
             VkPipelineBindPoint     bindPoint,
@@ -911,6 +1024,11 @@ namespace dxvk {
 
     void updateFramebuffer();
     
+    DxvkCmdBuffer prepareBufferWrite(
+      const Rc<DxvkBuffer>&           buffer,
+            VkDeviceSize              offset,
+            VkDeviceSize              length);
+    
     void updateIndexBufferBinding();
     void updateVertexBufferBindings();
     
@@ -941,6 +1059,17 @@ namespace dxvk {
 
     void trackDrawBuffer();
     
+    void trackBufferRelocation(
+      const Rc<DxvkBuffer>&           buffer);
+    
+    void relocateBuffer(
+      const Rc<DxvkBuffer>&           buffer);
+    
+    void invalidateBufferBindings(
+      const Rc<DxvkBuffer>&           buffer,
+      const DxvkBufferSliceHandle&    prevSlice,
+      const DxvkBufferSliceHandle&    slice);
+    
   };
   
 }
\ No newline at end of file
@@ -30,6 +30,7 @@ namespace dxvk {
     GpDirtyResources,           ///< Graphics pipeline resource bindings are out of date
     GpDirtyDescriptorOffsets,   ///< Graphics descriptor set needs to be rebound
     GpDirtyDescriptorSet,       ///< Graphics descriptor set needs to be updated
+    GpDirtyPushConstants,       ///< Graphics push constants are out of date
     GpDirtyVertexBuffers,       ///< Vertex buffer bindings are out of date
     GpDirtyIndexBuffer,         ///< Index buffer binding are out of date
     GpDirtyXfbBuffers,          ///< Transform feedback buffer bindings are out of date
@@ -37,16 +38,19 @@ namespace dxvk {
     GpDirtyBlendConstants,      ///< Blend constants have changed
     GpDirtyDepthBias,           ///< Depth bias has changed
     GpDirtyStencilRef,          ///< Stencil reference has changed
+    GpDirtyStencilMask,         ///< Stencil compare and write masks have changed
     GpDirtyViewport,            ///< Viewport state has changed
     GpDynamicBlendConstants,    ///< Blend constants are dynamic
     GpDynamicDepthBias,         ///< Depth bias is dynamic
     GpDynamicStencilRef,        ///< Stencil reference is dynamic
+    GpDynamicStencilMask,       ///< Stencil masks are dynamic
     
     CpDirtyPipeline,            ///< Compute pipeline binding are out of date
     CpDirtyPipelineState,       ///< Compute pipeline needs to be recompiled
     CpDirtyResources,           ///< Compute pipeline resource bindings are out of date
     CpDirtyDescriptorOffsets,   ///< Compute descriptor set needs to be rebound
     CpDirtyDescriptorSet,       ///< Compute descriptor set needs to be updated
+    CpDirtyPushConstants,       ///< Compute push constants are out of date
     
     DirtyDrawBuffer,            ///< Indirect argument buffer is dirty
   };
@@ -133,6 +137,26 @@ namespace dxvk {
     DxvkBlendConstants  blendConstants    = { 0.0f, 0.0f, 0.0f, 0.0f };
     DxvkDepthBias       depthBias         = { 0.0f, 0.0f, 0.0f };
     uint32_t            stencilReference  = 0;
+    DxvkStencilMasks    stencilMasks      = { 0, 0, 0, 0 };
+  };
+  
+  
+  /**
+   * \brief Pending image clears
+   * 
+   * Compute clears of 2D views which have not been
+   * dispatched yet. All views belong to different
+   * images and use the same pipeline, and each
+   * rectangle stores the index of its view.
+   */
+  struct DxvkClearBatchState {
+    bool                                            isUint    = false;
+    uint32_t                                        viewCount = 0;
+    uint32_t                                        rectCount = 0;
+    std::array<Rc<DxvkImageView>, MaxNumClearViews> views;
+    std::array<VkClearColorValue, MaxNumClearViews> values    = { };
+    std::array<VkRect2D,          MaxNumClearRects> rects     = { };
+    std::array<uint32_t,          MaxNumClearRects> rectViews = { };
   };
   
   
@@ -21,6 +21,7 @@ namespace dxvk {
     m_pipelineManager   (new DxvkPipelineManager    (this, m_renderPassPool.ptr())),
     m_gpuEventPool      (new DxvkGpuEventPool       (vkd)),
     m_gpuQueryPool      (new DxvkGpuQueryPool       (this)),
+    m_gpuProfiler       (new DxvkGpuProfiler        (adapter)),
     m_metaClearObjects  (new DxvkMetaClearObjects   (vkd)),
     m_metaCopyObjects   (new DxvkMetaCopyObjects    (vkd)),
     m_metaMipGenObjects (new DxvkMetaMipGenObjects  (vkd)),
@@ -232,15 +233,32 @@ namespace dxvk {
     DxvkPipelineCount pipe = m_pipelineManager->getPipelineCount();
     
     DxvkStatCounters result;
-    result.setCtr(DxvkStatCounter::MemoryAllocated,   mem.memoryAllocated);
-    result.setCtr(DxvkStatCounter::MemoryUsed,        mem.memoryUsed);
-    result.setCtr(DxvkStatCounter::PipeCountGraphics, pipe.numGraphicsPipelines);
-    result.setCtr(DxvkStatCounter::PipeCountCompute,  pipe.numComputePipelines);
+    result.setCtr(DxvkStatCounter::MemoryAllocated,     mem.memoryAllocated);
+    result.setCtr(DxvkStatCounter::MemoryUsed,          mem.memoryUsed);
+    result.setCtr(DxvkStatCounter::MemoryBudget,        mem.memoryBudget);
+    result.setCtr(DxvkStatCounter::MemoryDemoted,       mem.memoryDemoted);
+    result.setCtr(DxvkStatCounter::MemoryDemotionCount, mem.demotionCount);
+    result.setCtr(DxvkStatCounter::PipeCountGraphics,   pipe.numGraphicsPipelines);
+    result.setCtr(DxvkStatCounter::PipeCountCompute,    pipe.numComputePipelines);
+    result.setCtr(DxvkStatCounter::PipeOutputsMatched,  pipe.numMatchedOutputs);
+    result.setCtr(DxvkStatCounter::PipeOutputsRemoved,  pipe.numEliminatedOutputs);
+    result.setCtr(DxvkStatCounter::QueueSubmitLatency,  m_submissionQueue.averageLatencyUs());
     
     std::lock_guard<sync::Spinlock> lock(m_statLock);
     result.merge(m_statCounters);
     return result;
   }
+  
+  
+  void DxvkDevice::mergeStatCounters(const DxvkStatCounters& counters) {
+    std::lock_guard<sync::Spinlock> lock(m_statLock);
+    m_statCounters.merge(counters);
+  }
+  
+  
+  void DxvkDevice::updateMemoryDefragmentation() {
+    m_memory->updateDefragmentation();
+  }
 
 
   uint32_t DxvkDevice::getCurrentFrameId() const {
@@ -261,6 +279,10 @@ namespace dxvk {
   VkResult DxvkDevice::presentImage(
     const Rc<vk::Presenter>&        presenter,
           VkSemaphore               semaphore) {
+    DXVK_TRACE_ZONE("DxvkDevice::presentImage");
+
+    m_gpuProfiler->endFrame();
+
     std::lock_guard<std::mutex> queueLock(m_submissionLock);
     VkResult status = presenter->presentImage(semaphore);
 
@@ -277,18 +299,27 @@ namespace dxvk {
     const Rc<DxvkCommandList>&      commandList,
           VkSemaphore               waitSync,
           VkSemaphore               wakeSync) {
+    DXVK_TRACE_ZONE("DxvkDevice::submitCommandList");
+
     VkResult status;
     
     { // Queue submissions are not thread safe
       std::lock_guard<std::mutex> queueLock(m_submissionLock);
-      std::lock_guard<sync::Spinlock> statLock(m_statLock);
       
-      m_statCounters.merge(commandList->statCounters());
-      m_statCounters.addCtr(DxvkStatCounter::QueueSubmitCount, 1);
+      { std::lock_guard<sync::Spinlock> statLock(m_statLock);
+        m_statCounters.merge(commandList->statCounters());
+        m_statCounters.addCtr(DxvkStatCounter::QueueSubmitCount, 1);
+      }
       
       status = commandList->submit(
         m_graphicsQueue.queueHandle,
         waitSync, wakeSync);
+      
+      // This visits every tracked resource, so keep it out of
+      // the stat lock. It must stay within the submission lock
+      // so that resource submission IDs never go backwards.
+      if (status == VK_SUCCESS)
+        commandList->notifySubmission(++m_lastSubmissionId);
     }
     
     if (status == VK_SUCCESS) {
@@ -7,6 +7,7 @@
 #include "dxvk_context.h"
 #include "dxvk_extensions.h"
 #include "dxvk_framebuffer.h"
+#include "dxvk_gpu_profiler.h"
 #include "dxvk_image.h"
 #include "dxvk_memory.h"
 #include "dxvk_meta_clear.h"
@@ -220,6 +221,17 @@ namespace dxvk {
             VkQueryControlFlags   flags,
             uint32_t              index);
     
+    /**
+     * \brief GPU profiler
+     * 
+     * Collects GPU timings for debug regions
+     * that are recorded by all contexts.
+     * \returns GPU profiler
+     */
+    Rc<DxvkGpuProfiler> gpuProfiler() const {
+      return m_gpuProfiler;
+    }
+    
     /**
      * \brief Creates framebuffer for a set of render targets
      * 
@@ -309,6 +321,24 @@ namespace dxvk {
      * usage, draw calls, etc.
      */
     DxvkStatCounters getStatCounters();
+    
+    /**
+     * \brief Adds stat counters
+     * 
+     * Allows API frontends to report counters
+     * that are not tied to a command list.
+     * \param [in] counters Counters to add
+     */
+    void mergeStatCounters(const DxvkStatCounters& counters);
+
+    /**
+     * \brief Updates memory defragmentation
+     * 
+     * Selects sparsely used memory chunks to be
+     * evacuated. Should be called once per frame
+     * by the context that relocates resources.
+     */
+    void updateMemoryDefragmentation();
 
     /**
      * \brief Retreves current frame ID
@@ -390,6 +420,52 @@ namespace dxvk {
       return m_submissionQueue.pendingSubmissions();
     }
     
+    /**
+     * \brief Sequence number of the last submission
+     * 
+     * Every successful command list submission is
+     * assigned a monotonically increasing number.
+     * \returns Submission sequence number
+     */
+    uint64_t lastSubmissionId() const {
+      return m_lastSubmissionId.load();
+    }
+    
+    /**
+     * \brief Checks whether a submission has completed
+     * 
+     * \param [in] submissionId Submission sequence number
+     * \returns \c true if the GPU has finished executing
+     *    all command lists up to the given submission
+     */
+    bool isSubmissionComplete(uint64_t submissionId) const {
+      return m_submissionQueue.completedSubmissionId() >= submissionId;
+    }
+    
+    /**
+     * \brief Waits for a submission to complete
+     * 
+     * Blocks until the GPU has finished executing
+     * all command lists up to the given submission.
+     * \param [in] submissionId Submission sequence number
+     */
+    void waitForSubmission(uint64_t submissionId) {
+      m_submissionQueue.waitForSubmission(submissionId);
+    }
+    
+    /**
+     * \brief Average submission latency
+     * 
+     * Time it takes for a command list to complete
+     * execution after being submitted, averaged over
+     * recent submissions. Returns zero if no command
+     * list has completed yet.
+     * \returns Latency, in microseconds
+     */
+    uint64_t submissionLatencyUs() const {
+      return m_submissionQueue.averageLatencyUs();
+    }
+    
     /**
      * \brief Waits until the device becomes idle
      * 
@@ -418,6 +494,7 @@ namespace dxvk {
 
     Rc<DxvkGpuEventPool>        m_gpuEventPool;
     Rc<DxvkGpuQueryPool>        m_gpuQueryPool;
+    Rc<DxvkGpuProfiler>         m_gpuProfiler;
 
     Rc<DxvkMetaClearObjects>    m_metaClearObjects;
     Rc<DxvkMetaCopyObjects>     m_metaCopyObjects;
@@ -431,6 +508,7 @@ namespace dxvk {
     DxvkStatCounters            m_statCounters;
     
     std::mutex                  m_submissionLock;
+    std::atomic<uint64_t>       m_lastSubmissionId = { 0ull };
     DxvkDeviceQueue             m_graphicsQueue;
     DxvkDeviceQueue             m_presentQueue;
     
@@ -36,6 +36,7 @@ namespace dxvk {
     VkPhysicalDeviceMemoryPriorityFeaturesEXT           extMemoryPriority;
     VkPhysicalDeviceTransformFeedbackFeaturesEXT        extTransformFeedback;
     VkPhysicalDeviceVertexAttributeDivisorFeaturesEXT   extVertexAttributeDivisor;
+    VkPhysicalDeviceFloat16Int8FeaturesKHR              khrShaderFloat16Int8;
   };
 
 }
\ No newline at end of file
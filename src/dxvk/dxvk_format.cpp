@@ -547,23 +547,48 @@ namespace dxvk {
   }};
   
   
-  const std::array<std::pair<VkFormat, VkFormat>, 2> g_formatGroups = {{
-    { VK_FORMAT_UNDEFINED,              VK_FORMAT_BC7_SRGB_BLOCK          },
-    { VK_FORMAT_G8B8G8R8_422_UNORM_KHR, VK_FORMAT_B8G8R8G8_422_UNORM_KHR  },
+  /**
+   * \brief Format group
+   * 
+   * Range of consecutive formats, along with the
+   * index of the first format in the info table.
+   */
+  struct DxvkFormatGroup {
+    VkFormat first;
+    VkFormat last;
+    uint32_t offset;
+  };
+  
+  
+  constexpr uint32_t getFormatGroupSize(VkFormat first, VkFormat last) {
+    return uint32_t(last) - uint32_t(first) + 1;
+  }
+  
+  
+  constexpr std::array<DxvkFormatGroup, 2> g_formatGroups = {{
+    { VK_FORMAT_UNDEFINED,              VK_FORMAT_BC7_SRGB_BLOCK,         0 },
+    { VK_FORMAT_G8B8G8R8_422_UNORM_KHR, VK_FORMAT_B8G8R8G8_422_UNORM_KHR,
+      getFormatGroupSize(VK_FORMAT_UNDEFINED, VK_FORMAT_BC7_SRGB_BLOCK) },
   }};
   
+  static_assert(g_formatGroups[1].offset + getFormatGroupSize(
+    g_formatGroups[1].first, g_formatGroups[1].last) == std::tuple_size<decltype(g_formatInfos)>::value,
+    "Format info table does not match format groups");
+  
   
   const DxvkFormatInfo* imageFormatInfo(VkFormat format) {
-    uint32_t indexOffset = 0;
-    
-    for (const auto& group : g_formatGroups) {
-      if (format >= group.first && format <= group.second) {
-        uint32_t index = uint32_t(format) - uint32_t(group.first);
-        return &g_formatInfos[indexOffset + index];
-      } else {
-        indexOffset += uint32_t(group.second)
-                     - uint32_t(group.first) + 1;
-      }
+    // Core formats start at zero and are by far the most
+    // common, so look them up without walking the groups.
+    uint32_t index = uint32_t(format);
+    
+    if (likely(index <= uint32_t(g_formatGroups[0].last)))
+      return &g_formatInfos[index];
+    
+    for (uint32_t i = 1; i < g_formatGroups.size(); i++) {
+      const DxvkFormatGroup& group = g_formatGroups[i];
+      
+      if (format >= group.first && format <= group.last)
+        return &g_formatInfos[group.offset + index - uint32_t(group.first)];
     }
     
     return nullptr;
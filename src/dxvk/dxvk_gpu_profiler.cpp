@@ -0,0 +1,118 @@
+#include "dxvk_device.h"
+#include "dxvk_gpu_profiler.h"
+#include "dxvk_instance.h"
+
+namespace dxvk {
+
+  DxvkGpuProfiler::DxvkGpuProfiler(
+    const Rc<DxvkAdapter>& adapter)
+  : m_debugLabels     (adapter->instance()->extensions().extDebugUtils
+                    && env::getEnvVar("DXVK_DEBUG_LABELS") == "1"),
+    m_timestampPeriod (adapter->deviceProperties().limits.timestampPeriod) {
+
+  }
+
+
+  DxvkGpuProfiler::~DxvkGpuProfiler() {
+
+  }
+
+
+  void DxvkGpuProfiler::enableTiming() {
+    m_timingEnabled.store(true);
+  }
+
+
+  void DxvkGpuProfiler::addRegion(
+    const std::string&        name,
+          uint32_t            depth,
+    const Rc<DxvkGpuQuery>&   begin,
+    const Rc<DxvkGpuQuery>&   end) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Don't keep an unbounded number of queries alive
+    // if the application never presents anything
+    if (m_regions.size() >= MaxPendingRegions)
+      m_regions.pop();
+
+    m_regions.push({ name, depth, m_frameId, begin, end });
+  }
+
+
+  void DxvkGpuProfiler::endFrame() {
+    if (!m_timingEnabled.load())
+      return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_frameId += 1;
+
+    // Queries complete in submission order, so we can
+    // stop at the first region that is still pending.
+    while (!m_regions.empty()) {
+      const Region& region = m_regions.front();
+
+      DxvkQueryData beginData = { };
+      DxvkQueryData endData   = { };
+
+      DxvkGpuQueryStatus beginStatus = region.begin->getData(beginData);
+      DxvkGpuQueryStatus endStatus   = region.end  ->getData(endData);
+
+      if (beginStatus == DxvkGpuQueryStatus::Pending
+       || endStatus   == DxvkGpuQueryStatus::Pending)
+        break;
+
+      if (region.frameId != m_resolveFrameId) {
+        this->publishFrame();
+        m_resolveFrameId = region.frameId;
+      }
+
+      if (beginStatus == DxvkGpuQueryStatus::Available
+       && endStatus   == DxvkGpuQueryStatus::Available)
+        this->resolveRegion(region, endData.timestamp.time - beginData.timestamp.time);
+
+      m_regions.pop();
+    }
+
+    // No more regions can be added to frames that
+    // have already ended, so publish the last one
+    // once all of its regions have been resolved.
+    bool frameResolved = m_regions.empty()
+      || m_regions.front().frameId != m_resolveFrameId;
+
+    if (frameResolved && m_resolveFrameId < m_frameId)
+      this->publishFrame();
+  }
+
+
+  std::vector<DxvkGpuRegionStats> DxvkGpuProfiler::getFrameStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_frameStats;
+  }
+
+
+  void DxvkGpuProfiler::resolveRegion(
+    const Region&             region,
+          uint64_t            ticks) {
+    uint64_t timeNs = uint64_t(double(ticks) * m_timestampPeriod);
+
+    for (auto& stats : m_frameStatsAccum) {
+      if (stats.depth == region.depth && stats.name == region.name) {
+        stats.count  += 1;
+        stats.timeNs += timeNs;
+        return;
+      }
+    }
+
+    m_frameStatsAccum.push_back({ region.name, region.depth, 1, timeNs });
+  }
+
+
+  void DxvkGpuProfiler::publishFrame() {
+    if (m_frameStatsAccum.empty())
+      return;
+
+    m_frameStats = std::move(m_frameStatsAccum);
+    m_frameStatsAccum.clear();
+  }
+
+}
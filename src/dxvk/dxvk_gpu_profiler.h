@@ -0,0 +1,155 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "dxvk_gpu_query.h"
+
+namespace dxvk {
+
+  class DxvkAdapter;
+
+  /**
+   * \brief Debug region
+   *
+   * Stores the name of a region that is currently
+   * open on a context, along with the timestamp
+   * query written at the start of the region.
+   * The query is \c nullptr if GPU timing was
+   * disabled when the region was opened.
+   */
+  struct DxvkDebugRegion {
+    std::string       name;
+    Rc<DxvkGpuQuery>  query;
+  };
+
+
+  /**
+   * \brief GPU region statistics
+   *
+   * Accumulated GPU time of all regions with the
+   * same name and nesting level within one frame.
+   */
+  struct DxvkGpuRegionStats {
+    std::string name;
+    uint32_t    depth;
+    uint32_t    count;
+    uint64_t    timeNs;
+  };
+
+
+  /**
+   * \brief GPU profiler
+   *
+   * Resolves timestamp queries for debug regions
+   * recorded by contexts, and aggregates the GPU
+   * time spent in each region per frame.
+   */
+  class DxvkGpuProfiler : public RcObject {
+    constexpr static size_t MaxPendingRegions = 16384;
+  public:
+
+    DxvkGpuProfiler(
+      const Rc<DxvkAdapter>& adapter);
+
+    ~DxvkGpuProfiler();
+
+    /**
+     * \brief Checks whether debug labels are supported
+     *
+     * Debug labels are used to report region names
+     * to debugging tools. They are only enabled if
+     * \c DXVK_DEBUG_LABELS is set to \c 1, and the
+     * instance supports \c VK_EXT_debug_utils.
+     * \returns \c true if debug labels can be used
+     */
+    bool hasDebugLabels() const {
+      return m_debugLabels;
+    }
+
+    /**
+     * \brief Checks whether GPU timing is enabled
+     * \returns \c true if regions should be timed
+     */
+    bool isTimingEnabled() const {
+      return m_timingEnabled.load();
+    }
+
+    /**
+     * \brief Enables GPU timing
+     *
+     * Contexts will write timestamps for all
+     * debug regions opened after this call.
+     */
+    void enableTiming();
+
+    /**
+     * \brief Adds a completed region
+     *
+     * Called by contexts when a timed region
+     * gets closed. The region will be resolved
+     * once both queries have become available.
+     * \param [in] name Region name
+     * \param [in] depth Nesting level
+     * \param [in] begin Start timestamp query
+     * \param [in] end End timestamp query
+     */
+    void addRegion(
+      const std::string&        name,
+            uint32_t            depth,
+      const Rc<DxvkGpuQuery>&   begin,
+      const Rc<DxvkGpuQuery>&   end);
+
+    /**
+     * \brief Ends the current frame
+     *
+     * Resolves all regions whose queries are
+     * available, and publishes the statistics
+     * of frames whose regions are all resolved.
+     * Should be called once per presented frame.
+     */
+    void endFrame();
+
+    /**
+     * \brief Queries region statistics
+     *
+     * Regions are listed in the order in which
+     * they were first closed within the frame.
+     * \returns Statistics of the last resolved frame
+     */
+    std::vector<DxvkGpuRegionStats> getFrameStats() const;
+
+  private:
+
+    struct Region {
+      std::string       name;
+      uint32_t          depth;
+      uint64_t          frameId;
+      Rc<DxvkGpuQuery>  begin;
+      Rc<DxvkGpuQuery>  end;
+    };
+
+    bool                            m_debugLabels;
+    double                          m_timestampPeriod;
+
+    std::atomic<bool>               m_timingEnabled = { false };
+
+    mutable std::mutex              m_mutex;
+    uint64_t                        m_frameId         = 0;
+    uint64_t                        m_resolveFrameId  = 0;
+    std::queue<Region>              m_regions;
+    std::vector<DxvkGpuRegionStats> m_frameStatsAccum;
+    std::vector<DxvkGpuRegionStats> m_frameStats;
+
+    void resolveRegion(
+      const Region&             region,
+            uint64_t            ticks);
+
+    void publishFrame();
+
+  };
+
+}
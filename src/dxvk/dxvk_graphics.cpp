@@ -9,34 +9,6 @@
 
 namespace dxvk {
   
-  DxvkGraphicsPipelineStateInfo::DxvkGraphicsPipelineStateInfo() {
-    std::memset(this, 0, sizeof(DxvkGraphicsPipelineStateInfo));
-  }
-  
-  
-  DxvkGraphicsPipelineStateInfo::DxvkGraphicsPipelineStateInfo(
-    const DxvkGraphicsPipelineStateInfo& other) {
-    std::memcpy(this, &other, sizeof(DxvkGraphicsPipelineStateInfo));
-  }
-  
-  
-  DxvkGraphicsPipelineStateInfo& DxvkGraphicsPipelineStateInfo::operator = (
-    const DxvkGraphicsPipelineStateInfo& other) {
-    std::memcpy(this, &other, sizeof(DxvkGraphicsPipelineStateInfo));
-    return *this;
-  }
-  
-  
-  bool DxvkGraphicsPipelineStateInfo::operator == (const DxvkGraphicsPipelineStateInfo& other) const {
-    return std::memcmp(this, &other, sizeof(DxvkGraphicsPipelineStateInfo)) == 0;
-  }
-  
-  
-  bool DxvkGraphicsPipelineStateInfo::operator != (const DxvkGraphicsPipelineStateInfo& other) const {
-    return std::memcmp(this, &other, sizeof(DxvkGraphicsPipelineStateInfo)) != 0;
-  }
-  
-  
   DxvkGraphicsPipeline::DxvkGraphicsPipeline(
           DxvkPipelineManager*      pipeMgr,
     const Rc<DxvkShader>&           vs,
@@ -59,18 +31,26 @@ namespace dxvk {
     m_layout = new DxvkPipelineLayout(m_vkd,
       slotMapping.bindingCount(),
       slotMapping.bindingInfos(),
+      slotMapping.pushConstSlotCount(),
+      slotMapping.pushConstSlotInfos(),
       VK_PIPELINE_BIND_POINT_GRAPHICS);
     
     DxvkShaderModuleCreateInfo moduleInfo;
     moduleInfo.fsDualSrcBlend = false;
+    moduleInfo.unusedOutputs  = 0;
     
     DxvkShaderModuleCreateInfo moduleInfoDualSrc;
     moduleInfoDualSrc.fsDualSrcBlend = true;
+    moduleInfoDualSrc.unusedOutputs  = 0;
     
-    if (vs  != nullptr) m_vs  = vs ->createShaderModule(m_vkd, slotMapping, moduleInfo);
+    // Link each stage against the stage that consumes its outputs
+    const Rc<DxvkShader>& vsNext  = tcs != nullptr ? tcs : (gs != nullptr ? gs : fs);
+    const Rc<DxvkShader>& tesNext = gs  != nullptr ? gs  : fs;
+    
+    if (vs  != nullptr) m_vs  = vs ->createShaderModule(m_vkd, slotMapping, getModuleInfo(vs,  vsNext));
     if (tcs != nullptr) m_tcs = tcs->createShaderModule(m_vkd, slotMapping, moduleInfo);
-    if (tes != nullptr) m_tes = tes->createShaderModule(m_vkd, slotMapping, moduleInfo);
-    if (gs  != nullptr) m_gs  = gs ->createShaderModule(m_vkd, slotMapping, moduleInfo);
+    if (tes != nullptr) m_tes = tes->createShaderModule(m_vkd, slotMapping, getModuleInfo(tes, tesNext));
+    if (gs  != nullptr) m_gs  = gs ->createShaderModule(m_vkd, slotMapping, getModuleInfo(gs,  fs));
     if (fs  != nullptr) m_fs  = fs ->createShaderModule(m_vkd, slotMapping, moduleInfo);
     if (fs  != nullptr) m_fs2 = fs ->createShaderModule(m_vkd, slotMapping, moduleInfoDualSrc);
     
@@ -121,13 +101,17 @@ namespace dxvk {
   VkPipeline DxvkGraphicsPipeline::getPipelineHandle(
     const DxvkGraphicsPipelineStateInfo& state,
     const DxvkRenderPass&                renderPass) {
+    DXVK_TRACE_ZONE("DxvkGraphicsPipeline::getPipelineHandle");
+
     VkRenderPass renderPassHandle = renderPass.getDefaultHandle();
     
     VkPipeline newPipelineHandle = VK_NULL_HANDLE;
 
+    size_t stateHash = state.hash();
+
     { std::lock_guard<sync::Spinlock> lock(m_mutex);
     
-      auto instance = this->findInstance(state, renderPassHandle);
+      auto instance = this->findInstance(state, stateHash, renderPassHandle);
       
       if (instance != nullptr)
         return instance->pipeline();
@@ -142,7 +126,7 @@ namespace dxvk {
       newPipelineHandle = this->compilePipeline(state, renderPassHandle, m_basePipeline);
 
       // Add new pipeline to the set
-      m_pipelines.emplace_back(state, renderPassHandle, newPipelineHandle);
+      m_pipelines.emplace_back(state, stateHash, renderPassHandle, newPipelineHandle);
       m_pipeMgr->m_numGraphicsPipelines += 1;
       
       if (!m_basePipeline && newPipelineHandle)
@@ -156,11 +140,37 @@ namespace dxvk {
   }
   
   
+  DxvkShaderModuleCreateInfo DxvkGraphicsPipeline::getModuleInfo(
+    const Rc<DxvkShader>&                shader,
+    const Rc<DxvkShader>&                next) const {
+    DxvkShaderModuleCreateInfo info;
+    info.fsDualSrcBlend = false;
+    info.unusedOutputs  = 0;
+    
+    // If there is no fragment shader, no outputs are read at all
+    uint32_t outputs = shader->interfaceSlots().outputSlots;
+    uint32_t inputs  = next != nullptr ? next->interfaceSlots().inputSlots : 0;
+    
+    m_pipeMgr->m_numMatchedOutputs += bit::popcnt(outputs & inputs);
+    
+    // Transform feedback may capture outputs
+    // that are not used by the next stage
+    if (m_pipeMgr->m_device->config().eliminateUnusedOutputs
+     && !shader->hasCapability(spv::CapabilityTransformFeedback)) {
+      info.unusedOutputs = outputs & ~inputs;
+      m_pipeMgr->m_numEliminatedOutputs += bit::popcnt(info.unusedOutputs);
+    }
+    
+    return info;
+  }
+  
+  
   const DxvkGraphicsPipelineInstance* DxvkGraphicsPipeline::findInstance(
     const DxvkGraphicsPipelineStateInfo& state,
+          size_t                         hash,
           VkRenderPass                   renderPass) const {
     for (const auto& instance : m_pipelines) {
-      if (instance.isCompatible(state, renderPass))
+      if (instance.isCompatible(state, hash, renderPass))
         return &instance;
     }
     
@@ -172,13 +182,15 @@ namespace dxvk {
     const DxvkGraphicsPipelineStateInfo& state,
           VkRenderPass                   renderPass,
           VkPipeline                     baseHandle) const {
+    DXVK_TRACE_ZONE("DxvkGraphicsPipeline::compilePipeline");
+
     if (Logger::logLevel() <= LogLevel::Debug) {
       Logger::debug("Compiling graphics pipeline...");
       this->logPipelineState(LogLevel::Debug, state);
     }
     
     // Set up dynamic states as needed
-    std::array<VkDynamicState, 5> dynamicStates;
+    std::array<VkDynamicState, 7> dynamicStates;
     uint32_t                      dynamicStateCount = 0;
     
     dynamicStates[dynamicStateCount++] = VK_DYNAMIC_STATE_VIEWPORT;
@@ -193,13 +205,18 @@ namespace dxvk {
     if (state.useDynamicStencilRef())
       dynamicStates[dynamicStateCount++] = VK_DYNAMIC_STATE_STENCIL_REFERENCE;
 
+    if (state.useDynamicStencilMask()) {
+      dynamicStates[dynamicStateCount++] = VK_DYNAMIC_STATE_STENCIL_COMPARE_MASK;
+      dynamicStates[dynamicStateCount++] = VK_DYNAMIC_STATE_STENCIL_WRITE_MASK;
+    }
+
     // Figure out the actual sample count to use
     VkSampleCountFlagBits sampleCount = VK_SAMPLE_COUNT_1_BIT;
 
-    if (state.msSampleCount)
-      sampleCount = VkSampleCountFlagBits(state.msSampleCount);
-    else if (state.rsSampleCount)
-      sampleCount = VkSampleCountFlagBits(state.rsSampleCount);
+    if (state.ms.sampleCount())
+      sampleCount = VkSampleCountFlagBits(state.ms.sampleCount());
+    else if (state.rs.sampleCount())
+      sampleCount = VkSampleCountFlagBits(state.rs.sampleCount());
     
     // Set up some specialization constants
     DxvkSpecConstantData specData;
@@ -216,11 +233,11 @@ namespace dxvk {
     
     std::vector<VkPipelineShaderStageCreateInfo> stages;
 
-    bool useDualSrcBlend = state.omBlendAttachments[0].blendEnable && (
-      util::isDualSourceBlendFactor(state.omBlendAttachments[0].srcColorBlendFactor) ||
-      util::isDualSourceBlendFactor(state.omBlendAttachments[0].dstColorBlendFactor) ||
-      util::isDualSourceBlendFactor(state.omBlendAttachments[0].srcAlphaBlendFactor) ||
-      util::isDualSourceBlendFactor(state.omBlendAttachments[0].dstAlphaBlendFactor));
+    bool useDualSrcBlend = state.omBlend[0].blendEnable() && (
+      util::isDualSourceBlendFactor(state.omBlend[0].srcColorBlendFactor()) ||
+      util::isDualSourceBlendFactor(state.omBlend[0].dstColorBlendFactor()) ||
+      util::isDualSourceBlendFactor(state.omBlend[0].srcAlphaBlendFactor()) ||
+      util::isDualSourceBlendFactor(state.omBlend[0].dstAlphaBlendFactor()));
 
     Rc<DxvkShaderModule> fs = useDualSrcBlend ? m_fs2 : m_fs;
 
@@ -234,30 +251,41 @@ namespace dxvk {
     std::array<VkPipelineColorBlendAttachmentState, MaxNumRenderTargets> omBlendAttachments;
 
     for (uint32_t i = 0; i < MaxNumRenderTargets; i++) {
-      omBlendAttachments[i] = state.omBlendAttachments[i];
+      VkComponentMapping mapping = state.omSwizzle[i].mapping();
+
+      omBlendAttachments[i] = state.omBlend[i].state();
       omBlendAttachments[i].colorWriteMask = util::remapComponentMask(
-        state.omBlendAttachments[i].colorWriteMask,
-        state.omComponentMapping[i]);
+        state.omBlend[i].colorWriteMask(), mapping);
       
       if ((m_fsOut & (1 << i)) == 0)
         omBlendAttachments[i].colorWriteMask = 0;
       
-      specData.outputMappings[4 * i + 0] = util::getComponentIndex(state.omComponentMapping[i].r, 0);
-      specData.outputMappings[4 * i + 1] = util::getComponentIndex(state.omComponentMapping[i].g, 1);
-      specData.outputMappings[4 * i + 2] = util::getComponentIndex(state.omComponentMapping[i].b, 2);
-      specData.outputMappings[4 * i + 3] = util::getComponentIndex(state.omComponentMapping[i].a, 3);
+      specData.outputMappings[4 * i + 0] = util::getComponentIndex(mapping.r, 0);
+      specData.outputMappings[4 * i + 1] = util::getComponentIndex(mapping.g, 1);
+      specData.outputMappings[4 * i + 2] = util::getComponentIndex(mapping.b, 2);
+      specData.outputMappings[4 * i + 3] = util::getComponentIndex(mapping.a, 3);
     }
 
+    // Unpack vertex attributes and bindings
+    std::array<VkVertexInputAttributeDescription, MaxNumVertexAttributes> viAttributes;
+    std::array<VkVertexInputBindingDescription,   MaxNumVertexBindings>   viBindings;
+
+    for (uint32_t i = 0; i < state.il.attributeCount(); i++)
+      viAttributes[i] = state.ilAttributes[i].description();
+
+    for (uint32_t i = 0; i < state.il.bindingCount(); i++)
+      viBindings[i] = state.ilBindings[i].description();
+
     // Generate per-instance attribute divisors
     std::array<VkVertexInputBindingDivisorDescriptionEXT, MaxNumVertexBindings> viDivisorDesc;
     uint32_t                                                                    viDivisorCount = 0;
     
-    for (uint32_t i = 0; i < state.ilBindingCount; i++) {
-      if (state.ilBindings[i].inputRate == VK_VERTEX_INPUT_RATE_INSTANCE) {
+    for (uint32_t i = 0; i < state.il.bindingCount(); i++) {
+      if (state.ilBindings[i].inputRate() == VK_VERTEX_INPUT_RATE_INSTANCE) {
         const uint32_t id = viDivisorCount++;
         
-        viDivisorDesc[id].binding = state.ilBindings[i].binding;
-        viDivisorDesc[id].divisor = state.ilDivisors[i];
+        viDivisorDesc[id].binding = state.ilBindings[i].binding();
+        viDivisorDesc[id].divisor = state.ilBindings[i].divisor();
       }
     }
 
@@ -275,10 +303,10 @@ namespace dxvk {
     viInfo.sType                            = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
     viInfo.pNext                            = &viDivisorInfo;
     viInfo.flags                            = 0;
-    viInfo.vertexBindingDescriptionCount    = state.ilBindingCount;
-    viInfo.pVertexBindingDescriptions       = state.ilBindings;
-    viInfo.vertexAttributeDescriptionCount  = state.ilAttributeCount;
-    viInfo.pVertexAttributeDescriptions     = state.ilAttributes;
+    viInfo.vertexBindingDescriptionCount    = state.il.bindingCount();
+    viInfo.pVertexBindingDescriptions       = viBindings.data();
+    viInfo.vertexAttributeDescriptionCount  = state.il.attributeCount();
+    viInfo.pVertexAttributeDescriptions     = viAttributes.data();
     
     if (viDivisorCount == 0)
       viInfo.pNext = viDivisorInfo.pNext;
@@ -291,22 +319,22 @@ namespace dxvk {
     iaInfo.sType                  = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
     iaInfo.pNext                  = nullptr;
     iaInfo.flags                  = 0;
-    iaInfo.topology               = state.iaPrimitiveTopology;
-    iaInfo.primitiveRestartEnable = state.iaPrimitiveRestart;
+    iaInfo.topology               = state.ia.primitiveTopology();
+    iaInfo.primitiveRestartEnable = state.ia.primitiveRestart();
     
     VkPipelineTessellationStateCreateInfo tsInfo;
     tsInfo.sType                  = VK_STRUCTURE_TYPE_PIPELINE_TESSELLATION_STATE_CREATE_INFO;
     tsInfo.pNext                  = nullptr;
     tsInfo.flags                  = 0;
-    tsInfo.patchControlPoints     = state.iaPatchVertexCount;
+    tsInfo.patchControlPoints     = state.ia.patchVertexCount();
     
     VkPipelineViewportStateCreateInfo vpInfo;
     vpInfo.sType                  = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
     vpInfo.pNext                  = nullptr;
     vpInfo.flags                  = 0;
-    vpInfo.viewportCount          = state.rsViewportCount;
+    vpInfo.viewportCount          = state.rs.viewportCount();
     vpInfo.pViewports             = nullptr;
-    vpInfo.scissorCount           = state.rsViewportCount;
+    vpInfo.scissorCount           = state.rs.viewportCount();
     vpInfo.pScissors              = nullptr;
     
     VkPipelineRasterizationStateStreamCreateInfoEXT xfbStreamInfo;
@@ -319,7 +347,7 @@ namespace dxvk {
     rsDepthClipInfo.sType         = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_DEPTH_CLIP_STATE_CREATE_INFO_EXT;
     rsDepthClipInfo.pNext         = nullptr;
     rsDepthClipInfo.flags         = 0;
-    rsDepthClipInfo.depthClipEnable = state.rsDepthClipEnable;
+    rsDepthClipInfo.depthClipEnable = state.rs.depthClipEnable();
 
     VkPipelineRasterizationStateCreateInfo rsInfo;
     rsInfo.sType                  = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
@@ -327,10 +355,10 @@ namespace dxvk {
     rsInfo.flags                  = 0;
     rsInfo.depthClampEnable       = VK_TRUE;
     rsInfo.rasterizerDiscardEnable = rasterizedStream < 0;
-    rsInfo.polygonMode            = state.rsPolygonMode;
-    rsInfo.cullMode               = state.rsCullMode;
-    rsInfo.frontFace              = state.rsFrontFace;
-    rsInfo.depthBiasEnable        = state.rsDepthBiasEnable;
+    rsInfo.polygonMode            = state.rs.polygonMode();
+    rsInfo.cullMode               = state.rs.cullMode();
+    rsInfo.frontFace              = state.rs.frontFace();
+    rsInfo.depthBiasEnable        = state.rs.depthBiasEnable();
     rsInfo.depthBiasConstantFactor= 0.0f;
     rsInfo.depthBiasClamp         = 0.0f;
     rsInfo.depthBiasSlopeFactor   = 0.0f;
@@ -341,9 +369,11 @@ namespace dxvk {
     
     if (!m_pipeMgr->m_device->features().extDepthClipEnable.depthClipEnable) {
       rsInfo.pNext                = rsDepthClipInfo.pNext;
-      rsInfo.depthClampEnable     = !state.rsDepthClipEnable;
+      rsInfo.depthClampEnable     = !state.rs.depthClipEnable();
     }
 
+    uint32_t msSampleMask = state.ms.sampleMask();
+
     VkPipelineMultisampleStateCreateInfo msInfo;
     msInfo.sType                  = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
     msInfo.pNext                  = nullptr;
@@ -351,21 +381,21 @@ namespace dxvk {
     msInfo.rasterizationSamples   = sampleCount;
     msInfo.sampleShadingEnable    = m_common.msSampleShadingEnable;
     msInfo.minSampleShading       = m_common.msSampleShadingFactor;
-    msInfo.pSampleMask            = &state.msSampleMask;
-    msInfo.alphaToCoverageEnable  = state.msEnableAlphaToCoverage;
-    msInfo.alphaToOneEnable       = state.msEnableAlphaToOne;
+    msInfo.pSampleMask            = &msSampleMask;
+    msInfo.alphaToCoverageEnable  = state.ms.enableAlphaToCoverage();
+    msInfo.alphaToOneEnable       = state.ms.enableAlphaToOne();
     
     VkPipelineDepthStencilStateCreateInfo dsInfo;
     dsInfo.sType                  = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
     dsInfo.pNext                  = nullptr;
     dsInfo.flags                  = 0;
-    dsInfo.depthTestEnable        = state.dsEnableDepthTest;
-    dsInfo.depthWriteEnable       = state.dsEnableDepthWrite;
-    dsInfo.depthCompareOp         = state.dsDepthCompareOp;
+    dsInfo.depthTestEnable        = state.ds.enableDepthTest();
+    dsInfo.depthWriteEnable       = state.ds.enableDepthWrite();
+    dsInfo.depthCompareOp         = state.ds.depthCompareOp();
     dsInfo.depthBoundsTestEnable  = VK_FALSE;
-    dsInfo.stencilTestEnable      = state.dsEnableStencilTest;
-    dsInfo.front                  = state.dsStencilOpFront;
-    dsInfo.back                   = state.dsStencilOpBack;
+    dsInfo.stencilTestEnable      = state.ds.enableStencilTest();
+    dsInfo.front                  = state.dsFront.state();
+    dsInfo.back                   = state.dsBack.state();
     dsInfo.minDepthBounds         = 0.0f;
     dsInfo.maxDepthBounds         = 1.0f;
     
@@ -373,8 +403,8 @@ namespace dxvk {
     cbInfo.sType                  = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
     cbInfo.pNext                  = nullptr;
     cbInfo.flags                  = 0;
-    cbInfo.logicOpEnable          = state.omEnableLogicOp;
-    cbInfo.logicOp                = state.omLogicOp;
+    cbInfo.logicOpEnable          = state.om.enableLogicOp();
+    cbInfo.logicOp                = state.om.logicOp();
     cbInfo.attachmentCount        = DxvkLimits::MaxNumRenderTargets;
     cbInfo.pAttachments           = omBlendAttachments.data();
     
@@ -441,24 +471,24 @@ namespace dxvk {
 
   bool DxvkGraphicsPipeline::validatePipelineState(
     const DxvkGraphicsPipelineStateInfo& state) const {
+    // Prevent unintended out-of-bounds access to the IL arrays
+    if (state.il.attributeCount() > DxvkLimits::MaxNumVertexAttributes
+     || state.il.bindingCount()   > DxvkLimits::MaxNumVertexBindings)
+      return false;
+    
     // Validate vertex input - each input slot consumed by the
     // vertex shader must be provided by the input layout.
     uint32_t providedVertexInputs = 0;
     
-    for (uint32_t i = 0; i < state.ilAttributeCount; i++)
-      providedVertexInputs |= 1u << state.ilAttributes[i].location;
+    for (uint32_t i = 0; i < state.il.attributeCount(); i++)
+      providedVertexInputs |= 1u << state.ilAttributes[i].location();
     
     if ((providedVertexInputs & m_vsIn) != m_vsIn)
       return false;
     
     // If there are no tessellation shaders, we
     // obviously cannot use tessellation patches.
-    if ((state.iaPatchVertexCount != 0) && (m_tcs == nullptr || m_tes == nullptr))
-      return false;
-    
-    // Prevent unintended out-of-bounds access to the IL arrays
-    if (state.ilAttributeCount > DxvkLimits::MaxNumVertexAttributes
-     || state.ilBindingCount   > DxvkLimits::MaxNumVertexBindings)
+    if ((state.ia.patchVertexCount() != 0) && (m_tcs == nullptr || m_tes == nullptr))
       return false;
     
     // No errors
@@ -4,6 +4,7 @@
 
 #include "dxvk_bind_mask.h"
 #include "dxvk_constant_state.h"
+#include "dxvk_graphics_state.h"
 #include "dxvk_pipecache.h"
 #include "dxvk_pipelayout.h"
 #include "dxvk_renderpass.h"
@@ -28,86 +29,6 @@ namespace dxvk {
   using DxvkGraphicsPipelineFlags = Flags<DxvkGraphicsPipelineFlag>;
 
 
-  /**
-   * \brief Graphics pipeline state info
-   * 
-   * Stores all information that is required to create
-   * a graphics pipeline, except the shader objects
-   * themselves. Also used to identify pipelines using
-   * the current pipeline state vector.
-   */
-  struct DxvkGraphicsPipelineStateInfo {
-    DxvkGraphicsPipelineStateInfo();
-    DxvkGraphicsPipelineStateInfo(
-      const DxvkGraphicsPipelineStateInfo& other);
-    
-    DxvkGraphicsPipelineStateInfo& operator = (
-      const DxvkGraphicsPipelineStateInfo& other);
-    
-    bool operator == (const DxvkGraphicsPipelineStateInfo& other) const;
-    bool operator != (const DxvkGraphicsPipelineStateInfo& other) const;
-
-    bool useDynamicStencilRef() const {
-      return dsEnableStencilTest;
-    }
-
-    bool useDynamicDepthBias() const {
-      return rsDepthBiasEnable;
-    }
-
-    bool useDynamicBlendConstants() const {
-      bool result = false;
-      
-      for (uint32_t i = 0; i < MaxNumRenderTargets && !result; i++) {
-        result |= omBlendAttachments[i].blendEnable
-         && (util::isBlendConstantBlendFactor(omBlendAttachments[i].srcColorBlendFactor)
-          || util::isBlendConstantBlendFactor(omBlendAttachments[i].dstColorBlendFactor)
-          || util::isBlendConstantBlendFactor(omBlendAttachments[i].srcAlphaBlendFactor)
-          || util::isBlendConstantBlendFactor(omBlendAttachments[i].dstAlphaBlendFactor));
-      }
-
-      return result;
-    }
-    
-    DxvkBindingMask                     bsBindingMask;
-    
-    VkPrimitiveTopology                 iaPrimitiveTopology;
-    VkBool32                            iaPrimitiveRestart;
-    uint32_t                            iaPatchVertexCount;
-    
-    uint32_t                            ilAttributeCount;
-    uint32_t                            ilBindingCount;
-    VkVertexInputAttributeDescription   ilAttributes[DxvkLimits::MaxNumVertexAttributes];
-    VkVertexInputBindingDescription     ilBindings[DxvkLimits::MaxNumVertexBindings];
-    uint32_t                            ilDivisors[DxvkLimits::MaxNumVertexBindings];
-    
-    VkBool32                            rsDepthClipEnable;
-    VkBool32                            rsDepthBiasEnable;
-    VkPolygonMode                       rsPolygonMode;
-    VkCullModeFlags                     rsCullMode;
-    VkFrontFace                         rsFrontFace;
-    uint32_t                            rsViewportCount;
-    VkSampleCountFlags                  rsSampleCount;
-    
-    VkSampleCountFlags                  msSampleCount;
-    uint32_t                            msSampleMask;
-    VkBool32                            msEnableAlphaToCoverage;
-    VkBool32                            msEnableAlphaToOne;
-    
-    VkBool32                            dsEnableDepthTest;
-    VkBool32                            dsEnableDepthWrite;
-    VkBool32                            dsEnableStencilTest;
-    VkCompareOp                         dsDepthCompareOp;
-    VkStencilOpState                    dsStencilOpFront;
-    VkStencilOpState                    dsStencilOpBack;
-    
-    VkBool32                            omEnableLogicOp;
-    VkLogicOp                           omLogicOp;
-    VkPipelineColorBlendAttachmentState omBlendAttachments[MaxNumRenderTargets];
-    VkComponentMapping                  omComponentMapping[MaxNumRenderTargets];
-  };
-  
-  
   /**
    * \brief Common graphics pipeline state
    * 
@@ -133,24 +54,32 @@ namespace dxvk {
     DxvkGraphicsPipelineInstance() { }
     DxvkGraphicsPipelineInstance(
       const DxvkGraphicsPipelineStateInfo&  state,
+            size_t                          hash,
             VkRenderPass                    rp,
             VkPipeline                      pipe)
     : m_stateVector (state),
+      m_stateHash   (hash),
       m_renderPass  (rp),
       m_pipeline    (pipe) { }
 
     /**
      * \brief Checks for matching pipeline state
      * 
+     * The state hash is compared first so that
+     * the full state vector only needs to be
+     * compared for likely matches.
      * \param [in] stateVector Graphics pipeline state
+     * \param [in] hash Hash of the pipeline state
      * \param [in] renderPass Render pass handle
      * \returns \c true if the specialization is compatible
      */
     bool isCompatible(
       const DxvkGraphicsPipelineStateInfo&  state,
+            size_t                          hash,
             VkRenderPass                    rp) const {
-      return m_stateVector == state
-          && m_renderPass  == rp;
+      return m_stateHash   == hash
+          && m_renderPass  == rp
+          && m_stateVector == state;
     }
 
     /**
@@ -164,6 +93,7 @@ namespace dxvk {
   private:
 
     DxvkGraphicsPipelineStateInfo m_stateVector;
+    size_t                        m_stateHash;
     VkRenderPass                  m_renderPass;
     VkPipeline                    m_pipeline;
 
@@ -266,8 +196,13 @@ namespace dxvk {
     // Pipeline handles used for derivative pipelines
     VkPipeline m_basePipeline = VK_NULL_HANDLE;
     
+    DxvkShaderModuleCreateInfo getModuleInfo(
+      const Rc<DxvkShader>&                shader,
+      const Rc<DxvkShader>&                next) const;
+    
     const DxvkGraphicsPipelineInstance* findInstance(
       const DxvkGraphicsPipelineStateInfo& state,
+            size_t                         hash,
             VkRenderPass                   renderPass) const;
     
     VkPipeline compilePipeline(
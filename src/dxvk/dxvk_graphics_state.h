@@ -0,0 +1,681 @@
+#pragma once
+
+#include <cstring>
+
+#include "dxvk_bind_mask.h"
+#include "dxvk_hash.h"
+#include "dxvk_limits.h"
+#include "dxvk_util.h"
+
+namespace dxvk {
+
+  /**
+   * \brief Packed input assembly state
+   *
+   * Stores the primitive topology, primitive
+   * restart and the patch control point count.
+   */
+  class DxvkIaInfo {
+
+  public:
+
+    DxvkIaInfo() = default;
+
+    DxvkIaInfo(
+            VkPrimitiveTopology primitiveTopology,
+            VkBool32            primitiveRestart,
+            uint32_t            patchVertexCount)
+    : m_primitiveTopology (uint16_t(primitiveTopology)),
+      m_primitiveRestart  (uint16_t(primitiveRestart)),
+      m_patchVertexCount  (uint16_t(patchVertexCount)),
+      m_reserved          (0) { }
+
+    VkPrimitiveTopology primitiveTopology() const {
+      return VkPrimitiveTopology(m_primitiveTopology);
+    }
+
+    VkBool32 primitiveRestart() const {
+      return VkBool32(m_primitiveRestart);
+    }
+
+    uint32_t patchVertexCount() const {
+      return m_patchVertexCount;
+    }
+
+  private:
+
+    uint16_t m_primitiveTopology      : 4;
+    uint16_t m_primitiveRestart       : 1;
+    uint16_t m_patchVertexCount       : 6;
+    uint16_t m_reserved               : 5;
+
+  };
+
+
+  /**
+   * \brief Packed input layout metadata
+   *
+   * Stores the number of vertex attributes
+   * and bindings in the input layout.
+   */
+  class DxvkIlInfo {
+
+  public:
+
+    DxvkIlInfo() = default;
+
+    DxvkIlInfo(
+            uint32_t        attributeCount,
+            uint32_t        bindingCount)
+    : m_attributeCount(uint16_t(attributeCount)),
+      m_bindingCount  (uint16_t(bindingCount)),
+      m_reserved      (0) { }
+
+    uint32_t attributeCount() const {
+      return m_attributeCount;
+    }
+
+    uint32_t bindingCount() const {
+      return m_bindingCount;
+    }
+
+  private:
+
+    uint16_t m_attributeCount         : 6;
+    uint16_t m_bindingCount           : 6;
+    uint16_t m_reserved               : 4;
+
+  };
+
+
+  /**
+   * \brief Packed vertex attribute
+   *
+   * Stores a vertex attribute description. Note
+   * that the format must be one of the vertex
+   * formats supported by the frontend, and the
+   * offset is limited to the maximum stride.
+   */
+  class DxvkIlAttribute {
+
+  public:
+
+    DxvkIlAttribute() = default;
+
+    DxvkIlAttribute(
+            uint32_t        location,
+            uint32_t        binding,
+            VkFormat        format,
+            uint32_t        offset)
+    : m_location(uint32_t(location)),
+      m_binding (uint32_t(binding)),
+      m_format  (uint32_t(format)),
+      m_offset  (uint32_t(offset)),
+      m_reserved(0) { }
+
+    uint32_t location() const {
+      return m_location;
+    }
+
+    uint32_t binding() const {
+      return m_binding;
+    }
+
+    VkFormat format() const {
+      return VkFormat(m_format);
+    }
+
+    uint32_t offset() const {
+      return m_offset;
+    }
+
+    VkVertexInputAttributeDescription description() const {
+      VkVertexInputAttributeDescription result;
+      result.location = m_location;
+      result.binding  = m_binding;
+      result.format   = VkFormat(m_format);
+      result.offset   = m_offset;
+      return result;
+    }
+
+  private:
+
+    uint32_t m_location               : 5;
+    uint32_t m_binding                : 5;
+    uint32_t m_format                 : 8;
+    uint32_t m_offset                 : 11;
+    uint32_t m_reserved               : 3;
+
+  };
+
+
+  /**
+   * \brief Packed vertex binding
+   *
+   * Stores a vertex binding description
+   * as well as the instance step rate.
+   */
+  class DxvkIlBinding {
+
+  public:
+
+    DxvkIlBinding() = default;
+
+    DxvkIlBinding(
+            uint32_t          binding,
+            uint32_t          stride,
+            VkVertexInputRate inputRate,
+            uint32_t          divisor)
+    : m_binding   (uint32_t(binding)),
+      m_stride    (uint32_t(stride)),
+      m_inputRate (uint32_t(inputRate)),
+      m_reserved  (0),
+      m_divisor   (divisor) { }
+
+    uint32_t binding() const {
+      return m_binding;
+    }
+
+    uint32_t stride() const {
+      return m_stride;
+    }
+
+    VkVertexInputRate inputRate() const {
+      return VkVertexInputRate(m_inputRate);
+    }
+
+    uint32_t divisor() const {
+      return m_divisor;
+    }
+
+    void setStride(uint32_t stride) {
+      m_stride = stride;
+    }
+
+    VkVertexInputBindingDescription description() const {
+      VkVertexInputBindingDescription result;
+      result.binding   = m_binding;
+      result.stride    = m_stride;
+      result.inputRate = VkVertexInputRate(m_inputRate);
+      return result;
+    }
+
+  private:
+
+    uint32_t m_binding                : 5;
+    uint32_t m_stride                 : 12;
+    uint32_t m_inputRate              : 1;
+    uint32_t m_reserved               : 14;
+    uint32_t m_divisor;
+
+  };
+
+
+  /**
+   * \brief Packed rasterizer state
+   */
+  class DxvkRsInfo {
+
+  public:
+
+    DxvkRsInfo() = default;
+
+    DxvkRsInfo(
+            VkBool32              depthClipEnable,
+            VkBool32              depthBiasEnable,
+            VkPolygonMode         polygonMode,
+            VkCullModeFlags       cullMode,
+            VkFrontFace           frontFace,
+            uint32_t              viewportCount,
+            VkSampleCountFlags    sampleCount)
+    : m_depthClipEnable (uint32_t(depthClipEnable)),
+      m_depthBiasEnable (uint32_t(depthBiasEnable)),
+      m_polygonMode     (uint32_t(polygonMode)),
+      m_cullMode        (uint32_t(cullMode)),
+      m_frontFace       (uint32_t(frontFace)),
+      m_viewportCount   (uint32_t(viewportCount)),
+      m_sampleCount     (uint32_t(sampleCount)),
+      m_reserved        (0) { }
+
+    VkBool32 depthClipEnable() const {
+      return VkBool32(m_depthClipEnable);
+    }
+
+    VkBool32 depthBiasEnable() const {
+      return VkBool32(m_depthBiasEnable);
+    }
+
+    VkPolygonMode polygonMode() const {
+      return VkPolygonMode(m_polygonMode);
+    }
+
+    VkCullModeFlags cullMode() const {
+      return VkCullModeFlags(m_cullMode);
+    }
+
+    VkFrontFace frontFace() const {
+      return VkFrontFace(m_frontFace);
+    }
+
+    uint32_t viewportCount() const {
+      return m_viewportCount;
+    }
+
+    VkSampleCountFlags sampleCount() const {
+      return VkSampleCountFlags(m_sampleCount);
+    }
+
+    void setViewportCount(uint32_t viewportCount) {
+      m_viewportCount = viewportCount;
+    }
+
+  private:
+
+    uint32_t m_depthClipEnable        : 1;
+    uint32_t m_depthBiasEnable        : 1;
+    uint32_t m_polygonMode            : 2;
+    uint32_t m_cullMode               : 2;
+    uint32_t m_frontFace              : 1;
+    uint32_t m_viewportCount          : 5;
+    uint32_t m_sampleCount            : 7;
+    uint32_t m_reserved               : 13;
+
+  };
+
+
+  /**
+   * \brief Packed multisample state
+   */
+  class DxvkMsInfo {
+
+  public:
+
+    DxvkMsInfo() = default;
+
+    DxvkMsInfo(
+            VkSampleCountFlags    sampleCount,
+            uint32_t              sampleMask,
+            VkBool32              enableAlphaToCoverage,
+            VkBool32              enableAlphaToOne)
+    : m_sampleMask            (sampleMask),
+      m_sampleCount           (uint32_t(sampleCount)),
+      m_enableAlphaToCoverage (uint32_t(enableAlphaToCoverage)),
+      m_enableAlphaToOne      (uint32_t(enableAlphaToOne)),
+      m_reserved              (0) { }
+
+    VkSampleCountFlags sampleCount() const {
+      return VkSampleCountFlags(m_sampleCount);
+    }
+
+    uint32_t sampleMask() const {
+      return m_sampleMask;
+    }
+
+    VkBool32 enableAlphaToCoverage() const {
+      return VkBool32(m_enableAlphaToCoverage);
+    }
+
+    VkBool32 enableAlphaToOne() const {
+      return VkBool32(m_enableAlphaToOne);
+    }
+
+    void setSampleCount(VkSampleCountFlags sampleCount) {
+      m_sampleCount = uint32_t(sampleCount);
+    }
+
+  private:
+
+    uint32_t m_sampleMask;
+    uint32_t m_sampleCount            : 7;
+    uint32_t m_enableAlphaToCoverage  : 1;
+    uint32_t m_enableAlphaToOne       : 1;
+    uint32_t m_reserved               : 23;
+
+  };
+
+
+  /**
+   * \brief Packed depth-stencil state
+   *
+   * Stencil operations are stored separately. If the
+   * depth test is disabled, depth writes and the compare
+   * op have no effect and are normalized in order to
+   * avoid compiling redundant pipeline variants.
+   */
+  class DxvkDsInfo {
+
+  public:
+
+    DxvkDsInfo() = default;
+
+    DxvkDsInfo(
+            VkBool32 enableDepthTest,
+            VkBool32 enableDepthWrite,
+            VkBool32 enableStencilTest,
+            VkCompareOp depthCompareOp)
+    : m_enableDepthTest   (uint16_t(enableDepthTest)),
+      m_enableDepthWrite  (uint16_t(enableDepthTest ? enableDepthWrite : VK_FALSE)),
+      m_enableStencilTest (uint16_t(enableStencilTest)),
+      m_depthCompareOp    (uint16_t(enableDepthTest ? depthCompareOp : VK_COMPARE_OP_ALWAYS)),
+      m_reserved          (0) { }
+
+    VkBool32 enableDepthTest() const {
+      return VkBool32(m_enableDepthTest);
+    }
+
+    VkBool32 enableDepthWrite() const {
+      return VkBool32(m_enableDepthWrite);
+    }
+
+    VkBool32 enableStencilTest() const {
+      return VkBool32(m_enableStencilTest);
+    }
+
+    VkCompareOp depthCompareOp() const {
+      return VkCompareOp(m_depthCompareOp);
+    }
+
+  private:
+
+    uint16_t m_enableDepthTest        : 1;
+    uint16_t m_enableDepthWrite       : 1;
+    uint16_t m_enableStencilTest      : 1;
+    uint16_t m_depthCompareOp         : 3;
+    uint16_t m_reserved               : 10;
+
+  };
+
+
+  /**
+   * \brief Packed stencil op
+   *
+   * Stores the stencil operations for one face. The
+   * stencil reference as well as the compare and write
+   * masks are dynamic state and not stored here.
+   */
+  class DxvkDsStencilOp {
+
+  public:
+
+    DxvkDsStencilOp() = default;
+
+    DxvkDsStencilOp(const VkStencilOpState& state)
+    : m_failOp      (uint32_t(state.failOp)),
+      m_passOp      (uint32_t(state.passOp)),
+      m_depthFailOp (uint32_t(state.depthFailOp)),
+      m_compareOp   (uint32_t(state.compareOp)),
+      m_reserved    (0) { }
+
+    VkStencilOpState state() const {
+      VkStencilOpState result;
+      result.failOp      = VkStencilOp(m_failOp);
+      result.passOp      = VkStencilOp(m_passOp);
+      result.depthFailOp = VkStencilOp(m_depthFailOp);
+      result.compareOp   = VkCompareOp(m_compareOp);
+      result.compareMask = 0;
+      result.writeMask   = 0;
+      result.reference   = 0;
+      return result;
+    }
+
+  private:
+
+    uint32_t m_failOp                 : 3;
+    uint32_t m_passOp                 : 3;
+    uint32_t m_depthFailOp            : 3;
+    uint32_t m_compareOp              : 3;
+    uint32_t m_reserved               : 20;
+
+  };
+
+
+  /**
+   * \brief Packed output merger metadata
+   */
+  class DxvkOmInfo {
+
+  public:
+
+    DxvkOmInfo() = default;
+
+    DxvkOmInfo(
+            VkBool32    enableLogicOp,
+            VkLogicOp   logicOp)
+    : m_enableLogicOp (uint16_t(enableLogicOp)),
+      m_logicOp       (uint16_t(logicOp)),
+      m_reserved      (0) { }
+
+    VkBool32 enableLogicOp() const {
+      return VkBool32(m_enableLogicOp);
+    }
+
+    VkLogicOp logicOp() const {
+      return VkLogicOp(m_logicOp);
+    }
+
+  private:
+
+    uint16_t m_enableLogicOp          : 1;
+    uint16_t m_logicOp                : 4;
+    uint16_t m_reserved               : 11;
+
+  };
+
+
+  /**
+   * \brief Packed attachment blend mode
+   *
+   * Blend factors and ops are normalized if
+   * blending is disabled for the attachment.
+   */
+  class DxvkOmAttachmentBlend {
+
+  public:
+
+    DxvkOmAttachmentBlend() = default;
+
+    DxvkOmAttachmentBlend(
+            VkBool32              blendEnable,
+            VkBlendFactor         srcColorBlendFactor,
+            VkBlendFactor         dstColorBlendFactor,
+            VkBlendOp             colorBlendOp,
+            VkBlendFactor         srcAlphaBlendFactor,
+            VkBlendFactor         dstAlphaBlendFactor,
+            VkBlendOp             alphaBlendOp,
+            VkColorComponentFlags colorWriteMask)
+    : m_blendEnable         (uint32_t(blendEnable)),
+      m_srcColorBlendFactor (uint32_t(blendEnable ? srcColorBlendFactor : VK_BLEND_FACTOR_ONE)),
+      m_dstColorBlendFactor (uint32_t(blendEnable ? dstColorBlendFactor : VK_BLEND_FACTOR_ZERO)),
+      m_colorBlendOp        (uint32_t(blendEnable ? colorBlendOp        : VK_BLEND_OP_ADD)),
+      m_srcAlphaBlendFactor (uint32_t(blendEnable ? srcAlphaBlendFactor : VK_BLEND_FACTOR_ONE)),
+      m_dstAlphaBlendFactor (uint32_t(blendEnable ? dstAlphaBlendFactor : VK_BLEND_FACTOR_ZERO)),
+      m_alphaBlendOp        (uint32_t(blendEnable ? alphaBlendOp        : VK_BLEND_OP_ADD)),
+      m_colorWriteMask      (uint32_t(colorWriteMask)),
+      m_reserved            (0) { }
+
+    VkBool32 blendEnable() const {
+      return VkBool32(m_blendEnable);
+    }
+
+    VkBlendFactor srcColorBlendFactor() const {
+      return VkBlendFactor(m_srcColorBlendFactor);
+    }
+
+    VkBlendFactor dstColorBlendFactor() const {
+      return VkBlendFactor(m_dstColorBlendFactor);
+    }
+
+    VkBlendOp colorBlendOp() const {
+      return VkBlendOp(m_colorBlendOp);
+    }
+
+    VkBlendFactor srcAlphaBlendFactor() const {
+      return VkBlendFactor(m_srcAlphaBlendFactor);
+    }
+
+    VkBlendFactor dstAlphaBlendFactor() const {
+      return VkBlendFactor(m_dstAlphaBlendFactor);
+    }
+
+    VkBlendOp alphaBlendOp() const {
+      return VkBlendOp(m_alphaBlendOp);
+    }
+
+    VkColorComponentFlags colorWriteMask() const {
+      return VkColorComponentFlags(m_colorWriteMask);
+    }
+
+    VkPipelineColorBlendAttachmentState state() const {
+      VkPipelineColorBlendAttachmentState result;
+      result.blendEnable         = VkBool32(m_blendEnable);
+      result.srcColorBlendFactor = VkBlendFactor(m_srcColorBlendFactor);
+      result.dstColorBlendFactor = VkBlendFactor(m_dstColorBlendFactor);
+      result.colorBlendOp        = VkBlendOp(m_colorBlendOp);
+      result.srcAlphaBlendFactor = VkBlendFactor(m_srcAlphaBlendFactor);
+      result.dstAlphaBlendFactor = VkBlendFactor(m_dstAlphaBlendFactor);
+      result.alphaBlendOp        = VkBlendOp(m_alphaBlendOp);
+      result.colorWriteMask      = VkColorComponentFlags(m_colorWriteMask);
+      return result;
+    }
+
+  private:
+
+    uint32_t m_blendEnable            : 1;
+    uint32_t m_srcColorBlendFactor    : 5;
+    uint32_t m_dstColorBlendFactor    : 5;
+    uint32_t m_colorBlendOp           : 3;
+    uint32_t m_srcAlphaBlendFactor    : 5;
+    uint32_t m_dstAlphaBlendFactor    : 5;
+    uint32_t m_alphaBlendOp           : 3;
+    uint32_t m_colorWriteMask         : 4;
+    uint32_t m_reserved               : 1;
+
+  };
+
+
+  /**
+   * \brief Packed attachment component mapping
+   */
+  class DxvkOmAttachmentSwizzle {
+
+  public:
+
+    DxvkOmAttachmentSwizzle() = default;
+
+    DxvkOmAttachmentSwizzle(VkComponentMapping mapping)
+    : m_r       (uint16_t(mapping.r)),
+      m_g       (uint16_t(mapping.g)),
+      m_b       (uint16_t(mapping.b)),
+      m_a       (uint16_t(mapping.a)),
+      m_reserved(0) { }
+
+    VkComponentMapping mapping() const {
+      VkComponentMapping result;
+      result.r = VkComponentSwizzle(m_r);
+      result.g = VkComponentSwizzle(m_g);
+      result.b = VkComponentSwizzle(m_b);
+      result.a = VkComponentSwizzle(m_a);
+      return result;
+    }
+
+  private:
+
+    uint16_t m_r                      : 3;
+    uint16_t m_g                      : 3;
+    uint16_t m_b                      : 3;
+    uint16_t m_a                      : 3;
+    uint16_t m_reserved               : 4;
+
+  };
+
+
+  /**
+   * \brief Graphics pipeline state info
+   *
+   * Stores all information that is required to create
+   * a graphics pipeline, except the shader objects
+   * themselves. Also used to identify pipelines using
+   * the current pipeline state vector.
+   *
+   * All state is bit-packed in order to keep copies
+   * and comparisons cheap. The Vulkan structures are
+   * only generated when a pipeline gets compiled.
+   */
+  struct DxvkGraphicsPipelineStateInfo {
+    DxvkGraphicsPipelineStateInfo() {
+      std::memset(this, 0, sizeof(*this));
+    }
+
+    DxvkGraphicsPipelineStateInfo(const DxvkGraphicsPipelineStateInfo& other) {
+      std::memcpy(this, &other, sizeof(*this));
+    }
+
+    DxvkGraphicsPipelineStateInfo& operator = (const DxvkGraphicsPipelineStateInfo& other) {
+      std::memcpy(this, &other, sizeof(*this));
+      return *this;
+    }
+
+    bool operator == (const DxvkGraphicsPipelineStateInfo& other) const {
+      return std::memcmp(this, &other, sizeof(*this)) == 0;
+    }
+
+    bool operator != (const DxvkGraphicsPipelineStateInfo& other) const {
+      return std::memcmp(this, &other, sizeof(*this)) != 0;
+    }
+
+    size_t hash() const {
+      const uint32_t* words = reinterpret_cast<const uint32_t*>(this);
+
+      DxvkHashState result;
+
+      for (size_t i = 0; i < sizeof(*this) / sizeof(uint32_t); i++)
+        result.add(words[i]);
+
+      return result;
+    }
+
+    bool useDynamicStencilRef() const {
+      return ds.enableStencilTest();
+    }
+
+    bool useDynamicStencilMask() const {
+      return ds.enableStencilTest();
+    }
+
+    bool useDynamicDepthBias() const {
+      return rs.depthBiasEnable();
+    }
+
+    bool useDynamicBlendConstants() const {
+      bool result = false;
+
+      for (uint32_t i = 0; i < MaxNumRenderTargets && !result; i++) {
+        result |= omBlend[i].blendEnable()
+         && (util::isBlendConstantBlendFactor(omBlend[i].srcColorBlendFactor())
+          || util::isBlendConstantBlendFactor(omBlend[i].dstColorBlendFactor())
+          || util::isBlendConstantBlendFactor(omBlend[i].srcAlphaBlendFactor())
+          || util::isBlendConstantBlendFactor(omBlend[i].dstAlphaBlendFactor()));
+      }
+
+      return result;
+    }
+
+    DxvkBindingMask         bsBindingMask;
+    DxvkRsInfo              rs;
+    DxvkMsInfo              ms;
+    DxvkIaInfo              ia;
+    DxvkIlInfo              il;
+    DxvkDsInfo              ds;
+    DxvkOmInfo              om;
+    DxvkDsStencilOp         dsFront;
+    DxvkDsStencilOp         dsBack;
+    DxvkOmAttachmentBlend   omBlend[MaxNumRenderTargets];
+    DxvkOmAttachmentSwizzle omSwizzle[MaxNumRenderTargets];
+    DxvkIlAttribute         ilAttributes[DxvkLimits::MaxNumVertexAttributes];
+    DxvkIlBinding           ilBindings[DxvkLimits::MaxNumVertexBindings];
+  };
+
+  static_assert(sizeof(DxvkGraphicsPipelineStateInfo) % sizeof(uint32_t) == 0,
+    "Pipeline state size must be a multiple of four bytes");
+
+}
@@ -18,6 +18,8 @@
 #include "../util/sync/sync_spinlock.h"
 #include "../util/sync/sync_ticketlock.h"
 
+#include "../util/trace/trace.h"
+
 #include "../vulkan/vulkan_loader.h"
 #include "../vulkan/vulkan_names.h"
 #include "../vulkan/vulkan_util.h"
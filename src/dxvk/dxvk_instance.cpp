@@ -72,7 +72,8 @@ namespace dxvk {
   VkInstance DxvkInstance::createInstance() {
     DxvkInstanceExtensions insExtensions;
 
-    std::array<DxvkExt*, 3> insExtensionList = {{
+    std::array<DxvkExt*, 4> insExtensionList = {{
+      &insExtensions.extDebugUtils,
       &insExtensions.khrGetPhysicalDeviceProperties2,
       &insExtensions.khrSurface,
       &insExtensions.khrWin32Surface,
@@ -86,6 +87,8 @@ namespace dxvk {
           insExtensionList.data(),
           extensionsEnabled))
       throw DxvkError("DxvkInstance: Failed to create instance");
+
+    m_extensions = insExtensions;
     
     // Enable additional extensions if necessary
     extensionsEnabled.merge(g_vrInstance.getInstanceExtensions());
@@ -39,6 +39,14 @@ namespace dxvk {
       return m_vki->instance();
     }
     
+    /**
+     * \brief Enabled instance extensions
+     * \returns Enabled instance extensions
+     */
+    const DxvkInstanceExtensions& extensions() const {
+      return m_extensions;
+    }
+    
     /**
      * \brief Retrieves an adapter
      * 
@@ -95,6 +103,8 @@ namespace dxvk {
     Rc<vk::LibraryFn>   m_vkl;
     Rc<vk::InstanceFn>  m_vki;
 
+    DxvkInstanceExtensions m_extensions;
+
     std::vector<Rc<DxvkAdapter>> m_adapters;
     
     VkInstance createInstance();
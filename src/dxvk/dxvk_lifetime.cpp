@@ -6,6 +6,12 @@ namespace dxvk {
   DxvkLifetimeTracker::~DxvkLifetimeTracker() { }
   
   
+  void DxvkLifetimeTracker::notify(uint64_t submissionId) {
+    for (const auto& resource : m_resources)
+      resource->notifySubmission(submissionId);
+  }
+  
+  
   void DxvkLifetimeTracker::reset() {
     for (const auto& resource : m_resources)
       resource->release();
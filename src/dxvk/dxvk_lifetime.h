@@ -30,6 +30,15 @@ namespace dxvk {
       m_resources.emplace_back(std::move(rc));
     }
     
+    /**
+     * \brief Notifies resources about a submission
+     * 
+     * Stores the submission sequence number of the
+     * command list in all tracked resources.
+     * \param [in] submissionId Submission sequence number
+     */
+    void notify(uint64_t submissionId);
+    
     /**
      * \brief Resets the command list
      * 
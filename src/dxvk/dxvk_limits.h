@@ -18,6 +18,8 @@ namespace dxvk {
     MaxUniformBufferSize        = 65536,
     MaxVertexBindingStride      =  2048,
     MaxPushConstantSize         =   128,
+    MaxNumClearRects            =     6,
+    MaxNumClearViews            =     4,
   };
   
 }
\ No newline at end of file
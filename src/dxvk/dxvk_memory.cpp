@@ -28,7 +28,8 @@ namespace dxvk {
     m_memory  (std::exchange(other.m_memory, VkDeviceMemory(VK_NULL_HANDLE))),
     m_offset  (std::exchange(other.m_offset, 0)),
     m_length  (std::exchange(other.m_length, 0)),
-    m_mapPtr  (std::exchange(other.m_mapPtr, nullptr)) { }
+    m_mapPtr  (std::exchange(other.m_mapPtr, nullptr)),
+    m_demoted (std::exchange(other.m_demoted, false)) { }
   
   
   DxvkMemory& DxvkMemory::operator = (DxvkMemory&& other) {
@@ -40,6 +41,7 @@ namespace dxvk {
     m_offset  = std::exchange(other.m_offset, 0);
     m_length  = std::exchange(other.m_length, 0);
     m_mapPtr  = std::exchange(other.m_mapPtr, nullptr);
+    m_demoted = std::exchange(other.m_demoted, false);
     return *this;
   }
   
@@ -49,6 +51,12 @@ namespace dxvk {
   }
   
   
+  bool DxvkMemory::needsRelocation() const {
+    return m_chunk != nullptr
+        && m_chunk->isEvacuating();
+  }
+
+
   void DxvkMemory::free() {
     if (m_alloc != nullptr)
       m_alloc->free(*this);
@@ -66,8 +74,8 @@ namespace dxvk {
   
   
   DxvkMemoryChunk::~DxvkMemoryChunk() {
-    // This call is technically not thread-safe, but it
-    // doesn't need to be since we don't free chunks
+    // Chunks are only freed by the allocator while
+    // it holds the lock, so this is thread-safe
     m_alloc->freeDeviceMemory(m_type, m_memory);
   }
   
@@ -83,8 +91,8 @@ namespace dxvk {
      || m_memory.priority != priority)
       return DxvkMemory();
     
-    // If the chunk is full, return
-    if (m_freeList.size() == 0)
+    // If the chunk is full or being evacuated, return
+    if (m_freeList.size() == 0 || m_evacuate.load())
       return DxvkMemory();
     
     // Select the slice to allocate from in a worst-fit
@@ -120,6 +128,8 @@ namespace dxvk {
     if (allocEnd != sliceEnd)
       m_freeList.push_back({ allocEnd, sliceEnd - allocEnd });
     
+    m_usedMemory += allocEnd - allocStart;
+    
     // Create the memory object with the aligned slice
     return DxvkMemory(m_alloc, this, m_type,
       m_memory.memHandle, allocStart, allocEnd - allocStart,
@@ -133,6 +143,8 @@ namespace dxvk {
     // Remove adjacent entries from the free list and then add
     // a new slice that covers all those entries. Without doing
     // so, the slice could not be reused for larger allocations.
+    m_usedMemory -= length;
+
     auto curr = m_freeList.begin();
     
     while (curr != m_freeList.end()) {
@@ -156,13 +168,16 @@ namespace dxvk {
   : m_vkd             (device->vkd()),
     m_device          (device),
     m_devProps        (device->adapter()->deviceProperties()),
-    m_memProps        (device->adapter()->memoryProperties()) {
+    m_memProps        (device->adapter()->memoryProperties()),
+    m_budgetPercent   (std::max(device->config().memoryBudgetPercent, 0)) {
     for (uint32_t i = 0; i < m_memProps.memoryHeapCount; i++) {
       VkDeviceSize heapSize = m_memProps.memoryHeaps[i].size;
       
-      m_memHeaps[i].properties = m_memProps.memoryHeaps[i];
-      m_memHeaps[i].chunkSize  = pickChunkSize(heapSize);
-      m_memHeaps[i].stats      = DxvkMemoryStats { 0, 0 };
+      m_memHeaps[i].properties    = m_memProps.memoryHeaps[i];
+      m_memHeaps[i].chunkSize     = pickChunkSize(heapSize);
+      m_memHeaps[i].budget        = heapSize;
+      m_memHeaps[i].externalUsage = 0;
+      m_memHeaps[i].stats         = DxvkMemoryStats();
     }
     
     for (uint32_t i = 0; i < m_memProps.memoryTypeCount; i++) {
@@ -171,6 +186,8 @@ namespace dxvk {
       m_memTypes[i].memType    = m_memProps.memoryTypes[i];
       m_memTypes[i].memTypeId  = i;
     }
+
+    this->updateBudget();
   }
   
   
@@ -189,10 +206,41 @@ namespace dxvk {
     VkMemoryPropertyFlags optFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
                                    | VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
     
-    DxvkMemory result = this->tryAlloc(req, dedAllocInfo, flags, priority);
+    // The driver-reported budget changes over time, but the query
+    // is not free, so we only poll it in regular intervals.
+    if (flags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) {
+      if (Clock::now() - m_budgetPollTime > std::chrono::milliseconds(500))
+        this->updateBudget();
+    }
+
+    DxvkMemory result;
+
+    // Move low-priority allocations to system memory if the
+    // device-local heap would exceed its budget otherwise,
+    // so that render targets and other resources written
+    // by the GPU do not get paged out by the driver.
+    if (this->canDemote(flags, priority)) {
+      result = this->tryAlloc(req, dedAllocInfo,
+        flags, 0, priority, true);
+
+      if (!result) {
+        result = this->tryAlloc(req, dedAllocInfo,
+          flags & ~VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+          VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, priority, false);
+        
+        if (result) {
+          result.m_demoted = true;
+          result.m_type->heap->stats.memoryDemoted += result.m_length;
+          result.m_type->heap->stats.demotionCount += 1;
+        }
+      }
+    }
+
+    if (!result)
+      result = this->tryAlloc(req, dedAllocInfo, flags, 0, priority, false);
 
     if (!result && (flags & optFlags))
-      result = this->tryAlloc(req, dedAllocInfo, flags & ~optFlags, priority);
+      result = this->tryAlloc(req, dedAllocInfo, flags & ~optFlags, 0, priority, false);
     
     if (!result) {
       Logger::err(str::format(
@@ -216,24 +264,98 @@ namespace dxvk {
     for (size_t i = 0; i < m_memProps.memoryHeapCount; i++) {
       totalStats.memoryAllocated += m_memHeaps[i].stats.memoryAllocated;
       totalStats.memoryUsed      += m_memHeaps[i].stats.memoryUsed;
+      totalStats.memoryDemoted   += m_memHeaps[i].stats.memoryDemoted;
+      totalStats.demotionCount   += m_memHeaps[i].stats.demotionCount;
+
+      if (m_memHeaps[i].properties.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
+        totalStats.memoryBudget  += m_memHeaps[i].budget;
     }
       
     return totalStats;
   }
   
   
+  void DxvkMemoryAllocator::updateDefragmentation() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Give up on chunks that still hold resources after this
+    // many frames, since those are likely not relocatable.
+    constexpr uint32_t MaxEvacuateFrames = 300;
+
+    for (uint32_t i = 0; i < m_memProps.memoryTypeCount; i++) {
+      DxvkMemoryType* type = &m_memTypes[i];
+
+      DxvkMemoryChunk* candidate = nullptr;
+      bool             evacuating = false;
+
+      for (const auto& chunk : type->chunks) {
+        if (chunk->isEvacuating()) {
+          if (++chunk->m_evacuateFrames > MaxEvacuateFrames) {
+            chunk->m_evacuate       = false;
+            chunk->m_evacuateFailed = true;
+          } else {
+            evacuating = true;
+          }
+        }
+      }
+
+      // Only evacuate one chunk per memory type at a time
+      // in order to keep the amount of copies per frame low
+      if (evacuating)
+        continue;
+
+      for (const auto& chunk : type->chunks) {
+        const DxvkDeviceMemory& mem = chunk->m_memory;
+
+        bool eligible = !chunk->m_evacuateFailed
+          && (mem.memFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
+          && !(mem.memFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+          && (chunk->m_usedMemory != 0)
+          && (chunk->m_usedMemory < mem.memSize / 4);
+
+        if (eligible && (!candidate || chunk->m_usedMemory < candidate->m_usedMemory))
+          candidate = chunk.ptr();
+      }
+
+      if (!candidate)
+        continue;
+
+      // Only evacuate the chunk if other chunks with compatible
+      // properties have enough free memory to take its resources,
+      // otherwise we would just end up allocating a new chunk.
+      VkDeviceSize freeMemory = 0;
+
+      for (const auto& chunk : type->chunks) {
+        if (chunk.ptr() != candidate
+         && chunk->m_memory.memFlags == candidate->m_memory.memFlags
+         && chunk->m_memory.priority == candidate->m_memory.priority)
+          freeMemory += chunk->m_memory.memSize - chunk->m_usedMemory;
+      }
+
+      if (freeMemory >= candidate->m_usedMemory) {
+        candidate->m_evacuate       = true;
+        candidate->m_evacuateFrames = 0;
+      }
+    }
+  }
+  
+  
   DxvkMemory DxvkMemoryAllocator::tryAlloc(
     const VkMemoryRequirements*             req,
     const VkMemoryDedicatedAllocateInfoKHR* dedAllocInfo,
           VkMemoryPropertyFlags             flags,
-          float                             priority) {
+          VkMemoryPropertyFlags             excludeFlags,
+          float                             priority,
+          bool                              withinBudget) {
     DxvkMemory result;
 
     for (uint32_t i = 0; i < m_memProps.memoryTypeCount && !result; i++) {
       const bool supported = (req->memoryTypeBits & (1u << i)) != 0;
-      const bool adequate  = (m_memTypes[i].memType.propertyFlags & flags) == flags;
+      const bool adequate  = (m_memTypes[i].memType.propertyFlags & flags) == flags
+                          && (m_memTypes[i].memType.propertyFlags & excludeFlags) == 0;
+      const bool budgeted  = !withinBudget || this->isWithinBudget(&m_memTypes[i], req->size);
       
-      if (supported && adequate) {
+      if (supported && adequate && budgeted) {
         result = this->tryAllocFromType(&m_memTypes[i],
           flags, req->size, req->alignment, priority, dedAllocInfo);
       }
@@ -337,6 +459,9 @@ namespace dxvk {
     std::lock_guard<std::mutex> lock(m_mutex);
     memory.m_type->heap->stats.memoryUsed -= memory.m_length;
 
+    if (memory.m_demoted)
+      memory.m_type->heap->stats.memoryDemoted -= memory.m_length;
+
     if (memory.m_chunk != nullptr) {
       this->freeChunkMemory(
         memory.m_type,
@@ -359,6 +484,17 @@ namespace dxvk {
           VkDeviceSize          offset,
           VkDeviceSize          length) {
     chunk->free(offset, length);
+
+    // Release evacuated chunks as soon as the
+    // last resource has been moved out of them
+    if (chunk->isEvacuating() && !chunk->m_usedMemory) {
+      for (auto i = type->chunks.begin(); i != type->chunks.end(); i++) {
+        if (i->ptr() == chunk) {
+          type->chunks.erase(i);
+          break;
+        }
+      }
+    }
   }
   
 
@@ -381,4 +517,53 @@ namespace dxvk {
     return std::min(heapSize / MinChunkCount, MaxChunkSize);
   }
   
+
+
+  void DxvkMemoryAllocator::updateBudget() {
+    DxvkAdapterMemoryInfo info = m_device->adapter()->getMemoryHeapInfo();
+
+    for (uint32_t i = 0; i < info.heapCount && i < m_memProps.memoryHeapCount; i++) {
+      DxvkMemoryHeap& heap = m_memHeaps[i];
+
+      // The reported usage includes our own allocations. Store the
+      // remainder so that we can estimate the total heap usage
+      // between two polls without querying the driver again.
+      VkDeviceSize usage = info.heaps[i].memoryAllocated;
+
+      heap.externalUsage = usage > heap.stats.memoryAllocated
+        ? usage - heap.stats.memoryAllocated : 0;
+      heap.budget = std::min(info.heaps[i].memoryAvailable, heap.properties.size)
+                  * m_budgetPercent / 100;
+    }
+
+    m_budgetPollTime = Clock::now();
+  }
+
+
+  bool DxvkMemoryAllocator::canDemote(
+          VkMemoryPropertyFlags             flags,
+          float                             priority) const {
+    // Only resources with the lowest priority, i.e. buffers
+    // written by the CPU, get demoted. Textures and resources
+    // written by the GPU must stay in device-local memory.
+    return (flags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
+        && (m_budgetPercent != 0)
+        && (priority <= 0.0f);
+  }
+
+
+  bool DxvkMemoryAllocator::isWithinBudget(
+    const DxvkMemoryType*                   type,
+          VkDeviceSize                      size) const {
+    if (!(type->memType.propertyFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT))
+      return true;
+    
+    const DxvkMemoryHeap* heap = type->heap;
+
+    VkDeviceSize usage = heap->externalUsage
+                       + heap->stats.memoryAllocated
+                       + size;
+    return usage <= heap->budget;
+  }
+
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <chrono>
+
 #include "dxvk_adapter.h"
 
 namespace dxvk {
@@ -14,8 +16,11 @@ namespace dxvk {
    * allocated and used by the application.
    */
   struct DxvkMemoryStats {
-    VkDeviceSize memoryAllocated = 0;
-    VkDeviceSize memoryUsed      = 0;
+    VkDeviceSize memoryAllocated  = 0;
+    VkDeviceSize memoryUsed       = 0;
+    VkDeviceSize memoryBudget     = 0;
+    VkDeviceSize memoryDemoted    = 0;
+    uint64_t     demotionCount    = 0;
   };
   
   
@@ -40,10 +45,15 @@ namespace dxvk {
    * 
    * Corresponds to a Vulkan memory heap and stores
    * its properties as well as allocation statistics.
+   * The soft budget and the amount of memory used by
+   * other devices or processes are updated whenever
+   * the allocator polls the driver's memory budget.
    */
   struct DxvkMemoryHeap {
     VkMemoryHeap      properties;
     VkDeviceSize      chunkSize;
+    VkDeviceSize      budget;
+    VkDeviceSize      externalUsage;
     DxvkMemoryStats   stats;
   };
 
@@ -121,6 +131,26 @@ namespace dxvk {
       return reinterpret_cast<char*>(m_mapPtr) + offset;
     }
 
+    /**
+     * \brief Checks whether the allocation should be moved
+     * 
+     * \returns \c true if the allocation lives in a memory
+     *          chunk that is being evacuated in order to
+     *          reduce memory fragmentation.
+     */
+    bool needsRelocation() const;
+
+    /**
+     * \brief Checks whether the allocation was demoted
+     * 
+     * \returns \c true if the allocation was moved to
+     *          system memory because the device-local
+     *          heap was over budget at allocation time.
+     */
+    bool isDemoted() const {
+      return m_demoted;
+    }
+
     /**
      * \brief Checks whether the memory slice is defined
      * 
@@ -140,6 +170,7 @@ namespace dxvk {
     VkDeviceSize          m_offset = 0;
     VkDeviceSize          m_length = 0;
     void*                 m_mapPtr = nullptr;
+    bool                  m_demoted = false;
     
     void free();
     
@@ -153,7 +184,7 @@ namespace dxvk {
    * sub-allocator. This is not thread-safe.
    */
   class DxvkMemoryChunk : public RcObject {
-    
+    friend class DxvkMemoryAllocator;
   public:
     
     DxvkMemoryChunk(
@@ -193,6 +224,17 @@ namespace dxvk {
             VkDeviceSize  offset,
             VkDeviceSize  length);
     
+    /**
+     * \brief Checks whether the chunk is being evacuated
+     * 
+     * Evacuated chunks do not serve any new allocations,
+     * and will be freed as soon as they are empty.
+     * \returns \c true if the chunk is being evacuated
+     */
+    bool isEvacuating() const {
+      return m_evacuate.load();
+    }
+    
   private:
     
     struct FreeSlice {
@@ -203,8 +245,13 @@ namespace dxvk {
     DxvkMemoryAllocator*  m_alloc;
     DxvkMemoryType*       m_type;
     DxvkDeviceMemory      m_memory;
+    VkDeviceSize          m_usedMemory = 0;
     
     std::vector<FreeSlice> m_freeList;
+
+    std::atomic<bool>     m_evacuate       = { false };
+    uint32_t              m_evacuateFrames = 0;
+    bool                  m_evacuateFailed = false;
     
   };
   
@@ -254,13 +301,27 @@ namespace dxvk {
      * \brief Queries memory stats
      * 
      * Returns the total amount of device memory
-     * allocated and used by all available heaps.
+     * allocated and used by all available heaps,
+     * as well as the soft budget of device-local
+     * heaps and the number of demoted allocations.
      * \returns Global memory stats
      */
     DxvkMemoryStats getMemoryStats();
     
+    /**
+     * \brief Selects memory chunks to evacuate
+     * 
+     * Should be called once per frame. Picks a sparsely
+     * used device-local chunk per memory type if other
+     * chunks can take its allocations, so that the chunk
+     * can be freed once all resources are relocated.
+     */
+    void updateDefragmentation();
+    
   private:
 
+    using Clock = std::chrono::high_resolution_clock;
+
     const Rc<vk::DeviceFn>                 m_vkd;
     const DxvkDevice*                      m_device;
     const VkPhysicalDeviceProperties       m_devProps;
@@ -269,12 +330,17 @@ namespace dxvk {
     std::mutex                                      m_mutex;
     std::array<DxvkMemoryHeap, VK_MAX_MEMORY_HEAPS> m_memHeaps;
     std::array<DxvkMemoryType, VK_MAX_MEMORY_TYPES> m_memTypes;
+
+    VkDeviceSize      m_budgetPercent;
+    Clock::time_point m_budgetPollTime;
     
     DxvkMemory tryAlloc(
       const VkMemoryRequirements*             req,
       const VkMemoryDedicatedAllocateInfoKHR* dedAllocInfo,
             VkMemoryPropertyFlags             flags,
-            float                             priority);
+            VkMemoryPropertyFlags             excludeFlags,
+            float                             priority,
+            bool                              withinBudget);
     
     DxvkMemory tryAllocFromType(
             DxvkMemoryType*                   type,
@@ -307,6 +373,16 @@ namespace dxvk {
     VkDeviceSize pickChunkSize(
             VkDeviceSize          heapSize) const;
 
+    void updateBudget();
+
+    bool canDemote(
+            VkMemoryPropertyFlags             flags,
+            float                             priority) const;
+
+    bool isWithinBudget(
+      const DxvkMemoryType*                   type,
+            VkDeviceSize                      size) const;
+
   };
   
 }
\ No newline at end of file
@@ -12,18 +12,22 @@
 #include <dxvk_clear_image2darr_u.h>
 #include <dxvk_clear_image3d_f.h>
 #include <dxvk_clear_image3d_u.h>
+#include <dxvk_clear_images2d_f.h>
+#include <dxvk_clear_images2d_u.h>
 
 namespace dxvk {
   
   DxvkMetaClearObjects::DxvkMetaClearObjects(const Rc<vk::DeviceFn>& vkd)
   : m_vkd(vkd) {
     // Create descriptor set layouts
-    m_clearBufDsetLayout = createDescriptorSetLayout(VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER);
-    m_clearImgDsetLayout = createDescriptorSetLayout(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE);
+    m_clearBufDsetLayout = createDescriptorSetLayout(VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER, 1);
+    m_clearImgDsetLayout = createDescriptorSetLayout(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1);
+    m_clearBatDsetLayout = createDescriptorSetLayout(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, MaxNumClearViews);
     
     // Create pipeline layouts using those descriptor set layouts
-    m_clearBufPipeLayout = createPipelineLayout(m_clearBufDsetLayout);
-    m_clearImgPipeLayout = createPipelineLayout(m_clearImgDsetLayout);
+    m_clearBufPipeLayout = createPipelineLayout(m_clearBufDsetLayout, sizeof(DxvkMetaClearArgs));
+    m_clearImgPipeLayout = createPipelineLayout(m_clearImgDsetLayout, sizeof(DxvkMetaClearImageArgs));
+    m_clearBatPipeLayout = createPipelineLayout(m_clearBatDsetLayout, sizeof(DxvkMetaClearImageBatchArgs));
     
     // Create the actual compute pipelines
     m_clearPipesF32.clearBuf = createPipeline(dxvk_clear_buffer_f, m_clearBufPipeLayout);
@@ -40,6 +44,9 @@ namespace dxvk {
     m_clearPipesU32.clearImg1DArray = createPipeline(dxvk_clear_image1darr_u, m_clearImgPipeLayout);
     m_clearPipesF32.clearImg2DArray = createPipeline(dxvk_clear_image2darr_f, m_clearImgPipeLayout);
     m_clearPipesU32.clearImg2DArray = createPipeline(dxvk_clear_image2darr_u, m_clearImgPipeLayout);
+    
+    m_clearPipesF32.clearImg2DBatch = createPipeline(dxvk_clear_images2d_f, m_clearBatPipeLayout);
+    m_clearPipesU32.clearImg2DBatch = createPipeline(dxvk_clear_images2d_u, m_clearBatPipeLayout);
   }
   
   
@@ -60,13 +67,18 @@ namespace dxvk {
     m_vkd->vkDestroyPipeline(m_vkd->device(), m_clearPipesF32.clearImg2DArray, nullptr);
     m_vkd->vkDestroyPipeline(m_vkd->device(), m_clearPipesU32.clearImg2DArray, nullptr);
     
+    m_vkd->vkDestroyPipeline(m_vkd->device(), m_clearPipesF32.clearImg2DBatch, nullptr);
+    m_vkd->vkDestroyPipeline(m_vkd->device(), m_clearPipesU32.clearImg2DBatch, nullptr);
+    
     // Destroy pipeline layouts
     m_vkd->vkDestroyPipelineLayout(m_vkd->device(), m_clearBufPipeLayout, nullptr);
     m_vkd->vkDestroyPipelineLayout(m_vkd->device(), m_clearImgPipeLayout, nullptr);
+    m_vkd->vkDestroyPipelineLayout(m_vkd->device(), m_clearBatPipeLayout, nullptr);
     
     // Destroy descriptor set layouts
     m_vkd->vkDestroyDescriptorSetLayout(m_vkd->device(), m_clearBufDsetLayout, nullptr);
     m_vkd->vkDestroyDescriptorSetLayout(m_vkd->device(), m_clearImgDsetLayout, nullptr);
+    m_vkd->vkDestroyDescriptorSetLayout(m_vkd->device(), m_clearBatDsetLayout, nullptr);
   }
   
   
@@ -113,12 +125,28 @@ namespace dxvk {
   }
   
   
+  DxvkMetaClearPipeline DxvkMetaClearObjects::getClearImageBatchPipeline(
+          DxvkFormatFlags       formatFlags) const {
+    DxvkMetaClearPipeline result;
+    result.dsetLayout = m_clearBatDsetLayout;
+    result.pipeLayout = m_clearBatPipeLayout;
+    result.pipeline   = m_clearPipesF32.clearImg2DBatch;
+    
+    if (formatFlags.any(DxvkFormatFlag::SampledUInt, DxvkFormatFlag::SampledSInt))
+      result.pipeline = m_clearPipesU32.clearImg2DBatch;
+    
+    result.workgroupSize = VkExtent3D { 8, 8, 1 };
+    return result;
+  }
+  
+  
   VkDescriptorSetLayout DxvkMetaClearObjects::createDescriptorSetLayout(
-          VkDescriptorType        descriptorType) {
+          VkDescriptorType        descriptorType,
+          uint32_t                descriptorCount) {
     VkDescriptorSetLayoutBinding bindInfo;
     bindInfo.binding            = 0;
     bindInfo.descriptorType     = descriptorType;
-    bindInfo.descriptorCount    = 1;
+    bindInfo.descriptorCount    = descriptorCount;
     bindInfo.stageFlags         = VK_SHADER_STAGE_COMPUTE_BIT;
     bindInfo.pImmutableSamplers = nullptr;
     
@@ -138,11 +166,12 @@ namespace dxvk {
   
   
   VkPipelineLayout DxvkMetaClearObjects::createPipelineLayout(
-          VkDescriptorSetLayout   dsetLayout) {
+          VkDescriptorSetLayout   dsetLayout,
+          uint32_t                pushSize) {
     VkPushConstantRange pushInfo;
     pushInfo.stageFlags         = VK_SHADER_STAGE_COMPUTE_BIT;
     pushInfo.offset             = 0;
-    pushInfo.size               = sizeof(DxvkMetaClearArgs);
+    pushInfo.size               = pushSize;
     
     VkPipelineLayoutCreateInfo pipeInfo;
     pipeInfo.sType              = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
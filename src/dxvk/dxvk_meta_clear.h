@@ -2,6 +2,7 @@
 
 #include "dxvk_format.h"
 #include "dxvk_include.h"
+#include "dxvk_limits.h"
 
 #include "../spirv/spirv_code_buffer.h"
 
@@ -21,6 +22,48 @@ namespace dxvk {
   };
   
   
+  /**
+   * \brief Image clear args
+   * 
+   * Push constants for the image clear shaders.
+   * Up to \c MaxNumClearRects rectangles of the same
+   * view can be cleared with a single dispatch. The
+   * slice range is only used for 3D images, which
+   * only support one rectangle at a time.
+   */
+  struct DxvkMetaClearImageArgs {
+    VkClearColorValue clearValue;
+    int32_t           zOffset;
+    uint32_t          zExtent;
+    uint32_t          rectCount;
+    uint32_t          reserved;
+    VkRect2D          rects[MaxNumClearRects];
+  };
+  
+  static_assert(sizeof(DxvkMetaClearImageArgs) <= MaxPushConstantSize,
+    "DxvkMetaClearImageArgs exceeds push constant size");
+  
+  
+  /**
+   * \brief Batched image clear args
+   * 
+   * Push constants for the shaders which clear
+   * rectangles of up to \c MaxNumClearViews different
+   * 2D views at once. Each rectangle stores the index
+   * of its view in two bits of \c rectViews. Offsets
+   * and extents are packed into 16-bit pairs.
+   */
+  struct DxvkMetaClearImageBatchArgs {
+    VkClearColorValue clearValues[MaxNumClearViews];
+    uint32_t          rectCount;
+    uint32_t          rectViews;
+    uint32_t          rects[MaxNumClearRects][2];
+  };
+  
+  static_assert(sizeof(DxvkMetaClearImageBatchArgs) <= MaxPushConstantSize,
+    "DxvkMetaClearImageBatchArgs exceeds push constant size");
+  
+  
   /**
    * \brief Pipeline-related objects
    * 
@@ -73,6 +116,18 @@ namespace dxvk {
             VkImageViewType       viewType,
             DxvkFormatFlags       formatFlags) const;
     
+    /**
+     * \brief Retrieves objects for batched 2D image clears
+     * 
+     * The descriptor set layout contains an array of
+     * \c MaxNumClearViews storage images, all of which
+     * must be written before dispatching the pipeline.
+     * \param [in] formatFlags Format flags of the views
+     * \returns The pipeline-related objects to use
+     */
+    DxvkMetaClearPipeline getClearImageBatchPipeline(
+            DxvkFormatFlags       formatFlags) const;
+    
   private:
     
     struct DxvkMetaClearPipelines {
@@ -82,24 +137,29 @@ namespace dxvk {
       VkPipeline clearImg3D      = VK_NULL_HANDLE;
       VkPipeline clearImg1DArray = VK_NULL_HANDLE;
       VkPipeline clearImg2DArray = VK_NULL_HANDLE;
+      VkPipeline clearImg2DBatch = VK_NULL_HANDLE;
     };
     
     Rc<vk::DeviceFn> m_vkd;
     
     VkDescriptorSetLayout m_clearBufDsetLayout = VK_NULL_HANDLE;
     VkDescriptorSetLayout m_clearImgDsetLayout = VK_NULL_HANDLE;
+    VkDescriptorSetLayout m_clearBatDsetLayout = VK_NULL_HANDLE;
     
     VkPipelineLayout m_clearBufPipeLayout = VK_NULL_HANDLE;
     VkPipelineLayout m_clearImgPipeLayout = VK_NULL_HANDLE;
+    VkPipelineLayout m_clearBatPipeLayout = VK_NULL_HANDLE;
     
     DxvkMetaClearPipelines m_clearPipesF32;
     DxvkMetaClearPipelines m_clearPipesU32;
     
     VkDescriptorSetLayout createDescriptorSetLayout(
-            VkDescriptorType        descriptorType);
+            VkDescriptorType        descriptorType,
+            uint32_t                descriptorCount);
     
     VkPipelineLayout createPipelineLayout(
-            VkDescriptorSetLayout   dsetLayout);
+            VkDescriptorSetLayout   dsetLayout,
+            uint32_t                pushSize);
     
     VkPipeline createPipeline(
       const SpirvCodeBuffer&        spirvCode,
@@ -3,10 +3,14 @@
 namespace dxvk {
 
   DxvkOptions::DxvkOptions(const Config& config) {
-    enableStateCache      = config.getOption<bool>    ("dxvk.enableStateCache",       true);
-    numCompilerThreads    = config.getOption<int32_t> ("dxvk.numCompilerThreads",     0);
-    useRawSsbo            = config.getOption<Tristate>("dxvk.useRawSsbo",             Tristate::Auto);
-    useEarlyDiscard       = config.getOption<Tristate>("dxvk.useEarlyDiscard",        Tristate::Auto);
+    enableStateCache       = config.getOption<bool>    ("dxvk.enableStateCache",        true);
+    numCompilerThreads     = config.getOption<int32_t> ("dxvk.numCompilerThreads",      0);
+    bindDummyResources     = config.getOption<bool>    ("dxvk.bindDummyResources",      false);
+    memoryBudgetPercent    = config.getOption<int32_t> ("dxvk.memoryBudgetPercent",     90);
+    defragMemoryPerFrame   = config.getOption<int32_t> ("dxvk.defragMemoryPerFrame",    4);
+    eliminateUnusedOutputs = config.getOption<bool>    ("dxvk.eliminateUnusedOutputs",  true);
+    useRawSsbo             = config.getOption<Tristate>("dxvk.useRawSsbo",              Tristate::Auto);
+    useEarlyDiscard        = config.getOption<Tristate>("dxvk.useEarlyDiscard",         Tristate::Auto);
   }
 
 }
\ No newline at end of file
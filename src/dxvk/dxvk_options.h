@@ -15,6 +15,24 @@ namespace dxvk {
     /// when using the state cache
     int32_t numCompilerThreads;
 
+    /// Bind dummy resources to unbound read-only
+    /// slots instead of compiling pipeline variants
+    bool bindDummyResources;
+
+    /// Soft budget for device-local memory heaps, in
+    /// percent of the budget reported by the driver.
+    /// Setting this to zero disables demotion.
+    int32_t memoryBudgetPercent;
+
+    /// Maximum amount of memory, in MiB, to relocate
+    /// per frame when defragmenting device memory.
+    /// Setting this to zero disables defragmentation.
+    int32_t defragMemoryPerFrame;
+
+    /// Remove shader outputs that are not
+    /// read by the next pipeline stage
+    bool eliminateUnusedOutputs;
+
     /// Shader-related options
     Tristate useRawSsbo;
     Tristate useEarlyDiscard;
@@ -32,6 +32,12 @@ namespace dxvk {
   }
   
   
+  void DxvkDescriptorSlotMapping::definePushConstSlot(
+    const DxvkPushConstantSlot& slot) {
+    m_pushConstSlots.push_back(slot);
+  }
+  
+  
   uint32_t DxvkDescriptorSlotMapping::getBindingId(uint32_t slot) const {
     // This won't win a performance competition, but the number
     // of bindings used by a shader is usually much smaller than
@@ -78,15 +84,27 @@ namespace dxvk {
 
 
   DxvkPipelineLayout::DxvkPipelineLayout(
-    const Rc<vk::DeviceFn>&   vkd,
-          uint32_t            bindingCount,
-    const DxvkDescriptorSlot* bindingInfos,
-          VkPipelineBindPoint pipelineBindPoint)
-  : m_vkd(vkd), m_bindingSlots(bindingCount) {
+    const Rc<vk::DeviceFn>&     vkd,
+          uint32_t              bindingCount,
+    const DxvkDescriptorSlot*   bindingInfos,
+          uint32_t              pushConstCount,
+    const DxvkPushConstantSlot* pushConstInfos,
+          VkPipelineBindPoint   pipelineBindPoint)
+  : m_vkd(vkd), m_bindingSlots(bindingCount), m_pushConstSlots(pushConstCount) {
     
     for (uint32_t i = 0; i < bindingCount; i++)
       m_bindingSlots[i] = bindingInfos[i];
     
+    std::vector<VkPushConstantRange> pushRanges(pushConstCount);
+    
+    for (uint32_t i = 0; i < pushConstCount; i++) {
+      m_pushConstSlots[i] = pushConstInfos[i];
+      
+      pushRanges[i].stageFlags = pushConstInfos[i].stages;
+      pushRanges[i].offset     = pushConstInfos[i].offset;
+      pushRanges[i].size       = pushConstInfos[i].size;
+    }
+    
     std::vector<VkDescriptorSetLayoutBinding>       bindings(bindingCount);
     std::vector<VkDescriptorUpdateTemplateEntryKHR> tEntries(bindingCount);
     
@@ -133,8 +151,8 @@ namespace dxvk {
     pipeInfo.flags                  = 0;
     pipeInfo.setLayoutCount         = bindingCount > 0 ? 1 : 0;
     pipeInfo.pSetLayouts            = &m_descriptorSetLayout;
-    pipeInfo.pushConstantRangeCount = 0;
-    pipeInfo.pPushConstantRanges    = nullptr;
+    pipeInfo.pushConstantRangeCount = pushRanges.size();
+    pipeInfo.pPushConstantRanges    = pushRanges.data();
     
     if (m_vkd->vkCreatePipelineLayout(m_vkd->device(),
         &pipeInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS) {
@@ -35,6 +35,21 @@ namespace dxvk {
   };
   
   
+  /**
+   * \brief Push constant slot
+   * 
+   * Describes a push constant range whose contents
+   * are sourced from the buffer that is bound to the
+   * given resource slot at the time of a draw call.
+   */
+  struct DxvkPushConstantSlot {
+    uint32_t           slot;    ///< Resource slot index for the context
+    VkShaderStageFlags stages;  ///< Stages that use the push constants
+    uint32_t           offset;  ///< Offset of the push constant range
+    uint32_t           size;    ///< Size of the push constant range
+  };
+  
+  
   /**
    * \brief Descriptor slot mapping
    * 
@@ -66,6 +81,22 @@ namespace dxvk {
       return m_descriptorSlots.data();
     }
     
+    /**
+     * \brief Number of push constant slots
+     * \returns Push constant slot count
+     */
+    uint32_t pushConstSlotCount() const {
+      return m_pushConstSlots.size();
+    }
+    
+    /**
+     * \brief Push constant slot infos
+     * \returns Push constant slot infos
+     */
+    const DxvkPushConstantSlot* pushConstSlotInfos() const {
+      return m_pushConstSlots.data();
+    }
+    
     /**
      * \brief Defines a new slot
      * 
@@ -86,6 +117,16 @@ namespace dxvk {
             VkShaderStageFlagBits stage,
             VkAccessFlags         access);
     
+    /**
+     * \brief Defines a push constant slot
+     * 
+     * Push constant ranges of different
+     * shader stages must not overlap.
+     * \param [in] slot Push constant slot
+     */
+    void definePushConstSlot(
+      const DxvkPushConstantSlot& slot);
+    
     /**
      * \brief Gets binding ID for a slot
      * 
@@ -111,7 +152,8 @@ namespace dxvk {
     
   private:
     
-    std::vector<DxvkDescriptorSlot> m_descriptorSlots;
+    std::vector<DxvkDescriptorSlot>   m_descriptorSlots;
+    std::vector<DxvkPushConstantSlot> m_pushConstSlots;
 
     uint32_t countDescriptors(
             VkDescriptorType      type) const;
@@ -134,10 +176,12 @@ namespace dxvk {
   public:
     
     DxvkPipelineLayout(
-      const Rc<vk::DeviceFn>&   vkd,
-            uint32_t            bindingCount,
-      const DxvkDescriptorSlot* bindingInfos,
-            VkPipelineBindPoint pipelineBindPoint);
+      const Rc<vk::DeviceFn>&     vkd,
+            uint32_t              bindingCount,
+      const DxvkDescriptorSlot*   bindingInfos,
+            uint32_t              pushConstCount,
+      const DxvkPushConstantSlot* pushConstInfos,
+            VkPipelineBindPoint   pipelineBindPoint);
     
     ~DxvkPipelineLayout();
     
@@ -167,6 +211,24 @@ namespace dxvk {
       return m_bindingSlots.data();
     }
     
+    /**
+     * \brief Number of push constant slots
+     * \returns Push constant slot count
+     */
+    uint32_t pushConstSlotCount() const {
+      return m_pushConstSlots.size();
+    }
+    
+    /**
+     * \brief Push constant slot info
+     * 
+     * \param [in] id Push constant slot index
+     * \returns Push constant slot info
+     */
+    const DxvkPushConstantSlot& pushConstSlot(uint32_t id) const {
+      return m_pushConstSlots[id];
+    }
+    
     /**
      * \brief Descriptor set layout handle
      * \returns Descriptor set layout handle
@@ -241,6 +303,26 @@ namespace dxvk {
       return stages;
     }
 
+    /**
+     * \brief Checks whether a binding can use a dummy resource
+     * 
+     * Returns \c true for read-only bindings whose dummy
+     * resource returns zero for all reads. Storage images
+     * and storage texel buffers are excluded since their
+     * format must match the shader declaration.
+     * \param [in] id Binding index
+     * \returns \c true if a dummy can be bound
+     */
+    bool canBindDummyResource(uint32_t id) const {
+      const DxvkDescriptorSlot& slot = m_bindingSlots[id];
+
+      if (slot.access & VK_ACCESS_SHADER_WRITE_BIT)
+        return false;
+      
+      return slot.type != VK_DESCRIPTOR_TYPE_STORAGE_IMAGE
+          && slot.type != VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER;
+    }
+
   private:
     
     Rc<vk::DeviceFn> m_vkd;
@@ -249,8 +331,9 @@ namespace dxvk {
     VkPipelineLayout                m_pipelineLayout      = VK_NULL_HANDLE;
     VkDescriptorUpdateTemplateKHR   m_descriptorTemplate  = VK_NULL_HANDLE;
     
-    std::vector<DxvkDescriptorSlot> m_bindingSlots;
-    std::vector<uint32_t>           m_dynamicSlots;
+    std::vector<DxvkDescriptorSlot>   m_bindingSlots;
+    std::vector<DxvkPushConstantSlot> m_pushConstSlots;
+    std::vector<uint32_t>             m_dynamicSlots;
 
     Flags<VkDescriptorType>         m_descriptorTypes;
     
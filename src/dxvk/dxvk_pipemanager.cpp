@@ -119,6 +119,8 @@ namespace dxvk {
     DxvkPipelineCount result;
     result.numComputePipelines  = m_numComputePipelines.load();
     result.numGraphicsPipelines = m_numGraphicsPipelines.load();
+    result.numMatchedOutputs    = m_numMatchedOutputs.load();
+    result.numEliminatedOutputs = m_numEliminatedOutputs.load();
     return result;
   }
   
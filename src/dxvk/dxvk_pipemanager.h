@@ -19,6 +19,8 @@ namespace dxvk {
   struct DxvkPipelineCount {
     uint32_t numGraphicsPipelines;
     uint32_t numComputePipelines;
+    uint32_t numMatchedOutputs;
+    uint32_t numEliminatedOutputs;
   };
   
   /**
@@ -135,6 +137,8 @@ namespace dxvk {
 
     std::atomic<uint32_t>     m_numComputePipelines  = { 0 };
     std::atomic<uint32_t>     m_numGraphicsPipelines = { 0 };
+    std::atomic<uint32_t>     m_numMatchedOutputs    = { 0 };
+    std::atomic<uint32_t>     m_numEliminatedOutputs = { 0 };
     
     std::mutex m_mutex;
     
@@ -16,11 +16,16 @@ namespace dxvk {
     }
     
     m_condOnAdd.notify_one();
+    m_condOnSync.notify_all();
     m_thread.join();
   }
   
   
   void DxvkSubmissionQueue::submit(const Rc<DxvkCommandList>& cmdList) {
+    DxvkSubmissionEntry entry;
+    entry.cmdList    = cmdList;
+    entry.submitTime = std::chrono::high_resolution_clock::now();
+    
     { std::unique_lock<std::mutex> lock(m_mutex);
       
       m_condOnTake.wait(lock, [this] {
@@ -28,17 +33,43 @@ namespace dxvk {
       });
       
       m_submits += 1;
-      m_entries.push(cmdList);
+      m_entries.push(std::move(entry));
       m_condOnAdd.notify_one();
     }
   }
   
   
+  void DxvkSubmissionQueue::waitForSubmission(uint64_t submissionId) {
+    if (completedSubmissionId() >= submissionId)
+      return;
+    
+    std::unique_lock<std::mutex> lock(m_mutex);
+    
+    m_condOnSync.wait(lock, [this, submissionId] {
+      return m_stopped.load() || completedSubmissionId() >= submissionId;
+    });
+  }
+  
+  
+  void DxvkSubmissionQueue::updateLatency(
+          std::chrono::high_resolution_clock::time_point submitTime) {
+    auto t = std::chrono::high_resolution_clock::now();
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(t - submitTime);
+    
+    // Exponential moving average with a weight of 1/8 for
+    // new samples, which smoothes out individual outliers
+    // while still adapting to changes within a few frames
+    uint64_t prev = m_latencyUs.load(std::memory_order_relaxed);
+    uint64_t curr = prev != 0 ? (7 * prev + uint64_t(us.count())) / 8 : uint64_t(us.count());
+    m_latencyUs.store(std::max<uint64_t>(curr, 1), std::memory_order_relaxed);
+  }
+  
+  
   void DxvkSubmissionQueue::threadFunc() {
     env::setThreadName("dxvk-queue");
 
     while (!m_stopped.load()) {
-      Rc<DxvkCommandList> cmdList;
+      DxvkSubmissionEntry entry;
       
       { std::unique_lock<std::mutex> lock(m_mutex);
         
@@ -47,17 +78,22 @@ namespace dxvk {
         });
         
         if (m_entries.size() != 0) {
-          cmdList = std::move(m_entries.front());
+          entry = std::move(m_entries.front());
           m_entries.pop();
         }
         
         m_condOnTake.notify_one();
       }
       
-      if (cmdList != nullptr) {
+      if (entry.cmdList != nullptr) {
+        Rc<DxvkCommandList> cmdList = std::move(entry.cmdList);
+        
         VkResult status = cmdList->synchronize();
+        uint64_t submissionId = cmdList->submissionId();
         
         if (status == VK_SUCCESS) {
+          updateLatency(entry.submitTime);
+          
           cmdList->signalEvents();
           cmdList->reset();
           
@@ -68,6 +104,17 @@ namespace dxvk {
             status));
         }
         
+        // All command lists go to the same queue, so the fence
+        // of one submission implies completion of all previous
+        // ones. Advance the counter even if the wait failed so
+        // that threads waiting on the submission do not hang.
+        { std::unique_lock<std::mutex> lock(m_mutex);
+          
+          if (submissionId > m_completedId.load())
+            m_completedId.store(submissionId, std::memory_order_release);
+        }
+        
+        m_condOnSync.notify_all();
         m_submits -= 1;
       }
     }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <condition_variable>
 #include <mutex>
 #include <queue>
@@ -12,6 +13,18 @@ namespace dxvk {
   
   class DxvkDevice;
   
+  /**
+   * \brief Submission queue entry
+   * 
+   * Stores the time at which the command list
+   * was submitted so that the queue thread can
+   * measure how long it took to complete.
+   */
+  struct DxvkSubmissionEntry {
+    Rc<DxvkCommandList>                            cmdList;
+    std::chrono::high_resolution_clock::time_point submitTime;
+  };
+  
   /**
    * \brief Submission queue
    */
@@ -45,19 +58,61 @@ namespace dxvk {
      */
     void submit(const Rc<DxvkCommandList>& cmdList);
     
+    /**
+     * \brief Last completed submission
+     * 
+     * All submissions with a sequence number less
+     * than or equal to the returned value have
+     * completed execution on the GPU.
+     * \returns Submission sequence number
+     */
+    uint64_t completedSubmissionId() const {
+      return m_completedId.load(std::memory_order_acquire);
+    }
+    
+    /**
+     * \brief Waits for a submission to complete
+     * 
+     * Blocks the calling thread until the submission
+     * with the given sequence number has completed.
+     * Returns immediately if it already has.
+     * \param [in] submissionId Submission sequence number
+     */
+    void waitForSubmission(uint64_t submissionId);
+    
+    /**
+     * \brief Average submission latency
+     * 
+     * Moving average of the time between submitting
+     * a command list and the queue thread observing
+     * its completion. Since submissions execute in
+     * order, this includes time spent waiting for
+     * previously submitted command lists.
+     * \returns Latency, in microseconds
+     */
+    uint64_t averageLatencyUs() const {
+      return m_latencyUs.load(std::memory_order_relaxed);
+    }
+    
   private:
     
     DxvkDevice*             m_device;
     
     std::atomic<bool>       m_stopped = { false };
     std::atomic<uint32_t>   m_submits = { 0u };
+    std::atomic<uint64_t>   m_completedId = { 0ull };
+    std::atomic<uint64_t>   m_latencyUs   = { 0ull };
     
     std::mutex              m_mutex;
     std::condition_variable m_condOnAdd;
     std::condition_variable m_condOnTake;
-    std::queue<Rc<DxvkCommandList>> m_entries;
+    std::condition_variable m_condOnSync;
+    std::queue<DxvkSubmissionEntry> m_entries;
     dxvk::thread             m_thread;
     
+    void updateLatency(
+            std::chrono::high_resolution_clock::time_point submitTime);
+    
     void threadFunc();
     
   };
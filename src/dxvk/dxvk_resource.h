@@ -31,9 +31,27 @@ namespace dxvk {
     void acquire() { m_useCount += 1; }
     void release() { m_useCount -= 1; }
     
+    /**
+     * \brief Last submission using the resource
+     * 
+     * Sequence number of the most recent command list
+     * submission that used the resource. Once the device
+     * has completed that submission, the resource will
+     * no longer be in use by any submitted commands.
+     * \returns Submission sequence number
+     */
+    uint64_t lastSubmissionId() const {
+      return m_submissionId.load(std::memory_order_acquire);
+    }
+    
+    void notifySubmission(uint64_t submissionId) {
+      m_submissionId.store(submissionId, std::memory_order_release);
+    }
+    
   private:
     
-    std::atomic<uint32_t> m_useCount = { 0u };
+    std::atomic<uint32_t> m_useCount     = { 0u };
+    std::atomic<uint64_t> m_submissionId = { 0ull };
     
   };
   
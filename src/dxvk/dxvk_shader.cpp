@@ -1,4 +1,5 @@
 #include "dxvk_shader.h"
+#include "dxvk_shader_dce.h"
 
 namespace dxvk {
   
@@ -134,6 +135,9 @@ namespace dxvk {
           DxvkDescriptorSlotMapping& mapping) const {
     for (const auto& slot : m_slots)
       mapping.defineSlot(slot.slot, slot.type, slot.view, m_stage, slot.access);
+    
+    if (m_options.pushConstants.size != 0)
+      mapping.definePushConstSlot(m_options.pushConstants);
   }
   
   
@@ -155,6 +159,11 @@ namespace dxvk {
     if (info.fsDualSrcBlend && m_o1IdxOffset && m_o1LocOffset)
       std::swap(code[m_o1IdxOffset], code[m_o1LocOffset]);
     
+    // Remove stores to outputs that the next stage does
+    // not read, as well as any code that becomes dead
+    if (info.unusedOutputs)
+      spirvCode = eliminateUnusedOutputs(spirvCode, info.unusedOutputs);
+    
     return new DxvkShaderModule(vkd, this, spirvCode);
   }
   
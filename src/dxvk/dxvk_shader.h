@@ -61,6 +61,9 @@ namespace dxvk {
     int32_t rasterizedStream;
     /// Xfb vertex strides
     uint32_t xfbStrides[MaxNumXfbBuffers];
+    /// Constant buffer passed via push
+    /// constants, if the size is non-zero
+    DxvkPushConstantSlot pushConstants;
   };
 
 
@@ -107,7 +110,12 @@ namespace dxvk {
    * \brief Shader module create info
    */
   struct DxvkShaderModuleCreateInfo {
+    /// Remap fragment shader output
+    /// for dual-source blending
     bool fsDualSrcBlend;
+    /// Output locations that are not consumed
+    /// by the next stage and can be removed
+    uint32_t unusedOutputs;
   };
   
   
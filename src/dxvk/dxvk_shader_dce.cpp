@@ -0,0 +1,247 @@
+#include <unordered_map>
+#include <unordered_set>
+
+#include "dxvk_shader_dce.h"
+
+namespace dxvk {
+  
+  static bool isPureInstruction(
+          spv::Op                 op) {
+    // Instructions that take a result type and return
+    // a result ID, and that have no side effects
+    if (op >= spv::OpConvertFToU && op <= spv::OpBitCount)
+      return op != spv::OpConvertUToPtr && op != spv::OpConvertPtrToU;
+    
+    switch (op) {
+      case spv::OpExtInst:
+      case spv::OpLoad:
+      case spv::OpAccessChain:
+      case spv::OpInBoundsAccessChain:
+      case spv::OpVectorExtractDynamic:
+      case spv::OpVectorInsertDynamic:
+      case spv::OpVectorShuffle:
+      case spv::OpCompositeConstruct:
+      case spv::OpCompositeExtract:
+      case spv::OpCompositeInsert:
+      case spv::OpCopyObject:
+      case spv::OpSampledImage:
+      case spv::OpImageSampleImplicitLod:
+      case spv::OpImageSampleExplicitLod:
+      case spv::OpImageSampleDrefImplicitLod:
+      case spv::OpImageSampleDrefExplicitLod:
+      case spv::OpImageFetch:
+      case spv::OpImageGather:
+      case spv::OpImageDrefGather:
+      case spv::OpImageRead:
+      case spv::OpImage:
+      case spv::OpImageQuerySizeLod:
+      case spv::OpImageQuerySize:
+      case spv::OpImageQueryLod:
+      case spv::OpImageQueryLevels:
+      case spv::OpImageQuerySamples:
+      case spv::OpArrayLength:
+      case spv::OpPhi:
+        return true;
+      
+      default:
+        return false;
+    }
+  }
+  
+  
+  SpirvCodeBuffer eliminateUnusedOutputs(
+          SpirvCodeBuffer&        code,
+          uint32_t                unusedOutputs) {
+    std::unordered_map<uint32_t, uint32_t> locations;
+    std::unordered_map<uint32_t, uint32_t> pointerTypes;
+    std::unordered_set<uint32_t>           compositeTypes;
+    std::unordered_set<uint32_t>           builtIns;
+    std::unordered_set<uint32_t>           outputVars;
+    std::unordered_set<uint32_t>           trackedVars;
+    
+    // Find output variables which are assigned to one of
+    // the unused locations. Arrays and blocks are skipped
+    // since they may span more than one location. Private
+    // and function variables are only ever accessed by the
+    // shader itself, so their stores can be tracked too.
+    bool inFunction = false;
+    
+    for (auto ins : code) {
+      switch (ins.opCode()) {
+        case spv::OpDecorate:
+          if (ins.arg(2) == spv::DecorationLocation)
+            locations.insert({ ins.arg(1), ins.arg(3) });
+          if (ins.arg(2) == spv::DecorationBuiltIn)
+            builtIns.insert(ins.arg(1));
+          break;
+        
+        case spv::OpTypeArray:
+        case spv::OpTypeStruct:
+          compositeTypes.insert(ins.arg(1));
+          break;
+        
+        case spv::OpTypePointer:
+          pointerTypes.insert({ ins.arg(1), ins.arg(3) });
+          break;
+        
+        case spv::OpVariable: {
+          auto loc = locations.find(ins.arg(2));
+          auto ptr = pointerTypes.find(ins.arg(1));
+          
+          if (!inFunction
+           && ins.arg(3) == spv::StorageClassOutput
+           && loc != locations.end() && loc->second < 32
+           && (unusedOutputs & (1u << loc->second))
+           && ptr != pointerTypes.end()
+           && compositeTypes.find(ptr->second) == compositeTypes.end()
+           && builtIns.find(ins.arg(2)) == builtIns.end())
+            outputVars.insert(ins.arg(2));
+          
+          if (ins.arg(3) == spv::StorageClassPrivate
+           || ins.arg(3) == spv::StorageClassFunction)
+            trackedVars.insert(ins.arg(2));
+        } break;
+        
+        case spv::OpFunction:
+          inFunction = true;
+          break;
+        
+        default:
+          break;
+      }
+    }
+    
+    if (outputVars.empty())
+      return code;
+    
+    trackedVars.insert(outputVars.begin(), outputVars.end());
+    
+    // Gather instructions inside functions. Pure instructions
+    // and stores to the affected output variables or to local
+    // variables are only kept if their results are used, and
+    // everything else is considered live. Any live use of a
+    // variable, e.g. a load from a temporary register or from
+    // an output that is copied to a built-in, keeps all of
+    // the variable's stores alive. Variable declarations do
+    // not count as uses and are never removed.
+    std::unordered_map<uint32_t, uint32_t> definitions;
+    std::unordered_map<uint32_t, uint32_t> pointerBases;
+    std::unordered_map<uint32_t, std::vector<uint32_t>> varStores;
+    
+    std::vector<uint32_t>        worklist;
+    std::unordered_set<uint32_t> liveIds;
+    std::unordered_set<uint32_t> liveIns;
+    
+    inFunction = false;
+    
+    for (auto ins : code) {
+      if (ins.opCode() == spv::OpFunction)
+        inFunction = true;
+      
+      if (!inFunction)
+        continue;
+      
+      if (isPureInstruction(ins.opCode())) {
+        definitions.insert({ ins.arg(2), ins.offset() });
+        
+        if (ins.opCode() == spv::OpAccessChain
+         || ins.opCode() == spv::OpInBoundsAccessChain) {
+          auto base = pointerBases.find(ins.arg(3));
+          
+          pointerBases.insert({ ins.arg(2), base != pointerBases.end()
+            ? base->second : ins.arg(3) });
+        }
+      } else if (ins.opCode() == spv::OpStore) {
+        auto base = pointerBases.find(ins.arg(1));
+        
+        uint32_t varId = base != pointerBases.end()
+          ? base->second : ins.arg(1);
+        
+        if (trackedVars.find(varId) != trackedVars.end())
+          varStores[varId].push_back(ins.offset());
+        else
+          worklist.push_back(ins.offset());
+      } else if (ins.opCode() != spv::OpVariable) {
+        worklist.push_back(ins.offset());
+      }
+    }
+    
+    uint32_t* words = code.data();
+    
+    while (!worklist.empty()) {
+      uint32_t offset = worklist.back();
+      worklist.pop_back();
+      
+      if (!liveIns.insert(offset).second)
+        continue;
+      
+      // Treat all operands as potential IDs. Literals may
+      // accidentally keep some code alive, which is safe.
+      uint32_t length = words[offset] >> spv::WordCountShift;
+      
+      for (uint32_t i = 1; i < length; i++) {
+        uint32_t id = words[offset + i];
+        
+        if (!liveIds.insert(id).second)
+          continue;
+        
+        auto def = definitions.find(id);
+        
+        if (def != definitions.end())
+          worklist.push_back(def->second);
+        
+        auto stores = varStores.find(id);
+        
+        if (stores != varStores.end())
+          worklist.insert(worklist.end(), stores->second.begin(), stores->second.end());
+      }
+    }
+    
+    // Collect the IDs of all instructions that we remove so
+    // that debug names and decorations can be removed too
+    std::unordered_set<uint32_t> deadIds;
+    
+    for (const auto& def : definitions) {
+      if (liveIns.find(def.second) == liveIns.end())
+        deadIds.insert(def.first);
+    }
+    
+    std::vector<uint32_t> result(words, words + 5);
+    
+    for (auto ins : code) {
+      bool dead = false;
+      
+      switch (ins.opCode()) {
+        case spv::OpName:
+        case spv::OpMemberName:
+        case spv::OpDecorate:
+        case spv::OpMemberDecorate:
+          dead = deadIds.find(ins.arg(1)) != deadIds.end();
+          break;
+        
+        case spv::OpStore: {
+          auto base = pointerBases.find(ins.arg(1));
+          
+          uint32_t varId = base != pointerBases.end()
+            ? base->second : ins.arg(1);
+          
+          dead = trackedVars.find(varId) != trackedVars.end()
+              && liveIns.find(ins.offset()) == liveIns.end();
+        } break;
+        
+        default:
+          dead = isPureInstruction(ins.opCode())
+              && deadIds.find(ins.arg(2)) != deadIds.end();
+      }
+      
+      if (!dead) {
+        result.insert(result.end(),
+          words + ins.offset(),
+          words + ins.offset() + ins.length());
+      }
+    }
+    
+    return SpirvCodeBuffer(result.size(), result.data());
+  }
+  
+}
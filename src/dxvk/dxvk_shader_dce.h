@@ -0,0 +1,27 @@
+#pragma once
+
+#include "dxvk_include.h"
+
+#include "../spirv/spirv_code_buffer.h"
+
+namespace dxvk {
+
+  /**
+   * \brief Removes stores to unused outputs
+   *
+   * Removes stores to output variables at the given
+   * locations, along with any pure instructions that
+   * only contributed to those stores. Stores to private
+   * and function variables, which the DXBC compiler uses
+   * for temporary registers, are only kept if the shader
+   * reads the variable in live code. Instructions with
+   * side effects are always kept.
+   * \param [in] code SPIR-V code to process
+   * \param [in] unusedOutputs Unused output locations
+   * \returns Code without the dead stores
+   */
+  SpirvCodeBuffer eliminateUnusedOutputs(
+          SpirvCodeBuffer&        code,
+          uint32_t                unusedOutputs);
+
+}
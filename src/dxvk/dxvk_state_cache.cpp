@@ -7,6 +7,17 @@ namespace dxvk {
   static const Sha1Hash       g_nullHash      = Sha1Hash::compute(nullptr, 0);
   static const DxvkShaderKey  g_nullShaderKey = DxvkShaderKey();
 
+  /* Interval at which the writer thread checks
+   * the cache file for entries that have been
+   * written by other processes. */
+  static constexpr auto g_peerPollInterval = std::chrono::seconds(1);
+
+  /* Offset of the byte range used for locking. This
+   * lies far beyond the end of any actual cache file
+   * so that mandatory locks on Windows do not affect
+   * regular reads and writes of the file contents. */
+  static constexpr uint64_t g_lockOffset = 1ull << 62;
+
   bool DxvkStateCacheKey::eq(const DxvkStateCacheKey& key) const {
     return this->vs.eq(key.vs)
         && this->tcs.eq(key.tcs)
@@ -34,35 +45,27 @@ namespace dxvk {
           DxvkPipelineManager*  pipeManager,
           DxvkRenderPassPool*   passManager)
   : m_pipeManager(pipeManager),
-    m_passManager(passManager) {
-    bool newFile = !readCacheFile();
-
-    if (newFile) {
-      Logger::warn("DXVK: Creating new state cache file");
-
-      // Start with an empty file
-      std::ofstream file(getCacheFileName(),
-        std::ios_base::binary |
-        std::ios_base::trunc);
-
-      if (!file && env::createDirectory(getCacheDir())) {
-        file = std::ofstream(getCacheFileName(),
-          std::ios_base::binary |
-          std::ios_base::trunc);
+    m_passManager(passManager),
+    m_bindDummyResources(device->config().bindDummyResources) {
+    std::string fileName = getCacheFileName();
+
+    if (!m_file.open(fileName) && env::createDirectory(getCacheDir()))
+      m_file.open(fileName);
+
+    if (m_file.isOpen()) {
+      // Multiple instances of the same application may use
+      // the same file, so prevent other processes from
+      // appending entries while we read or rewrite it.
+      std::lock_guard<DxvkStateCacheFile> lock(m_file);
+
+      if (!readCacheFile()) {
+        Logger::warn("DXVK: Creating new state cache file");
+        writeCacheFile();
       }
 
-      // Write header with the current version number
-      DxvkStateCacheHeader header;
-
-      auto data = reinterpret_cast<const char*>(&header);
-      auto size = sizeof(header);
-
-      file.write(data, size);
-
-      // Write all valid entries to the cache file in
-      // case we're recovering a corrupted cache file
-      for (auto& e : m_entries)
-        writeCacheEntry(file, e);
+      m_fileOffset = m_file.size();
+    } else {
+      Logger::err(str::format("DXVK: Failed to open state cache file ", fileName));
     }
 
     // Use half the available CPU cores for pipeline compilation
@@ -110,17 +113,19 @@ namespace dxvk {
     const DxvkStateCacheKey&              shaders,
     const DxvkGraphicsPipelineStateInfo&  state,
     const DxvkRenderPassFormat&           format) {
-    if (shaders.vs.eq(g_nullShaderKey))
+    if (shaders.vs.eq(g_nullShaderKey) || !m_file.isOpen())
       return;
     
     // Do not add an entry that is already in the cache
-    auto entries = m_entryMap.equal_range(shaders);
+    { std::lock_guard<std::mutex> entryLock(m_entryLock);
+      auto entries = m_entryMap.equal_range(shaders);
 
-    for (auto e = entries.first; e != entries.second; e++) {
-      const DxvkStateCacheEntry& entry = m_entries[e->second];
+      for (auto e = entries.first; e != entries.second; e++) {
+        const DxvkStateCacheEntry& entry = m_entries[e->second];
 
-      if (entry.format.matches(format) && entry.gpState == state)
-        return;
+        if (entry.format.matches(format) && entry.gpState == state)
+          return;
+      }
     }
 
     // Queue a job to write this pipeline to the cache
@@ -136,15 +141,17 @@ namespace dxvk {
   void DxvkStateCache::addComputePipeline(
     const DxvkStateCacheKey&              shaders,
     const DxvkComputePipelineStateInfo&   state) {
-    if (shaders.cs.eq(g_nullShaderKey))
+    if (shaders.cs.eq(g_nullShaderKey) || !m_file.isOpen())
       return;
 
     // Do not add an entry that is already in the cache
-    auto entries = m_entryMap.equal_range(shaders);
+    { std::lock_guard<std::mutex> entryLock(m_entryLock);
+      auto entries = m_entryMap.equal_range(shaders);
 
-    for (auto e = entries.first; e != entries.second; e++) {
-      if (m_entries[e->second].cpState == state)
-        return;
+      for (auto e = entries.first; e != entries.second; e++) {
+        if (m_entries[e->second].cpState == state)
+          return;
+      }
     }
 
     // Queue a job to write this pipeline to the cache
@@ -175,12 +182,7 @@ namespace dxvk {
     for (auto p = pipelines.first; p != pipelines.second; p++) {
       WorkerItem item;
 
-      if (!getShaderByKey(p->second.vs,  item.vs)
-       || !getShaderByKey(p->second.tcs, item.tcs)
-       || !getShaderByKey(p->second.tes, item.tes)
-       || !getShaderByKey(p->second.gs,  item.gs)
-       || !getShaderByKey(p->second.fs,  item.fs)
-       || !getShaderByKey(p->second.cs,  item.cs))
+      if (!getWorkerItem(p->second, item))
         continue;
       
       if (!workerLock)
@@ -214,6 +216,85 @@ namespace dxvk {
   }
 
 
+  bool DxvkStateCache::addEntry(
+    const DxvkStateCacheEntry&      entry,
+          bool                      compile) {
+    std::lock_guard<std::mutex> entryLock(m_entryLock);
+
+    if (hasEntry(entry))
+      return false;
+
+    size_t entryId = m_entries.size();
+    m_entries.push_back(entry);
+
+    mapPipelineToEntry(entry.shaders, entryId);
+
+    mapShaderToPipeline(entry.shaders.vs,  entry.shaders);
+    mapShaderToPipeline(entry.shaders.tcs, entry.shaders);
+    mapShaderToPipeline(entry.shaders.tes, entry.shaders);
+    mapShaderToPipeline(entry.shaders.gs,  entry.shaders);
+    mapShaderToPipeline(entry.shaders.fs,  entry.shaders);
+    mapShaderToPipeline(entry.shaders.cs,  entry.shaders);
+
+    // If all shaders are already known, the pipeline
+    // would not get compiled by registerShader anymore
+    WorkerItem item;
+
+    if (compile && getWorkerItem(entry.shaders, item)) {
+      std::lock_guard<std::mutex> workerLock(m_workerLock);
+      m_workerQueue.push(item);
+      m_workerCond.notify_one();
+    }
+
+    return true;
+  }
+
+
+  bool DxvkStateCache::hasEntry(
+    const DxvkStateCacheEntry&      entry) const {
+    auto entries = m_entryMap.equal_range(entry.shaders);
+
+    for (auto e = entries.first; e != entries.second; e++) {
+      const DxvkStateCacheEntry& other = m_entries[e->second];
+
+      bool eq = entry.shaders.cs.eq(g_nullShaderKey)
+        ? other.format.matches(entry.format) && other.gpState == entry.gpState
+        : other.cpState == entry.cpState;
+
+      if (eq)
+        return true;
+    }
+
+    return false;
+  }
+
+
+  std::vector<DxvkStateCacheEntry> DxvkStateCache::getEntries(
+    const DxvkStateCacheKey&        key) {
+    std::lock_guard<std::mutex> entryLock(m_entryLock);
+
+    std::vector<DxvkStateCacheEntry> result;
+    auto entries = m_entryMap.equal_range(key);
+
+    for (auto e = entries.first; e != entries.second; e++)
+      result.push_back(m_entries[e->second]);
+
+    return result;
+  }
+
+
+  bool DxvkStateCache::getWorkerItem(
+    const DxvkStateCacheKey&        key,
+          WorkerItem&               item) const {
+    return getShaderByKey(key.vs,  item.vs)
+        && getShaderByKey(key.tcs, item.tcs)
+        && getShaderByKey(key.tes, item.tes)
+        && getShaderByKey(key.gs,  item.gs)
+        && getShaderByKey(key.fs,  item.fs)
+        && getShaderByKey(key.cs,  item.cs);
+  }
+
+
   void DxvkStateCache::mapPipelineToEntry(
     const DxvkStateCacheKey&        key,
           size_t                    entryId) {
@@ -241,35 +322,55 @@ namespace dxvk {
     if (item.cs == nullptr) {
       auto pipeline = m_pipeManager->createGraphicsPipeline(
         item.vs, item.tcs, item.tes, item.gs, item.fs);
-      auto entries = m_entryMap.equal_range(key);
 
-      for (auto e = entries.first; e != entries.second; e++) {
-        const auto& entry = m_entries[e->second];
+      for (const auto& entry : getEntries(key)) {
+        DxvkGraphicsPipelineStateInfo state = entry.gpState;
+        normalizeBindingMask(state.bsBindingMask, pipeline->layout());
 
         auto rp = m_passManager->getRenderPass(entry.format);
-        pipeline->getPipelineHandle(entry.gpState, *rp);
+        pipeline->getPipelineHandle(state, *rp);
       }
     } else {
       auto pipeline = m_pipeManager->createComputePipeline(item.cs);
-      auto entries = m_entryMap.equal_range(key);
 
-      for (auto e = entries.first; e != entries.second; e++) {
-        const auto& entry = m_entries[e->second];
-        pipeline->getPipelineHandle(entry.cpState);
+      for (const auto& entry : getEntries(key)) {
+        DxvkComputePipelineStateInfo state = entry.cpState;
+        normalizeBindingMask(state.bsBindingMask, pipeline->layout());
+
+        pipeline->getPipelineHandle(state);
       }
     }
   }
 
 
+  void DxvkStateCache::normalizeBindingMask(
+          DxvkBindingMask&          mask,
+    const DxvkPipelineLayout*       layout) const {
+    // Entries written without dummy bindings may have read-only
+    // slots marked as unbound, which would compile pipelines that
+    // the context will never use. Map them to the used variant.
+    if (!m_bindDummyResources)
+      return;
+    
+    for (uint32_t i = 0; i < layout->bindingCount(); i++) {
+      if (layout->canBindDummyResource(i))
+        mask.setBound(i);
+    }
+  }
+
+
   bool DxvkStateCache::readCacheFile() {
-    // Open state file and just fail if it doesn't exist
-    std::ifstream ifile(getCacheFileName(), std::ios_base::binary);
+    // Read the whole file at once rather than issuing
+    // one read per entry, and fail if it is empty
+    std::string data;
 
-    if (!ifile) {
+    if (!m_file.read(0, m_file.size(), data) || data.empty()) {
       Logger::warn("DXVK: No state cache file found");
       return false;
     }
 
+    std::istringstream ifile(data);
+
     // The header stores the state cache version,
     // we need to regenerate it if it's outdated
     DxvkStateCacheHeader newHeader;
@@ -280,15 +381,20 @@ namespace dxvk {
       return false;
     }
 
-    // Struct size hasn't changed between v2/v3
-    if (curHeader.entrySize != newHeader.entrySize) {
-      Logger::warn("DXVK: State cache entry size changed");
+    // Discard caches of unsupported versions
+    if (curHeader.version < 2 || curHeader.version > 4) {
+      Logger::warn("DXVK: State cache out of date");
       return false;
     }
 
-    // Discard caches of unsupported versions
-    if (curHeader.version != 2 && curHeader.version != 3) {
-      Logger::warn("DXVK: State cache out of date");
+    // Struct size hasn't changed between v2/v3,
+    // v4 introduced the packed pipeline state
+    uint32_t expectedEntrySize = curHeader.version < 4
+      ? sizeof(DxvkStateCacheEntryV3)
+      : sizeof(DxvkStateCacheEntry);
+
+    if (curHeader.entrySize != expectedEntrySize) {
+      Logger::warn("DXVK: State cache entry size changed");
       return false;
     }
 
@@ -303,22 +409,24 @@ namespace dxvk {
 
     while (ifile) {
       DxvkStateCacheEntry entry;
+      bool valid;
 
-      if (readCacheEntry(ifile, entry)) {
-        if (curHeader.version == 2)
-          convertEntryV2(entry);
-        
-        size_t entryId = m_entries.size();
-        m_entries.push_back(entry);
+      if (curHeader.version < 4) {
+        DxvkStateCacheEntryV3 legacy;
+        valid = readCacheEntryV3(ifile, legacy);
 
-        mapPipelineToEntry(entry.shaders, entryId);
+        if (valid && curHeader.version == 2)
+          convertEntryV2(legacy);
+        
+        if (valid)
+          convertEntryV3(legacy, entry);
+      } else {
+        valid = readCacheEntry(ifile, entry);
+      }
 
-        mapShaderToPipeline(entry.shaders.vs,  entry.shaders);
-        mapShaderToPipeline(entry.shaders.tcs, entry.shaders);
-        mapShaderToPipeline(entry.shaders.tes, entry.shaders);
-        mapShaderToPipeline(entry.shaders.gs,  entry.shaders);
-        mapShaderToPipeline(entry.shaders.fs,  entry.shaders);
-        mapShaderToPipeline(entry.shaders.cs,  entry.shaders);
+      if (valid) {
+        normalizeEntry(entry);
+        addEntry(entry, false);
       } else if (ifile) {
         numInvalidEntries += 1;
       }
@@ -340,6 +448,74 @@ namespace dxvk {
   }
 
 
+  void DxvkStateCache::readPeerEntries() {
+    std::string data;
+
+    { std::shared_lock<DxvkStateCacheFile> lock(m_file);
+      uint64_t fileSize = m_file.size();
+
+      // If another process rewrote the file, start over.
+      // Entries that we already know will be skipped.
+      if (fileSize < m_fileOffset)
+        m_fileOffset = sizeof(DxvkStateCacheHeader);
+
+      // Only read complete entries. Appends are atomic
+      // with respect to the lock, so this is only a
+      // safeguard against truncated files.
+      size_t entryCount = (fileSize - m_fileOffset) / sizeof(DxvkStateCacheEntry);
+
+      if (!entryCount)
+        return;
+
+      if (!m_file.read(m_fileOffset, entryCount * sizeof(DxvkStateCacheEntry), data))
+        return;
+
+      m_fileOffset += data.size();
+    }
+
+    std::istringstream stream(data);
+    uint32_t numNewEntries = 0;
+
+    while (stream) {
+      DxvkStateCacheEntry entry;
+
+      if (readCacheEntry(stream, entry)) {
+        normalizeEntry(entry);
+
+        if (addEntry(entry, true))
+          numNewEntries += 1;
+      }
+    }
+
+    if (numNewEntries) {
+      Logger::debug(str::format(
+        "DXVK: Read ", numNewEntries,
+        " state cache entries from other processes"));
+    }
+  }
+
+
+  void DxvkStateCache::writeCacheFile() {
+    std::ostringstream stream;
+
+    // Write header with the current version number
+    DxvkStateCacheHeader header;
+
+    auto data = reinterpret_cast<const char*>(&header);
+    auto size = sizeof(header);
+
+    stream.write(data, size);
+
+    // Write all valid entries to the cache file in
+    // case we're recovering a corrupted cache file
+    for (auto& e : m_entries)
+      writeCacheEntry(stream, e);
+
+    if (!m_file.truncate() || !m_file.append(stream.str()))
+      Logger::err("DXVK: Failed to write state cache file");
+  }
+
+
   bool DxvkStateCache::readCacheHeader(
           std::istream&             stream,
           DxvkStateCacheHeader&     header) const {
@@ -375,6 +551,21 @@ namespace dxvk {
   }
 
 
+  bool DxvkStateCache::readCacheEntryV3(
+          std::istream&             stream, 
+          DxvkStateCacheEntryV3&    entry) const {
+    auto data = reinterpret_cast<char*>(&entry);
+    auto size = sizeof(DxvkStateCacheEntryV3);
+
+    if (!stream.read(data, size))
+      return false;
+    
+    Sha1Hash expectedHash = std::exchange(entry.hash, g_nullHash);
+    Sha1Hash computedHash = Sha1Hash::compute(entry);
+    return expectedHash == computedHash;
+  }
+
+
   void DxvkStateCache::writeCacheEntry(
           std::ostream&             stream, 
           DxvkStateCacheEntry&      entry) const {
@@ -389,7 +580,7 @@ namespace dxvk {
 
 
   bool DxvkStateCache::convertEntryV2(
-          DxvkStateCacheEntry&      entry) const {
+          DxvkStateCacheEntryV3&    entry) const {
     // Semantics changed:
     // v2: rsDepthClampEnable
     // v3: rsDepthClipEnable
@@ -402,6 +593,127 @@ namespace dxvk {
   }
 
 
+  bool DxvkStateCache::convertEntryV3(
+    const DxvkStateCacheEntryV3&    legacy,
+          DxvkStateCacheEntry&      entry) const {
+    // v4: Pipeline state is bit-packed
+    const auto& src = legacy.gpState;
+          auto& dst = entry.gpState;
+
+    entry.shaders = legacy.shaders;
+    entry.cpState = legacy.cpState;
+    entry.format  = legacy.format;
+    entry.hash    = legacy.hash;
+
+    dst = DxvkGraphicsPipelineStateInfo();
+    dst.bsBindingMask = src.bsBindingMask;
+
+    dst.ia = DxvkIaInfo(
+      src.iaPrimitiveTopology,
+      src.iaPrimitiveRestart,
+      src.iaPatchVertexCount);
+    
+    dst.il = DxvkIlInfo(
+      std::min<uint32_t>(src.ilAttributeCount, MaxNumVertexAttributes),
+      std::min<uint32_t>(src.ilBindingCount,   MaxNumVertexBindings));
+    
+    for (uint32_t i = 0; i < dst.il.attributeCount(); i++) {
+      dst.ilAttributes[i] = DxvkIlAttribute(
+        src.ilAttributes[i].location,
+        src.ilAttributes[i].binding,
+        src.ilAttributes[i].format,
+        src.ilAttributes[i].offset);
+    }
+
+    for (uint32_t i = 0; i < dst.il.bindingCount(); i++) {
+      dst.ilBindings[i] = DxvkIlBinding(
+        src.ilBindings[i].binding,
+        src.ilBindings[i].stride,
+        src.ilBindings[i].inputRate,
+        src.ilDivisors[i]);
+    }
+
+    dst.rs = DxvkRsInfo(
+      src.rsDepthClipEnable,
+      src.rsDepthBiasEnable,
+      src.rsPolygonMode,
+      src.rsCullMode,
+      src.rsFrontFace,
+      src.rsViewportCount,
+      src.rsSampleCount);
+    
+    dst.ms = DxvkMsInfo(
+      src.msSampleCount,
+      src.msSampleMask,
+      src.msEnableAlphaToCoverage,
+      src.msEnableAlphaToOne);
+    
+    dst.ds = DxvkDsInfo(
+      src.dsEnableDepthTest,
+      src.dsEnableDepthWrite,
+      src.dsEnableStencilTest,
+      src.dsDepthCompareOp);
+    
+    dst.dsFront = DxvkDsStencilOp(src.dsStencilOpFront);
+    dst.dsBack  = DxvkDsStencilOp(src.dsStencilOpBack);
+
+    dst.om = DxvkOmInfo(
+      src.omEnableLogicOp,
+      src.omLogicOp);
+    
+    for (uint32_t i = 0; i < MaxNumRenderTargets; i++) {
+      dst.omBlend[i] = DxvkOmAttachmentBlend(
+        src.omBlendAttachments[i].blendEnable,
+        src.omBlendAttachments[i].srcColorBlendFactor,
+        src.omBlendAttachments[i].dstColorBlendFactor,
+        src.omBlendAttachments[i].colorBlendOp,
+        src.omBlendAttachments[i].srcAlphaBlendFactor,
+        src.omBlendAttachments[i].dstAlphaBlendFactor,
+        src.omBlendAttachments[i].alphaBlendOp,
+        src.omBlendAttachments[i].colorWriteMask);
+      
+      dst.omSwizzle[i] = DxvkOmAttachmentSwizzle(
+        src.omComponentMapping[i]);
+    }
+
+    return true;
+  }
+
+
+  void DxvkStateCache::normalizeEntry(
+          DxvkStateCacheEntry&      entry) const {
+    // Entries may have been written before some state was
+    // made dynamic or normalized. Repack the affected state
+    // so that it matches what the context will look up.
+    auto& state = entry.gpState;
+
+    state.ds = DxvkDsInfo(
+      state.ds.enableDepthTest(),
+      state.ds.enableDepthWrite(),
+      state.ds.enableStencilTest(),
+      state.ds.depthCompareOp());
+    
+    state.dsFront = state.ds.enableStencilTest()
+      ? DxvkDsStencilOp(state.dsFront.state())
+      : DxvkDsStencilOp();
+    state.dsBack  = state.ds.enableStencilTest()
+      ? DxvkDsStencilOp(state.dsBack.state())
+      : DxvkDsStencilOp();
+    
+    for (uint32_t i = 0; i < MaxNumRenderTargets; i++) {
+      state.omBlend[i] = DxvkOmAttachmentBlend(
+        state.omBlend[i].blendEnable(),
+        state.omBlend[i].srcColorBlendFactor(),
+        state.omBlend[i].dstColorBlendFactor(),
+        state.omBlend[i].colorBlendOp(),
+        state.omBlend[i].srcAlphaBlendFactor(),
+        state.omBlend[i].dstAlphaBlendFactor(),
+        state.omBlend[i].alphaBlendOp(),
+        state.omBlend[i].colorWriteMask());
+    }
+  }
+
+
   void DxvkStateCache::workerFunc() {
     env::setThreadName("dxvk-shader");
 
@@ -430,32 +742,47 @@ namespace dxvk {
   void DxvkStateCache::writerFunc() {
     env::setThreadName("dxvk-writer");
 
-    std::ofstream file;
+    if (!m_file.isOpen())
+      return;
 
     while (!m_stopThreads.load()) {
       DxvkStateCacheEntry entry;
+      bool hasItem = false;
 
       { std::unique_lock<std::mutex> lock(m_writerLock);
 
-        m_writerCond.wait(lock, [this] () {
+        m_writerCond.wait_for(lock, g_peerPollInterval, [this] () {
           return m_writerQueue.size()
               || m_stopThreads.load();
         });
 
-        if (m_writerQueue.size() == 0)
+        if (m_stopThreads.load())
           break;
 
-        entry = m_writerQueue.front();
-        m_writerQueue.pop();
+        if (m_writerQueue.size() != 0) {
+          entry = m_writerQueue.front();
+          m_writerQueue.pop();
+          hasItem = true;
+        }
       }
 
-      if (!file) {
-        file = std::ofstream(getCacheFileName(),
-          std::ios_base::binary |
-          std::ios_base::app);
+      if (!hasItem) {
+        // Pick up pipelines that other processes running
+        // the same application have added in the meantime
+        readPeerEntries();
+        continue;
       }
 
-      writeCacheEntry(file, entry);
+      // Skip entries that were either queued multiple
+      // times or that another process has written
+      if (!addEntry(entry, false))
+        continue;
+
+      std::ostringstream stream;
+      writeCacheEntry(stream, entry);
+
+      std::lock_guard<DxvkStateCacheFile> lock(m_file);
+      m_file.append(stream.str());
     }
   }
 
@@ -481,4 +808,122 @@ namespace dxvk {
     return env::getEnvVar("DXVK_STATE_CACHE_PATH");
   }
 
+
+
+  DxvkStateCacheFile::DxvkStateCacheFile() {
+
+  }
+
+
+  DxvkStateCacheFile::~DxvkStateCacheFile() {
+    if (m_handle != INVALID_HANDLE_VALUE)
+      ::CloseHandle(m_handle);
+  }
+
+
+  bool DxvkStateCacheFile::open(const std::string& path) {
+    auto widePath = str::tows(path);
+
+    m_handle = ::CreateFileW(widePath.data(),
+      GENERIC_READ | GENERIC_WRITE,
+      FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+      nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    return m_handle != INVALID_HANDLE_VALUE;
+  }
+
+
+  uint64_t DxvkStateCacheFile::size() const {
+    LARGE_INTEGER size = { };
+
+    if (!::GetFileSizeEx(m_handle, &size))
+      return 0;
+
+    return uint64_t(size.QuadPart);
+  }
+
+
+  bool DxvkStateCacheFile::read(
+          uint64_t          offset,
+          size_t            size,
+          std::string&      data) const {
+    data.resize(size);
+
+    size_t bytesRead = 0;
+
+    while (bytesRead < size) {
+      OVERLAPPED ov = { };
+      ov.Offset     = DWORD(offset + bytesRead);
+      ov.OffsetHigh = DWORD((offset + bytesRead) >> 32);
+
+      DWORD chunkSize = DWORD(std::min<size_t>(size - bytesRead, 1u << 30));
+      DWORD chunkRead = 0;
+
+      if (!::ReadFile(m_handle, &data[bytesRead], chunkSize, &chunkRead, &ov) || !chunkRead)
+        break;
+
+      bytesRead += chunkRead;
+    }
+
+    data.resize(bytesRead);
+    return bytesRead == size;
+  }
+
+
+  bool DxvkStateCacheFile::append(
+    const std::string&      data) {
+    uint64_t offset = this->size();
+
+    OVERLAPPED ov = { };
+    ov.Offset     = DWORD(offset);
+    ov.OffsetHigh = DWORD(offset >> 32);
+
+    DWORD bytesWritten = 0;
+
+    return ::WriteFile(m_handle, data.data(), DWORD(data.size()), &bytesWritten, &ov)
+        && bytesWritten == data.size();
+  }
+
+
+  bool DxvkStateCacheFile::truncate() {
+    LARGE_INTEGER offset = { };
+
+    return ::SetFilePointerEx(m_handle, offset, nullptr, FILE_BEGIN)
+        && ::SetEndOfFile(m_handle);
+  }
+
+
+  void DxvkStateCacheFile::lock() {
+    lockRange(LOCKFILE_EXCLUSIVE_LOCK);
+  }
+
+
+  void DxvkStateCacheFile::unlock() {
+    OVERLAPPED ov = { };
+    ov.Offset     = DWORD(g_lockOffset);
+    ov.OffsetHigh = DWORD(g_lockOffset >> 32);
+
+    ::UnlockFileEx(m_handle, 0, 1, 0, &ov);
+  }
+
+
+  void DxvkStateCacheFile::lock_shared() {
+    lockRange(0);
+  }
+
+
+  void DxvkStateCacheFile::unlock_shared() {
+    unlock();
+  }
+
+
+  void DxvkStateCacheFile::lockRange(DWORD flags) {
+    OVERLAPPED ov = { };
+    ov.Offset     = DWORD(g_lockOffset);
+    ov.OffsetHigh = DWORD(g_lockOffset >> 32);
+
+    if (!::LockFileEx(m_handle, flags, 0, 1, 0, &ov))
+      Logger::warn("DXVK: Failed to lock state cache file");
+  }
+
 }
@@ -5,6 +5,8 @@
 #include <fstream>
 #include <mutex>
 #include <queue>
+#include <shared_mutex>
+#include <sstream>
 #include <unordered_map>
 #include <vector>
 
@@ -53,6 +55,68 @@ namespace dxvk {
   };
 
 
+  /**
+   * \brief Legacy graphics pipeline state
+   * 
+   * Pipeline state vector as stored in state cache
+   * files prior to v4, which used the unpacked
+   * Vulkan structures directly. Only used to
+   * convert entries from older cache files.
+   */
+  struct DxvkGraphicsPipelineStateInfoV3 {
+    DxvkBindingMask                     bsBindingMask;
+    
+    VkPrimitiveTopology                 iaPrimitiveTopology;
+    VkBool32                            iaPrimitiveRestart;
+    uint32_t                            iaPatchVertexCount;
+    
+    uint32_t                            ilAttributeCount;
+    uint32_t                            ilBindingCount;
+    VkVertexInputAttributeDescription   ilAttributes[DxvkLimits::MaxNumVertexAttributes];
+    VkVertexInputBindingDescription     ilBindings[DxvkLimits::MaxNumVertexBindings];
+    uint32_t                            ilDivisors[DxvkLimits::MaxNumVertexBindings];
+    
+    VkBool32                            rsDepthClipEnable;
+    VkBool32                            rsDepthBiasEnable;
+    VkPolygonMode                       rsPolygonMode;
+    VkCullModeFlags                     rsCullMode;
+    VkFrontFace                         rsFrontFace;
+    uint32_t                            rsViewportCount;
+    VkSampleCountFlags                  rsSampleCount;
+    
+    VkSampleCountFlags                  msSampleCount;
+    uint32_t                            msSampleMask;
+    VkBool32                            msEnableAlphaToCoverage;
+    VkBool32                            msEnableAlphaToOne;
+    
+    VkBool32                            dsEnableDepthTest;
+    VkBool32                            dsEnableDepthWrite;
+    VkBool32                            dsEnableStencilTest;
+    VkCompareOp                         dsDepthCompareOp;
+    VkStencilOpState                    dsStencilOpFront;
+    VkStencilOpState                    dsStencilOpBack;
+    
+    VkBool32                            omEnableLogicOp;
+    VkLogicOp                           omLogicOp;
+    VkPipelineColorBlendAttachmentState omBlendAttachments[MaxNumRenderTargets];
+    VkComponentMapping                  omComponentMapping[MaxNumRenderTargets];
+  };
+
+
+  /**
+   * \brief Legacy state entry
+   * 
+   * State cache entry layout used by v2 and v3.
+   */
+  struct DxvkStateCacheEntryV3 {
+    DxvkStateCacheKey               shaders;
+    DxvkGraphicsPipelineStateInfoV3 gpState;
+    DxvkComputePipelineStateInfo    cpState;
+    DxvkRenderPassFormat            format;
+    Sha1Hash                        hash;
+  };
+
+
   /**
    * \brief State cache header
    * 
@@ -62,13 +126,101 @@ namespace dxvk {
    */
   struct DxvkStateCacheHeader {
     char     magic[4]   = { 'D', 'X', 'V', 'K' };
-    uint32_t version    = 3;
+    uint32_t version    = 4;
     uint32_t entrySize  = sizeof(DxvkStateCacheEntry);
   };
 
   static_assert(sizeof(DxvkStateCacheHeader) == 12);
 
 
+  /**
+   * \brief State cache file
+   * 
+   * Thin wrapper around a file handle that can be
+   * shared between multiple processes. Provides an
+   * advisory lock which satisfies the requirements
+   * of both \c std::unique_lock and \c std::shared_lock.
+   * Appending to and rewriting the file requires an
+   * exclusive lock, reading requires a shared lock.
+   */
+  class DxvkStateCacheFile {
+
+  public:
+
+    DxvkStateCacheFile();
+
+    ~DxvkStateCacheFile();
+
+    DxvkStateCacheFile             (const DxvkStateCacheFile&) = delete;
+    DxvkStateCacheFile& operator = (const DxvkStateCacheFile&) = delete;
+
+    /**
+     * \brief Opens or creates the file
+     * 
+     * \param [in] path Path to the file
+     * \returns \c true on success
+     */
+    bool open(const std::string& path);
+
+    /**
+     * \brief Checks whether the file is open
+     * \returns \c true if the file is open
+     */
+    bool isOpen() const {
+      return m_handle != INVALID_HANDLE_VALUE;
+    }
+
+    /**
+     * \brief Queries current file size
+     * \returns File size, in bytes
+     */
+    uint64_t size() const;
+
+    /**
+     * \brief Reads data from the file
+     * 
+     * \param [in] offset Offset of the data
+     * \param [in] size Number of bytes to read
+     * \param [out] data Data read from the file
+     * \returns \c true if all data could be read
+     */
+    bool read(
+            uint64_t          offset,
+            size_t            size,
+            std::string&      data) const;
+
+    /**
+     * \brief Appends data to the file
+     * 
+     * The data is written with a single call, so that
+     * readers never see partially written records.
+     * \param [in] data The data to append
+     * \returns \c true on success
+     */
+    bool append(
+      const std::string&      data);
+
+    /**
+     * \brief Discards the file contents
+     * \returns \c true on success
+     */
+    bool truncate();
+
+    void lock();
+    void unlock();
+
+    void lock_shared();
+    void unlock_shared();
+
+  private:
+
+    HANDLE m_handle = INVALID_HANDLE_VALUE;
+
+    void lockRange(DWORD flags);
+
+  };
+
+
   /**
    * \brief State cache
    * 
@@ -142,9 +294,14 @@ namespace dxvk {
     DxvkPipelineManager*              m_pipeManager;
     DxvkRenderPassPool*               m_passManager;
 
+    bool                              m_bindDummyResources;
+
     std::vector<DxvkStateCacheEntry>  m_entries;
     std::atomic<bool>                 m_stopThreads = { false };
 
+    DxvkStateCacheFile                m_file;
+    uint64_t                          m_fileOffset = 0;
+
     std::mutex                        m_entryLock;
 
     std::unordered_multimap<
@@ -176,6 +333,20 @@ namespace dxvk {
       const DxvkShaderKey&            key,
             Rc<DxvkShader>&           shader) const;
     
+    bool addEntry(
+      const DxvkStateCacheEntry&      entry,
+            bool                      compile);
+
+    bool hasEntry(
+      const DxvkStateCacheEntry&      entry) const;
+
+    std::vector<DxvkStateCacheEntry> getEntries(
+      const DxvkStateCacheKey&        key);
+
+    bool getWorkerItem(
+      const DxvkStateCacheKey&        key,
+            WorkerItem&               item) const;
+
     void mapPipelineToEntry(
       const DxvkStateCacheKey&        key,
             size_t                    entryId);
@@ -187,8 +358,16 @@ namespace dxvk {
     void compilePipelines(
       const WorkerItem&               item);
 
+    void normalizeBindingMask(
+            DxvkBindingMask&          mask,
+      const DxvkPipelineLayout*       layout) const;
+
     bool readCacheFile();
 
+    void readPeerEntries();
+
+    void writeCacheFile();
+
     bool readCacheHeader(
             std::istream&             stream,
             DxvkStateCacheHeader&     header) const;
@@ -197,11 +376,22 @@ namespace dxvk {
             std::istream&             stream, 
             DxvkStateCacheEntry&      entry) const;
     
+    bool readCacheEntryV3(
+            std::istream&             stream, 
+            DxvkStateCacheEntryV3&    entry) const;
+    
     void writeCacheEntry(
             std::ostream&             stream, 
             DxvkStateCacheEntry&      entry) const;
     
     bool convertEntryV2(
+            DxvkStateCacheEntryV3&    entry) const;
+    
+    bool convertEntryV3(
+      const DxvkStateCacheEntryV3&    legacy,
+            DxvkStateCacheEntry&      entry) const;
+    
+    void normalizeEntry(
             DxvkStateCacheEntry&      entry) const;
     
     void workerFunc();
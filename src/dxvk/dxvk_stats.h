@@ -14,12 +14,24 @@ namespace dxvk {
     CmdDrawCalls,             ///< Number of draw calls
     CmdDispatchCalls,         ///< Number of compute calls
     CmdRenderPassCount,       ///< Number of render passes
+    CmdTransfersHoisted,      ///< Transfers moved out of active render passes
+    CmdClearCountFb,          ///< Image clears using attachment clears
+    CmdClearCountCs,          ///< Image clears using compute shaders
     MemoryAllocationCount,    ///< Number of memory allocations
     MemoryAllocated,          ///< Amount of memory allocated
     MemoryUsed,               ///< Amount of memory used
+    MemoryBudget,             ///< Soft budget of device-local memory
+    MemoryDemoted,            ///< Amount of memory demoted to system memory
+    MemoryDemotionCount,      ///< Number of demoted allocations
     PipeCountGraphics,        ///< Number of graphics pipelines
     PipeCountCompute,         ///< Number of compute pipelines
+    PipeOutputsMatched,       ///< Shader outputs read by the next stage
+    PipeOutputsRemoved,       ///< Unused shader outputs removed at link time
     QueueSubmitCount,         ///< Number of command buffer submissions
+    QueueSubmitLatency,       ///< Average submit-to-complete latency, in us
+    QueueFlushIdleCount,      ///< Implicit flushes because the GPU was about to idle
+    QueueFlushWorkCount,      ///< Implicit flushes because of the recorded workload
+    QueueFlushDeferCount,     ///< Implicit flushes deferred while the GPU was busy
     QueuePresentCount,        ///< Number of present calls / frames
     NumCounters,              ///< Number of counters available
   };
@@ -14,7 +14,8 @@ namespace dxvk::hud {
     m_renderer      (device),
     m_hudDeviceInfo (device),
     m_hudFramerate  (config.elements),
-    m_hudStats      (config.elements) {
+    m_hudStats      (config.elements),
+    m_hudRegions    (device, config.elements) {
     // Set up constant state
     m_rsState.polygonMode       = VK_POLYGON_MODE_FILL;
     m_rsState.cullMode          = VK_CULL_MODE_BACK_BIT;
@@ -45,6 +46,7 @@ namespace dxvk::hud {
   void Hud::update() {
     m_hudFramerate.update();
     m_hudStats.update(m_device);
+    m_hudRegions.update(m_device);
   }
   
   
@@ -105,6 +107,7 @@ namespace dxvk::hud {
     
     position = m_hudFramerate.render(ctx, m_renderer, position);
     position = m_hudStats    .render(ctx, m_renderer, position);
+    position = m_hudRegions  .render(ctx, m_renderer, position);
   }
   
   
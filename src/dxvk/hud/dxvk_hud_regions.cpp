@@ -0,0 +1,71 @@
+#include "dxvk_hud_regions.h"
+
+namespace dxvk::hud {
+
+  HudRegions::HudRegions(
+    const Rc<DxvkDevice>&   device,
+          HudElements       elements)
+  : m_elements(filterElements(elements)) {
+    if (!m_elements.isClear())
+      device->gpuProfiler()->enableTiming();
+  }
+
+
+  HudRegions::~HudRegions() {
+
+  }
+
+
+  void HudRegions::update(const Rc<DxvkDevice>& device) {
+    if (m_elements.isClear())
+      return;
+
+    m_regions = device->gpuProfiler()->getFrameStats();
+  }
+
+
+  HudPos HudRegions::render(
+    const Rc<DxvkContext>&  context,
+          HudRenderer&      renderer,
+          HudPos            position) {
+    if (m_elements.isClear())
+      return position;
+
+    renderer.drawText(context, 16.0f,
+      { position.x, position.y },
+      { 1.0f, 1.0f, 1.0f, 1.0f },
+      "GPU regions:");
+
+    position.y += 20.0f;
+
+    uint32_t regionCount = std::min<uint32_t>(m_regions.size(), MaxRegionCount);
+
+    for (uint32_t i = 0; i < regionCount; i++) {
+      const DxvkGpuRegionStats& region = m_regions[i];
+
+      // Time in units of 10 microseconds
+      const uint64_t time = region.timeNs / 10000;
+
+      const std::string strRegion = str::format(
+        std::string(2 * region.depth + 2, ' '), region.name, ": ",
+        time / 100, ".", (time / 10) % 10, time % 10, " ms",
+        region.count > 1 ? str::format(" (", region.count, "x)") : "");
+
+      renderer.drawText(context, 14.0f,
+        { position.x, position.y },
+        { 1.0f, 1.0f, 1.0f, 1.0f },
+        strRegion);
+
+      position.y += 18.0f;
+    }
+
+    return { position.x, position.y + 6.0f };
+  }
+
+
+  HudElements HudRegions::filterElements(HudElements elements) {
+    return elements & HudElements(
+      HudElement::GpuRegions);
+  }
+
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "../dxvk_device.h"
+
+#include "dxvk_hud_config.h"
+#include "dxvk_hud_renderer.h"
+
+namespace dxvk::hud {
+
+  /**
+   * \brief GPU region display for the HUD
+   *
+   * Displays the GPU time spent in each region
+   * that the application annotated during the
+   * last frame. Enables GPU timing on the device
+   * when the element is enabled.
+   */
+  class HudRegions {
+    constexpr static uint32_t MaxRegionCount = 24;
+  public:
+
+    HudRegions(
+      const Rc<DxvkDevice>&   device,
+            HudElements       elements);
+
+    ~HudRegions();
+
+    void update(
+      const Rc<DxvkDevice>&   device);
+
+    HudPos render(
+      const Rc<DxvkContext>&  context,
+            HudRenderer&      renderer,
+            HudPos            position);
+
+  private:
+
+    const HudElements m_elements;
+
+    std::vector<DxvkGpuRegionStats> m_regions;
+
+    static HudElements filterElements(HudElements elements);
+
+  };
+
+}
@@ -52,10 +52,13 @@ namespace dxvk::hud {
     const uint64_t gpCalls = m_diffCounters.getCtr(DxvkStatCounter::CmdDrawCalls)       / frameCount;
     const uint64_t cpCalls = m_diffCounters.getCtr(DxvkStatCounter::CmdDispatchCalls)   / frameCount;
     const uint64_t rpCalls = m_diffCounters.getCtr(DxvkStatCounter::CmdRenderPassCount) / frameCount;
+    const uint64_t fbClears = m_diffCounters.getCtr(DxvkStatCounter::CmdClearCountFb)   / frameCount;
+    const uint64_t csClears = m_diffCounters.getCtr(DxvkStatCounter::CmdClearCountCs)   / frameCount;
     
     const std::string strDrawCalls      = str::format("Draw calls:     ", gpCalls);
     const std::string strDispatchCalls  = str::format("Dispatch calls: ", cpCalls);
     const std::string strRenderPasses   = str::format("Render passes:  ", rpCalls);
+    const std::string strImageClears    = str::format("Image clears:   ", fbClears, " fb, ", csClears, " cs");
     
     renderer.drawText(context, 16.0f,
       { position.x, position.y },
@@ -72,7 +75,12 @@ namespace dxvk::hud {
       { 1.0f, 1.0f, 1.0f, 1.0f },
       strRenderPasses);
     
-    return { position.x, position.y + 64 };
+    renderer.drawText(context, 16.0f,
+      { position.x, position.y + 60.0f },
+      { 1.0f, 1.0f, 1.0f, 1.0f },
+      strImageClears);
+    
+    return { position.x, position.y + 84 };
   }
   
   
@@ -126,9 +134,14 @@ namespace dxvk::hud {
     
     const uint64_t memAllocated = m_prevCounters.getCtr(DxvkStatCounter::MemoryAllocated);
     const uint64_t memUsed      = m_prevCounters.getCtr(DxvkStatCounter::MemoryUsed);
+    const uint64_t memBudget    = m_prevCounters.getCtr(DxvkStatCounter::MemoryBudget);
+    const uint64_t memDemoted   = m_prevCounters.getCtr(DxvkStatCounter::MemoryDemoted);
+    const uint64_t numDemoted   = m_prevCounters.getCtr(DxvkStatCounter::MemoryDemotionCount);
     
     const std::string strMemAllocated = str::format("Memory allocated: ", memAllocated / mib, " MB");
     const std::string strMemUsed      = str::format("Memory used:      ", memUsed      / mib, " MB");
+    const std::string strMemBudget    = str::format("Memory budget:    ", memBudget    / mib, " MB");
+    const std::string strMemDemoted   = str::format("Memory demoted:   ", memDemoted   / mib, " MB (", numDemoted, " total)");
     
     renderer.drawText(context, 16.0f,
       { position.x, position.y },
@@ -140,7 +153,17 @@ namespace dxvk::hud {
       { 1.0f, 1.0f, 1.0f, 1.0f },
       strMemUsed);
     
-    return { position.x, position.y + 44.0f };
+    renderer.drawText(context, 16.0f,
+      { position.x, position.y + 40.0f },
+      { 1.0f, 1.0f, 1.0f, 1.0f },
+      strMemBudget);
+    
+    renderer.drawText(context, 16.0f,
+      { position.x, position.y + 60.0f },
+      { 1.0f, 1.0f, 1.0f, 1.0f },
+      strMemDemoted);
+    
+    return { position.x, position.y + 84.0f };
   }
   
   
@@ -2919,6 +2919,34 @@ namespace dxvk {
   }
 
 
+  uint32_t SpirvModule::opGroupNonUniformElect(
+          uint32_t                resultType,
+          uint32_t                execution) {
+    uint32_t resultId = this->allocateId();
+
+    m_code.putIns(spv::OpGroupNonUniformElect, 4);
+    m_code.putWord(resultType);
+    m_code.putWord(resultId);
+    m_code.putWord(execution);
+    return resultId;
+  }
+
+
+  uint32_t SpirvModule::opGroupNonUniformBroadcastFirst(
+          uint32_t                resultType,
+          uint32_t                execution,
+          uint32_t                value) {
+    uint32_t resultId = this->allocateId();
+
+    m_code.putIns(spv::OpGroupNonUniformBroadcastFirst, 5);
+    m_code.putWord(resultType);
+    m_code.putWord(resultId);
+    m_code.putWord(execution);
+    m_code.putWord(value);
+    return resultId;
+  }
+
+
   uint32_t SpirvModule::opGroupNonUniformLogicalAnd(
           uint32_t                resultType,
           uint32_t                execution,
@@ -1008,6 +1008,15 @@ namespace dxvk {
             uint32_t                operation,
             uint32_t                ballot);
     
+    uint32_t opGroupNonUniformElect(
+            uint32_t                resultType,
+            uint32_t                execution);
+    
+    uint32_t opGroupNonUniformBroadcastFirst(
+            uint32_t                resultType,
+            uint32_t                execution,
+            uint32_t                value);
+    
     uint32_t opGroupNonUniformLogicalAnd(
             uint32_t                resultType,
             uint32_t                execution,
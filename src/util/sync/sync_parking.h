@@ -0,0 +1,135 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+#ifndef _MSC_VER
+#include <x86intrin.h>
+#else
+#include <intrin.h>
+#endif
+
+#include "../thread.h"
+
+namespace dxvk::sync {
+
+  /**
+   * \brief Lock contention statistics
+   *
+   * Counts how often a lock could not be acquired
+   * immediately, and how often a thread trying to
+   * acquire the lock had to be put to sleep.
+   */
+  struct LockStats {
+    uint32_t contended = 0;
+    uint32_t parked    = 0;
+  };
+
+
+  /**
+   * \brief Thread parking functions
+   *
+   * Uses \c WaitOnAddress and \c WakeByAddressSingle
+   * if available. These are loaded at runtime since
+   * they do not exist on older versions of Windows,
+   * in which case parking degrades to yielding.
+   */
+  class ParkingLot {
+    using PFN_WaitOnAddress       = BOOL (WINAPI*)(volatile void*, void*, SIZE_T, DWORD);
+    using PFN_WakeByAddressSingle = void (WINAPI*)(void*);
+  public:
+
+    /**
+     * \brief Parks the calling thread
+     *
+     * Returns when the value at the given address
+     * was changed and the address was woken up, or
+     * spuriously. Callers must re-check the value.
+     * \param [in] address Address to wait on
+     * \param [in] value Value to compare against
+     */
+    static void park(std::atomic<uint32_t>* address, uint32_t value) {
+      const ParkingLot& lot = instance();
+
+      if (lot.m_waitOnAddress != nullptr)
+        lot.m_waitOnAddress(address, &value, sizeof(value), INFINITE);
+      else
+        dxvk::this_thread::yield();
+    }
+
+    /**
+     * \brief Wakes up one parked thread
+     * \param [in] address Address to wake up
+     */
+    static void wake(std::atomic<uint32_t>* address) {
+      const ParkingLot& lot = instance();
+
+      if (lot.m_wakeByAddressSingle != nullptr)
+        lot.m_wakeByAddressSingle(address);
+    }
+
+    /**
+     * \brief Number of spin iterations before parking
+     *
+     * Calibrated once so that spinning takes roughly
+     * as long as a thread that holds a short lock needs
+     * to release it, regardless of the cost of \c pause.
+     * \returns Spin iteration count
+     */
+    static uint32_t spinCount() {
+      return instance().m_spinCount;
+    }
+
+  private:
+
+    PFN_WaitOnAddress       m_waitOnAddress       = nullptr;
+    PFN_WakeByAddressSingle m_wakeByAddressSingle = nullptr;
+
+    uint32_t                m_spinCount           = 0;
+
+    ParkingLot() {
+      HMODULE module = ::LoadLibraryA("api-ms-win-core-synch-l1-2-0.dll");
+
+      if (module != nullptr) {
+        m_waitOnAddress       = reinterpret_cast<PFN_WaitOnAddress>(
+          reinterpret_cast<void*>(::GetProcAddress(module, "WaitOnAddress")));
+        m_wakeByAddressSingle = reinterpret_cast<PFN_WakeByAddressSingle>(
+          reinterpret_cast<void*>(::GetProcAddress(module, "WakeByAddressSingle")));
+      }
+
+      if (m_waitOnAddress == nullptr || m_wakeByAddressSingle == nullptr) {
+        m_waitOnAddress       = nullptr;
+        m_wakeByAddressSingle = nullptr;
+      }
+
+      m_spinCount = calibrateSpinCount();
+    }
+
+    static const ParkingLot& instance() {
+      static ParkingLot s_instance;
+      return s_instance;
+    }
+
+    static uint32_t calibrateSpinCount() {
+      constexpr uint32_t SampleIterations = 1024;
+      constexpr auto     SpinDuration     = std::chrono::microseconds(4);
+
+      auto t0 = std::chrono::high_resolution_clock::now();
+
+      for (uint32_t i = 0; i < SampleIterations; i++)
+        _mm_pause();
+
+      auto t1 = std::chrono::high_resolution_clock::now();
+      auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+
+      uint64_t count = SampleIterations
+        * std::chrono::duration_cast<std::chrono::nanoseconds>(SpinDuration).count()
+        / std::max<int64_t>(ns, 1);
+
+      return uint32_t(std::min<uint64_t>(std::max<uint64_t>(count, 16), 65536));
+    }
+
+  };
+
+}
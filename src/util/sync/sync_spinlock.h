@@ -1,7 +1,10 @@
 #pragma once
 
 #include <atomic>
-#include "../thread.h"
+
+#include "sync_parking.h"
+
+#include "../util_likely.h"
 
 namespace dxvk::sync {
   
@@ -11,6 +14,13 @@ namespace dxvk::sync {
    * A low-overhead spin lock which can be used to
    * protect data structures for a short duration
    * in case the structure is not likely contested.
+   * 
+   * If the lock is contested, waiting threads spin
+   * for a short, calibrated period before they are
+   * parked, so that a preempted lock holder does
+   * not cause other threads to burn their entire
+   * time slice. The lock word is 0 when unlocked,
+   * 1 when locked, and 2 when threads may be parked.
    */
   class Spinlock {
     
@@ -23,12 +33,15 @@ namespace dxvk::sync {
     Spinlock& operator = (const Spinlock&) = delete;
     
     void lock() {
-      while (!this->try_lock())
-        dxvk::this_thread::yield();
+      if (likely(this->try_lock()))
+        return;
+      
+      this->lockContended();
     }
     
     void unlock() {
-      m_lock.store(0, std::memory_order_release);
+      if (unlikely(m_lock.exchange(0, std::memory_order_release) == 2))
+        ParkingLot::wake(&m_lock);
     }
     
     bool try_lock() {
@@ -38,9 +51,43 @@ namespace dxvk::sync {
         std::memory_order_relaxed);
     }
     
+    /**
+     * \brief Queries contention statistics
+     * \returns Lock statistics
+     */
+    LockStats getStats() const {
+      LockStats result;
+      result.contended = m_contended.load(std::memory_order_relaxed);
+      result.parked    = m_parked.load(std::memory_order_relaxed);
+      return result;
+    }
+    
   private:
     
-    std::atomic<uint32_t> m_lock = { 0 };
+    std::atomic<uint32_t> m_lock      = { 0 };
+    std::atomic<uint32_t> m_contended = { 0 };
+    std::atomic<uint32_t> m_parked    = { 0 };
+    
+    void lockContended() {
+      m_contended.fetch_add(1, std::memory_order_relaxed);
+      
+      uint32_t spinCount = ParkingLot::spinCount();
+      
+      for (uint32_t i = 0; i < spinCount; i++) {
+        _mm_pause();
+        
+        if (m_lock.load(std::memory_order_relaxed) == 0
+         && this->try_lock())
+          return;
+      }
+      
+      // Mark the lock as having waiters, so that
+      // the owning thread wakes us up on unlock
+      m_parked.fetch_add(1, std::memory_order_relaxed);
+      
+      while (m_lock.exchange(2, std::memory_order_acquire) != 0)
+        ParkingLot::park(&m_lock, 2);
+    }
     
   };
   
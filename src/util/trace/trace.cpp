@@ -0,0 +1,132 @@
+#include <algorithm>
+#include <array>
+#include <fstream>
+
+#include "trace.h"
+
+#include "../log/log.h"
+
+#include "../util_env.h"
+#include "../util_string.h"
+
+#include "../com/com_include.h"
+
+namespace dxvk::trace {
+
+  thread_local TraceBuffer* Tracer::s_threadBuffer = nullptr;
+
+
+  Tracer::Tracer() {
+    std::string path = env::getEnvVar("DXVK_TRACE_PATH");
+
+    if (path.empty())
+      return;
+
+    m_enabled   = true;
+    m_fileName  = getFileName(path);
+    m_tscStart  = timestamp();
+    m_timeStart = std::chrono::steady_clock::now();
+  }
+
+
+  Tracer::~Tracer() {
+    if (m_enabled)
+      writeTraceFile();
+  }
+
+
+  TraceBuffer* Tracer::createBuffer() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_buffers.push_back(std::make_unique<TraceBuffer>(
+      uint32_t(::GetCurrentThreadId())));
+    return m_buffers.back().get();
+  }
+
+
+  void Tracer::writeTraceFile() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Compute the time stamp counter frequency from
+    // the time that elapsed since tracing started
+    uint64_t tscEnd  = timestamp();
+    auto     timeEnd = std::chrono::steady_clock::now();
+
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(timeEnd - m_timeStart);
+
+    double ticksPerUs = double(tscEnd - m_tscStart)
+      / std::max(double(ns.count()) / 1000.0, 1.0);
+
+    std::ofstream file(m_fileName);
+
+    if (!file) {
+      Logger::err(str::format("Tracer: Failed to open ", m_fileName));
+      return;
+    }
+
+    file << "{\"traceEvents\":[";
+
+    bool first = true;
+
+    for (const auto& buffer : m_buffers) {
+      uint32_t count = buffer->count();
+      uint32_t start = count > TraceBuffer::Size ? count - TraceBuffer::Size : 0;
+
+      for (uint32_t i = start; i < count; i++) {
+        const TraceEvent& e = buffer->event(i);
+
+        if (e.begin < m_tscStart)
+          continue;
+
+        file << (first ? "\n" : ",\n")
+             << "{\"name\":\"" << e.name << "\",\"ph\":\"X\",\"pid\":"
+             << ::GetCurrentProcessId() << ",\"tid\":" << buffer->threadId()
+             << ",\"ts\":" << double(e.begin - m_tscStart) / ticksPerUs
+             << ",\"dur\":" << double(e.end - e.begin) / ticksPerUs << "}";
+
+        first = false;
+      }
+    }
+
+    file << "\n]}\n";
+  }
+
+
+  std::string Tracer::getFileName(const std::string& path) {
+    std::string fileName = path;
+
+    if (*fileName.rbegin() != '/')
+      fileName += '/';
+
+    std::string exeName = env::getExeName();
+    auto extp = exeName.find_last_of('.');
+
+    if (extp != std::string::npos && exeName.substr(extp + 1) == "exe")
+      exeName.erase(extp);
+
+    // Each DLL has its own tracer instance, so
+    // include the module name in the file name
+    HMODULE module = nullptr;
+
+    std::string moduleName = "dxvk";
+
+    if (::GetModuleHandleExA(
+          GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS |
+          GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+          reinterpret_cast<LPCSTR>(&Tracer::getFileName), &module)) {
+      std::array<char, MAX_PATH + 1> modulePath = { };
+      DWORD len = ::GetModuleFileNameA(module, modulePath.data(), MAX_PATH);
+
+      moduleName = std::string(modulePath.data(), len);
+      moduleName = moduleName.substr(moduleName.find_last_of("\\/") + 1);
+
+      auto dllp = moduleName.find_last_of('.');
+
+      if (dllp != std::string::npos)
+        moduleName.erase(dllp);
+    }
+
+    return fileName + exeName + "_" + moduleName + "_trace.json";
+  }
+
+}
@@ -0,0 +1,198 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifndef _MSC_VER
+#include <x86intrin.h>
+#else
+#include <intrin.h>
+#endif
+
+#include "../util_likely.h"
+
+#define DXVK_TRACE_CONCAT_(a, b) a ## b
+#define DXVK_TRACE_CONCAT(a, b) DXVK_TRACE_CONCAT_(a, b)
+
+#ifdef DXVK_TRACE_ZONES
+#define DXVK_TRACE_ZONE(name) \
+  ::dxvk::trace::TraceZone DXVK_TRACE_CONCAT(traceZone, __LINE__)(name)
+#else
+#define DXVK_TRACE_ZONE(name) \
+  do { } while (0)
+#endif
+
+namespace dxvk::trace {
+
+  /**
+   * \brief Trace event
+   *
+   * Stores the name of a zone along with the time
+   * stamps at which the zone was entered and left,
+   * in CPU time stamp counter ticks.
+   */
+  struct TraceEvent {
+    const char* name;
+    uint64_t    begin;
+    uint64_t    end;
+  };
+
+
+  /**
+   * \brief Per-thread trace buffer
+   *
+   * Ring buffer that stores the most recent events
+   * recorded by a single thread. Only the owning
+   * thread writes to the buffer, and once it is
+   * full, the oldest events get overwritten.
+   */
+  class TraceBuffer {
+
+  public:
+
+    constexpr static uint32_t Size = 1u << 16;
+
+    TraceBuffer(uint32_t threadId)
+    : m_threadId(threadId), m_events(Size) { }
+
+    void record(const char* name, uint64_t begin, uint64_t end) {
+      uint32_t index = m_count.load(std::memory_order_relaxed);
+      m_events[index & (Size - 1)] = { name, begin, end };
+      m_count.store(index + 1, std::memory_order_release);
+    }
+
+    uint32_t threadId() const {
+      return m_threadId;
+    }
+
+    uint32_t count() const {
+      return m_count.load(std::memory_order_acquire);
+    }
+
+    const TraceEvent& event(uint32_t index) const {
+      return m_events[index & (Size - 1)];
+    }
+
+  private:
+
+    uint32_t                m_threadId;
+    std::atomic<uint32_t>   m_count = { 0u };
+    std::vector<TraceEvent> m_events;
+
+  };
+
+
+  /**
+   * \brief Tracer
+   *
+   * Collects trace events from all threads and writes
+   * them to a Chrome trace file when the module gets
+   * unloaded. Tracing is enabled by setting the
+   * \c DXVK_TRACE_PATH environment variable to the
+   * directory where the trace file is to be stored.
+   */
+  class Tracer {
+
+  public:
+
+    ~Tracer();
+
+    /**
+     * \brief Checks whether tracing is enabled
+     * \returns \c true if events are recorded
+     */
+    static bool enabled() {
+      return instance().m_enabled;
+    }
+
+    /**
+     * \brief Queries current time stamp
+     * \returns Time stamp counter value
+     */
+    static uint64_t timestamp() {
+      return __rdtsc();
+    }
+
+    /**
+     * \brief Records an event for the calling thread
+     *
+     * \param [in] name Zone name. Must be a string
+     *    literal, since only the pointer is stored.
+     * \param [in] begin Time stamp when entering the zone
+     * \param [in] end Time stamp when leaving the zone
+     */
+    static void record(const char* name, uint64_t begin, uint64_t end) {
+      TraceBuffer* buffer = s_threadBuffer;
+
+      if (unlikely(buffer == nullptr))
+        buffer = s_threadBuffer = instance().createBuffer();
+
+      buffer->record(name, begin, end);
+    }
+
+  private:
+
+    Tracer();
+
+    bool                      m_enabled = false;
+    std::string               m_fileName;
+
+    uint64_t                  m_tscStart = 0;
+    std::chrono::steady_clock::time_point m_timeStart;
+
+    std::mutex                m_mutex;
+    std::vector<std::unique_ptr<TraceBuffer>> m_buffers;
+
+    static thread_local TraceBuffer* s_threadBuffer;
+
+    static Tracer& instance() {
+      static Tracer s_instance;
+      return s_instance;
+    }
+
+    TraceBuffer* createBuffer();
+
+    void writeTraceFile();
+
+    static std::string getFileName(const std::string& path);
+
+  };
+
+
+  /**
+   * \brief Trace zone
+   *
+   * Records the time spent in the enclosing scope
+   * as a single trace event. Use the \c DXVK_TRACE_ZONE
+   * macro, which compiles to nothing unless DXVK was
+   * built with tracing support.
+   */
+  class TraceZone {
+
+  public:
+
+    TraceZone(const char* name)
+    : m_name  (name),
+      m_begin (Tracer::enabled() ? Tracer::timestamp() : 0) { }
+
+    ~TraceZone() {
+      if (m_begin)
+        Tracer::record(m_name, m_begin, Tracer::timestamp());
+    }
+
+    TraceZone             (const TraceZone&) = delete;
+    TraceZone& operator = (const TraceZone&) = delete;
+
+  private:
+
+    const char* m_name;
+    uint64_t    m_begin;
+
+  };
+
+}
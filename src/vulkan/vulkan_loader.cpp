@@ -1,4 +1,5 @@
 #include "vulkan_loader.h"
+#include "vulkan_null.h"
 
 namespace dxvk::vk {
 
@@ -14,8 +15,14 @@ namespace dxvk::vk {
 
 #endif
 
+  static PFN_vkVoidFunction getInstanceProcAddr(VkInstance instance, const char* name) {
+    return isNullDriverEnabled()
+      ? getNullDriverProcAddr(name)
+      : GetInstanceProcAddr(instance, name);
+  }
+
   PFN_vkVoidFunction LibraryLoader::sym(const char* name) const {
-    return dxvk::vk::GetInstanceProcAddr(nullptr, name);
+    return dxvk::vk::getInstanceProcAddr(nullptr, name);
   }
   
   
@@ -24,13 +31,13 @@ namespace dxvk::vk {
   
   
   PFN_vkVoidFunction InstanceLoader::sym(const char* name) const {
-    return dxvk::vk::GetInstanceProcAddr(m_instance, name);
+    return dxvk::vk::getInstanceProcAddr(m_instance, name);
   }
   
   
   DeviceLoader::DeviceLoader(bool owned, VkInstance instance, VkDevice device)
   : m_getDeviceProcAddr(reinterpret_cast<PFN_vkGetDeviceProcAddr>(
-      dxvk::vk::GetInstanceProcAddr(instance, "vkGetDeviceProcAddr"))),
+      dxvk::vk::getInstanceProcAddr(instance, "vkGetDeviceProcAddr"))),
     m_device(device), m_owned(owned) { }
   
   
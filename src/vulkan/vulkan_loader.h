@@ -299,6 +299,12 @@ namespace dxvk::vk {
     VULKAN_FN(vkCmdBeginQueryIndexedEXT);
     VULKAN_FN(vkCmdEndQueryIndexedEXT);
     #endif
+
+    #ifdef VK_EXT_debug_utils
+    VULKAN_FN(vkCmdBeginDebugUtilsLabelEXT);
+    VULKAN_FN(vkCmdEndDebugUtilsLabelEXT);
+    VULKAN_FN(vkCmdInsertDebugUtilsLabelEXT);
+    #endif
   };
   
 }
\ No newline at end of file
@@ -0,0 +1,1547 @@
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "../util/util_bit.h"
+#include "../util/util_env.h"
+
+#include "vulkan_null.h"
+
+namespace dxvk::vk {
+
+  /**
+   * \brief Null driver configuration
+   *
+   * Properties of the fake physical device, which
+   * can be overridden with environment variables.
+   */
+  struct NullDeviceConfig {
+    std::string   deviceName  = "DXVK Null Device";
+    uint32_t      vendorId    = 0x10de;
+    uint32_t      deviceId    = 0x0000;
+    VkDeviceSize  memorySize  = VkDeviceSize(4096) << 20;
+
+    NullDeviceConfig() {
+      std::string name   = env::getEnvVar("DXVK_NULL_DEVICE_NAME");
+      std::string vendor = env::getEnvVar("DXVK_NULL_DEVICE_VENDOR");
+      std::string device = env::getEnvVar("DXVK_NULL_DEVICE_ID");
+      std::string memory = env::getEnvVar("DXVK_NULL_DEVICE_MEMORY");
+
+      if (!name.empty())
+        deviceName = name;
+
+      try {
+        if (!vendor.empty()) vendorId   = uint32_t(std::stoul(vendor, nullptr, 0));
+        if (!device.empty()) deviceId   = uint32_t(std::stoul(device, nullptr, 0));
+        if (!memory.empty()) memorySize = VkDeviceSize(std::stoull(memory, nullptr, 0)) << 20;
+      } catch (const std::exception&) { }
+    }
+  };
+
+
+  struct NullMemory {
+    VkDeviceSize          size;
+    std::vector<uint8_t>  data;
+  };
+
+
+  struct NullBuffer {
+    VkDeviceSize          size;
+  };
+
+
+  struct NullImage {
+    VkFormat              format;
+    VkExtent3D            extent;
+    uint32_t              mipLevels;
+    uint32_t              arrayLayers;
+  };
+
+
+  struct NullFence {
+    std::atomic<bool>     signaled;
+  };
+
+
+  struct NullEvent {
+    std::atomic<bool>     signaled;
+  };
+
+
+  struct NullQueryPool {
+    VkQueryType           type;
+    uint32_t              valueCount;
+  };
+
+
+  struct NullCommandBuffer {
+    std::vector<std::pair<NullEvent*, bool>> events;
+  };
+
+
+  struct NullCommandPool {
+    std::vector<NullCommandBuffer*> cmdBuffers;
+  };
+
+
+  struct NullSwapchain {
+    std::vector<NullImage*> images;
+    uint32_t                nextImage = 0;
+  };
+
+
+  static const NullDeviceConfig& getNullDeviceConfig() {
+    static NullDeviceConfig s_config;
+    return s_config;
+  }
+
+
+  /**
+   * \brief Creates a handle from a counter
+   *
+   * Used for objects that do not need to store any
+   * data. Non-dispatchable handles are plain integers
+   * on 32-bit platforms, and pointers otherwise.
+   */
+  template<typename T>
+  static T allocHandle() {
+    static std::atomic<uint64_t> s_nextHandle = { 1 };
+    uint64_t id = s_nextHandle++;
+
+    if constexpr (std::is_pointer<T>::value)
+      return reinterpret_cast<T>(uintptr_t(id << 4));
+    else
+      return T(id << 4);
+  }
+
+
+  template<typename T, typename P>
+  static T toHandle(P* object) {
+    if constexpr (std::is_pointer<T>::value)
+      return reinterpret_cast<T>(object);
+    else
+      return T(reinterpret_cast<uintptr_t>(object));
+  }
+
+
+  template<typename P, typename T>
+  static P* fromHandle(T handle) {
+    if constexpr (std::is_pointer<T>::value)
+      return reinterpret_cast<P*>(handle);
+    else
+      return reinterpret_cast<P*>(uintptr_t(handle));
+  }
+
+
+  template<typename T>
+  static VkResult writeArray(
+          uint32_t*             pCount,
+          T*                    pData,
+          uint32_t              count,
+    const T*                    data) {
+    if (pData == nullptr) {
+      *pCount = count;
+      return VK_SUCCESS;
+    }
+
+    uint32_t written = std::min(*pCount, count);
+
+    for (uint32_t i = 0; i < written; i++)
+      pData[i] = data[i];
+
+    *pCount = written;
+    return written < count ? VK_INCOMPLETE : VK_SUCCESS;
+  }
+
+
+  /**
+   * \brief Computes image subresource size
+   *
+   * Assumes the largest possible texel size for all
+   * formats, so that no format table is needed. This
+   * over-allocates memory, which is not a problem for
+   * the null driver since device memory isn't backed.
+   */
+  static VkDeviceSize getImageMipSize(const NullImage* image, uint32_t mip) {
+    return VkDeviceSize(16)
+      * std::max(image->extent.width  >> mip, 1u)
+      * std::max(image->extent.height >> mip, 1u)
+      * std::max(image->extent.depth  >> mip, 1u);
+  }
+
+
+  static VkDeviceSize getImageSize(const NullImage* image) {
+    VkDeviceSize size = 0;
+
+    for (uint32_t i = 0; i < image->mipLevels; i++)
+      size += getImageMipSize(image, i) * image->arrayLayers;
+
+    return size;
+  }
+
+
+  static void fillFeatures(VkPhysicalDeviceFeatures* pFeatures) {
+    // The feature struct consists of VkBool32 members only
+    auto features = reinterpret_cast<VkBool32*>(pFeatures);
+
+    for (size_t i = 0; i < sizeof(*pFeatures) / sizeof(VkBool32); i++)
+      features[i] = VK_TRUE;
+  }
+
+
+  static void fillFormatProperties(VkFormatProperties* pProperties) {
+    pProperties->linearTilingFeatures   = VkFormatFeatureFlags(~0u);
+    pProperties->optimalTilingFeatures  = VkFormatFeatureFlags(~0u);
+    pProperties->bufferFeatures         = VkFormatFeatureFlags(~0u);
+  }
+
+
+  static void fillImageFormatProperties(VkImageFormatProperties* pProperties) {
+    pProperties->maxExtent        = VkExtent3D { 16384, 16384, 2048 };
+    pProperties->maxMipLevels     = 15;
+    pProperties->maxArrayLayers   = 2048;
+    pProperties->sampleCounts     = VK_SAMPLE_COUNT_1_BIT | VK_SAMPLE_COUNT_2_BIT
+                                  | VK_SAMPLE_COUNT_4_BIT | VK_SAMPLE_COUNT_8_BIT;
+    pProperties->maxResourceSize  = VkDeviceSize(1) << 32;
+  }
+
+
+  static void fillProperties(VkPhysicalDeviceProperties* pProperties) {
+    const NullDeviceConfig& config = getNullDeviceConfig();
+
+    *pProperties = VkPhysicalDeviceProperties();
+    pProperties->apiVersion     = VK_MAKE_VERSION(1, 1, 0);
+    pProperties->driverVersion  = VK_MAKE_VERSION(1, 0, 0);
+    pProperties->vendorID       = config.vendorId;
+    pProperties->deviceID       = config.deviceId;
+    pProperties->deviceType     = VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU;
+
+    std::strncpy(pProperties->deviceName, config.deviceName.c_str(),
+      VK_MAX_PHYSICAL_DEVICE_NAME_SIZE - 1);
+
+    VkSampleCountFlags sampleCounts = VK_SAMPLE_COUNT_1_BIT | VK_SAMPLE_COUNT_2_BIT
+                                    | VK_SAMPLE_COUNT_4_BIT | VK_SAMPLE_COUNT_8_BIT;
+
+    VkPhysicalDeviceLimits& limits = pProperties->limits;
+    limits.maxImageDimension1D                    = 16384;
+    limits.maxImageDimension2D                    = 16384;
+    limits.maxImageDimension3D                    = 2048;
+    limits.maxImageDimensionCube                  = 16384;
+    limits.maxImageArrayLayers                    = 2048;
+    limits.maxTexelBufferElements                 = 1u << 27;
+    limits.maxUniformBufferRange                  = 65536;
+    limits.maxStorageBufferRange                  = 1u << 30;
+    limits.maxPushConstantsSize                   = 256;
+    limits.maxMemoryAllocationCount               = 4096;
+    limits.maxSamplerAllocationCount              = 4000;
+    limits.bufferImageGranularity                 = 1024;
+    limits.sparseAddressSpaceSize                 = 0;
+    limits.maxBoundDescriptorSets                 = 8;
+    limits.maxPerStageDescriptorSamplers          = 1u << 20;
+    limits.maxPerStageDescriptorUniformBuffers    = 1u << 20;
+    limits.maxPerStageDescriptorStorageBuffers    = 1u << 20;
+    limits.maxPerStageDescriptorSampledImages     = 1u << 20;
+    limits.maxPerStageDescriptorStorageImages     = 1u << 20;
+    limits.maxPerStageDescriptorInputAttachments  = 1u << 20;
+    limits.maxPerStageResources                   = 1u << 20;
+    limits.maxDescriptorSetSamplers               = 1u << 20;
+    limits.maxDescriptorSetUniformBuffers         = 1u << 20;
+    limits.maxDescriptorSetUniformBuffersDynamic  = 32;
+    limits.maxDescriptorSetStorageBuffers         = 1u << 20;
+    limits.maxDescriptorSetStorageBuffersDynamic  = 16;
+    limits.maxDescriptorSetSampledImages          = 1u << 20;
+    limits.maxDescriptorSetStorageImages          = 1u << 20;
+    limits.maxDescriptorSetInputAttachments       = 1u << 20;
+    limits.maxVertexInputAttributes               = 32;
+    limits.maxVertexInputBindings                 = 32;
+    limits.maxVertexInputAttributeOffset          = 2047;
+    limits.maxVertexInputBindingStride            = 2048;
+    limits.maxVertexOutputComponents              = 128;
+    limits.maxTessellationGenerationLevel         = 64;
+    limits.maxTessellationPatchSize               = 32;
+    limits.maxTessellationControlPerVertexInputComponents   = 128;
+    limits.maxTessellationControlPerVertexOutputComponents  = 128;
+    limits.maxTessellationControlPerPatchOutputComponents   = 120;
+    limits.maxTessellationControlTotalOutputComponents      = 4216;
+    limits.maxTessellationEvaluationInputComponents         = 128;
+    limits.maxTessellationEvaluationOutputComponents        = 128;
+    limits.maxGeometryShaderInvocations           = 32;
+    limits.maxGeometryInputComponents             = 128;
+    limits.maxGeometryOutputComponents            = 128;
+    limits.maxGeometryOutputVertices              = 1024;
+    limits.maxGeometryTotalOutputComponents       = 1024;
+    limits.maxFragmentInputComponents             = 128;
+    limits.maxFragmentOutputAttachments           = 8;
+    limits.maxFragmentDualSrcAttachments          = 1;
+    limits.maxFragmentCombinedOutputResources     = 16;
+    limits.maxComputeSharedMemorySize             = 32768;
+    limits.maxComputeWorkGroupCount[0]            = 65535;
+    limits.maxComputeWorkGroupCount[1]            = 65535;
+    limits.maxComputeWorkGroupCount[2]            = 65535;
+    limits.maxComputeWorkGroupInvocations         = 1024;
+    limits.maxComputeWorkGroupSize[0]             = 1024;
+    limits.maxComputeWorkGroupSize[1]             = 1024;
+    limits.maxComputeWorkGroupSize[2]             = 64;
+    limits.subPixelPrecisionBits                  = 8;
+    limits.subTexelPrecisionBits                  = 8;
+    limits.mipmapPrecisionBits                    = 8;
+    limits.maxDrawIndexedIndexValue               = ~0u;
+    limits.maxDrawIndirectCount                   = ~0u;
+    limits.maxSamplerLodBias                      = 15.0f;
+    limits.maxSamplerAnisotropy                   = 16.0f;
+    limits.maxViewports                           = 16;
+    limits.maxViewportDimensions[0]               = 16384;
+    limits.maxViewportDimensions[1]               = 16384;
+    limits.viewportBoundsRange[0]                 = -32768.0f;
+    limits.viewportBoundsRange[1]                 =  32767.0f;
+    limits.viewportSubPixelBits                   = 8;
+    limits.minMemoryMapAlignment                  = 64;
+    limits.minTexelBufferOffsetAlignment          = 16;
+    limits.minUniformBufferOffsetAlignment        = 256;
+    limits.minStorageBufferOffsetAlignment        = 16;
+    limits.minTexelOffset                         = -8;
+    limits.maxTexelOffset                         = 7;
+    limits.minTexelGatherOffset                   = -32;
+    limits.maxTexelGatherOffset                   = 31;
+    limits.minInterpolationOffset                 = -0.5f;
+    limits.maxInterpolationOffset                 = 0.4375f;
+    limits.subPixelInterpolationOffsetBits        = 4;
+    limits.maxFramebufferWidth                    = 16384;
+    limits.maxFramebufferHeight                   = 16384;
+    limits.maxFramebufferLayers                   = 2048;
+    limits.framebufferColorSampleCounts           = sampleCounts;
+    limits.framebufferDepthSampleCounts           = sampleCounts;
+    limits.framebufferStencilSampleCounts         = sampleCounts;
+    limits.framebufferNoAttachmentsSampleCounts   = sampleCounts;
+    limits.maxColorAttachments                    = 8;
+    limits.sampledImageColorSampleCounts          = sampleCounts;
+    limits.sampledImageIntegerSampleCounts        = sampleCounts;
+    limits.sampledImageDepthSampleCounts          = sampleCounts;
+    limits.sampledImageStencilSampleCounts        = sampleCounts;
+    limits.storageImageSampleCounts               = sampleCounts;
+    limits.maxSampleMaskWords                     = 1;
+    limits.timestampComputeAndGraphics            = VK_TRUE;
+    limits.timestampPeriod                        = 1.0f;
+    limits.maxClipDistances                       = 8;
+    limits.maxCullDistances                       = 8;
+    limits.maxCombinedClipAndCullDistances        = 8;
+    limits.discreteQueuePriorities                = 2;
+    limits.pointSizeRange[0]                      = 1.0f;
+    limits.pointSizeRange[1]                      = 64.0f;
+    limits.lineWidthRange[0]                      = 1.0f;
+    limits.lineWidthRange[1]                      = 64.0f;
+    limits.pointSizeGranularity                   = 0.125f;
+    limits.lineWidthGranularity                   = 0.125f;
+    limits.strictLines                            = VK_TRUE;
+    limits.standardSampleLocations                = VK_TRUE;
+    limits.optimalBufferCopyOffsetAlignment       = 1;
+    limits.optimalBufferCopyRowPitchAlignment     = 1;
+    limits.nonCoherentAtomSize                    = 64;
+  }
+
+
+  static void fillMemoryProperties(VkPhysicalDeviceMemoryProperties* pProperties) {
+    *pProperties = VkPhysicalDeviceMemoryProperties();
+    pProperties->memoryHeapCount = 2;
+    pProperties->memoryHeaps[0] = { getNullDeviceConfig().memorySize, VK_MEMORY_HEAP_DEVICE_LOCAL_BIT };
+    pProperties->memoryHeaps[1] = { VkDeviceSize(8192) << 20, 0 };
+
+    pProperties->memoryTypeCount = 3;
+    pProperties->memoryTypes[0] = { VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0 };
+    pProperties->memoryTypes[1] = { VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+                                  | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, 1 };
+    pProperties->memoryTypes[2] = { VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+                                  | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+                                  | VK_MEMORY_PROPERTY_HOST_CACHED_BIT, 1 };
+  }
+
+
+  static void fillMemoryRequirements(VkMemoryRequirements* pRequirements, VkDeviceSize size) {
+    pRequirements->size           = (size + 255) & ~VkDeviceSize(255);
+    pRequirements->alignment      = 256;
+    pRequirements->memoryTypeBits = 0x7;
+  }
+
+
+  /* Instance and physical device functions */
+
+  static VKAPI_ATTR VkResult VKAPI_CALL nullCreateInstance(
+    const VkInstanceCreateInfo*         pCreateInfo,
+    const VkAllocationCallbacks*        pAllocator,
+          VkInstance*                   pInstance) {
+    *pInstance = allocHandle<VkInstance>();
+    return VK_SUCCESS;
+  }
+
+
+  static VKAPI_ATTR VkResult VKAPI_CALL nullEnumerateInstanceLayerProperties(
+          uint32_t*                     pPropertyCount,
+          VkLayerProperties*            pProperties) {
+    *pPropertyCount = 0;
+    return VK_SUCCESS;
+  }
+
+
+  static VKAPI_ATTR VkResult VKAPI_CALL nullEnumerateInstanceExtensionProperties(
+    const char*                         pLayerName,
+          uint32_t*                     pPropertyCount,
+          VkExtensionProperties*        pProperties) {
+    static const std::array<VkExtensionProperties, 3> s_extensions = {{
+      { VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME, 1 },
+      { VK_KHR_SURFACE_EXTENSION_NAME,                          25 },
+      { VK_KHR_WIN32_SURFACE_EXTENSION_NAME,                    6 },
+    }};
+
+    return writeArray(pPropertyCount, pProperties,
+      s_extensions.size(), s_extensions.data());
+  }
+
+
+  static VKAPI_ATTR VkResult VKAPI_CALL nullEnumeratePhysicalDevices(
+          VkInstance                    instance,
+          uint32_t*                     pPhysicalDeviceCount,
+          VkPhysicalDevice*             pPhysicalDevices) {
+    static const VkPhysicalDevice s_device = allocHandle<VkPhysicalDevice>();
+    return writeArray(pPhysicalDeviceCount, pPhysicalDevices, 1, &s_device);
+  }
+
+
+  static VKAPI_ATTR VkResult VKAPI_CALL nullEnumerateDeviceExtensionProperties(
+          VkPhysicalDevice              physicalDevice,
+    const char*                         pLayerName,
+          uint32_t*                     pPropertyCount,
+          VkExtensionProperties*        pProperties) {
+    static const std::array<VkExtensionProperties, 9> s_extensions = {{
+      { VK_KHR_DEDICATED_ALLOCATION_EXTENSION_NAME,         3 },
+      { VK_KHR_DESCRIPTOR_UPDATE_TEMPLATE_EXTENSION_NAME,   1 },
+      { VK_KHR_GET_MEMORY_REQUIREMENTS_2_EXTENSION_NAME,    1 },
+      { VK_KHR_IMAGE_FORMAT_LIST_EXTENSION_NAME,            1 },
+      { VK_KHR_MAINTENANCE1_EXTENSION_NAME,                 2 },
+      { VK_KHR_MAINTENANCE2_EXTENSION_NAME,                 1 },
+      { VK_KHR_SAMPLER_MIRROR_CLAMP_TO_EDGE_EXTENSION_NAME, 1 },
+      { VK_KHR_SHADER_DRAW_PARAMETERS_EXTENSION_NAME,       1 },
+      { VK_KHR_SWAPCHAIN_EXTENSION_NAME,                    70 },
+    }};
+
+    return writeArray(pPropertyCount, pProperties,
+      s_extensions.size(), s_extensions.data());
+  }
+
+
+  static VKAPI_ATTR void VKAPI_CALL nullGetPhysicalDeviceFeatures(
+          VkPhysicalDevice              physicalDevice,
+          VkPhysicalDeviceFeatures*     pFeatures) {
+    fillFeatures(pFeatures);
+  }
+
+
+  static VKAPI_ATTR void VKAPI_CALL nullGetPhysicalDeviceFeatures2(
+          VkPhysicalDevice              physicalDevice,
+          VkPhysicalDeviceFeatures2*    pFeatures) {
+    fillFeatures(&pFeatures->features);
+  }
+
+
+  static VKAPI_ATTR void VKAPI_CALL nullGetPhysicalDeviceProperties(
+          VkPhysicalDevice              physicalDevice,
+          VkPhysicalDeviceProperties*   pProperties) {
+    fillProperties(pProperties);
+  }
+
+
+  static VKAPI_ATTR void VKAPI_CALL nullGetPhysicalDeviceProperties2(
+          VkPhysicalDevice              physicalDevice,
+          VkPhysicalDeviceProperties2*  pProperties) {
+    fillProperties(&pProperties->properties);
+
+    auto next = reinterpret_cast<VkBaseOutStructure*>(pProperties->pNext);
+
+    for (; next != nullptr; next = next->pNext) {
+      if (next->sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES) {
+        auto idProps = reinterpret_cast<VkPhysicalDeviceIDProperties*>(next);
+        std::memset(idProps->deviceUUID, 0, VK_UUID_SIZE);
+        std::memset(idProps->driverUUID, 0, VK_UUID_SIZE);
+        std::memset(idProps->deviceLUID, 0, VK_LUID_SIZE);
+        idProps->deviceNodeMask  = 1;
+        idProps->deviceLUIDValid = VK_FALSE;
+      }
+
+      if (next->sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_PROPERTIES) {
+        auto subgroupProps = reinterpret_cast<VkPhysicalDeviceSubgroupProperties*>(next);
+        subgroupProps->subgroupSize              = 32;
+        subgroupProps->supportedStages           = VK_SHADER_STAGE_ALL;
+        subgroupProps->supportedOperations       = VK_SUBGROUP_FEATURE_BASIC_BIT
+                                                 | VK_SUBGROUP_FEATURE_VOTE_BIT
+                                                 | VK_SUBGROUP_FEATURE_ARITHMETIC_BIT
+                                                 | VK_SUBGROUP_FEATURE_BALLOT_BIT;
+        subgroupProps->quadOperationsInAllStages = VK_TRUE;
+      }
+    }
+  }
+
+
+  static VKAPI_ATTR void VKAPI_CALL nullGetPhysicalDeviceFormatProperties(
+          VkPhysicalDevice              physicalDevice,
+          VkFormat                      format,
+          VkFormatProperties*           pFormatProperties) {
+    fillFormatProperties(pFormatProperties);
+  }
+
+
+  static VKAPI_ATTR void VKAPI_CALL nullGetPhysicalDeviceFormatProperties2(
+          VkPhysicalDevice              physicalDevice,
+          VkFormat                      format,
+          VkFormatProperties2*          pFormatProperties) {
+    fillFormatProperties(&pFormatProperties->formatProperties);
+  }
+
+
+  static VKAPI_ATTR VkResult VKAPI_CALL nullGetPhysicalDeviceImageFormatProperties(
+          VkPhysicalDevice              physicalDevice,
+          VkFormat                      format,
+          VkImageType                   type,
+          VkImageTiling                 tiling,
+          VkImageUsageFlags             usage,
+          VkImageCreateFlags            flags,
+          VkImageFormatProperties*      pImageFormatProperties) {
+    fillImageFormatProperties(pImageFormatProperties);
+    return VK_SUCCESS;
+  }
+
+
+  static VKAPI_ATTR VkResult VKAPI_CALL nullGetPhysicalDeviceImageFormatProperties2(
+          VkPhysicalDevice                        physicalDevice,
+    const VkPhysicalDeviceImageFormatInfo2*       pImageFormatInfo,
+          VkImageFormatProperties2*               pImageFormatProperties) {
+    fillImageFormatProperties(&pImageFormatProperties->imageFormatProperties);
+    return VK_SUCCESS;
+  }
+
+
+  static VKAPI_ATTR void VKAPI_CALL nullGetPhysicalDeviceMemoryProperties(
+          VkPhysicalDevice                    physicalDevice,
+          VkPhysicalDeviceMemoryProperties*   pMemoryProperties) {
+    fillMemoryProperties(pMemoryProperties);
+  }
+
+
+  static VKAPI_ATTR void VKAPI_CALL nullGetPhysicalDeviceMemoryProperties2(
+          VkPhysicalDevice                    physicalDevice,
+          VkPhysicalDeviceMemoryProperties2*  pMemoryProperties) {
+    fillMemoryProperties(&pMemoryProperties->memoryProperties);
+  }
+
+
+  static VKAPI_ATTR void VKAPI_CALL nullGetPhysicalDeviceQueueFamilyProperties(
+          VkPhysicalDevice              physicalDevice,
+          uint32_t*                     pQueueFamilyPropertyCount,
+          VkQueueFamilyProperties*      pQueueFamilyProperties) {
+    VkQueueFamilyProperties family;
+    family.queueFlags                   = VK_QUEUE_GRAPHICS_BIT
+                                        | VK_QUEUE_COMPUTE_BIT
+                                        | VK_QUEUE_TRANSFER_BIT;
+    family.queueCount                   = 1;
+    family.timestampValidBits           = 64;
+    family.minImageTransferGranularity  = VkExtent3D { 1, 1, 1 };
+
+    writeArray(pQueueFamilyPropertyCount, pQueueFamilyProperties, 1, &family);
+  }
+
+
+  static VKAPI_ATTR void VKAPI_CALL nullGetPhysicalDeviceQueueFamilyProperties2(
+          VkPhysicalDevice              physicalDevice,
+          uint32_t*                     pQueueFamilyPropertyCount,
+          VkQueueFamilyProperties2*     pQueueFamilyProperties) {
+    if (pQueueFamilyProperties == nullptr) {
+      *pQueueFamilyPropertyCount = 1;
+    } else if (*pQueueFamilyPropertyCount != 0) {
+      uint32_t count = 1;
+      nullGetPhysicalDeviceQueueFamilyProperties(physicalDevice,
+        &count, &pQueueFamilyProperties->queueFamilyProperties);
+      *pQueueFamilyPropertyCount = count;
+    }
+  }
+
+
+  static VKAPI_ATTR void VKAPI_CALL nullGetPhysicalDeviceSparseImageFormatProperties(
+          VkPhysicalDevice              physicalDevice,
+          VkFormat                      format,
+          VkImageType                   type,
+          VkSampleCountFlagBits         samples,
+          VkImageUsageFlags             usage,
+          VkImageTiling                 tiling,
+          uint32_t*                     pPropertyCount,
+          VkSparseImageFormatProperties* pProperties) {
+    *pPropertyCount = 0;
+  }
+
+
+  static VKAPI_ATTR void VKAPI_CALL nullGetPhysicalDeviceSparseImageFormatProperties2(
+          VkPhysicalDevice                              physicalDevice,
+    const VkPhysicalDeviceSparseImageFormatInfo2*       pFormatInfo,
+          uint32_t*                                     pPropertyCount,
+          VkSparseImageFormatProperties2*               pProperties) {
+    *pPropertyCount = 0;
+  }
+
+
+  /* Surface functions */
+
+  static VKAPI_ATTR VkResult VKAPI_CALL nullCreateWin32SurfaceKHR(
+          VkInstance                    instance,
+    const VkWin32SurfaceCreateInfoKHR*  pCreateInfo,
+    const VkAllocationCallbacks*        pAllocator,
+          VkSurfaceKHR*                 pSurface) {
+    *pSurface = allocHandle<VkSurfaceKHR>();
+    return VK_SUCCESS;
+  }
+
+
+  static VKAPI_ATTR VkBool32 VKAPI_CALL nullGetPhysicalDeviceWin32PresentationSupportKHR(
+          VkPhysicalDevice              physicalDevice,
+          uint32_t                      queueFamilyIndex) {
+    return VK_TRUE;
+  }
+
+
+  static VKAPI_ATTR VkResult VKAPI_CALL nullGetPhysicalDeviceSurfaceSupportKHR(
+          VkPhysicalDevice              physicalDevice,
+          uint32_t                      queueFamilyIndex,
+          VkSurfaceKHR                  surface,
+          VkBool32*                     pSupported) {
+    *pSupported = VK_TRUE;
+    return VK_SUCCESS;
+  }
+
+
+  static VKAPI_ATTR VkResult VKAPI_CALL nullGetPhysicalDeviceSurfaceCapabilitiesKHR(
+          VkPhysicalDevice              physicalDevice,
+          VkSurfaceKHR                  surface,
+          VkSurfaceCapabilitiesKHR*     pSurfaceCapabilities) {
+    pSurfaceCapabilities->minImageCount           = 2;
+    pSurfaceCapabilities->maxImageCount           = 8;
+    pSurfaceCapabilities->currentExtent           = VkExtent2D { ~0u, ~0u };
+    pSurfaceCapabilities->minImageExtent          = VkExtent2D { 1, 1 };
+    pSurfaceCapabilities->maxImageExtent          = VkExtent2D { 16384, 16384 };
+    pSurfaceCapabilities->maxImageArrayLayers     = 1;
+    pSurfaceCapabilities->supportedTransforms     = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR;
+    pSurfaceCapabilities->currentTransform        = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR;
+    pSurfaceCapabilities->supportedCompositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+    pSurfaceCapabilities->supportedUsageFlags     = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT
+                                                  | VK_IMAGE_USAGE_TRANSFER_SRC_BIT
+                                                  | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    return VK_SUCCESS;
+  }
+
+
+  static VKAPI_ATTR VkResult VKAPI_CALL nullGetPhysicalDeviceSurfaceFormatsKHR(
+          VkPhysicalDevice              physicalDevice,
+          VkSurfaceKHR                  surface,
+          uint32_t*                     pSurfaceFormatCount,
+          VkSurfaceFormatKHR*           pSurfaceFormats) {
+    static const std::array<VkSurfaceFormatKHR, 4> s_formats = {{
+      { VK_FORMAT_B8G8R8A8_UNORM, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR },
+      { VK_FORMAT_B8G8R8A8_SRGB,  VK_COLOR_SPACE_SRGB_NONLINEAR_KHR },
+      { VK_FORMAT_R8G8B8A8_UNORM, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR },
+      { VK_FORMAT_R8G8B8A8_SRGB,  VK_COLOR_SPACE_SRGB_NONLINEAR_KHR },
+    }};
+
+    return writeArray(pSurfaceFormatCount, pSurfaceFormats,
+      s_formats.size(), s_formats.data());
+  }
+
+
+  static VKAPI_ATTR VkResult VKAPI_CALL nullGetPhysicalDeviceSurfacePresentModesKHR(
+          VkPhysicalDevice              physicalDevice,
+          VkSurfaceKHR                  surface,
+          uint32_t*                     pPresentModeCount,
+          VkPresentModeKHR*             pPresentModes) {
+    static const std::array<VkPresentModeKHR, 3> s_modes = {{
+      VK_PRESENT_MODE_IMMEDIATE_KHR,
+      VK_PRESENT_MODE_MAILBOX_KHR,
+      VK_PRESENT_MODE_FIFO_KHR,
+    }};
+
+    return writeArray(pPresentModeCount, pPresentModes,
+      s_modes.size(), s_modes.data());
+  }
+
+
+  /* Device functions */
+
+  static VKAPI_ATTR VkResult VKAPI_CALL nullCreateDevice(
+          VkPhysicalDevice              physicalDevice,
+    const VkDeviceCreateInfo*           pCreateInfo,
+    const VkAllocationCallbacks*        pAllocator,
+          VkDevice*                     pDevice) {
+    *pDevice = allocHandle<VkDevice>();
+    return VK_SUCCESS;
+  }
+
+
+  static VKAPI_ATTR void VKAPI_CALL nullGetDeviceQueue(
+          VkDevice                      device,
+          uint32_t                      queueFamilyIndex,
+          uint32_t                      queueIndex,
+          VkQueue*                      pQueue) {
+    static const VkQueue s_queue = allocHandle<VkQueue>();
+    *pQueue = s_queue;
+  }
+
+
+  static VKAPI_ATTR VkResult VKAPI_CALL nullAllocateMemory(
+          VkDevice                      device,
+    const VkMemoryAllocateInfo*         pAllocateInfo,
+    const VkAllocationCallbacks*        pAllocator,
+          VkDeviceMemory*               pMemory) {
+    // Only back host-visible memory types with actual
+    // memory since device-local memory is never mapped
+    auto memory = new NullMemory();
+    memory->size = pAllocateInfo->allocationSize;
+
+    if (pAllocateInfo->memoryTypeIndex != 0)
+      memory->data.resize(pAllocateInfo->allocationSize);
+
+    *pMemory = toHandle<VkDeviceMemory>(memory);
+    return VK_SUCCESS;
+  }
+
+
+  static VKAPI_ATTR void VKAPI_CALL nullFreeMemory(
+          VkDevice                      device,
+          VkDeviceMemory                memory,
+    const VkAllocationCallbacks*        pAllocator) {
+    delete fromHandle<NullMemory>(memory);
+  }
+
+
+  static VKAPI_ATTR VkResult VKAPI_CALL nullMapMemory(
+          VkDevice                      device,
+          VkDeviceMemory                memory,
+          VkDeviceSize                  offset,
+          VkDeviceSize                  size,
+          VkMemoryMapFlags              flags,
+          void**                        ppData) {
+    auto object = fromHandle<NullMemory>(memory);
+
+    if (object->data.empty())
+      return VK_ERROR_MEMORY_MAP_FAILED;
+
+    *ppData = object->data.data() + offset;
+    return VK_SUCCESS;
+  }
+
+
+  static VKAPI_ATTR VkResult VKAPI_CALL nullCreateBuffer(
+          VkDevice                      device,
+    const VkBufferCreateInfo*           pCreateInfo,
+    const VkAllocationCallbacks*        pAllocator,
+          VkBuffer*                     pBuffer) {
+    auto buffer = new NullBuffer();
+    buffer->size = pCreateInfo->size;
+
+    *pBuffer = toHandle<VkBuffer>(buffer);
+    return VK_SUCCESS;
+  }
+
+
+  static VKAPI_ATTR void VKAPI_CALL nullDestroyBuffer(
+          VkDevice                      device,
+          VkBuffer                      buffer,
+    const VkAllocationCallbacks*        pAllocator) {
+    delete fromHandle<NullBuffer>(buffer);
+  }
+
+
+  static VKAPI_ATTR void VKAPI_CALL nullGetBufferMemoryRequirements(
+          VkDevice                      device,
+          VkBuffer                      buffer,
+          VkMemoryRequirements*         pMemoryRequirements) {
+    fillMemoryRequirements(pMemoryRequirements,
+      fromHandle<NullBuffer>(buffer)->size);
+  }
+
+
+  static VKAPI_ATTR void VKAPI_CALL nullGetBufferMemoryRequirements2(
+          VkDevice                                device,
+    const VkBufferMemoryRequirementsInfo2*        pInfo,
+          VkMemoryRequirements2*                  pMemoryRequirements) {
+    nullGetBufferMemoryRequirements(device, pInfo->buffer,
+      &pMemoryRequirements->memoryRequirements);
+  }
+
+
+  static VKAPI_ATTR VkResult VKAPI_CALL nullCreateImage(
+          VkDevice                      device,
+    const VkImageCreateInfo*            pCreateInfo,
+    const VkAllocationCallbacks*        pAllocator,
+          VkImage*                      pImage) {
+    auto image = new NullImage();
+    image->format       = pCreateInfo->format;
+    image->extent       = pCreateInfo->extent;
+    image->mipLevels    = pCreateInfo->mipLevels;
+    image->arrayLayers  = pCreateInfo->arrayLayers;
+
+    *pImage = toHandle<VkImage>(image);
+    return VK_SUCCESS;
+  }
+
+
+  static VKAPI_ATTR void VKAPI_CALL nullDestroyImage(
+          VkDevice                      device,
+          VkImage                       image,
+    const VkAllocationCallbacks*        pAllocator) {
+    delete fromHandle<NullImage>(image);
+  }
+
+
+  static VKAPI_ATTR void VKAPI_CALL nullGetImageMemoryRequirements(
+          VkDevice                      device,
+          VkImage                       image,
+          VkMemoryRequirements*         pMemoryRequirements) {
+    fillMemoryRequirements(pMemoryRequirements,
+      getImageSize(fromHandle<NullImage>(image)));
+  }
+
+
+  static VKAPI_ATTR void VKAPI_CALL nullGetImageMemoryRequirements2(
+          VkDevice                                device,
+    const VkImageMemoryRequirementsInfo2*         pInfo,
+          VkMemoryRequirements2*                  pMemoryRequirements) {
+    nullGetImageMemoryRequirements(device, pInfo->image,
+      &pMemoryRequirements->memoryRequirements);
+  }
+
+
+  static VKAPI_ATTR void VKAPI_CALL nullGetImageSparseMemoryRequirements(
+          VkDevice                      device,
+          VkImage                       image,
+          uint32_t*                     pSparseMemoryRequirementCount,
+          VkSparseImageMemoryRequirements* pSparseMemoryRequirements) {
+    *pSparseMemoryRequirementCount = 0;
+  }
+
+
+  static VKAPI_ATTR void VKAPI_CALL nullGetImageSubresourceLayout(
+          VkDevice                      device,
+          VkImage                       image,
+    const VkImageSubresource*           pSubresource,
+          VkSubresourceLayout*          pLayout) {
+    // Images are laid out mip by mip, with all
+    // array layers of a mip level stored together
+    auto object = fromHandle<NullImage>(image);
+
+    VkDeviceSize offset = 0;
+
+    for (uint32_t i = 0; i < pSubresource->mipLevel; i++)
+      offset += getImageMipSize(object, i) * object->arrayLayers;
+
+    uint32_t w = std::max(object->extent.width  >> pSubresource->mipLevel, 1u);
+    uint32_t h = std::max(object->extent.height >> pSubresource->mipLevel, 1u);
+
+    pLayout->rowPitch   = VkDeviceSize(16) * w;
+    pLayout->depthPitch = pLayout->rowPitch * h;
+    pLayout->size       = getImageMipSize(object, pSubresource->mipLevel);
+    pLayout->arrayPitch = pLayout->size;
+    pLayout->offset     = offset + pLayout->arrayPitch * pSubresource->arrayLayer;
+  }
+
+
+  static VKAPI_ATTR VkResult VKAPI_CALL nullCreateFence(
+          VkDevice                      device,
+    const VkFenceCreateInfo*            pCreateInfo,
+    const VkAllocationCallbacks*        pAllocator,
+          VkFence*                      pFence) {
+    auto fence = new NullFence();
+    fence->signaled = (pCreateInfo->flags & VK_FENCE_CREATE_SIGNALED_BIT) != 0;
+
+    *pFence = toHandle<VkFence>(fence);
+    return VK_SUCCESS;
+  }
+
+
+  static VKAPI_ATTR void VKAPI_CALL nullDestroyFence(
+          VkDevice                      device,
+          VkFence                       fence,
+    const VkAllocationCallbacks*        pAllocator) {
+    delete fromHandle<NullFence>(fence);
+  }
+
+
+  static VKAPI_ATTR VkResult VKAPI_CALL nullResetFences(
+          VkDevice                      device,
+          uint32_t                      fenceCount,
+    const VkFence*                      pFences) {
+    for (uint32_t i = 0; i < fenceCount; i++)
+      fromHandle<NullFence>(pFences[i])->signaled = false;
+    return VK_SUCCESS;
+  }
+
+
+  static VKAPI_ATTR VkResult VKAPI_CALL nullGetFenceStatus(
+          VkDevice                      device,
+          VkFence                       fence) {
+    return fromHandle<NullFence>(fence)->signaled
+      ? VK_SUCCESS : VK_NOT_READY;
+  }
+
+
+  static VKAPI_ATTR VkResult VKAPI_CALL nullWaitForFences(
+          VkDevice                      device,
+          uint32_t                      fenceCount,
+    const VkFence*                      pFences,
+          VkBool32                      waitAll,
+          uint64_t                      timeout) {
+    // Fences are signaled on submission, so a fence that is
+    // still unsignaled here will never be signaled at all.
+    uint32_t signaled = 0;
+
+    for (uint32_t i = 0; i < fenceCount; i++)
+      signaled += fromHandle<NullFence>(pFences[i])->signaled ? 1 : 0;
+
+    bool done = waitAll ? signaled == fenceCount : signaled != 0;
+    return done ? VK_SUCCESS : VK_TIMEOUT;
+  }
+
+
+  static VKAPI_ATTR VkResult VKAPI_CALL nullCreateEvent(
+          VkDevice                      device,
+    const VkEventCreateInfo*            pCreateInfo,
+    const VkAllocationCallbacks*        pAllocator,
+          VkEvent*                      pEvent) {
+    auto event = new NullEvent();
+    event->signaled = false;
+
+    *pEvent = toHandle<VkEvent>(event);
+    return VK_SUCCESS;
+  }
+
+
+  static VKAPI_ATTR void VKAPI_CALL nullDestroyEvent(
+          VkDevice                      device,
+          VkEvent                       event,
+    const VkAllocationCallbacks*        pAllocator) {
+    delete fromHandle<NullEvent>(event);
+  }
+
+
+  static VKAPI_ATTR VkResult VKAPI_CALL nullGetEventStatus(
+          VkDevice                      device,
+          VkEvent                       event) {
+    return fromHandle<NullEvent>(event)->signaled
+      ? VK_EVENT_SET : VK_EVENT_RESET;
+  }
+
+
+  static VKAPI_ATTR VkResult VKAPI_CALL nullSetEvent(
+          VkDevice                      device,
+          VkEvent                       event) {
+    fromHandle<NullEvent>(event)->signaled = true;
+    return VK_SUCCESS;
+  }
+
+
+  static VKAPI_ATTR VkResult VKAPI_CALL nullResetEvent(
+          VkDevice                      device,
+          VkEvent                       event) {
+    fromHandle<NullEvent>(event)->signaled = false;
+    return VK_SUCCESS;
+  }
+
+
+  static VKAPI_ATTR VkResult VKAPI_CALL nullCreateQueryPool(
+          VkDevice                      device,
+    const VkQueryPoolCreateInfo*        pCreateInfo,
+    const VkAllocationCallbacks*        pAllocator,
+          VkQueryPool*                  pQueryPool) {
+    auto queryPool = new NullQueryPool();
+    queryPool->type       = pCreateInfo->queryType;
+    queryPool->valueCount = 1;
+
+    if (pCreateInfo->queryType == VK_QUERY_TYPE_PIPELINE_STATISTICS)
+      queryPool->valueCount = bit::popcnt(pCreateInfo->pipelineStatistics);
+
+    if (pCreateInfo->queryType == VK_QUERY_TYPE_TRANSFORM_FEEDBACK_STREAM_EXT)
+      queryPool->valueCount = 2;
+
+    *pQueryPool = toHandle<VkQueryPool>(queryPool);
+    return VK_SUCCESS;
+  }
+
+
+  static VKAPI_ATTR void VKAPI_CALL nullDestroyQueryPool(
+          VkDevice                      device,
+          VkQueryPool                   queryPool,
+    const VkAllocationCallbacks*        pAllocator) {
+    delete fromHandle<NullQueryPool>(queryPool);
+  }
+
+
+  static VKAPI_ATTR VkResult VKAPI_CALL nullGetQueryPoolResults(
+          VkDevice                      device,
+          VkQueryPool                   queryPool,
+          uint32_t                      firstQuery,
+          uint32_t                      queryCount,
+          size_t                        dataSize,
+          void*                         pData,
+          VkDeviceSize                  stride,
+          VkQueryResultFlags            flags) {
+    // All queries are available immediately and
+    // report zero for all values they contain
+    auto object = fromHandle<NullQueryPool>(queryPool);
+
+    bool is64Bit = (flags & VK_QUERY_RESULT_64_BIT) != 0;
+    bool hasAvailability = (flags & VK_QUERY_RESULT_WITH_AVAILABILITY_BIT) != 0;
+
+    for (uint32_t i = 0; i < queryCount; i++) {
+      auto data = reinterpret_cast<char*>(pData) + stride * i;
+
+      if (is64Bit) {
+        auto values = reinterpret_cast<uint64_t*>(data);
+        std::memset(values, 0, sizeof(uint64_t) * object->valueCount);
+
+        if (hasAvailability)
+          values[object->valueCount] = 1;
+      } else {
+        auto values = reinterpret_cast<uint32_t*>(data);
+        std::memset(values, 0, sizeof(uint32_t) * object->valueCount);
+
+        if (hasAvailability)
+          values[object->valueCount] = 1;
+      }
+    }
+
+    return VK_SUCCESS;
+  }
+
+
+  static VKAPI_ATTR VkResult VKAPI_CALL nullGetPipelineCacheData(
+          VkDevice                      device,
+          VkPipelineCache               pipelineCache,
+          size_t*                       pDataSize,
+          void*                         pData) {
+    *pDataSize = 0;
+    return VK_SUCCESS;
+  }
+
+
+  static VKAPI_ATTR VkResult VKAPI_CALL nullCreateGraphicsPipelines(
+          VkDevice                      device,
+          VkPipelineCache               pipelineCache,
+          uint32_t                      createInfoCount,
+    const VkGraphicsPipelineCreateInfo* pCreateInfos,
+    const VkAllocationCallbacks*        pAllocator,
+          VkPipeline*                   pPipelines) {
+    for (uint32_t i = 0; i < createInfoCount; i++)
+      pPipelines[i] = allocHandle<VkPipeline>();
+    return VK_SUCCESS;
+  }
+
+
+  static VKAPI_ATTR VkResult VKAPI_CALL nullCreateComputePipelines(
+          VkDevice                      device,
+          VkPipelineCache               pipelineCache,
+          uint32_t                      createInfoCount,
+    const VkComputePipelineCreateInfo*  pCreateInfos,
+    const VkAllocationCallbacks*        pAllocator,
+          VkPipeline*                   pPipelines) {
+    for (uint32_t i = 0; i < createInfoCount; i++)
+      pPipelines[i] = allocHandle<VkPipeline>();
+    return VK_SUCCESS;
+  }
+
+
+  static VKAPI_ATTR VkResult VKAPI_CALL nullAllocateDescriptorSets(
+          VkDevice                      device,
+    const VkDescriptorSetAllocateInfo*  pAllocateInfo,
+          VkDescriptorSet*              pDescriptorSets) {
+    for (uint32_t i = 0; i < pAllocateInfo->descriptorSetCount; i++)
+      pDescriptorSets[i] = allocHandle<VkDescriptorSet>();
+    return VK_SUCCESS;
+  }
+
+
+  static VKAPI_ATTR void VKAPI_CALL nullGetRenderAreaGranularity(
+          VkDevice                      device,
+          VkRenderPass                  renderPass,
+          VkExtent2D*                   pGranularity) {
+    *pGranularity = VkExtent2D { 1, 1 };
+  }
+
+
+  static VKAPI_ATTR VkResult VKAPI_CALL nullCreateCommandPool(
+          VkDevice                      device,
+    const VkCommandPoolCreateInfo*      pCreateInfo,
+    const VkAllocationCallbacks*        pAllocator,
+          VkCommandPool*                pCommandPool) {
+    *pCommandPool = toHandle<VkCommandPool>(new NullCommandPool());
+    return VK_SUCCESS;
+  }
+
+
+  static VKAPI_ATTR void VKAPI_CALL nullDestroyCommandPool(
+          VkDevice                      device,
+          VkCommandPool                 commandPool,
+    const VkAllocationCallbacks*        pAllocator) {
+    auto pool = fromHandle<NullCommandPool>(commandPool);
+
+    if (pool == nullptr)
+      return;
+
+    for (auto cmdBuffer : pool->cmdBuffers)
+      delete cmdBuffer;
+
+    delete pool;
+  }
+
+
+  static VKAPI_ATTR VkResult VKAPI_CALL nullResetCommandPool(
+          VkDevice                      device,
+          VkCommandPool                 commandPool,
+          VkCommandPoolResetFlags       flags) {
+    auto pool = fromHandle<NullCommandPool>(commandPool);
+
+    for (auto cmdBuffer : pool->cmdBuffers)
+      cmdBuffer->events.clear();
+
+    return VK_SUCCESS;
+  }
+
+
+  static VKAPI_ATTR VkResult VKAPI_CALL nullAllocateCommandBuffers(
+          VkDevice                      device,
+    const VkCommandBufferAllocateInfo*  pAllocateInfo,
+          VkCommandBuffer*              pCommandBuffers) {
+    auto pool = fromHandle<NullCommandPool>(pAllocateInfo->commandPool);
+
+    for (uint32_t i = 0; i < pAllocateInfo->commandBufferCount; i++) {
+      auto cmdBuffer = new NullCommandBuffer();
+      pool->cmdBuffers.push_back(cmdBuffer);
+      pCommandBuffers[i] = toHandle<VkCommandBuffer>(cmdBuffer);
+    }
+
+    return VK_SUCCESS;
+  }
+
+
+  static VKAPI_ATTR void VKAPI_CALL nullFreeCommandBuffers(
+          VkDevice                      device,
+          VkCommandPool                 commandPool,
+          uint32_t                      commandBufferCount,
+    const VkCommandBuffer*              pCommandBuffers) {
+    auto pool = fromHandle<NullCommandPool>(commandPool);
+
+    for (uint32_t i = 0; i < commandBufferCount; i++) {
+      auto cmdBuffer = fromHandle<NullCommandBuffer>(pCommandBuffers[i]);
+
+      for (auto entry = pool->cmdBuffers.begin(); entry != pool->cmdBuffers.end(); entry++) {
+        if (*entry == cmdBuffer) {
+          pool->cmdBuffers.erase(entry);
+          break;
+        }
+      }
+
+      delete cmdBuffer;
+    }
+  }
+
+
+  static VKAPI_ATTR VkResult VKAPI_CALL nullBeginCommandBuffer(
+          VkCommandBuffer               commandBuffer,
+    const VkCommandBufferBeginInfo*     pBeginInfo) {
+    fromHandle<NullCommandBuffer>(commandBuffer)->events.clear();
+    return VK_SUCCESS;
+  }
+
+
+  static VKAPI_ATTR VkResult VKAPI_CALL nullResetCommandBuffer(
+          VkCommandBuffer               commandBuffer,
+          VkCommandBufferResetFlags     flags) {
+    fromHandle<NullCommandBuffer>(commandBuffer)->events.clear();
+    return VK_SUCCESS;
+  }
+
+
+  static VKAPI_ATTR void VKAPI_CALL nullCmdSetEvent(
+          VkCommandBuffer               commandBuffer,
+          VkEvent                       event,
+          VkPipelineStageFlags          stageMask) {
+    fromHandle<NullCommandBuffer>(commandBuffer)->events.push_back(
+      { fromHandle<NullEvent>(event), true });
+  }
+
+
+  static VKAPI_ATTR void VKAPI_CALL nullCmdResetEvent(
+          VkCommandBuffer               commandBuffer,
+          VkEvent                       event,
+          VkPipelineStageFlags          stageMask) {
+    fromHandle<NullCommandBuffer>(commandBuffer)->events.push_back(
+      { fromHandle<NullEvent>(event), false });
+  }
+
+
+  static VKAPI_ATTR VkResult VKAPI_CALL nullQueueSubmit(
+          VkQueue                       queue,
+          uint32_t                      submitCount,
+    const VkSubmitInfo*                 pSubmits,
+          VkFence                       fence) {
+    // Command buffers complete immediately, so we only
+    // need to apply the event operations they contain
+    for (uint32_t i = 0; i < submitCount; i++) {
+      for (uint32_t j = 0; j < pSubmits[i].commandBufferCount; j++) {
+        auto cmdBuffer = fromHandle<NullCommandBuffer>(pSubmits[i].pCommandBuffers[j]);
+
+        for (const auto& event : cmdBuffer->events)
+          event.first->signaled = event.second;
+      }
+    }
+
+    if (fence != VK_NULL_HANDLE)
+      fromHandle<NullFence>(fence)->signaled = true;
+
+    return VK_SUCCESS;
+  }
+
+
+  static VKAPI_ATTR VkResult VKAPI_CALL nullCreateSwapchainKHR(
+          VkDevice                        device,
+    const VkSwapchainCreateInfoKHR*       pCreateInfo,
+    const VkAllocationCallbacks*          pAllocator,
+          VkSwapchainKHR*                 pSwapchain) {
+    auto swapchain = new NullSwapchain();
+
+    for (uint32_t i = 0; i < pCreateInfo->minImageCount; i++) {
+      auto image = new NullImage();
+      image->format       = pCreateInfo->imageFormat;
+      image->extent       = VkExtent3D {
+        pCreateInfo->imageExtent.width,
+        pCreateInfo->imageExtent.height, 1 };
+      image->mipLevels    = 1;
+      image->arrayLayers  = pCreateInfo->imageArrayLayers;
+      swapchain->images.push_back(image);
+    }
+
+    *pSwapchain = toHandle<VkSwapchainKHR>(swapchain);
+    return VK_SUCCESS;
+  }
+
+
+  static VKAPI_ATTR void VKAPI_CALL nullDestroySwapchainKHR(
+          VkDevice                        device,
+          VkSwapchainKHR                  swapchain,
+    const VkAllocationCallbacks*          pAllocator) {
+    auto object = fromHandle<NullSwapchain>(swapchain);
+
+    if (object == nullptr)
+      return;
+
+    for (auto image : object->images)
+      delete image;
+
+    delete object;
+  }
+
+
+  static VKAPI_ATTR VkResult VKAPI_CALL nullGetSwapchainImagesKHR(
+          VkDevice                        device,
+          VkSwapchainKHR                  swapchain,
+          uint32_t*                       pSwapchainImageCount,
+          VkImage*                        pSwapchainImages) {
+    auto object = fromHandle<NullSwapchain>(swapchain);
+
+    std::vector<VkImage> images;
+
+    for (auto image : object->images)
+      images.push_back(toHandle<VkImage>(image));
+
+    return writeArray(pSwapchainImageCount, pSwapchainImages,
+      images.size(), images.data());
+  }
+
+
+  static VKAPI_ATTR VkResult VKAPI_CALL nullAcquireNextImageKHR(
+          VkDevice                        device,
+          VkSwapchainKHR                  swapchain,
+          uint64_t                        timeout,
+          VkSemaphore                     semaphore,
+          VkFence                         fence,
+          uint32_t*                       pImageIndex) {
+    auto object = fromHandle<NullSwapchain>(swapchain);
+
+    *pImageIndex = object->nextImage;
+    object->nextImage = (object->nextImage + 1) % object->images.size();
+
+    if (fence != VK_NULL_HANDLE)
+      fromHandle<NullFence>(fence)->signaled = true;
+
+    return VK_SUCCESS;
+  }
+
+
+  /**
+   * \brief Generic function implementation
+   *
+   * Used for functions that do not need to do anything,
+   * such as command recording functions or functions that
+   * destroy objects represented by plain handles. Returns
+   * \c VK_SUCCESS for functions that return a result.
+   */
+  template<typename Fn>
+  struct NullFn;
+
+  template<typename Ret, typename... Args>
+  struct NullFn<Ret (VKAPI_PTR*)(Args...)> {
+    static VKAPI_ATTR Ret VKAPI_CALL call(Args...) {
+      return Ret();
+    }
+  };
+
+
+  /**
+   * \brief Generic object creation function
+   *
+   * Used for \c vkCreate* functions that do not need
+   * to store any object data. Writes a new handle.
+   */
+  template<typename Fn>
+  struct NullCreateFn;
+
+  template<typename Device, typename Info, typename Handle>
+  struct NullCreateFn<VkResult (VKAPI_PTR*)(Device, const Info*, const VkAllocationCallbacks*, Handle*)> {
+    static VKAPI_ATTR VkResult VKAPI_CALL call(Device, const Info*, const VkAllocationCallbacks*, Handle* pHandle) {
+      *pHandle = allocHandle<Handle>();
+      return VK_SUCCESS;
+    }
+  };
+
+
+  struct NullProc {
+    const char*         name;
+    PFN_vkVoidFunction  proc;
+  };
+
+  #define NULL_FN(name, fn) \
+    NullProc { "vk" #name, reinterpret_cast<PFN_vkVoidFunction>(&fn) }
+
+  #define NULL_FN_IMPL(name) \
+    NULL_FN(name, null ## name)
+
+  #define NULL_FN_ALIAS(name, impl) \
+    NULL_FN(name, null ## impl)
+
+  #define NULL_FN_NOOP(name) \
+    NULL_FN(name, NullFn<PFN_vk ## name>::call)
+
+  #define NULL_FN_CREATE(name) \
+    NULL_FN(name, NullCreateFn<PFN_vk ## name>::call)
+
+  static VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL nullGetInstanceProcAddr(
+          VkInstance                    instance,
+    const char*                         pName) {
+    return getNullDriverProcAddr(pName);
+  }
+
+
+  static VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL nullGetDeviceProcAddr(
+          VkDevice                      device,
+    const char*                         pName) {
+    return getNullDriverProcAddr(pName);
+  }
+
+
+  static const NullProc g_nullProcs[] = {
+    NULL_FN_IMPL  (GetInstanceProcAddr),
+    NULL_FN_IMPL  (GetDeviceProcAddr),
+    NULL_FN_IMPL  (CreateInstance),
+    NULL_FN_NOOP  (DestroyInstance),
+    NULL_FN_IMPL  (EnumerateInstanceLayerProperties),
+    NULL_FN_IMPL  (EnumerateInstanceExtensionProperties),
+    NULL_FN_IMPL  (EnumeratePhysicalDevices),
+    NULL_FN_IMPL  (EnumerateDeviceExtensionProperties),
+    NULL_FN_IMPL  (GetPhysicalDeviceFeatures),
+    NULL_FN_ALIAS (GetPhysicalDeviceFeatures2KHR, GetPhysicalDeviceFeatures2),
+    NULL_FN_IMPL  (GetPhysicalDeviceProperties),
+    NULL_FN_ALIAS (GetPhysicalDeviceProperties2KHR, GetPhysicalDeviceProperties2),
+    NULL_FN_IMPL  (GetPhysicalDeviceFormatProperties),
+    NULL_FN_ALIAS (GetPhysicalDeviceFormatProperties2KHR, GetPhysicalDeviceFormatProperties2),
+    NULL_FN_IMPL  (GetPhysicalDeviceImageFormatProperties),
+    NULL_FN_ALIAS (GetPhysicalDeviceImageFormatProperties2KHR, GetPhysicalDeviceImageFormatProperties2),
+    NULL_FN_IMPL  (GetPhysicalDeviceMemoryProperties),
+    NULL_FN_ALIAS (GetPhysicalDeviceMemoryProperties2KHR, GetPhysicalDeviceMemoryProperties2),
+    NULL_FN_IMPL  (GetPhysicalDeviceQueueFamilyProperties),
+    NULL_FN_ALIAS (GetPhysicalDeviceQueueFamilyProperties2KHR, GetPhysicalDeviceQueueFamilyProperties2),
+    NULL_FN_IMPL  (GetPhysicalDeviceSparseImageFormatProperties),
+    NULL_FN_ALIAS (GetPhysicalDeviceSparseImageFormatProperties2KHR, GetPhysicalDeviceSparseImageFormatProperties2),
+    NULL_FN_IMPL  (CreateWin32SurfaceKHR),
+    NULL_FN_IMPL  (GetPhysicalDeviceWin32PresentationSupportKHR),
+    NULL_FN_NOOP  (DestroySurfaceKHR),
+    NULL_FN_IMPL  (GetPhysicalDeviceSurfaceSupportKHR),
+    NULL_FN_IMPL  (GetPhysicalDeviceSurfaceCapabilitiesKHR),
+    NULL_FN_IMPL  (GetPhysicalDeviceSurfaceFormatsKHR),
+    NULL_FN_IMPL  (GetPhysicalDeviceSurfacePresentModesKHR),
+    NULL_FN_CREATE(CreateDebugReportCallbackEXT),
+    NULL_FN_NOOP  (DestroyDebugReportCallbackEXT),
+    NULL_FN_NOOP  (DebugReportMessageEXT),
+
+    NULL_FN_IMPL  (CreateDevice),
+    NULL_FN_NOOP  (DestroyDevice),
+    NULL_FN_IMPL  (GetDeviceQueue),
+    NULL_FN_IMPL  (QueueSubmit),
+    NULL_FN_NOOP  (QueueWaitIdle),
+    NULL_FN_NOOP  (DeviceWaitIdle),
+    NULL_FN_IMPL  (AllocateMemory),
+    NULL_FN_IMPL  (FreeMemory),
+    NULL_FN_IMPL  (MapMemory),
+    NULL_FN_NOOP  (UnmapMemory),
+    NULL_FN_NOOP  (FlushMappedMemoryRanges),
+    NULL_FN_NOOP  (InvalidateMappedMemoryRanges),
+    NULL_FN_NOOP  (GetDeviceMemoryCommitment),
+    NULL_FN_NOOP  (BindBufferMemory),
+    NULL_FN_NOOP  (BindImageMemory),
+    NULL_FN_IMPL  (GetBufferMemoryRequirements),
+    NULL_FN_IMPL  (GetImageMemoryRequirements),
+    NULL_FN_ALIAS (GetBufferMemoryRequirements2KHR, GetBufferMemoryRequirements2),
+    NULL_FN_ALIAS (GetImageMemoryRequirements2KHR, GetImageMemoryRequirements2),
+    NULL_FN_IMPL  (GetImageSparseMemoryRequirements),
+    NULL_FN_NOOP  (QueueBindSparse),
+    NULL_FN_IMPL  (CreateFence),
+    NULL_FN_IMPL  (DestroyFence),
+    NULL_FN_IMPL  (ResetFences),
+    NULL_FN_IMPL  (GetFenceStatus),
+    NULL_FN_IMPL  (WaitForFences),
+    NULL_FN_CREATE(CreateSemaphore),
+    NULL_FN_NOOP  (DestroySemaphore),
+    NULL_FN_IMPL  (CreateEvent),
+    NULL_FN_IMPL  (DestroyEvent),
+    NULL_FN_IMPL  (GetEventStatus),
+    NULL_FN_IMPL  (SetEvent),
+    NULL_FN_IMPL  (ResetEvent),
+    NULL_FN_IMPL  (CreateQueryPool),
+    NULL_FN_IMPL  (DestroyQueryPool),
+    NULL_FN_IMPL  (GetQueryPoolResults),
+    NULL_FN_NOOP  (ResetQueryPoolEXT),
+    NULL_FN_IMPL  (CreateBuffer),
+    NULL_FN_IMPL  (DestroyBuffer),
+    NULL_FN_CREATE(CreateBufferView),
+    NULL_FN_NOOP  (DestroyBufferView),
+    NULL_FN_IMPL  (CreateImage),
+    NULL_FN_IMPL  (DestroyImage),
+    NULL_FN_IMPL  (GetImageSubresourceLayout),
+    NULL_FN_CREATE(CreateImageView),
+    NULL_FN_NOOP  (DestroyImageView),
+    NULL_FN_CREATE(CreateShaderModule),
+    NULL_FN_NOOP  (DestroyShaderModule),
+    NULL_FN_CREATE(CreatePipelineCache),
+    NULL_FN_NOOP  (DestroyPipelineCache),
+    NULL_FN_IMPL  (GetPipelineCacheData),
+    NULL_FN_NOOP  (MergePipelineCaches),
+    NULL_FN_IMPL  (CreateGraphicsPipelines),
+    NULL_FN_IMPL  (CreateComputePipelines),
+    NULL_FN_NOOP  (DestroyPipeline),
+    NULL_FN_CREATE(CreatePipelineLayout),
+    NULL_FN_NOOP  (DestroyPipelineLayout),
+    NULL_FN_CREATE(CreateSampler),
+    NULL_FN_NOOP  (DestroySampler),
+    NULL_FN_CREATE(CreateDescriptorSetLayout),
+    NULL_FN_NOOP  (DestroyDescriptorSetLayout),
+    NULL_FN_CREATE(CreateDescriptorPool),
+    NULL_FN_NOOP  (DestroyDescriptorPool),
+    NULL_FN_NOOP  (ResetDescriptorPool),
+    NULL_FN_IMPL  (AllocateDescriptorSets),
+    NULL_FN_NOOP  (FreeDescriptorSets),
+    NULL_FN_NOOP  (UpdateDescriptorSets),
+    NULL_FN_CREATE(CreateDescriptorUpdateTemplateKHR),
+    NULL_FN_NOOP  (DestroyDescriptorUpdateTemplateKHR),
+    NULL_FN_NOOP  (UpdateDescriptorSetWithTemplateKHR),
+    NULL_FN_CREATE(CreateFramebuffer),
+    NULL_FN_NOOP  (DestroyFramebuffer),
+    NULL_FN_CREATE(CreateRenderPass),
+    NULL_FN_NOOP  (DestroyRenderPass),
+    NULL_FN_IMPL  (GetRenderAreaGranularity),
+    NULL_FN_IMPL  (CreateCommandPool),
+    NULL_FN_IMPL  (DestroyCommandPool),
+    NULL_FN_IMPL  (ResetCommandPool),
+    NULL_FN_IMPL  (AllocateCommandBuffers),
+    NULL_FN_IMPL  (FreeCommandBuffers),
+    NULL_FN_IMPL  (BeginCommandBuffer),
+    NULL_FN_NOOP  (EndCommandBuffer),
+    NULL_FN_IMPL  (ResetCommandBuffer),
+    NULL_FN_IMPL  (CmdSetEvent),
+    NULL_FN_IMPL  (CmdResetEvent),
+    NULL_FN_NOOP  (CmdBindPipeline),
+    NULL_FN_NOOP  (CmdSetViewport),
+    NULL_FN_NOOP  (CmdSetScissor),
+    NULL_FN_NOOP  (CmdSetLineWidth),
+    NULL_FN_NOOP  (CmdSetDepthBias),
+    NULL_FN_NOOP  (CmdSetBlendConstants),
+    NULL_FN_NOOP  (CmdSetDepthBounds),
+    NULL_FN_NOOP  (CmdSetStencilCompareMask),
+    NULL_FN_NOOP  (CmdSetStencilWriteMask),
+    NULL_FN_NOOP  (CmdSetStencilReference),
+    NULL_FN_NOOP  (CmdBindDescriptorSets),
+    NULL_FN_NOOP  (CmdBindIndexBuffer),
+    NULL_FN_NOOP  (CmdBindVertexBuffers),
+    NULL_FN_NOOP  (CmdDraw),
+    NULL_FN_NOOP  (CmdDrawIndexed),
+    NULL_FN_NOOP  (CmdDrawIndirect),
+    NULL_FN_NOOP  (CmdDrawIndexedIndirect),
+    NULL_FN_NOOP  (CmdDispatch),
+    NULL_FN_NOOP  (CmdDispatchIndirect),
+    NULL_FN_NOOP  (CmdCopyBuffer),
+    NULL_FN_NOOP  (CmdCopyImage),
+    NULL_FN_NOOP  (CmdBlitImage),
+    NULL_FN_NOOP  (CmdCopyBufferToImage),
+    NULL_FN_NOOP  (CmdCopyImageToBuffer),
+    NULL_FN_NOOP  (CmdUpdateBuffer),
+    NULL_FN_NOOP  (CmdFillBuffer),
+    NULL_FN_NOOP  (CmdClearColorImage),
+    NULL_FN_NOOP  (CmdClearDepthStencilImage),
+    NULL_FN_NOOP  (CmdClearAttachments),
+    NULL_FN_NOOP  (CmdResolveImage),
+    NULL_FN_NOOP  (CmdWaitEvents),
+    NULL_FN_NOOP  (CmdPipelineBarrier),
+    NULL_FN_NOOP  (CmdBeginQuery),
+    NULL_FN_NOOP  (CmdEndQuery),
+    NULL_FN_NOOP  (CmdResetQueryPool),
+    NULL_FN_NOOP  (CmdWriteTimestamp),
+    NULL_FN_NOOP  (CmdCopyQueryPoolResults),
+    NULL_FN_NOOP  (CmdPushConstants),
+    NULL_FN_NOOP  (CmdBeginRenderPass),
+    NULL_FN_NOOP  (CmdNextSubpass),
+    NULL_FN_NOOP  (CmdEndRenderPass),
+    NULL_FN_NOOP  (CmdExecuteCommands),
+    NULL_FN_NOOP  (CmdPushDescriptorSetWithTemplateKHR),
+    NULL_FN_NOOP  (CmdBindTransformFeedbackBuffersEXT),
+    NULL_FN_NOOP  (CmdBeginTransformFeedbackEXT),
+    NULL_FN_NOOP  (CmdEndTransformFeedbackEXT),
+    NULL_FN_NOOP  (CmdDrawIndirectByteCountEXT),
+    NULL_FN_NOOP  (CmdBeginQueryIndexedEXT),
+    NULL_FN_NOOP  (CmdEndQueryIndexedEXT),
+    NULL_FN_IMPL  (CreateSwapchainKHR),
+    NULL_FN_IMPL  (DestroySwapchainKHR),
+    NULL_FN_IMPL  (GetSwapchainImagesKHR),
+    NULL_FN_IMPL  (AcquireNextImageKHR),
+    NULL_FN_NOOP  (QueuePresentKHR),
+  };
+
+
+  bool isNullDriverEnabled() {
+    static bool s_enabled = env::getEnvVar("DXVK_NULL_DRIVER") == "1";
+    return s_enabled;
+  }
+
+
+  PFN_vkVoidFunction getNullDriverProcAddr(const char* name) {
+    for (const auto& proc : g_nullProcs) {
+      if (!std::strcmp(proc.name, name))
+        return proc.proc;
+    }
+
+    return nullptr;
+  }
+
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "vulkan_loader_fn.h"
+
+namespace dxvk::vk {
+
+  /**
+   * \brief Checks whether the null driver is enabled
+   *
+   * The null driver is enabled by setting the environment
+   * variable \c DXVK_NULL_DRIVER to \c 1. In that case, all
+   * Vulkan functions are resolved to a built-in implementation
+   * that does not require a GPU or Vulkan driver, which allows
+   * measuring the CPU overhead of DXVK itself.
+   * \returns \c true if the null driver is enabled
+   */
+  bool isNullDriverEnabled();
+
+  /**
+   * \brief Retrieves null driver function
+   *
+   * The returned functions create fake handles, treat all
+   * command buffer functions as no-ops, and signal fences
+   * and events as soon as work is submitted. The reported
+   * physical device can be configured via environment
+   * variables, see \c README.md for details.
+   * \param [in] name Function name
+   * \returns Function pointer, or \c nullptr if the
+   *    function is not implemented by the null driver.
+   */
+  PFN_vkVoidFunction getNullDriverProcAddr(const char* name);
+
+}
@@ -0,0 +1,170 @@
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <d3d11_1.h>
+
+#include <windows.h>
+#include <windowsx.h>
+
+#include "../test_utils.h"
+
+using namespace dxvk;
+
+// Both images are cleared with ClearView while they are not
+// bound, so that their rectangles end up in the same compute
+// dispatch. Some rectangles are partly or entirely outside
+// of the image and must be clipped to the image bounds.
+constexpr uint32_t ImageSize = 16;
+
+struct ClearTarget {
+  Com<ID3D11Texture2D>        image;
+  Com<ID3D11Texture2D>        readback;
+  Com<ID3D11RenderTargetView> view;
+  std::array<FLOAT, 4>        color;
+  std::vector<D3D11_RECT>     rects;
+};
+
+bool isInRect(const D3D11_RECT& rect, uint32_t x, uint32_t y) {
+  return int32_t(x) >= rect.left && int32_t(x) < rect.right
+      && int32_t(y) >= rect.top  && int32_t(y) < rect.bottom;
+}
+
+int WINAPI WinMain(HINSTANCE hInstance,
+                   HINSTANCE hPrevInstance,
+                   LPSTR lpCmdLine,
+                   int nCmdShow) {
+  Com<ID3D11Device>         device;
+  Com<ID3D11DeviceContext>  context;
+  Com<ID3D11DeviceContext1> context1;
+
+  D3D_FEATURE_LEVEL featureLevel = D3D_FEATURE_LEVEL_11_1;
+
+  if (FAILED(D3D11CreateDevice(
+        nullptr, D3D_DRIVER_TYPE_HARDWARE,
+        nullptr, 0, &featureLevel, 1, D3D11_SDK_VERSION,
+        &device, nullptr, &context))) {
+    std::cerr << "Failed to create D3D11 device" << std::endl;
+    return 1;
+  }
+
+  if (FAILED(context->QueryInterface(__uuidof(ID3D11DeviceContext1),
+      reinterpret_cast<void**>(&context1)))) {
+    std::cerr << "Failed to query ID3D11DeviceContext1" << std::endl;
+    return 1;
+  }
+
+  std::array<ClearTarget, 2> targets;
+
+  targets[0].color = {{ 1.0f, 0.0f, 0.0f, 1.0f }};
+  targets[0].rects = {
+    {  -4,  -4,     4,     4 },   // Top left corner, negative offset
+    {  12,  10, 70000, 70000 },   // Bottom right corner, huge extent
+    {  20,  20,    30,    30 },   // Entirely outside the image
+  };
+
+  targets[1].color = {{ 0.0f, 1.0f, 0.0f, 1.0f }};
+  targets[1].rects = {
+    { -100,  2,     3,     5 },   // Left edge, large negative offset
+    {    6, -9,     9, 65540 },   // Full column, crosses 16-bit range
+  };
+
+  D3D11_TEXTURE2D_DESC imageDesc;
+  imageDesc.Width          = ImageSize;
+  imageDesc.Height         = ImageSize;
+  imageDesc.MipLevels      = 1;
+  imageDesc.ArraySize      = 1;
+  imageDesc.Format         = DXGI_FORMAT_R8G8B8A8_UNORM;
+  imageDesc.SampleDesc     = { 1, 0 };
+  imageDesc.CPUAccessFlags = 0;
+  imageDesc.MiscFlags      = 0;
+
+  for (auto& target : targets) {
+    imageDesc.Usage          = D3D11_USAGE_DEFAULT;
+    imageDesc.BindFlags      = D3D11_BIND_RENDER_TARGET;
+    imageDesc.CPUAccessFlags = 0;
+
+    if (FAILED(device->CreateTexture2D(&imageDesc, nullptr, &target.image))) {
+      std::cerr << "Failed to create render target" << std::endl;
+      return 1;
+    }
+
+    imageDesc.Usage          = D3D11_USAGE_STAGING;
+    imageDesc.BindFlags      = 0;
+    imageDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+
+    if (FAILED(device->CreateTexture2D(&imageDesc, nullptr, &target.readback))) {
+      std::cerr << "Failed to create readback image" << std::endl;
+      return 1;
+    }
+
+    if (FAILED(device->CreateRenderTargetView(target.image.ptr(), nullptr, &target.view))) {
+      std::cerr << "Failed to create render target view" << std::endl;
+      return 1;
+    }
+  }
+
+  FLOAT clearColor[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+  for (const auto& target : targets)
+    context->ClearRenderTargetView(target.view.ptr(), clearColor);
+
+  for (const auto& target : targets) {
+    context1->ClearView(target.view.ptr(), target.color.data(),
+      target.rects.data(), target.rects.size());
+  }
+
+  for (const auto& target : targets)
+    context->CopyResource(target.readback.ptr(), target.image.ptr());
+
+  uint32_t errorCount = 0;
+
+  for (uint32_t i = 0; i < targets.size(); i++) {
+    const ClearTarget& target = targets[i];
+
+    D3D11_MAPPED_SUBRESOURCE mappedResource;
+    if (FAILED(context->Map(target.readback.ptr(), 0, D3D11_MAP_READ, 0, &mappedResource))) {
+      std::cerr << "Failed to map readback image" << std::endl;
+      return 1;
+    }
+
+    auto pixels = reinterpret_cast<const uint8_t*>(mappedResource.pData);
+
+    for (uint32_t y = 0; y < ImageSize; y++) {
+      for (uint32_t x = 0; x < ImageSize; x++) {
+        const uint8_t* pixel = &pixels[y * mappedResource.RowPitch + 4 * x];
+
+        bool isCleared = false;
+
+        for (const auto& rect : target.rects)
+          isCleared |= isInRect(rect, x, y);
+
+        for (uint32_t c = 0; c < 4; c++) {
+          int32_t expected = isCleared
+            ? int32_t(target.color[c] * 255.0f) : 0;
+
+          if (std::abs(int32_t(pixel[c]) - expected) > 1) {
+            std::cerr << "Image " << i << ", pixel " << x << "," << y
+                      << ", component " << c
+                      << ": expected " << expected
+                      << ", got " << uint32_t(pixel[c]) << std::endl;
+            errorCount += 1;
+          }
+        }
+      }
+    }
+
+    context->Unmap(target.readback.ptr(), 0);
+  }
+
+  context->ClearState();
+
+  if (errorCount) {
+    std::cerr << "Clear view: " << errorCount << " errors" << std::endl;
+    return 1;
+  }
+
+  std::cout << "Clear view: all pixels match" << std::endl;
+  return 0;
+}
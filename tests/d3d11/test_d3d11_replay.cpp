@@ -0,0 +1,1067 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <cwchar>
+#include <fstream>
+#include <unordered_map>
+#include <vector>
+
+#include <d3d11_1.h>
+
+#include <windows.h>
+#include <windowsx.h>
+#include <tlhelp32.h>
+
+#include "../../src/d3d11/d3d11_capture.h"
+
+#include "../test_utils.h"
+
+using namespace dxvk;
+
+class CaptureReader {
+
+public:
+
+  CaptureReader(const std::vector<char>& Data)
+  : m_data(Data) { }
+
+  template<typename T>
+  T Read() {
+    T value;
+    ReadRaw(&value, sizeof(value));
+    return value;
+  }
+
+  template<typename T>
+  std::vector<T> ReadArray() {
+    std::vector<T> result(Read<uint32_t>());
+
+    for (auto& value : result)
+      value = Read<T>();
+
+    return result;
+  }
+
+  std::vector<char> ReadBlob() {
+    std::vector<char> result(Read<uint64_t>());
+    ReadRaw(result.data(), result.size());
+    return result;
+  }
+
+  std::string ReadString() {
+    std::string result(Read<uint32_t>(), '\0');
+    ReadRaw(&result[0], result.size());
+    return result;
+  }
+
+  bool ReadOptional() {
+    return Read<uint32_t>() != 0;
+  }
+
+private:
+
+  const std::vector<char>& m_data;
+  size_t                   m_offset = 0;
+
+  void ReadRaw(void* pData, size_t Size) {
+    if (m_offset + Size > m_data.size())
+      throw DxvkError("Capture record truncated");
+
+    std::memcpy(pData, m_data.data() + m_offset, Size);
+    m_offset += Size;
+  }
+
+};
+
+
+class CaptureReplay {
+
+public:
+
+  CaptureReplay(
+    const Com<ID3D11Device1>&         Device,
+    const Com<ID3D11DeviceContext1>&  Context)
+  : m_device(Device), m_context(Context) {
+    D3D11_QUERY_DESC queryDesc = { D3D11_QUERY_EVENT, 0 };
+    m_device->CreateQuery(&queryDesc, &m_eventQuery);
+
+    // The CS thread names itself once it starts running,
+    // so make sure it has executed something before we
+    // look for it. If it cannot be found, we report the
+    // CPU time of all threads other than this one.
+    WaitForIdle();
+    m_csThread = FindThread(L"dxvk-cs");
+
+    if (m_csThread == nullptr)
+      std::cerr << "CS thread not found, reporting CPU time of all worker threads" << std::endl;
+
+    BeginFrame();
+  }
+
+  ~CaptureReplay() {
+    if (m_csThread != nullptr)
+      CloseHandle(m_csThread);
+  }
+
+  void Execute(D3D11CaptureOp Op, const std::vector<char>& Payload) {
+    CaptureReader reader(Payload);
+
+    switch (Op) {
+      case D3D11CaptureOp::CreateBuffer: {
+        uint32_t id = reader.Read<uint32_t>();
+        auto desc = reader.Read<D3D11_BUFFER_DESC>();
+        auto data = reader.ReadBlob();
+
+        D3D11_SUBRESOURCE_DATA initialData = { data.data(), 0, 0 };
+
+        Com<ID3D11Buffer> buffer;
+        m_device->CreateBuffer(&desc, data.size() ? &initialData : nullptr, &buffer);
+        SetObject(id, buffer.ptr());
+      } break;
+
+      case D3D11CaptureOp::CreateTexture1D: {
+        uint32_t id = reader.Read<uint32_t>();
+        auto desc = reader.Read<D3D11_TEXTURE1D_DESC>();
+        std::vector<std::vector<char>> storage;
+        auto data = ReadInitialData(reader, storage);
+
+        Com<ID3D11Texture1D> texture;
+        m_device->CreateTexture1D(&desc, data.size() ? data.data() : nullptr, &texture);
+        SetObject(id, texture.ptr());
+      } break;
+
+      case D3D11CaptureOp::CreateTexture2D: {
+        uint32_t id = reader.Read<uint32_t>();
+        auto desc = reader.Read<D3D11_TEXTURE2D_DESC>();
+        std::vector<std::vector<char>> storage;
+        auto data = ReadInitialData(reader, storage);
+
+        Com<ID3D11Texture2D> texture;
+        m_device->CreateTexture2D(&desc, data.size() ? data.data() : nullptr, &texture);
+        SetObject(id, texture.ptr());
+      } break;
+
+      case D3D11CaptureOp::CreateTexture3D: {
+        uint32_t id = reader.Read<uint32_t>();
+        auto desc = reader.Read<D3D11_TEXTURE3D_DESC>();
+        std::vector<std::vector<char>> storage;
+        auto data = ReadInitialData(reader, storage);
+
+        Com<ID3D11Texture3D> texture;
+        m_device->CreateTexture3D(&desc, data.size() ? data.data() : nullptr, &texture);
+        SetObject(id, texture.ptr());
+      } break;
+
+      case D3D11CaptureOp::CreateShaderResourceView: {
+        uint32_t id = reader.Read<uint32_t>();
+        auto resource = GetObject<ID3D11Resource>(reader);
+        auto desc = reader.Read<D3D11_SHADER_RESOURCE_VIEW_DESC>();
+
+        Com<ID3D11ShaderResourceView> view;
+        m_device->CreateShaderResourceView(resource, &desc, &view);
+        SetObject(id, view.ptr());
+      } break;
+
+      case D3D11CaptureOp::CreateUnorderedAccessView: {
+        uint32_t id = reader.Read<uint32_t>();
+        auto resource = GetObject<ID3D11Resource>(reader);
+        auto desc = reader.Read<D3D11_UNORDERED_ACCESS_VIEW_DESC>();
+
+        Com<ID3D11UnorderedAccessView> view;
+        m_device->CreateUnorderedAccessView(resource, &desc, &view);
+        SetObject(id, view.ptr());
+      } break;
+
+      case D3D11CaptureOp::CreateRenderTargetView: {
+        uint32_t id = reader.Read<uint32_t>();
+        auto resource = GetObject<ID3D11Resource>(reader);
+        auto desc = reader.Read<D3D11_RENDER_TARGET_VIEW_DESC>();
+
+        Com<ID3D11RenderTargetView> view;
+        m_device->CreateRenderTargetView(resource, &desc, &view);
+        SetObject(id, view.ptr());
+      } break;
+
+      case D3D11CaptureOp::CreateDepthStencilView: {
+        uint32_t id = reader.Read<uint32_t>();
+        auto resource = GetObject<ID3D11Resource>(reader);
+        auto desc = reader.Read<D3D11_DEPTH_STENCIL_VIEW_DESC>();
+
+        Com<ID3D11DepthStencilView> view;
+        m_device->CreateDepthStencilView(resource, &desc, &view);
+        SetObject(id, view.ptr());
+      } break;
+
+      case D3D11CaptureOp::CreateInputLayout: {
+        uint32_t id = reader.Read<uint32_t>();
+
+        std::vector<std::string>              names(reader.Read<uint32_t>());
+        std::vector<D3D11_INPUT_ELEMENT_DESC> elements(names.size());
+
+        for (size_t i = 0; i < elements.size(); i++) {
+          names[i] = reader.ReadString();
+          elements[i].SemanticIndex        = reader.Read<UINT>();
+          elements[i].Format               = reader.Read<DXGI_FORMAT>();
+          elements[i].InputSlot            = reader.Read<UINT>();
+          elements[i].AlignedByteOffset    = reader.Read<UINT>();
+          elements[i].InputSlotClass       = reader.Read<D3D11_INPUT_CLASSIFICATION>();
+          elements[i].InstanceDataStepRate = reader.Read<UINT>();
+        }
+
+        for (size_t i = 0; i < elements.size(); i++)
+          elements[i].SemanticName = names[i].c_str();
+
+        auto bytecode = reader.ReadBlob();
+
+        Com<ID3D11InputLayout> layout;
+        m_device->CreateInputLayout(elements.data(), elements.size(),
+          bytecode.data(), bytecode.size(), &layout);
+        SetObject(id, layout.ptr());
+      } break;
+
+      case D3D11CaptureOp::CreateVertexShader:
+        CreateShader<ID3D11VertexShader>(reader, &ID3D11Device1::CreateVertexShader);
+        break;
+
+      case D3D11CaptureOp::CreateHullShader:
+        CreateShader<ID3D11HullShader>(reader, &ID3D11Device1::CreateHullShader);
+        break;
+
+      case D3D11CaptureOp::CreateDomainShader:
+        CreateShader<ID3D11DomainShader>(reader, &ID3D11Device1::CreateDomainShader);
+        break;
+
+      case D3D11CaptureOp::CreateGeometryShader:
+        CreateShader<ID3D11GeometryShader>(reader, &ID3D11Device1::CreateGeometryShader);
+        break;
+
+      case D3D11CaptureOp::CreatePixelShader:
+        CreateShader<ID3D11PixelShader>(reader, &ID3D11Device1::CreatePixelShader);
+        break;
+
+      case D3D11CaptureOp::CreateComputeShader:
+        CreateShader<ID3D11ComputeShader>(reader, &ID3D11Device1::CreateComputeShader);
+        break;
+
+      case D3D11CaptureOp::CreateGeometryShaderWithStreamOutput: {
+        uint32_t id = reader.Read<uint32_t>();
+        auto bytecode = reader.ReadBlob();
+
+        std::vector<std::string>                names(reader.Read<uint32_t>());
+        std::vector<D3D11_SO_DECLARATION_ENTRY> entries(names.size());
+
+        for (size_t i = 0; i < entries.size(); i++) {
+          entries[i].Stream         = reader.Read<UINT>();
+          names[i]                  = reader.ReadString();
+          entries[i].SemanticIndex  = reader.Read<UINT>();
+          entries[i].StartComponent = reader.Read<BYTE>();
+          entries[i].ComponentCount = reader.Read<BYTE>();
+          entries[i].OutputSlot     = reader.Read<BYTE>();
+        }
+
+        for (size_t i = 0; i < entries.size(); i++)
+          entries[i].SemanticName = names[i].size() ? names[i].c_str() : nullptr;
+
+        auto strides = reader.ReadArray<UINT>();
+        auto rasterizedStream = reader.Read<UINT>();
+
+        Com<ID3D11GeometryShader> shader;
+        m_device->CreateGeometryShaderWithStreamOutput(
+          bytecode.data(), bytecode.size(),
+          entries.data(), entries.size(),
+          strides.data(), strides.size(),
+          rasterizedStream, nullptr, &shader);
+        SetObject(id, shader.ptr());
+      } break;
+
+      case D3D11CaptureOp::CreateBlendState1: {
+        uint32_t id = reader.Read<uint32_t>();
+        auto desc = reader.Read<D3D11_BLEND_DESC1>();
+
+        Com<ID3D11BlendState1> state;
+        m_device->CreateBlendState1(&desc, &state);
+        SetObject(id, state.ptr());
+      } break;
+
+      case D3D11CaptureOp::CreateDepthStencilState: {
+        uint32_t id = reader.Read<uint32_t>();
+        auto desc = reader.Read<D3D11_DEPTH_STENCIL_DESC>();
+
+        Com<ID3D11DepthStencilState> state;
+        m_device->CreateDepthStencilState(&desc, &state);
+        SetObject(id, state.ptr());
+      } break;
+
+      case D3D11CaptureOp::CreateRasterizerState1: {
+        uint32_t id = reader.Read<uint32_t>();
+        auto desc = reader.Read<D3D11_RASTERIZER_DESC1>();
+
+        Com<ID3D11RasterizerState1> state;
+        m_device->CreateRasterizerState1(&desc, &state);
+        SetObject(id, state.ptr());
+      } break;
+
+      case D3D11CaptureOp::CreateSamplerState: {
+        uint32_t id = reader.Read<uint32_t>();
+        auto desc = reader.Read<D3D11_SAMPLER_DESC>();
+
+        Com<ID3D11SamplerState> state;
+        m_device->CreateSamplerState(&desc, &state);
+        SetObject(id, state.ptr());
+      } break;
+
+      case D3D11CaptureOp::CreateQuery: {
+        uint32_t id = reader.Read<uint32_t>();
+        auto desc = reader.Read<D3D11_QUERY_DESC>();
+
+        Com<ID3D11Query> query;
+        m_device->CreateQuery(&desc, &query);
+        SetObject(id, query.ptr());
+      } break;
+
+      case D3D11CaptureOp::CreatePredicate: {
+        uint32_t id = reader.Read<uint32_t>();
+        auto desc = reader.Read<D3D11_QUERY_DESC>();
+
+        Com<ID3D11Predicate> predicate;
+        m_device->CreatePredicate(&desc, &predicate);
+        SetObject(id, predicate.ptr());
+      } break;
+
+      case D3D11CaptureOp::ClearState:
+        m_context->ClearState();
+        break;
+
+      case D3D11CaptureOp::Begin:
+        m_context->Begin(GetObject<ID3D11Asynchronous>(reader));
+        break;
+
+      case D3D11CaptureOp::End:
+        m_context->End(GetObject<ID3D11Asynchronous>(reader));
+        break;
+
+      case D3D11CaptureOp::SetPredication: {
+        auto predicate = GetObject<ID3D11Predicate>(reader);
+        auto value = reader.Read<BOOL>();
+        m_context->SetPredication(predicate, value);
+      } break;
+
+      case D3D11CaptureOp::CopySubresourceRegion1: {
+        auto dstResource    = GetObject<ID3D11Resource>(reader);
+        auto dstSubresource = reader.Read<UINT>();
+        auto dstX           = reader.Read<UINT>();
+        auto dstY           = reader.Read<UINT>();
+        auto dstZ           = reader.Read<UINT>();
+        auto srcResource    = GetObject<ID3D11Resource>(reader);
+        auto srcSubresource = reader.Read<UINT>();
+
+        D3D11_BOX box;
+        bool hasBox = reader.ReadOptional();
+
+        if (hasBox)
+          box = reader.Read<D3D11_BOX>();
+
+        auto copyFlags = reader.Read<UINT>();
+
+        m_context->CopySubresourceRegion1(
+          dstResource, dstSubresource, dstX, dstY, dstZ,
+          srcResource, srcSubresource, hasBox ? &box : nullptr,
+          copyFlags);
+      } break;
+
+      case D3D11CaptureOp::CopyResource: {
+        auto dstResource = GetObject<ID3D11Resource>(reader);
+        auto srcResource = GetObject<ID3D11Resource>(reader);
+        m_context->CopyResource(dstResource, srcResource);
+      } break;
+
+      case D3D11CaptureOp::CopyStructureCount: {
+        auto dstBuffer = GetObject<ID3D11Buffer>(reader);
+        auto dstOffset = reader.Read<UINT>();
+        auto srcView   = GetObject<ID3D11UnorderedAccessView>(reader);
+        m_context->CopyStructureCount(dstBuffer, dstOffset, srcView);
+      } break;
+
+      case D3D11CaptureOp::ClearRenderTargetView: {
+        auto view  = GetObject<ID3D11RenderTargetView>(reader);
+        auto color = reader.ReadArray<FLOAT>();
+        m_context->ClearRenderTargetView(view, color.data());
+      } break;
+
+      case D3D11CaptureOp::ClearUnorderedAccessViewUint: {
+        auto view   = GetObject<ID3D11UnorderedAccessView>(reader);
+        auto values = reader.ReadArray<UINT>();
+        m_context->ClearUnorderedAccessViewUint(view, values.data());
+      } break;
+
+      case D3D11CaptureOp::ClearUnorderedAccessViewFloat: {
+        auto view   = GetObject<ID3D11UnorderedAccessView>(reader);
+        auto values = reader.ReadArray<FLOAT>();
+        m_context->ClearUnorderedAccessViewFloat(view, values.data());
+      } break;
+
+      case D3D11CaptureOp::ClearDepthStencilView: {
+        auto view    = GetObject<ID3D11DepthStencilView>(reader);
+        auto flags   = reader.Read<UINT>();
+        auto depth   = reader.Read<FLOAT>();
+        auto stencil = reader.Read<UINT8>();
+        m_context->ClearDepthStencilView(view, flags, depth, stencil);
+      } break;
+
+      case D3D11CaptureOp::ClearView: {
+        auto view  = GetObject<ID3D11View>(reader);
+        auto color = reader.ReadArray<FLOAT>();
+        auto rects = reader.ReadArray<D3D11_RECT>();
+        m_context->ClearView(view, color.data(), rects.data(), rects.size());
+      } break;
+
+      case D3D11CaptureOp::GenerateMips:
+        m_context->GenerateMips(GetObject<ID3D11ShaderResourceView>(reader));
+        break;
+
+      case D3D11CaptureOp::UpdateSubresource1: {
+        auto dstResource    = GetObject<ID3D11Resource>(reader);
+        auto dstSubresource = reader.Read<UINT>();
+
+        D3D11_BOX box;
+        bool hasBox = reader.ReadOptional();
+
+        if (hasBox)
+          box = reader.Read<D3D11_BOX>();
+
+        auto rowPitch   = reader.Read<UINT>();
+        auto depthPitch = reader.Read<UINT>();
+        auto copyFlags  = reader.Read<UINT>();
+        auto data       = reader.ReadBlob();
+
+        m_context->UpdateSubresource1(dstResource, dstSubresource,
+          hasBox ? &box : nullptr, data.data(), rowPitch, depthPitch,
+          copyFlags);
+      } break;
+
+      case D3D11CaptureOp::ResolveSubresource: {
+        auto dstResource    = GetObject<ID3D11Resource>(reader);
+        auto dstSubresource = reader.Read<UINT>();
+        auto srcResource    = GetObject<ID3D11Resource>(reader);
+        auto srcSubresource = reader.Read<UINT>();
+        auto format         = reader.Read<DXGI_FORMAT>();
+
+        m_context->ResolveSubresource(
+          dstResource, dstSubresource,
+          srcResource, srcSubresource, format);
+      } break;
+
+      case D3D11CaptureOp::DrawAuto:
+        m_context->DrawAuto();
+        break;
+
+      case D3D11CaptureOp::Draw: {
+        auto vertexCount = reader.Read<UINT>();
+        auto firstVertex = reader.Read<UINT>();
+        m_context->Draw(vertexCount, firstVertex);
+      } break;
+
+      case D3D11CaptureOp::DrawIndexed: {
+        auto indexCount = reader.Read<UINT>();
+        auto firstIndex = reader.Read<UINT>();
+        auto baseVertex = reader.Read<INT>();
+        m_context->DrawIndexed(indexCount, firstIndex, baseVertex);
+      } break;
+
+      case D3D11CaptureOp::DrawInstanced: {
+        auto vertexCount   = reader.Read<UINT>();
+        auto instanceCount = reader.Read<UINT>();
+        auto firstVertex   = reader.Read<UINT>();
+        auto firstInstance = reader.Read<UINT>();
+        m_context->DrawInstanced(vertexCount, instanceCount, firstVertex, firstInstance);
+      } break;
+
+      case D3D11CaptureOp::DrawIndexedInstanced: {
+        auto indexCount    = reader.Read<UINT>();
+        auto instanceCount = reader.Read<UINT>();
+        auto firstIndex    = reader.Read<UINT>();
+        auto baseVertex    = reader.Read<INT>();
+        auto firstInstance = reader.Read<UINT>();
+        m_context->DrawIndexedInstanced(indexCount, instanceCount,
+          firstIndex, baseVertex, firstInstance);
+      } break;
+
+      case D3D11CaptureOp::DrawIndexedInstancedIndirect: {
+        auto buffer = GetObject<ID3D11Buffer>(reader);
+        auto offset = reader.Read<UINT>();
+        m_context->DrawIndexedInstancedIndirect(buffer, offset);
+      } break;
+
+      case D3D11CaptureOp::DrawInstancedIndirect: {
+        auto buffer = GetObject<ID3D11Buffer>(reader);
+        auto offset = reader.Read<UINT>();
+        m_context->DrawInstancedIndirect(buffer, offset);
+      } break;
+
+      case D3D11CaptureOp::Dispatch: {
+        auto x = reader.Read<UINT>();
+        auto y = reader.Read<UINT>();
+        auto z = reader.Read<UINT>();
+        m_context->Dispatch(x, y, z);
+      } break;
+
+      case D3D11CaptureOp::DispatchIndirect: {
+        auto buffer = GetObject<ID3D11Buffer>(reader);
+        auto offset = reader.Read<UINT>();
+        m_context->DispatchIndirect(buffer, offset);
+      } break;
+
+      case D3D11CaptureOp::IASetInputLayout:
+        m_context->IASetInputLayout(GetObject<ID3D11InputLayout>(reader));
+        break;
+
+      case D3D11CaptureOp::IASetPrimitiveTopology:
+        m_context->IASetPrimitiveTopology(reader.Read<D3D11_PRIMITIVE_TOPOLOGY>());
+        break;
+
+      case D3D11CaptureOp::IASetVertexBuffers: {
+        auto startSlot = reader.Read<UINT>();
+        auto count     = reader.Read<UINT>();
+        auto buffers   = GetObjectArray<ID3D11Buffer>(reader);
+        auto strides   = reader.ReadArray<UINT>();
+        auto offsets   = reader.ReadArray<UINT>();
+
+        m_context->IASetVertexBuffers(startSlot, count,
+          GetArrayPtr(buffers), GetArrayPtr(strides), GetArrayPtr(offsets));
+      } break;
+
+      case D3D11CaptureOp::IASetIndexBuffer: {
+        auto buffer = GetObject<ID3D11Buffer>(reader);
+        auto format = reader.Read<DXGI_FORMAT>();
+        auto offset = reader.Read<UINT>();
+        m_context->IASetIndexBuffer(buffer, format, offset);
+      } break;
+
+      case D3D11CaptureOp::SetShader: {
+        auto stage = reader.Read<uint32_t>();
+        auto shader = GetObject<ID3D11DeviceChild>(reader);
+
+        switch (stage) {
+          case 0: m_context->PSSetShader(static_cast<ID3D11PixelShader*>   (shader), nullptr, 0); break;
+          case 1: m_context->VSSetShader(static_cast<ID3D11VertexShader*>  (shader), nullptr, 0); break;
+          case 2: m_context->GSSetShader(static_cast<ID3D11GeometryShader*>(shader), nullptr, 0); break;
+          case 3: m_context->HSSetShader(static_cast<ID3D11HullShader*>    (shader), nullptr, 0); break;
+          case 4: m_context->DSSetShader(static_cast<ID3D11DomainShader*>  (shader), nullptr, 0); break;
+          case 5: m_context->CSSetShader(static_cast<ID3D11ComputeShader*> (shader), nullptr, 0); break;
+        }
+      } break;
+
+      case D3D11CaptureOp::SetConstantBuffers: {
+        auto stage     = reader.Read<uint32_t>();
+        auto startSlot = reader.Read<UINT>();
+        auto count     = reader.Read<UINT>();
+        auto buffers   = GetObjectArray<ID3D11Buffer>(reader);
+        auto first     = reader.ReadArray<UINT>();
+        auto num       = reader.ReadArray<UINT>();
+
+        auto pBuffers = GetArrayPtr(buffers);
+        auto pFirst   = GetArrayPtr(first);
+        auto pNum     = GetArrayPtr(num);
+
+        switch (stage) {
+          case 0: m_context->PSSetConstantBuffers1(startSlot, count, pBuffers, pFirst, pNum); break;
+          case 1: m_context->VSSetConstantBuffers1(startSlot, count, pBuffers, pFirst, pNum); break;
+          case 2: m_context->GSSetConstantBuffers1(startSlot, count, pBuffers, pFirst, pNum); break;
+          case 3: m_context->HSSetConstantBuffers1(startSlot, count, pBuffers, pFirst, pNum); break;
+          case 4: m_context->DSSetConstantBuffers1(startSlot, count, pBuffers, pFirst, pNum); break;
+          case 5: m_context->CSSetConstantBuffers1(startSlot, count, pBuffers, pFirst, pNum); break;
+        }
+      } break;
+
+      case D3D11CaptureOp::SetShaderResources: {
+        auto stage     = reader.Read<uint32_t>();
+        auto startSlot = reader.Read<UINT>();
+        auto count     = reader.Read<UINT>();
+        auto views     = GetObjectArray<ID3D11ShaderResourceView>(reader);
+        auto pViews    = GetArrayPtr(views);
+
+        switch (stage) {
+          case 0: m_context->PSSetShaderResources(startSlot, count, pViews); break;
+          case 1: m_context->VSSetShaderResources(startSlot, count, pViews); break;
+          case 2: m_context->GSSetShaderResources(startSlot, count, pViews); break;
+          case 3: m_context->HSSetShaderResources(startSlot, count, pViews); break;
+          case 4: m_context->DSSetShaderResources(startSlot, count, pViews); break;
+          case 5: m_context->CSSetShaderResources(startSlot, count, pViews); break;
+        }
+      } break;
+
+      case D3D11CaptureOp::SetSamplers: {
+        auto stage     = reader.Read<uint32_t>();
+        auto startSlot = reader.Read<UINT>();
+        auto count     = reader.Read<UINT>();
+        auto samplers  = GetObjectArray<ID3D11SamplerState>(reader);
+        auto pSamplers = GetArrayPtr(samplers);
+
+        switch (stage) {
+          case 0: m_context->PSSetSamplers(startSlot, count, pSamplers); break;
+          case 1: m_context->VSSetSamplers(startSlot, count, pSamplers); break;
+          case 2: m_context->GSSetSamplers(startSlot, count, pSamplers); break;
+          case 3: m_context->HSSetSamplers(startSlot, count, pSamplers); break;
+          case 4: m_context->DSSetSamplers(startSlot, count, pSamplers); break;
+          case 5: m_context->CSSetSamplers(startSlot, count, pSamplers); break;
+        }
+      } break;
+
+      case D3D11CaptureOp::CSSetUnorderedAccessViews: {
+        auto startSlot = reader.Read<UINT>();
+        auto count     = reader.Read<UINT>();
+        auto views     = GetObjectArray<ID3D11UnorderedAccessView>(reader);
+        auto counters  = reader.ReadArray<UINT>();
+
+        m_context->CSSetUnorderedAccessViews(startSlot, count,
+          GetArrayPtr(views), GetArrayPtr(counters));
+      } break;
+
+      case D3D11CaptureOp::OMSetRenderTargets: {
+        auto count = reader.Read<UINT>();
+        auto rtvs  = GetObjectArray<ID3D11RenderTargetView>(reader);
+        auto dsv   = GetObject<ID3D11DepthStencilView>(reader);
+
+        m_context->OMSetRenderTargets(count, GetArrayPtr(rtvs), dsv);
+      } break;
+
+      case D3D11CaptureOp::OMSetRenderTargetsAndUnorderedAccessViews: {
+        auto rtvCount  = reader.Read<UINT>();
+        auto rtvs      = GetObjectArray<ID3D11RenderTargetView>(reader);
+        auto dsv       = GetObject<ID3D11DepthStencilView>(reader);
+        auto uavStart  = reader.Read<UINT>();
+        auto uavCount  = reader.Read<UINT>();
+        auto uavs      = GetObjectArray<ID3D11UnorderedAccessView>(reader);
+        auto counters  = reader.ReadArray<UINT>();
+
+        m_context->OMSetRenderTargetsAndUnorderedAccessViews(
+          rtvCount, GetArrayPtr(rtvs), dsv, uavStart, uavCount,
+          GetArrayPtr(uavs), GetArrayPtr(counters));
+      } break;
+
+      case D3D11CaptureOp::OMSetBlendState: {
+        auto state       = GetObject<ID3D11BlendState>(reader);
+        auto blendFactor = reader.ReadArray<FLOAT>();
+        auto sampleMask  = reader.Read<UINT>();
+
+        m_context->OMSetBlendState(state, GetArrayPtr(blendFactor), sampleMask);
+      } break;
+
+      case D3D11CaptureOp::OMSetDepthStencilState: {
+        auto state      = GetObject<ID3D11DepthStencilState>(reader);
+        auto stencilRef = reader.Read<UINT>();
+        m_context->OMSetDepthStencilState(state, stencilRef);
+      } break;
+
+      case D3D11CaptureOp::RSSetState:
+        m_context->RSSetState(GetObject<ID3D11RasterizerState>(reader));
+        break;
+
+      case D3D11CaptureOp::RSSetViewports: {
+        auto count     = reader.Read<UINT>();
+        auto viewports = reader.ReadArray<D3D11_VIEWPORT>();
+        m_context->RSSetViewports(count, GetArrayPtr(viewports));
+      } break;
+
+      case D3D11CaptureOp::RSSetScissorRects: {
+        auto count = reader.Read<UINT>();
+        auto rects = reader.ReadArray<D3D11_RECT>();
+        m_context->RSSetScissorRects(count, GetArrayPtr(rects));
+      } break;
+
+      case D3D11CaptureOp::SOSetTargets: {
+        auto count   = reader.Read<UINT>();
+        auto buffers = GetObjectArray<ID3D11Buffer>(reader);
+        auto offsets = reader.ReadArray<UINT>();
+        m_context->SOSetTargets(count, GetArrayPtr(buffers), GetArrayPtr(offsets));
+      } break;
+
+      case D3D11CaptureOp::DiscardResource:
+        m_context->DiscardResource(GetObject<ID3D11Resource>(reader));
+        break;
+
+      case D3D11CaptureOp::DiscardView:
+        m_context->DiscardView(GetObject<ID3D11View>(reader));
+        break;
+
+      case D3D11CaptureOp::Map: {
+        uint32_t id = reader.Read<uint32_t>();
+        auto subresource = reader.Read<UINT>();
+        auto mapType     = reader.Read<D3D11_MAP>();
+        auto mapFlags    = reader.Read<UINT>();
+
+        auto resource = static_cast<ID3D11Resource*>(GetObject(id));
+
+        // Always wait for the resource to become available
+        // since the trace only contains successful maps
+        D3D11_MAPPED_SUBRESOURCE sr;
+
+        if (SUCCEEDED(m_context->Map(resource, subresource, mapType,
+            mapFlags & ~D3D11_MAP_FLAG_DO_NOT_WAIT, &sr)))
+          m_mappedRegions[GetMapKey(id, subresource)] = sr;
+      } break;
+
+      case D3D11CaptureOp::Unmap: {
+        uint32_t id = reader.Read<uint32_t>();
+        auto subresource = reader.Read<UINT>();
+        auto rowPitch    = reader.Read<UINT>();
+        auto depthPitch  = reader.Read<UINT>();
+        auto offset      = reader.Read<uint64_t>();
+        auto data        = reader.ReadBlob();
+
+        auto resource = static_cast<ID3D11Resource*>(GetObject(id));
+        auto entry = m_mappedRegions.find(GetMapKey(id, subresource));
+
+        if (entry != m_mappedRegions.end()) {
+          WriteMappedData(entry->second, rowPitch, depthPitch, offset, data);
+          m_mappedRegions.erase(entry);
+        }
+
+        m_context->Unmap(resource, subresource);
+      } break;
+
+      case D3D11CaptureOp::Flush:
+        m_context->Flush();
+        break;
+
+      case D3D11CaptureOp::ExecuteCommandList: {
+        // Command lists are not part of the trace, but we
+        // need to reset the state the same way the app did
+        if (!reader.Read<BOOL>())
+          m_context->ClearState();
+      } break;
+
+      case D3D11CaptureOp::Present:
+        EndFrame();
+        break;
+
+      default:
+        std::cerr << "Unknown opcode " << uint32_t(Op) << std::endl;
+    }
+  }
+
+  void PrintSummary() const {
+    if (m_frameTimes.empty())
+      return;
+
+    std::cout << "Frames:     " << m_frameTimes.size() << std::endl;
+    PrintTimes("Frame time: ", &FrameTime::frameTime);
+    PrintTimes("App CPU:    ", &FrameTime::appTime);
+    PrintTimes("CS CPU:     ", &FrameTime::csTime);
+  }
+
+private:
+
+  struct FrameTime {
+    double frameTime;
+    double appTime;
+    double csTime;
+  };
+
+  Com<ID3D11Device1>        m_device;
+  Com<ID3D11DeviceContext1> m_context;
+  Com<ID3D11Query>          m_eventQuery;
+
+  std::vector<Com<ID3D11DeviceChild>> m_objects;
+  std::unordered_map<uint64_t, D3D11_MAPPED_SUBRESOURCE> m_mappedRegions;
+
+  HANDLE m_csThread = nullptr;
+
+  std::chrono::high_resolution_clock::time_point m_frameStart;
+  uint64_t m_appCpuStart = 0;
+  uint64_t m_csCpuStart  = 0;
+
+  std::vector<FrameTime> m_frameTimes;
+
+  void SetObject(uint32_t Id, ID3D11DeviceChild* pObject) {
+    if (Id >= m_objects.size())
+      m_objects.resize(Id + 1);
+
+    m_objects[Id] = pObject;
+  }
+
+  ID3D11DeviceChild* GetObject(uint32_t Id) const {
+    return Id < m_objects.size() ? m_objects[Id].ptr() : nullptr;
+  }
+
+  template<typename T>
+  T* GetObject(CaptureReader& Reader) const {
+    return static_cast<T*>(GetObject(Reader.Read<uint32_t>()));
+  }
+
+  template<typename T>
+  std::vector<T*> GetObjectArray(CaptureReader& Reader) const {
+    std::vector<T*> result(Reader.Read<uint32_t>());
+
+    for (auto& object : result)
+      object = GetObject<T>(Reader);
+
+    return result;
+  }
+
+  template<typename T>
+  static T* GetArrayPtr(std::vector<T>& Array) {
+    return Array.size() ? Array.data() : nullptr;
+  }
+
+  static uint64_t GetMapKey(uint32_t Id, UINT Subresource) {
+    return uint64_t(Id) | (uint64_t(Subresource) << 32);
+  }
+
+  template<typename T, typename Fn>
+  void CreateShader(CaptureReader& Reader, Fn Create) {
+    uint32_t id = Reader.Read<uint32_t>();
+    auto bytecode = Reader.ReadBlob();
+
+    Com<T> shader;
+    (m_device.ptr()->*Create)(bytecode.data(), bytecode.size(), nullptr, &shader);
+    SetObject(id, shader.ptr());
+  }
+
+  static std::vector<D3D11_SUBRESOURCE_DATA> ReadInitialData(
+          CaptureReader&                  Reader,
+          std::vector<std::vector<char>>& Storage) {
+    std::vector<D3D11_SUBRESOURCE_DATA> result(Reader.Read<uint32_t>());
+    Storage.resize(result.size());
+
+    for (size_t i = 0; i < result.size(); i++) {
+      result[i].SysMemPitch      = Reader.Read<uint32_t>();
+      result[i].SysMemSlicePitch = Reader.Read<uint32_t>();
+
+      Storage[i] = Reader.ReadBlob();
+      result[i].pSysMem = Storage[i].data();
+    }
+
+    return result;
+  }
+
+  void WriteMappedData(
+    const D3D11_MAPPED_SUBRESOURCE& Mapped,
+          UINT                      RowPitch,
+          UINT                      DepthPitch,
+          uint64_t                  Offset,
+    const std::vector<char>&        Data) {
+    auto dst = reinterpret_cast<char*>(Mapped.pData);
+
+    if (Data.empty() || dst == nullptr)
+      return;
+
+    if (RowPitch == Mapped.RowPitch && DepthPitch == Mapped.DepthPitch) {
+      std::memcpy(dst + Offset, Data.data(), Data.size());
+      return;
+    }
+
+    // Texture layouts may differ between the driver the
+    // trace was captured on and the one used for replay
+    UINT rowSize = std::min(RowPitch, Mapped.RowPitch);
+    UINT rowCount = RowPitch ? DepthPitch / RowPitch : 0;
+    UINT layerCount = DepthPitch ? UINT(Data.size() / DepthPitch) : 0;
+
+    for (UINT z = 0; z < layerCount; z++) {
+      for (UINT y = 0; y < rowCount; y++) {
+        std::memcpy(
+          dst + z * Mapped.DepthPitch + y * Mapped.RowPitch,
+          Data.data() + z * DepthPitch + y * RowPitch,
+          rowSize);
+      }
+    }
+  }
+
+  void PrintTimes(const char* pName, double FrameTime::*pTime) const {
+    double sum = 0.0, min = 1.0e9, max = 0.0;
+
+    for (const auto& frame : m_frameTimes) {
+      sum += frame.*pTime;
+      min  = std::min(min, frame.*pTime);
+      max  = std::max(max, frame.*pTime);
+    }
+
+    std::cout << pName << "avg " << (sum / double(m_frameTimes.size()))
+              << " ms, min " << min << " ms, max " << max << " ms" << std::endl;
+  }
+
+  static HANDLE FindThread(const wchar_t* pName) {
+    using GetThreadDescriptionProc = HRESULT (WINAPI *) (HANDLE, PWSTR*);
+
+    auto proc = reinterpret_cast<GetThreadDescriptionProc>(::GetProcAddress(
+      ::GetModuleHandleW(L"kernel32.dll"), "GetThreadDescription"));
+
+    if (proc == nullptr)
+      return nullptr;
+
+    HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPTHREAD, 0);
+
+    if (snapshot == INVALID_HANDLE_VALUE)
+      return nullptr;
+
+    HANDLE result = nullptr;
+
+    THREADENTRY32 entry;
+    entry.dwSize = sizeof(entry);
+
+    for (BOOL valid = Thread32First(snapshot, &entry); valid && !result; valid = Thread32Next(snapshot, &entry)) {
+      if (entry.th32OwnerProcessID != GetCurrentProcessId())
+        continue;
+
+      HANDLE thread = OpenThread(THREAD_QUERY_LIMITED_INFORMATION, FALSE, entry.th32ThreadID);
+
+      if (thread == nullptr)
+        continue;
+
+      PWSTR description = nullptr;
+
+      if (SUCCEEDED(proc(thread, &description)) && description != nullptr) {
+        if (!std::wcscmp(description, pName))
+          result = thread;
+
+        LocalFree(description);
+      }
+
+      if (result != thread)
+        CloseHandle(thread);
+    }
+
+    CloseHandle(snapshot);
+    return result;
+  }
+
+  static uint64_t GetCpuTime(const FILETIME& Kernel, const FILETIME& User) {
+    auto toU64 = [] (const FILETIME& Time) {
+      return uint64_t(Time.dwLowDateTime) | (uint64_t(Time.dwHighDateTime) << 32);
+    };
+
+    return toU64(Kernel) + toU64(User);
+  }
+
+  static uint64_t GetThreadCpuTime(HANDLE Thread) {
+    FILETIME creation, exit, kernel, user;
+
+    if (!GetThreadTimes(Thread, &creation, &exit, &kernel, &user))
+      return 0;
+
+    return GetCpuTime(kernel, user);
+  }
+
+  uint64_t GetCsCpuTime() const {
+    if (m_csThread != nullptr)
+      return GetThreadCpuTime(m_csThread);
+
+    // Query the app thread first, since process
+    // times include the times of all threads
+    uint64_t appTime = GetThreadCpuTime(GetCurrentThread());
+
+    FILETIME creation, exit, kernel, user;
+
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+      return 0;
+
+    uint64_t processTime = GetCpuTime(kernel, user);
+    return processTime > appTime ? processTime - appTime : 0;
+  }
+
+  static double GetDeltaMs(uint64_t Start, uint64_t End) {
+    // CPU times are given in 100ns units
+    return End > Start ? double(End - Start) / 10000.0 : 0.0;
+  }
+
+  void WaitForIdle() {
+    m_context->End(m_eventQuery.ptr());
+    m_context->Flush();
+
+    while (m_context->GetData(m_eventQuery.ptr(), nullptr, 0, 0) == S_FALSE)
+      continue;
+  }
+
+  void BeginFrame() {
+    m_frameStart  = std::chrono::high_resolution_clock::now();
+    m_appCpuStart = GetThreadCpuTime(GetCurrentThread());
+    m_csCpuStart  = GetCsCpuTime();
+  }
+
+  void EndFrame() {
+    uint64_t appCpuEnd = GetThreadCpuTime(GetCurrentThread());
+
+    // Wait for the CS thread to finish the frame so that
+    // its CPU time can be attributed to this frame. This
+    // also keeps the app thread from running ahead.
+    WaitForIdle();
+
+    auto frameEnd = std::chrono::high_resolution_clock::now();
+
+    FrameTime frame;
+    frame.frameTime = std::chrono::duration<double, std::milli>(frameEnd - m_frameStart).count();
+    frame.appTime   = GetDeltaMs(m_appCpuStart, appCpuEnd);
+    frame.csTime    = GetDeltaMs(m_csCpuStart, GetCsCpuTime());
+    m_frameTimes.push_back(frame);
+
+    std::cout << "Frame " << m_frameTimes.size()
+              << ": " << frame.frameTime << " ms"
+              << ", app CPU " << frame.appTime << " ms"
+              << ", CS CPU " << frame.csTime << " ms" << std::endl;
+
+    BeginFrame();
+  }
+
+};
+
+
+int WINAPI WinMain(HINSTANCE hInstance,
+                   HINSTANCE hPrevInstance,
+                   LPSTR lpCmdLine,
+                   int nCmdShow) {
+  std::string path = lpCmdLine;
+
+  if (path.empty()) {
+    std::cerr << "Usage: d3d11-replay <file.dxvk-trace>" << std::endl;
+    return 1;
+  }
+
+  std::ifstream file(path, std::ios_base::binary);
+
+  D3D11CaptureHeader header;
+  D3D11CaptureHeader expected;
+
+  if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))
+   || std::memcmp(header.magic, expected.magic, sizeof(header.magic))
+   || header.version != expected.version) {
+    std::cerr << "Invalid capture file: " << path << std::endl;
+    return 1;
+  }
+
+  Com<ID3D11Device>         device;
+  Com<ID3D11DeviceContext>  context;
+  Com<ID3D11Device1>        device1;
+  Com<ID3D11DeviceContext1> context1;
+
+  if (FAILED(D3D11CreateDevice(
+        nullptr, D3D_DRIVER_TYPE_HARDWARE,
+        nullptr, 0, nullptr, 0, D3D11_SDK_VERSION,
+        &device, nullptr, &context))
+   || FAILED(device->QueryInterface(__uuidof(ID3D11Device1), reinterpret_cast<void**>(&device1)))
+   || FAILED(context->QueryInterface(__uuidof(ID3D11DeviceContext1), reinterpret_cast<void**>(&context1)))) {
+    std::cerr << "Failed to create D3D11 device" << std::endl;
+    return 1;
+  }
+
+  CaptureReplay replay(device1, context1);
+
+  D3D11CaptureRecordHeader record;
+  std::vector<char> payload;
+
+  try {
+    while (file.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+      payload.resize(record.size);
+
+      if (!file.read(payload.data(), payload.size()))
+        break;
+
+      replay.Execute(record.op, payload);
+    }
+  } catch (const DxvkError& e) {
+    std::cerr << e.message() << std::endl;
+    return 1;
+  }
+
+  replay.PrintSummary();
+  return 0;
+}
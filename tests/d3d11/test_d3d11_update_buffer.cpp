@@ -0,0 +1,244 @@
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <d3dcompiler.h>
+#include <d3d11.h>
+
+#include <windows.h>
+#include <windowsx.h>
+
+#include "../test_utils.h"
+
+using namespace dxvk;
+
+const std::string g_vsCode =
+  "float4 main(uint id : SV_VERTEXID) : SV_POSITION {\n"
+  "  float2 coord = float2((id << 1) & 2, id & 2);\n"
+  "  return float4(coord * 2.0f - 1.0f, 0.0f, 1.0f);\n"
+  "}\n";
+
+const std::string g_psCode =
+  "cbuffer cb : register(b0) {\n"
+  "  float4 cb_color;\n"
+  "};\n"
+  "Buffer<float4> srv_color : register(t0);\n"
+  "float4 main() : SV_TARGET {\n"
+  "  return cb_color + srv_color[0];\n"
+  "}\n";
+
+struct Color {
+  float r, g, b, a;
+};
+
+// Each column of the render target is drawn with a different
+// set of buffer contents. The constant buffer is small enough
+// for updates to be moved out of the render pass, whereas the
+// texel buffer updates have to interrupt the render pass.
+constexpr uint32_t ColumnCount      = 8;
+constexpr uint32_t ColumnWidth      = 2;
+constexpr uint32_t ConstantSize     = 256;
+constexpr uint32_t TexelBufferSize  = 128 * 1024;
+
+Color getConstantColor(uint32_t column) {
+  return { float(20 * column) / 255.0f, 0.0f, 0.0f, 1.0f };
+}
+
+Color getTexelColor(uint32_t column) {
+  return { 0.0f, float(30 * column) / 255.0f, 0.0f, 0.0f };
+}
+
+int WINAPI WinMain(HINSTANCE hInstance,
+                   HINSTANCE hPrevInstance,
+                   LPSTR lpCmdLine,
+                   int nCmdShow) {
+  Com<ID3D11Device>             device;
+  Com<ID3D11DeviceContext>      context;
+  Com<ID3D11VertexShader>       vertexShader;
+  Com<ID3D11PixelShader>        pixelShader;
+  Com<ID3D11Buffer>             constantBuffer;
+  Com<ID3D11Buffer>             texelBuffer;
+  Com<ID3D11ShaderResourceView> texelView;
+  Com<ID3D11Texture2D>          renderTarget;
+  Com<ID3D11Texture2D>          readTarget;
+  Com<ID3D11RenderTargetView>   renderTargetView;
+
+  if (FAILED(D3D11CreateDevice(
+        nullptr, D3D_DRIVER_TYPE_HARDWARE,
+        nullptr, 0, nullptr, 0, D3D11_SDK_VERSION,
+        &device, nullptr, &context))) {
+    std::cerr << "Failed to create D3D11 device" << std::endl;
+    return 1;
+  }
+
+  Com<ID3DBlob> vsBlob;
+  Com<ID3DBlob> psBlob;
+
+  if (FAILED(D3DCompile(g_vsCode.data(), g_vsCode.size(),
+      "Vertex shader", nullptr, nullptr, "main", "vs_4_0",
+      0, 0, &vsBlob, nullptr))) {
+    std::cerr << "Failed to compile vertex shader" << std::endl;
+    return 1;
+  }
+
+  if (FAILED(D3DCompile(g_psCode.data(), g_psCode.size(),
+      "Pixel shader", nullptr, nullptr, "main", "ps_4_0",
+      0, 0, &psBlob, nullptr))) {
+    std::cerr << "Failed to compile pixel shader" << std::endl;
+    return 1;
+  }
+
+  if (FAILED(device->CreateVertexShader(
+      vsBlob->GetBufferPointer(),
+      vsBlob->GetBufferSize(),
+      nullptr, &vertexShader))) {
+    std::cerr << "Failed to create vertex shader" << std::endl;
+    return 1;
+  }
+
+  if (FAILED(device->CreatePixelShader(
+      psBlob->GetBufferPointer(),
+      psBlob->GetBufferSize(),
+      nullptr, &pixelShader))) {
+    std::cerr << "Failed to create pixel shader" << std::endl;
+    return 1;
+  }
+
+  D3D11_BUFFER_DESC bufferDesc;
+  bufferDesc.ByteWidth           = ConstantSize;
+  bufferDesc.Usage               = D3D11_USAGE_DEFAULT;
+  bufferDesc.BindFlags           = D3D11_BIND_CONSTANT_BUFFER;
+  bufferDesc.CPUAccessFlags      = 0;
+  bufferDesc.MiscFlags           = 0;
+  bufferDesc.StructureByteStride = 0;
+
+  if (FAILED(device->CreateBuffer(&bufferDesc, nullptr, &constantBuffer))) {
+    std::cerr << "Failed to create constant buffer" << std::endl;
+    return 1;
+  }
+
+  bufferDesc.ByteWidth           = TexelBufferSize;
+  bufferDesc.BindFlags           = D3D11_BIND_SHADER_RESOURCE;
+
+  if (FAILED(device->CreateBuffer(&bufferDesc, nullptr, &texelBuffer))) {
+    std::cerr << "Failed to create texel buffer" << std::endl;
+    return 1;
+  }
+
+  D3D11_SHADER_RESOURCE_VIEW_DESC texelViewDesc;
+  texelViewDesc.Format              = DXGI_FORMAT_R32G32B32A32_FLOAT;
+  texelViewDesc.ViewDimension       = D3D11_SRV_DIMENSION_BUFFER;
+  texelViewDesc.Buffer.FirstElement = 0;
+  texelViewDesc.Buffer.NumElements  = TexelBufferSize / sizeof(Color);
+
+  if (FAILED(device->CreateShaderResourceView(texelBuffer.ptr(), &texelViewDesc, &texelView))) {
+    std::cerr << "Failed to create shader resource view" << std::endl;
+    return 1;
+  }
+
+  D3D11_TEXTURE2D_DESC targetDesc;
+  targetDesc.Width          = ColumnCount * ColumnWidth;
+  targetDesc.Height         = 1;
+  targetDesc.MipLevels      = 1;
+  targetDesc.ArraySize      = 1;
+  targetDesc.Format         = DXGI_FORMAT_R8G8B8A8_UNORM;
+  targetDesc.SampleDesc     = { 1, 0 };
+  targetDesc.Usage          = D3D11_USAGE_DEFAULT;
+  targetDesc.BindFlags      = D3D11_BIND_RENDER_TARGET;
+  targetDesc.CPUAccessFlags = 0;
+  targetDesc.MiscFlags      = 0;
+
+  if (FAILED(device->CreateTexture2D(&targetDesc, nullptr, &renderTarget))) {
+    std::cerr << "Failed to create render target" << std::endl;
+    return 1;
+  }
+
+  targetDesc.Usage          = D3D11_USAGE_STAGING;
+  targetDesc.BindFlags      = 0;
+  targetDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+
+  if (FAILED(device->CreateTexture2D(&targetDesc, nullptr, &readTarget))) {
+    std::cerr << "Failed to create readback image" << std::endl;
+    return 1;
+  }
+
+  if (FAILED(device->CreateRenderTargetView(renderTarget.ptr(), nullptr, &renderTargetView))) {
+    std::cerr << "Failed to create render target view" << std::endl;
+    return 1;
+  }
+
+  FLOAT clearColor[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+  context->OMSetRenderTargets(1, &renderTargetView, nullptr);
+  context->ClearRenderTargetView(renderTargetView.ptr(), clearColor);
+
+  context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+  context->VSSetShader(vertexShader.ptr(), nullptr, 0);
+  context->PSSetShader(pixelShader.ptr(), nullptr, 0);
+  context->PSSetConstantBuffers(0, 1, &constantBuffer);
+  context->PSSetShaderResources(0, 1, &texelView);
+
+  std::vector<Color> constantData(ConstantSize / sizeof(Color));
+  std::vector<Color> texelData(TexelBufferSize / sizeof(Color));
+
+  // Overwrite both buffers in their entirety between draws, so
+  // that every draw after the first one sees renamed buffers
+  for (uint32_t i = 0; i < ColumnCount; i++) {
+    constantData[0] = getConstantColor(i);
+    texelData[0]    = getTexelColor(i);
+
+    context->UpdateSubresource(constantBuffer.ptr(), 0, nullptr, constantData.data(), 0, 0);
+    context->UpdateSubresource(texelBuffer.ptr(),    0, nullptr, texelData.data(),    0, 0);
+
+    D3D11_VIEWPORT viewport;
+    viewport.TopLeftX = float(i * ColumnWidth);
+    viewport.TopLeftY = 0.0f;
+    viewport.Width    = float(ColumnWidth);
+    viewport.Height   = 1.0f;
+    viewport.MinDepth = 0.0f;
+    viewport.MaxDepth = 1.0f;
+
+    context->RSSetViewports(1, &viewport);
+    context->Draw(3, 0);
+  }
+
+  context->CopyResource(readTarget.ptr(), renderTarget.ptr());
+
+  D3D11_MAPPED_SUBRESOURCE mappedResource;
+  if (FAILED(context->Map(readTarget.ptr(), 0, D3D11_MAP_READ, 0, &mappedResource))) {
+    std::cerr << "Failed to map readback image" << std::endl;
+    return 1;
+  }
+
+  auto pixels = reinterpret_cast<const uint8_t*>(mappedResource.pData);
+  uint32_t errorCount = 0;
+
+  for (uint32_t x = 0; x < ColumnCount * ColumnWidth; x++) {
+    const uint32_t column = x / ColumnWidth;
+    const uint8_t* pixel  = &pixels[4 * x];
+
+    std::array<int32_t, 4> expected = {
+      int32_t(20 * column), int32_t(30 * column), 0, 255 };
+
+    for (uint32_t c = 0; c < 4; c++) {
+      if (std::abs(int32_t(pixel[c]) - expected[c]) > 1) {
+        std::cerr << "Pixel " << x << ", component " << c
+                  << ": expected " << expected[c]
+                  << ", got " << uint32_t(pixel[c]) << std::endl;
+        errorCount += 1;
+      }
+    }
+  }
+
+  context->Unmap(readTarget.ptr(), 0);
+  context->ClearState();
+
+  if (errorCount) {
+    std::cerr << "Buffer updates: " << errorCount << " errors" << std::endl;
+    return 1;
+  }
+
+  std::cout << "Buffer updates: all pixels match" << std::endl;
+  return 0;
+}
@@ -0,0 +1,134 @@
+#include <vector>
+
+#include <shellapi.h>
+#include <windows.h>
+#include <windowsx.h>
+
+#include "test_dxbc_utils.h"
+
+namespace dxvk {
+  Logger Logger::s_instance("dxbc-min-precision.log");
+}
+
+using namespace dxvk;
+
+struct TestCase {
+  const char* name;
+  const char* code;
+  bool        relaxed;
+  bool        float16;
+};
+
+const std::vector<TestCase> g_testCases = {
+  // Eligible for 16-bit float arithmetic
+  { "min16float",
+    "Texture2D<min16float4> t0 : register(t0);\n"
+    "SamplerState s0 : register(s0);\n"
+    "min16float4 main(float4 pos : SV_POSITION, float2 uv : TEXCOORD0) : SV_TARGET {\n"
+    "  min16float4 a = t0.Sample(s0, uv);\n"
+    "  min16float4 b = t0.Sample(s0, uv * 0.5f);\n"
+    "  return max(a * b + a, min16float4(0.0f, 0.0f, 0.0f, 0.0f));\n"
+    "}\n", true, true },
+
+  // Integer results are only ever decorated
+  { "min16int",
+    "Buffer<min16int4> t0 : register(t0);\n"
+    "Buffer<min16uint4> t1 : register(t1);\n"
+    "int4 main(uint id : SV_PRIMITIVEID) : SV_TARGET {\n"
+    "  min16int4  a = t0.Load(id);\n"
+    "  min16uint4 b = t1.Load(id);\n"
+    "  return max(a + a, min16int4(0, 0, 0, 0)) + min16int4(b >> 1);\n"
+    "}\n", true, false },
+
+  // No minimum precision hints at all
+  { "Full precision",
+    "Texture2D<float4> t0 : register(t0);\n"
+    "SamplerState s0 : register(s0);\n"
+    "float4 main(float4 pos : SV_POSITION, float2 uv : TEXCOORD0) : SV_TARGET {\n"
+    "  float4 a = t0.Sample(s0, uv);\n"
+    "  float4 b = t0.Sample(s0, uv * 0.5f);\n"
+    "  return max(a * b + a, float4(0.0f, 0.0f, 0.0f, 0.0f));\n"
+    "}\n", false, false },
+};
+
+
+struct SpirvStats {
+  uint32_t relaxedDecorations = 0;
+  uint32_t float16Conversions = 0;
+  bool     float16Capability  = false;
+};
+
+
+SpirvStats getSpirvStats(SpirvCodeBuffer& code) {
+  SpirvStats stats;
+
+  for (auto ins : code) {
+    switch (ins.opCode()) {
+      case spv::OpCapability:
+        stats.float16Capability |= ins.arg(1) == spv::CapabilityFloat16;
+        break;
+
+      case spv::OpDecorate:
+        stats.relaxedDecorations += ins.arg(2) == spv::DecorationRelaxedPrecision;
+        break;
+
+      case spv::OpFConvert:
+        stats.float16Conversions += 1;
+        break;
+
+      default:
+        break;
+    }
+  }
+
+  return stats;
+}
+
+
+bool checkStats(const TestCase& test, bool float16, std::ostream& summary) {
+  DxbcModuleInfo moduleInfo;
+  moduleInfo.options.useFloat16Arithmetic = float16;
+  moduleInfo.tess = nullptr;
+  moduleInfo.xfb  = nullptr;
+
+  SpirvCodeBuffer code  = compileHlslShader(test.name, test.code, "ps_5_0", moduleInfo);
+  SpirvStats      stats = getSpirvStats(code);
+
+  // 16-bit arithmetic must only be used if it is enabled and the
+  // shader has min16float operands. Otherwise, results declared
+  // with minimum precision must be decorated, and nothing else.
+  const bool useFloat16 = float16 && test.float16;
+
+  bool success = useFloat16
+    ? (stats.float16Capability && stats.float16Conversions != 0)
+    : (!stats.float16Capability && stats.float16Conversions == 0);
+
+  if (!useFloat16) {
+    success &= test.relaxed
+      ? stats.relaxedDecorations != 0
+      : stats.relaxedDecorations == 0;
+  }
+
+  summary << (float16 ? "Float16" : "RelaxedPrecision") << " mode: "
+    << stats.relaxedDecorations << " relaxed, "
+    << stats.float16Conversions << " conversions, "
+    << (stats.float16Capability ? "Float16" : "no Float16");
+  return success;
+}
+
+
+bool runTest(const TestCase& test, std::ostream& summary) {
+  bool success = true;
+  success &= checkStats(test, false, summary);
+  summary << "; ";
+  success &= checkStats(test, true,  summary);
+  return success;
+}
+
+
+int WINAPI WinMain(HINSTANCE hInstance,
+                   HINSTANCE hPrevInstance,
+                   LPSTR lpCmdLine,
+                   int nCmdShow) {
+  return runTestCases(g_testCases, runTest);
+}
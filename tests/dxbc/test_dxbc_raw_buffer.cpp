@@ -0,0 +1,176 @@
+#include <unordered_map>
+#include <vector>
+
+#include <shellapi.h>
+#include <windows.h>
+#include <windowsx.h>
+
+#include "test_dxbc_utils.h"
+
+namespace dxvk {
+  Logger Logger::s_instance("dxbc-raw-buffer.log");
+}
+
+using namespace dxvk;
+
+struct TestCase {
+  const char* name;
+  const char* code;
+  bool        vectorLoads;
+  bool        vectorStores;
+};
+
+const std::vector<TestCase> g_testCases = {
+  // 32-byte stride, all members 16-byte aligned
+  { "Aligned vec4",
+    "struct S { float4 a; float4 b; };\n"
+    "StructuredBuffer<S> src : register(t0);\n"
+    "RWStructuredBuffer<S> dst : register(u0);\n"
+    "[numthreads(64,1,1)]\n"
+    "void main(uint id : SV_DispatchThreadID) {\n"
+    "  dst[id] = src[id];\n"
+    "}\n", true, true },
+
+  // 8-byte stride, uses the uvec2 view
+  { "Aligned vec2",
+    "StructuredBuffer<uint2> src : register(t0);\n"
+    "RWStructuredBuffer<uint2> dst : register(u0);\n"
+    "[numthreads(64,1,1)]\n"
+    "void main(uint id : SV_DispatchThreadID) {\n"
+    "  dst[id] = src[id] + 1;\n"
+    "}\n", true, true },
+
+  // 12-byte stride, no vector view is declared
+  { "Unaligned stride",
+    "StructuredBuffer<float3> src : register(t0);\n"
+    "RWStructuredBuffer<float3> dst : register(u0);\n"
+    "[numthreads(64,1,1)]\n"
+    "void main(uint id : SV_DispatchThreadID) {\n"
+    "  dst[id] = src[id] * 2.0f;\n"
+    "}\n", false, false },
+
+  // 16-byte stride, but the member is at offset 4
+  { "Unaligned offset",
+    "struct S { float x; float3 y; };\n"
+    "StructuredBuffer<S> src : register(t0);\n"
+    "RWStructuredBuffer<S> dst : register(u0);\n"
+    "[numthreads(64,1,1)]\n"
+    "void main(uint id : SV_DispatchThreadID) {\n"
+    "  dst[id].y = src[id].y;\n"
+    "}\n", false, false },
+};
+
+
+struct SpirvStats {
+  uint32_t vectorLoads  = 0;
+  uint32_t vectorStores = 0;
+  uint32_t scalarLoads  = 0;
+  uint32_t scalarStores = 0;
+};
+
+
+SpirvStats getSpirvStats(SpirvCodeBuffer& code) {
+  // Maps type and variable IDs to the vector size of the
+  // runtime array they refer to, so that loads and stores
+  // can be classified by the buffer view they go through
+  std::unordered_map<uint32_t, uint32_t> vectorTypes;
+  std::unordered_map<uint32_t, uint32_t> arraySizes;
+  std::unordered_map<uint32_t, uint32_t> pointers;
+
+  SpirvStats stats;
+
+  for (auto ins : code) {
+    switch (ins.opCode()) {
+      case spv::OpTypeVector:
+        vectorTypes.insert({ ins.arg(1), ins.arg(3) });
+        break;
+
+      case spv::OpTypeRuntimeArray: {
+        auto entry = vectorTypes.find(ins.arg(2));
+        arraySizes.insert({ ins.arg(1), entry != vectorTypes.end() ? entry->second : 1 });
+      } break;
+
+      case spv::OpTypeStruct: {
+        auto entry = arraySizes.find(ins.arg(2));
+        if (entry != arraySizes.end())
+          arraySizes.insert({ ins.arg(1), entry->second });
+      } break;
+
+      case spv::OpTypePointer: {
+        auto entry = arraySizes.find(ins.arg(3));
+        if (entry != arraySizes.end())
+          arraySizes.insert({ ins.arg(1), entry->second });
+      } break;
+
+      case spv::OpVariable: {
+        auto entry = arraySizes.find(ins.arg(1));
+        if (entry != arraySizes.end())
+          pointers.insert({ ins.arg(2), entry->second });
+      } break;
+
+      case spv::OpAccessChain: {
+        auto entry = pointers.find(ins.arg(3));
+        if (entry != pointers.end())
+          pointers.insert({ ins.arg(2), entry->second });
+      } break;
+
+      case spv::OpLoad: {
+        auto entry = pointers.find(ins.arg(3));
+        if (entry != pointers.end()) {
+          stats.vectorLoads += entry->second > 1;
+          stats.scalarLoads += entry->second == 1;
+        }
+      } break;
+
+      case spv::OpStore: {
+        auto entry = pointers.find(ins.arg(1));
+        if (entry != pointers.end()) {
+          stats.vectorStores += entry->second > 1;
+          stats.scalarStores += entry->second == 1;
+        }
+      } break;
+
+      default:
+        break;
+    }
+  }
+
+  return stats;
+}
+
+
+bool runTest(const TestCase& test, std::ostream& summary) {
+  DxbcModuleInfo moduleInfo;
+  moduleInfo.options.useRawSsbo = true;
+  moduleInfo.tess = nullptr;
+  moduleInfo.xfb  = nullptr;
+
+  SpirvCodeBuffer code  = compileHlslShader(test.name, test.code, "cs_5_0", moduleInfo);
+  SpirvStats      stats = getSpirvStats(code);
+
+  bool success = true;
+
+  // Aligned accesses must not be split into scalar operations,
+  // and unaligned accesses must not use the vector view at all.
+  success &= test.vectorLoads
+    ? (stats.vectorLoads  != 0 && stats.scalarLoads  == 0)
+    : (stats.vectorLoads  == 0 && stats.scalarLoads  != 0);
+  success &= test.vectorStores
+    ? (stats.vectorStores != 0 && stats.scalarStores == 0)
+    : (stats.vectorStores == 0 && stats.scalarStores != 0);
+
+  summary
+    << stats.vectorLoads  << " vector loads, "
+    << stats.scalarLoads  << " scalar loads, "
+    << stats.vectorStores << " vector stores, "
+    << stats.scalarStores << " scalar stores";
+  return success;
+}
+
+
+int WINAPI WinMain(HINSTANCE hInstance,
+                   HINSTANCE hPrevInstance,
+                   LPSTR lpCmdLine,
+                   int nCmdShow) {
+  return runTestCases(g_testCases, runTest);
+}
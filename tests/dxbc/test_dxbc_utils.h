@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstring>
+#include <sstream>
+
+#include <d3dcompiler.h>
+
+#include "../../src/dxbc/dxbc_module.h"
+#include "../../src/dxvk/dxvk_shader.h"
+#include "../../src/spirv/spirv_code_buffer.h"
+
+#include "../test_harness.h"
+
+/**
+ * \brief Compiles HLSL code to SPIR-V
+ * 
+ * Compiles the given code with \c D3DCompile and
+ * runs the resulting DXBC through the DXBC compiler.
+ * \param [in] name Shader name
+ * \param [in] code HLSL source code
+ * \param [in] profile Shader profile, e.g. \c ps_5_0
+ * \param [in] moduleInfo DXBC compiler options
+ * \returns SPIR-V code of the shader
+ * \throws DxvkError if compilation fails
+ */
+inline dxvk::SpirvCodeBuffer compileHlslShader(
+        const char*             name,
+        const char*             code,
+        const char*             profile,
+  const dxvk::DxbcModuleInfo&   moduleInfo) {
+  using namespace dxvk;
+
+  Com<ID3DBlob> binary;
+  Com<ID3DBlob> errors;
+
+  HRESULT hr = D3DCompile(
+    code, std::strlen(code),
+    name, nullptr, nullptr,
+    "main", profile,
+    D3DCOMPILE_OPTIMIZATION_LEVEL3,
+    0, &binary, &errors);
+
+  if (FAILED(hr)) {
+    throw DxvkError(errors != nullptr
+      ? reinterpret_cast<const char*>(errors->GetBufferPointer())
+      : "Failed to compile HLSL shader");
+  }
+
+  DxbcReader reader(
+    reinterpret_cast<const char*>(binary->GetBufferPointer()),
+    binary->GetBufferSize());
+  DxbcModule module(reader);
+
+  Rc<DxvkShader> shader = module.compile(moduleInfo, name);
+
+  std::stringstream stream;
+  shader->dump(stream);
+
+  return SpirvCodeBuffer(stream);
+}
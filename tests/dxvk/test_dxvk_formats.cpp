@@ -0,0 +1,217 @@
+#include <chrono>
+
+#include "../../src/dxvk/dxvk_adapter.h"
+#include "../../src/dxvk/dxvk_format.h"
+#include "../../src/dxvk/dxvk_instance.h"
+
+#include <windows.h>
+#include <windowsx.h>
+
+namespace dxvk {
+  Logger Logger::s_instance("dxvk-formats.log");
+}
+
+using namespace dxvk;
+
+using Clock = std::chrono::high_resolution_clock;
+
+/* Format ranges covered by the format info table. The
+ * test checks all formats within and around each range. */
+const std::array<std::pair<VkFormat, VkFormat>, 2> g_referenceGroups = {{
+  { VK_FORMAT_UNDEFINED,              VK_FORMAT_BC7_SRGB_BLOCK          },
+  { VK_FORMAT_G8B8G8R8_422_UNORM_KHR, VK_FORMAT_B8G8R8G8_422_UNORM_KHR  },
+}};
+
+const uint32_t g_lookupIterations = 64;
+
+
+/**
+ * \brief Reference format info lookup
+ * 
+ * Walks the format groups in order, which is what
+ * the original implementation of imageFormatInfo did.
+ */
+const DxvkFormatInfo* referenceFormatInfo(VkFormat format) {
+  const DxvkFormatInfo* base = imageFormatInfo(VK_FORMAT_UNDEFINED);
+  uint32_t indexOffset = 0;
+  
+  for (const auto& group : g_referenceGroups) {
+    if (format >= group.first && format <= group.second) {
+      uint32_t index = uint32_t(format) - uint32_t(group.first);
+      return base + indexOffset + index;
+    } else {
+      indexOffset += uint32_t(group.second)
+                   - uint32_t(group.first) + 1;
+    }
+  }
+  
+  return nullptr;
+}
+
+
+std::vector<VkFormat> getTestFormats() {
+  std::vector<VkFormat> result;
+  
+  for (const auto& group : g_referenceGroups) {
+    uint32_t first = uint32_t(group.first) >= 16 ? uint32_t(group.first) - 16 : 0;
+    uint32_t last  = uint32_t(group.second) + 16;
+    
+    for (uint32_t i = first; i <= last; i++)
+      result.push_back(VkFormat(i));
+  }
+  
+  return result;
+}
+
+
+template<typename Fn>
+double measure(Fn fn) {
+  auto t0 = Clock::now();
+  fn();
+  auto t1 = Clock::now();
+  return std::chrono::duration<double, std::micro>(t1 - t0).count();
+}
+
+
+bool testFormatInfo() {
+  std::vector<VkFormat> formats = getTestFormats();
+  uint32_t numErrors = 0;
+  
+  for (VkFormat format : formats) {
+    if (imageFormatInfo(format) != referenceFormatInfo(format)) {
+      Logger::err(str::format("Format info mismatch: ", format));
+      numErrors += 1;
+    }
+  }
+  
+  // Prevent the compiler from optimizing the lookups away
+  volatile uintptr_t sink = 0;
+  
+  double tNew = measure([&] {
+    for (uint32_t i = 0; i < g_lookupIterations; i++) {
+      for (VkFormat format : formats)
+        sink = sink + reinterpret_cast<uintptr_t>(imageFormatInfo(format));
+    }
+  });
+  
+  double tRef = measure([&] {
+    for (uint32_t i = 0; i < g_lookupIterations; i++) {
+      for (VkFormat format : formats)
+        sink = sink + reinterpret_cast<uintptr_t>(referenceFormatInfo(format));
+    }
+  });
+  
+  uint32_t lookups = g_lookupIterations * formats.size();
+  
+  Logger::info(str::format("imageFormatInfo: ", formats.size(), " formats checked, ", numErrors, " mismatches"));
+  Logger::info(str::format("  Table lookup:     ", 1000.0 * tNew / lookups, " ns"));
+  Logger::info(str::format("  Reference lookup: ", 1000.0 * tRef / lookups, " ns"));
+  return numErrors == 0;
+}
+
+
+bool testAdapter(const Rc<DxvkAdapter>& adapter) {
+  Rc<vk::InstanceFn> vki = adapter->vki();
+  uint32_t numErrors = 0;
+  
+  Logger::info(str::format("Adapter: ", adapter->deviceProperties().deviceName));
+  
+  // Only core formats are guaranteed to be valid
+  // for all adapters, so don't test extensions
+  std::vector<VkFormat> formats;
+  
+  for (uint32_t i = 0; i < VK_FORMAT_RANGE_SIZE; i++)
+    formats.push_back(VkFormat(i));
+  
+  for (VkFormat format : formats) {
+    VkFormatProperties expected;
+    vki->vkGetPhysicalDeviceFormatProperties(adapter->handle(), format, &expected);
+    
+    VkFormatProperties actual = adapter->formatProperties(format);
+    
+    if (std::memcmp(&expected, &actual, sizeof(expected))) {
+      Logger::err(str::format("  Format properties mismatch: ", format));
+      numErrors += 1;
+    }
+  }
+  
+  const std::array<VkImageUsageFlags, 4> usages = {{
+    VK_IMAGE_USAGE_SAMPLED_BIT,
+    VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
+    VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+    VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT,
+  }};
+  
+  // Query everything twice so that the second
+  // iteration gets served from the cache
+  for (uint32_t i = 0; i < 2; i++) {
+    for (VkFormat format : formats) {
+      for (VkImageUsageFlags usage : usages) {
+        VkImageFormatProperties expected = { };
+        VkImageFormatProperties actual   = { };
+        
+        VkResult expectedResult = vki->vkGetPhysicalDeviceImageFormatProperties(
+          adapter->handle(), format, VK_IMAGE_TYPE_2D, VK_IMAGE_TILING_OPTIMAL,
+          usage, 0, &expected);
+        
+        VkResult actualResult = adapter->imageFormatProperties(
+          format, VK_IMAGE_TYPE_2D, VK_IMAGE_TILING_OPTIMAL,
+          usage, 0, actual);
+        
+        if (expectedResult != actualResult || (expectedResult == VK_SUCCESS
+         && std::memcmp(&expected, &actual, sizeof(expected)))) {
+          Logger::err(str::format("  Image format properties mismatch: ", format, ", usage ", usage));
+          numErrors += 1;
+        }
+      }
+    }
+  }
+  
+  // Typical format support check as done by
+  // applications for every format on startup
+  double tCached = measure([&] {
+    for (VkFormat format : formats) {
+      VkImageFormatProperties properties;
+      adapter->formatProperties(format);
+      adapter->imageFormatProperties(format, VK_IMAGE_TYPE_2D,
+        VK_IMAGE_TILING_OPTIMAL, usages[0], 0, properties);
+    }
+  });
+  
+  double tDriver = measure([&] {
+    for (VkFormat format : formats) {
+      VkFormatProperties formatProperties;
+      VkImageFormatProperties properties;
+      vki->vkGetPhysicalDeviceFormatProperties(
+        adapter->handle(), format, &formatProperties);
+      vki->vkGetPhysicalDeviceImageFormatProperties(
+        adapter->handle(), format, VK_IMAGE_TYPE_2D,
+        VK_IMAGE_TILING_OPTIMAL, usages[0], 0, &properties);
+    }
+  });
+  
+  Logger::info(str::format("  ", formats.size(), " formats checked, ", numErrors, " mismatches"));
+  Logger::info(str::format("  Cached queries: ", tCached, " us"));
+  Logger::info(str::format("  Driver queries: ", tDriver, " us"));
+  return numErrors == 0;
+}
+
+
+int WINAPI WinMain(HINSTANCE hInstance,
+                   HINSTANCE hPrevInstance,
+                   LPSTR lpCmdLine,
+                   int nCmdShow) {
+  try {
+    bool success = testFormatInfo();
+    
+    Rc<DxvkInstance> instance = new DxvkInstance();
+    
+    for (uint32_t i = 0; instance->enumAdapters(i) != nullptr; i++)
+      success &= testAdapter(instance->enumAdapters(i));
+    
+    return success ? 0 : 1;
+  } catch (const DxvkError& e) {
+    Logger::err(e.message());
+    return 1;
+  }
+}
@@ -0,0 +1,130 @@
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+#include "../../src/d3d10/d3d10_multithread.h"
+
+#include "../../src/util/sync/sync_spinlock.h"
+#include "../../src/util/thread.h"
+
+#include <windows.h>
+#include <windowsx.h>
+
+using namespace dxvk;
+
+using Clock = std::chrono::high_resolution_clock;
+
+const uint32_t g_iterationsPerThread = 200000;
+const uint32_t g_criticalSectionSize = 64;
+
+
+/**
+ * \brief Reference lock
+ *
+ * The spin lock as it was implemented before
+ * threads got parked, i.e. it only yields.
+ */
+class YieldLock {
+
+public:
+
+  void lock() {
+    while (!try_lock())
+      dxvk::this_thread::yield();
+  }
+
+  void unlock() {
+    m_lock.store(0, std::memory_order_release);
+  }
+
+  bool try_lock() {
+    uint32_t expected = 0;
+    return m_lock.compare_exchange_strong(expected, 1,
+      std::memory_order_acquire,
+      std::memory_order_relaxed);
+  }
+
+private:
+
+  std::atomic<uint32_t> m_lock = { 0 };
+
+};
+
+
+template<typename Lock>
+double runBenchmark(Lock& lock, uint32_t threadCount, uint64_t& checksum) {
+  std::vector<uint32_t> data(g_criticalSectionSize);
+  std::vector<dxvk::thread> threads;
+
+  auto t0 = Clock::now();
+
+  for (uint32_t i = 0; i < threadCount; i++) {
+    threads.emplace_back([&lock, &data] {
+      for (uint32_t j = 0; j < g_iterationsPerThread; j++) {
+        std::lock_guard<Lock> guard(lock);
+
+        for (uint32_t k = 0; k < data.size(); k++)
+          data[k] += k + 1;
+      }
+    });
+  }
+
+  for (auto& thread : threads)
+    thread.join();
+
+  auto t1 = Clock::now();
+
+  checksum = 0;
+
+  for (uint32_t value : data)
+    checksum += value;
+
+  auto us = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0);
+  return double(us.count()) / 1000.0;
+}
+
+
+int WINAPI WinMain(HINSTANCE hInstance,
+                   HINSTANCE hPrevInstance,
+                   LPSTR lpCmdLine,
+                   int nCmdShow) {
+  bool success = true;
+
+  std::cout << "Spin count: " << sync::ParkingLot::spinCount() << std::endl;
+
+  for (uint32_t threadCount = 1; threadCount <= 32; threadCount *= 2) {
+    YieldLock        yieldLock;
+    sync::Spinlock   spinLock;
+    D3D10DeviceMutex deviceMutex;
+
+    uint64_t yieldChecksum  = 0;
+    uint64_t spinChecksum   = 0;
+    uint64_t deviceChecksum = 0;
+
+    double yieldMs  = runBenchmark(yieldLock,   threadCount, yieldChecksum);
+    double spinMs   = runBenchmark(spinLock,    threadCount, spinChecksum);
+    double deviceMs = runBenchmark(deviceMutex, threadCount, deviceChecksum);
+
+    sync::LockStats spinStats   = spinLock.getStats();
+    sync::LockStats deviceStats = deviceMutex.getStats();
+
+    // All locks must have serialized all
+    // increments to the shared data array
+    bool valid = yieldChecksum == spinChecksum
+              && yieldChecksum == deviceChecksum;
+    success &= valid;
+
+    std::cout << threadCount << " threads: "
+      << "yield " << yieldMs << " ms, "
+      << "adaptive " << spinMs << " ms "
+      << "(" << spinStats.contended << " contended, "
+      << spinStats.parked << " parked), "
+      << "device " << deviceMs << " ms "
+      << "(" << deviceStats.contended << " contended, "
+      << deviceStats.parked << " parked)"
+      << (valid ? "" : " - FAIL") << std::endl;
+  }
+
+  return success ? 0 : 1;
+}
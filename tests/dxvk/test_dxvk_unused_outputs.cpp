@@ -0,0 +1,249 @@
+#include <array>
+#include <unordered_map>
+#include <vector>
+
+#include "../../src/dxvk/dxvk_shader_dce.h"
+#include "../../src/spirv/spirv_module.h"
+
+#include <windows.h>
+#include <windowsx.h>
+
+#include "../test_harness.h"
+
+namespace dxvk {
+  Logger Logger::s_instance("dxvk-unused-outputs.log");
+}
+
+using namespace dxvk;
+
+/**
+ * \brief Test shader
+ *
+ * Vertex shader with one output per location:
+ *  - o0 = v + v, plain arithmetic
+ *  - o1 = v * v, plain arithmetic
+ *  - o2 = float(atomicAdd(buf[0], 1)), which
+ *    has a side effect that must be kept
+ *  - o3 = v - v, which is read back and
+ *    written to the position built-in
+ *  - o4 = r1, with r0 = -v in a private variable
+ *    and r1 = r0 / v in a function variable, the
+ *    way the DXBC compiler uses temp registers
+ *  - o5 = r0
+ */
+struct TestShader {
+  SpirvCodeBuffer code;
+
+  uint32_t outputVars[6];
+  uint32_t tempVars[2];
+  uint32_t positionVar;
+  uint32_t fmulId;
+};
+
+
+TestShader createTestShader() {
+  TestShader result;
+  SpirvModule m;
+
+  m.enableCapability(spv::CapabilityShader);
+  m.setMemoryModel(
+    spv::AddressingModelLogical,
+    spv::MemoryModelGLSL450);
+
+  uint32_t voidType = m.defVoidType();
+  uint32_t funcType = m.defFunctionType(voidType, 0, nullptr);
+  uint32_t uintType = m.defIntType(32, 0);
+  uint32_t f32Type  = m.defFloatType(32);
+  uint32_t vec4Type = m.defVectorType(f32Type, 4);
+
+  uint32_t inPtrType   = m.defPointerType(vec4Type, spv::StorageClassInput);
+  uint32_t outPtrType  = m.defPointerType(vec4Type, spv::StorageClassOutput);
+  uint32_t privPtrType = m.defPointerType(vec4Type, spv::StorageClassPrivate);
+  uint32_t funcPtrType = m.defPointerType(vec4Type, spv::StorageClassFunction);
+  uint32_t uintPtrType = m.defPointerType(uintType, spv::StorageClassUniform);
+
+  // Storage buffer for the atomic
+  uint32_t arrayType = m.defRuntimeArrayTypeUnique(uintType);
+  m.decorateArrayStride(arrayType, sizeof(uint32_t));
+
+  uint32_t blockType = m.defStructTypeUnique(1, &arrayType);
+  m.memberDecorateOffset(blockType, 0, 0);
+  m.decorate(blockType, spv::DecorationBufferBlock);
+
+  uint32_t bufferVar = m.newVar(
+    m.defPointerType(blockType, spv::StorageClassUniform),
+    spv::StorageClassUniform);
+  m.decorateDescriptorSet(bufferVar, 0);
+  m.decorateBinding(bufferVar, 0);
+
+  // Shader interface
+  std::vector<uint32_t> interfaceVars;
+
+  uint32_t inputVar = m.newVar(inPtrType, spv::StorageClassInput);
+  m.decorateLocation(inputVar, 0);
+  interfaceVars.push_back(inputVar);
+
+  for (uint32_t i = 0; i < 6; i++) {
+    result.outputVars[i] = m.newVar(outPtrType, spv::StorageClassOutput);
+    m.decorateLocation(result.outputVars[i], i);
+    interfaceVars.push_back(result.outputVars[i]);
+  }
+
+  result.positionVar = m.newVar(outPtrType, spv::StorageClassOutput);
+  m.decorateBuiltIn(result.positionVar, spv::BuiltInPosition);
+  interfaceVars.push_back(result.positionVar);
+
+  // Shader code
+  uint32_t entryPointId = m.allocateId();
+
+  m.functionBegin(voidType, entryPointId, funcType, spv::FunctionControlMaskNone);
+  m.opLabel(m.allocateId());
+
+  result.tempVars[0] = m.newVar(privPtrType, spv::StorageClassPrivate);
+  result.tempVars[1] = m.newVar(funcPtrType, spv::StorageClassFunction);
+
+  uint32_t v = m.opLoad(vec4Type, inputVar);
+  m.opStore(result.outputVars[0], m.opFAdd(vec4Type, v, v));
+
+  result.fmulId = m.opFMul(vec4Type, v, v);
+  m.setDebugName(result.fmulId, "fmul");
+  m.opStore(result.outputVars[1], result.fmulId);
+
+  std::array<uint32_t, 2> indices = {{ m.constu32(0), m.constu32(0) }};
+
+  uint32_t counter = m.opAtomicIAdd(uintType,
+    m.opAccessChain(uintPtrType, bufferVar, indices.size(), indices.data()),
+    m.constu32(spv::ScopeDevice), m.constu32(spv::MemorySemanticsMaskNone),
+    m.constu32(1));
+
+  uint32_t counterF = m.opConvertUtoF(f32Type, counter);
+  std::array<uint32_t, 4> components = {{ counterF, counterF, counterF, counterF }};
+  m.opStore(result.outputVars[2], m.opCompositeConstruct(vec4Type, components.size(), components.data()));
+
+  m.opStore(result.outputVars[3], m.opFSub(vec4Type, v, v));
+  m.opStore(result.positionVar, m.opLoad(vec4Type, result.outputVars[3]));
+
+  m.opStore(result.tempVars[0], m.opFNegate(vec4Type, v));
+  m.opStore(result.tempVars[1], m.opFDiv(vec4Type, m.opLoad(vec4Type, result.tempVars[0]), v));
+  m.opStore(result.outputVars[4], m.opLoad(vec4Type, result.tempVars[1]));
+  m.opStore(result.outputVars[5], m.opLoad(vec4Type, result.tempVars[0]));
+
+  m.opReturn();
+  m.functionEnd();
+
+  m.addEntryPoint(entryPointId, spv::ExecutionModelVertex, "main",
+    interfaceVars.size(), interfaceVars.data());
+
+  result.code = m.compile();
+  return result;
+}
+
+
+struct SpirvStats {
+  uint32_t outputStores[6] = { };
+  uint32_t tempStores[2]   = { };
+  uint32_t positionStores  = 0;
+  uint32_t fmulNames       = 0;
+
+  std::unordered_map<uint32_t, uint32_t> opCounts;
+};
+
+
+SpirvStats getSpirvStats(const TestShader& shader, SpirvCodeBuffer& code) {
+  SpirvStats stats;
+
+  for (auto ins : code) {
+    stats.opCounts[ins.opCode()] += 1;
+
+    if (ins.opCode() == spv::OpName && ins.arg(1) == shader.fmulId)
+      stats.fmulNames += 1;
+
+    if (ins.opCode() == spv::OpStore) {
+      for (uint32_t i = 0; i < 6; i++)
+        stats.outputStores[i] += ins.arg(1) == shader.outputVars[i];
+
+      for (uint32_t i = 0; i < 2; i++)
+        stats.tempStores[i] += ins.arg(1) == shader.tempVars[i];
+
+      stats.positionStores += ins.arg(1) == shader.positionVar;
+    }
+  }
+
+  return stats;
+}
+
+
+struct TestCase {
+  const char* name;
+  uint32_t    unusedOutputs;
+  uint32_t    outputStores[6];
+  uint32_t    tempStores[2];
+  uint32_t    fadd;
+  uint32_t    fmul;
+  uint32_t    convert;
+  uint32_t    fnegate;
+  uint32_t    fdiv;
+};
+
+
+const std::vector<TestCase> g_testCases = {
+  { "No unused outputs", 0x00, { 1, 1, 1, 1, 1, 1 }, { 1, 1 }, 1, 1, 1, 1, 1 },
+  { "Arithmetic",        0x02, { 1, 0, 1, 1, 1, 1 }, { 1, 1 }, 1, 0, 1, 1, 1 },
+  { "Side effects",      0x04, { 1, 1, 0, 1, 1, 1 }, { 1, 1 }, 1, 1, 0, 1, 1 },
+  { "Read back",         0x08, { 1, 1, 1, 1, 1, 1 }, { 1, 1 }, 1, 1, 1, 1, 1 },
+  { "Function temp",     0x10, { 1, 1, 1, 1, 0, 1 }, { 1, 0 }, 1, 1, 1, 1, 0 },
+  { "Shared temp",       0x20, { 1, 1, 1, 1, 1, 0 }, { 1, 1 }, 1, 1, 1, 1, 1 },
+  { "Private temp",      0x30, { 1, 1, 1, 1, 0, 0 }, { 0, 0 }, 1, 1, 1, 0, 0 },
+  { "All unused",        0x3F, { 0, 0, 0, 1, 0, 0 }, { 0, 0 }, 0, 0, 0, 0, 0 },
+};
+
+
+bool runTest(const TestShader& shader, const TestCase& test, std::ostream& summary) {
+  SpirvCodeBuffer input = shader.code;
+  SpirvCodeBuffer code  = eliminateUnusedOutputs(input, test.unusedOutputs);
+  SpirvStats      stats = getSpirvStats(shader, code);
+
+  bool success = true;
+
+  for (uint32_t i = 0; i < 6; i++)
+    success &= stats.outputStores[i] == test.outputStores[i];
+
+  for (uint32_t i = 0; i < 2; i++)
+    success &= stats.tempStores[i] == test.tempStores[i];
+
+  // The atomic, the position store and the
+  // input load must survive in every case
+  success &= stats.positionStores == 1;
+  success &= stats.opCounts[spv::OpAtomicIAdd]   == 1;
+  success &= stats.opCounts[spv::OpFAdd]         == test.fadd;
+  success &= stats.opCounts[spv::OpFMul]         == test.fmul;
+  success &= stats.opCounts[spv::OpConvertUToF]  == test.convert;
+  success &= stats.opCounts[spv::OpFSub]         == 1;
+  success &= stats.opCounts[spv::OpFNegate]      == test.fnegate;
+  success &= stats.opCounts[spv::OpFDiv]         == test.fdiv;
+  success &= stats.fmulNames                     == test.fmul;
+
+  // Variable declarations are never removed
+  success &= stats.opCounts[spv::OpVariable]     == 11;
+
+  for (uint32_t i = 0; i < 6; i++)
+    summary << stats.outputStores[i] << " ";
+
+  summary << "output stores, "
+    << stats.tempStores[0] << " " << stats.tempStores[1]
+    << " temp stores, " << stats.opCounts[spv::OpAtomicIAdd] << " atomics";
+  return success;
+}
+
+
+int WINAPI WinMain(HINSTANCE hInstance,
+                   HINSTANCE hPrevInstance,
+                   LPSTR lpCmdLine,
+                   int nCmdShow) {
+  TestShader shader = createTestShader();
+
+  return runTestCases(g_testCases,
+    [&shader] (const TestCase& test, std::ostream& summary) {
+      return runTest(shader, test, summary);
+    });
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "test_utils.h"
+
+/**
+ * \brief Runs a table of test cases
+ * 
+ * Runs each test case and prints one line per test,
+ * consisting of the test name, whatever the test
+ * wrote to the given stream, and the result. Tests
+ * that throw a \c DxvkError count as failed.
+ * \param [in] tests Test cases, each with a \c name
+ * \param [in] run Runs a single test case and returns
+ *    \c true on success. Takes the test case and an
+ *    output stream for a short summary.
+ * \returns Exit code, non-zero if any test failed
+ */
+template<typename Test, typename Fn>
+int runTestCases(const std::vector<Test>& tests, const Fn& run) {
+  bool success = true;
+
+  for (const auto& test : tests) {
+    std::stringstream summary;
+    bool result = false;
+
+    try {
+      result = run(test, summary);
+    } catch (const dxvk::DxvkError& e) {
+      summary << e.message();
+    }
+
+    std::cout << test.name << ": " << summary.str()
+      << " - " << (result ? "PASS" : "FAIL") << std::endl;
+    success &= result;
+  }
+
+  return success ? 0 : 1;
+}